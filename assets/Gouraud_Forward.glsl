@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // =========================================================================
 // SHARED SETS
@@ -21,11 +22,37 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightDirection;
     vec4 ambientLightColor;
 
-    mat4 lightSpaceMatrix; // Shadow Matrix
+    mat4 cascadeMatrices[4]; // MAX_SHADOW_CASCADES, cascadeSplits[i] is the view depth cascade i ends at
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
 // SET 0, Binding 1: Shadow Map (Gouraud olsa bile buna ihtiyacimiz var)
-layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
+layout(set = 0, binding = 1) uniform sampler2DArrayShadow shadowMap;
+
+// SET 2, Binding 0: Bindless Material Properties
+// One record per material (GPUMaterial), the properties padded to 64 bytes followed by the slots of its textures in
+// bindlessTextures, indexed by TextureType.
+struct MaterialData {
+    vec4 diffuseColor;
+    vec3 specularColor;
+    float specularPower;
+    vec2 tiling;
+    vec2 offset;
+    vec4 _pad0;
+    uint textureSlots[12];
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// The draw's material, pushed whenever it changes between batches.
+layout(push_constant) uniform MaterialPush {
+    uint materialIndex;
+} push;
+
+#define material materials[push.materialIndex]
 
 // =========================================================================
 // VERTEX SHADER
@@ -33,23 +60,28 @@ layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
 #if defined(VERTEX_SHADER)
 
 // SET 1: Object Buffer
-layout(set = 1, binding = 0) uniform PerObjectBuffer {
+// One record per instance (CBPerObject). Mesh vertices are packed, positions are unorm16 within the mesh bounds and
+// decode to inPosition * positionScale + positionOffset.
+struct ObjectData {
     mat4 worldMatrix;
-} object;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
 
-// SET 2: Material Properties
-layout(set = 2, binding = 0) uniform PerMaterialBuffer {
-    vec4 diffuseColor;
-    vec3 specularColor;
-    float specularPower;
-    vec2 tiling;
-    vec2 offset;
-} material;
+layout(std430, set = 1, binding = 0) readonly buffer PerObjectBuffer {
+    ObjectData data[];
+} objects;
+
+// Object an instance draws, gl_InstanceIndex includes the draw's firstInstance. The identity on the CPU path, the
+// visible list the culling pass wrote on the GPU driven one.
+layout(std430, set = 1, binding = 1) readonly buffer InstanceIndexBuffer {
+    uint instanceIndices[];
+};
 
 // Inputs
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inTangent;
 layout(location = 3) in vec2 inTexCoord;
 
 // Outputs
@@ -58,22 +90,35 @@ layout(location = 3) in vec2 inTexCoord;
 layout(location = 0) out vec3 fragAmbient;      // Ortam Isigi (Golgeden etkilenmez)
 layout(location = 1) out vec3 fragDiffSpec;     // Diffuse + Specular (Golgeden etkilenir)
 layout(location = 2) out vec2 fragTexCoord;     // Texture UV
-layout(location = 3) out vec4 fragPosLightSpace; // Golge Haritasi Koordinati
+layout(location = 3) out vec3 fragWorldPos;      // Golge kaskadi ve koordinati icin
+
+// Unfolds a unit vector stored as its projection onto the octahedron, see PackVertices.
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
 
 void main() {
+    ObjectData objectData = objects.data[instanceIndices[gl_InstanceIndex]];
+    mat4 worldMatrix = objectData.worldMatrix;
+    vec3 position = inPosition * objectData.positionScale.xyz + objectData.positionOffset.xyz;
+    vec3 normal = DecodeOctahedral(inNormal);
+
     // 1. World Position
-    vec4 worldPos = object.worldMatrix * vec4(inPosition, 1.0);
+    vec4 worldPos = worldMatrix * vec4(position, 1.0);
     gl_Position = global.projectionMatrix * global.viewMatrix * worldPos;
 
-    // 2. Light Space Position (Fragment shader'da golge kontrolu icin)
-    fragPosLightSpace = global.lightSpaceMatrix * worldPos;
+    // 2. World Position (Fragment shader'da golge kontrolu icin)
+    fragWorldPos = worldPos.xyz;
 
     // 3. Texture Coordinates
     fragTexCoord = inTexCoord * material.tiling + material.offset;
 
     // --- GOURAUD ISIK HESABI (Per-Vertex) ---
 
-    vec3 N = normalize(mat3(object.worldMatrix) * inNormal);
+    vec3 N = normalize(mat3(worldMatrix) * normal);
     vec3 L = normalize(-global.lightDirection.xyz);
     vec3 V = normalize(global.inverseViewMatrix[3].xyz - worldPos.xyz);
     vec3 H = normalize(L + V);
@@ -104,16 +149,28 @@ void main() {
 layout(location = 0) in vec3 fragAmbient;
 layout(location = 1) in vec3 fragDiffSpec;
 layout(location = 2) in vec2 fragTexCoord;
-layout(location = 3) in vec4 fragPosLightSpace;
+layout(location = 3) in vec3 fragWorldPos;
 
 layout(location = 0) out vec4 outColor;
 
-// Texture Sampler
-layout(set = 2, binding = 1) uniform sampler2D albedoMap;
+// SET 2, Binding 1: Bindless Texture Samplers
+layout(set = 2, binding = 1) uniform sampler2D bindlessTextures[];
+#define albedoMap bindlessTextures[material.textureSlots[0]]
 // Shadow Map Sampler (Set 0 Binding 1 - Yukarida tanimli)
 
-float CalculateShadow(vec4 posLightSpace) {
+// The cascade is picked by the camera view depth of the fragment, past the last split nothing is shadowed.
+float CalculateShadow(vec3 worldPos) {
+    float viewDepth = (global.viewMatrix * vec4(worldPos, 1.0)).z;
+    uint cascade = 0;
+    while (cascade < global.cascadeCount && viewDepth > global.cascadeSplits[cascade]) {
+        cascade++;
+    }
+    if (cascade >= global.cascadeCount) {
+        return 1.0;
+    }
+
     // 1. Perspective divide
+    vec4 posLightSpace = global.cascadeMatrices[cascade] * vec4(worldPos, 1.0);
     vec3 projCoords = posLightSpace.xyz / posLightSpace.w;
 
     // 2. Transform ONLY X and Y from [-1,1] to [0,1] for UV sampling
@@ -129,10 +186,10 @@ float CalculateShadow(vec4 posLightSpace) {
     float bias = 0.00005;
 
     // 4. Sample
-    // ERROR FIX: 'sampler2DShadow' takes a vec3(u, v, ref_z)
+    // 'sampler2DArrayShadow' takes a vec4(u, v, layer, ref_z)
     // It automatically performs the comparison: (projCoords.z - bias) < storedDepth
     // Returns 1.0 if visible (lit), 0.0 if occluded (shadow)
-    float shadow = texture(shadowMap, vec3(projCoords.xy, projCoords.z - bias));
+    float shadow = texture(shadowMap, vec4(projCoords.xy, cascade, projCoords.z - bias));
 
     return shadow;
 }
@@ -142,7 +199,7 @@ void main() {
     vec4 texColor = texture(albedoMap, fragTexCoord);
 
     // 2. Golge Faktorunu Hesapla (Per-Pixel olmak ZORUNDA)
-    float shadow = CalculateShadow(fragPosLightSpace);
+    float shadow = CalculateShadow(fragWorldPos);
 
     // 3. Birlestirme: Ambient + (DiffuseSpecular * Shadow)
     // Ambient isiga golge uygulanmaz!
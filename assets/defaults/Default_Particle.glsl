@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // =========================================================================
 // VERTEX SHADER
@@ -32,10 +33,21 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightDirection;
     vec4 ambientLightColor;
 
-    mat4 lightSpaceMatrix;
+    mat4 cascadeMatrices[4];
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
+// The quad is packed like every mesh, its corners decode to inPosition * positionScale + positionOffset. The fragment
+// stage's texture slot comes first.
+layout(push_constant) uniform QuadPush {
+    layout(offset = 16) vec4 positionScale;
+    vec4 positionOffset;
+} quad;
+
 void main() {
+    vec3 position = inPosition * quad.positionScale.xyz + quad.positionOffset.xyz;
+
     // Billboarding: Construct rotation from View Matrix
     // In a View Matrix (Left Handed), Column 0 is Right, Column 1 is Up
     vec3 cameraRight = vec3(global.viewMatrix[0][0], global.viewMatrix[1][0], global.viewMatrix[2][0]);
@@ -43,8 +55,8 @@ void main() {
 
     // Calculate vertex world position
     vec3 worldPos = inInstancePos
-    + (cameraRight * inPosition.x * inInstanceSize)
-    + (cameraUp * inPosition.y * inInstanceSize);
+    + (cameraRight * position.x * inInstanceSize)
+    + (cameraUp * position.y * inInstanceSize);
 
     gl_Position = global.projectionMatrix * global.viewMatrix * vec4(worldPos, 1.0);
 
@@ -62,11 +74,15 @@ layout(location = 1) in vec4 fragColor;
 
 layout(location = 0) out vec4 outColor;
 
-// Separate Set for Particle Texture to keep it simple
-layout(set = 1, binding = 0) uniform sampler2D texSampler;
+// Particle textures live in the bindless array (Set 2, Binding 1), each batch pushes the slot of its texture.
+layout(set = 2, binding = 1) uniform sampler2D bindlessTextures[];
+
+layout(push_constant) uniform ParticlePush {
+    uint textureSlot;
+} push;
 
 void main() {
-    vec4 texColor = texture(texSampler, fragTexCoord);
+    vec4 texColor = texture(bindlessTextures[push.textureSlot], fragTexCoord);
     outColor = texColor * fragColor;
 
     // Simple Alpha Test
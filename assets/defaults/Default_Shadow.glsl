@@ -6,7 +6,7 @@
 
 // SET 0: Global Buffer (PerPass)
 // Shadow Pass sirasinda C++ tarafinda Set 0 bind edilir.
-// Buradaki 'lightSpaceMatrix' bizim icin kritik olandir.
+// Buradaki 'cascadeMatrices' bizim icin kritik olandir.
 layout(set = 0, binding = 0) uniform PerPassBuffer {
     mat4 viewMatrix;
     mat4 projectionMatrix;
@@ -23,14 +23,35 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightDirection;
     vec4 ambientLightColor;
 
-    mat4 lightSpaceMatrix; // <--- KRITIK VERI
+    mat4 cascadeMatrices[4]; // <--- KRITIK VERI, MAX_SHADOW_CASCADES
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
+// Cascade the pass renders, every cascade draws into its own layer of the shadow map.
+layout(push_constant) uniform CascadePush {
+    uint cascadeIndex;
+} push;
+
 // SET 1: Object Buffer
 // Her objenin kendi Dunya matrisi
-layout(set = 1, binding = 0) uniform PerObjectBuffer {
+// One record per instance (CBPerObject). Mesh vertices are packed, positions are unorm16 within the mesh bounds and
+// decode to inPosition * positionScale + positionOffset.
+struct ObjectData {
     mat4 worldMatrix;
-} object;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer PerObjectBuffer {
+    ObjectData data[];
+} objects;
+
+// Object an instance draws, gl_InstanceIndex includes the draw's firstInstance. The identity on the CPU path, the
+// visible list the culling pass wrote on the GPU driven one.
+layout(std430, set = 1, binding = 1) readonly buffer InstanceIndexBuffer {
+    uint instanceIndices[];
+};
 
 // NOT: Set 2 (Material) burada tanimlanmaz cunku Shadow Pass
 // sirasinda texture veya materyal baglamiyoruz (C++ tarafinda).
@@ -45,12 +66,16 @@ layout(location = 0) in vec3 inPosition;
 // Normal, Tangent ve UV'ye golge haritasi cikarirken ihtiyac yok.
 
 void main() {
+    ObjectData objectData = objects.data[instanceIndices[gl_InstanceIndex]];
+    mat4 worldMatrix = objectData.worldMatrix;
+    vec3 position = inPosition * objectData.positionScale.xyz + objectData.positionOffset.xyz;
+
     // 1. Model Space -> World Space
-    vec4 worldPos = object.worldMatrix * vec4(inPosition, 1.0);
+    vec4 worldPos = worldMatrix * vec4(position, 1.0);
 
     // 2. World Space -> Light Clip Space
     // Standart kameranin view/proj matrisi yerine, isigin matrisini kullaniyoruz.
-    gl_Position = global.lightSpaceMatrix * worldPos;
+    gl_Position = global.cascadeMatrices[push.cascadeIndex] * worldPos;
 }
 
 #endif // VERTEX_SHADER
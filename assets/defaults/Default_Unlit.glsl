@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // =========================================================================
 // SHARED SETS
@@ -21,13 +22,15 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightColor;
     vec4 lightDirection;
     vec4 ambientLightColor;
-    mat4 lightSpaceMatrix;
+    mat4 cascadeMatrices[4];
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
 // SET 0, Binding 1: Shadow Map
 // Unlit shader golge okumaz ama Layout uyumu icin tanimliyoruz.
 // Kullanmadigimiz icin Vulkan "unused" uyarisi verebilir, sorun degil.
-layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
+layout(set = 0, binding = 1) uniform sampler2DArrayShadow shadowMap;
 
 // =========================================================================
 // VERTEX SHADER
@@ -36,21 +39,39 @@ layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
 
 // Inputs
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;   // Unlit icin gereksiz ama format geregi var
-layout(location = 2) in vec3 inTangent;  // Unlit icin gereksiz
+layout(location = 1) in vec2 inNormal;   // Unlit icin gereksiz ama format geregi var
+layout(location = 2) in vec2 inTangent;  // Unlit icin gereksiz
 layout(location = 3) in vec2 inTexCoord;
 
 // Outputs
 layout(location = 0) out vec2 fragTexCoord;
 
 // SET 1: Object Buffer
-layout(set = 1, binding = 0) uniform PerObjectBuffer {
+// One record per instance (CBPerObject). Mesh vertices are packed, positions are unorm16 within the mesh bounds and
+// decode to inPosition * positionScale + positionOffset.
+struct ObjectData {
     mat4 worldMatrix;
-} object;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer PerObjectBuffer {
+    ObjectData data[];
+} objects;
+
+// Object an instance draws, gl_InstanceIndex includes the draw's firstInstance. The identity on the CPU path, the
+// visible list the culling pass wrote on the GPU driven one.
+layout(std430, set = 1, binding = 1) readonly buffer InstanceIndexBuffer {
+    uint instanceIndices[];
+};
 
 void main() {
+    ObjectData objectData = objects.data[instanceIndices[gl_InstanceIndex]];
+    mat4 worldMatrix = objectData.worldMatrix;
+    vec3 position = inPosition * objectData.positionScale.xyz + objectData.positionOffset.xyz;
+
     // 1. World Position
-    vec4 worldPos = object.worldMatrix * vec4(inPosition, 1.0);
+    vec4 worldPos = worldMatrix * vec4(position, 1.0);
 
     // 2. Clip Space (Ekrana Basma)
     gl_Position = global.projectionMatrix * global.viewMatrix * worldPos;
@@ -75,14 +96,31 @@ layout(location = 0) out vec4 outColor;
 // SET 2: Material Properties
 // Unlit sadece Diffuse Color ve Tiling kullanir.
 // Specular, Roughness vb. yoksayilir.
-layout(set = 2, binding = 0) uniform PerMaterialBuffer {
+// Every material is one record of the bindless material buffer, the properties padded to 64 bytes followed by the
+// slots of its textures in bindlessTextures, indexed by TextureType.
+struct MaterialData {
     vec4 diffuseColor;
     vec2 tiling;
     vec2 offset;
-} material;
+    vec4 _pad0;
+    vec4 _pad1;
+    uint textureSlots[12];
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// The draw's material, pushed whenever it changes between batches.
+layout(push_constant) uniform MaterialPush {
+    uint materialIndex;
+} push;
+
+#define material materials[push.materialIndex]
 
 // SET 2: Textures
-layout(set = 2, binding = 1) uniform sampler2D albedoMap;
+layout(set = 2, binding = 1) uniform sampler2D bindlessTextures[];
+#define albedoMap bindlessTextures[material.textureSlots[0]]
 // Normal map unlit shader'da kullanilmaz.
 
 void main() {
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // =========================================================================
 // SHARED SETS (Available to both Vertex and Fragment stages)
@@ -22,12 +23,14 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightDirection;
     vec4 ambientLightColor;
 
-    mat4 lightSpaceMatrix;
+    mat4 cascadeMatrices[4]; // MAX_SHADOW_CASCADES, cascadeSplits[i] is the view depth cascade i ends at
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
-// SET 0, Binding 1: Shadow Map Sampler (YENİ!)
-// sampler2DShadow, derinlik karşılaştırmasını (d < z) otomatik yapar.
-layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
+// SET 0, Binding 1: Shadow Map Sampler, one layer per cascade
+// sampler2DArrayShadow, derinlik karşılaştırmasını (d < z) otomatik yapar.
+layout(set = 0, binding = 1) uniform sampler2DArrayShadow shadowMap;
 
 // =========================================================================
 // VERTEX SHADER
@@ -36,38 +39,61 @@ layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
 
 // Attributes (Inputs)
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inTangent;
 layout(location = 3) in vec2 inTexCoord;
 
 // Varyings (Outputs to Fragment Shader)
 layout(location = 0) out vec3 fragWorldPos;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out mat3 fragTBN;
-layout(location = 5) out vec4 fragPosLightSpace; // Shadow Coordinate
 
 // SET 1: Object Buffer
-layout(set = 1, binding = 0) uniform PerObjectBuffer {
+// One record per instance (CBPerObject). Mesh vertices are packed, positions are unorm16 within the mesh bounds and
+// decode to inPosition * positionScale + positionOffset.
+struct ObjectData {
     mat4 worldMatrix;
-} object;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer PerObjectBuffer {
+    ObjectData data[];
+} objects;
+
+// Object an instance draws, gl_InstanceIndex includes the draw's firstInstance. The identity on the CPU path, the
+// visible list the culling pass wrote on the GPU driven one.
+layout(std430, set = 1, binding = 1) readonly buffer InstanceIndexBuffer {
+    uint instanceIndices[];
+};
+
+// Unfolds a unit vector stored as its projection onto the octahedron, see PackVertices.
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
 
 void main() {
+    ObjectData objectData = objects.data[instanceIndices[gl_InstanceIndex]];
+    mat4 worldMatrix = objectData.worldMatrix;
+    vec3 position = inPosition * objectData.positionScale.xyz + objectData.positionOffset.xyz;
+    vec3 normal = DecodeOctahedral(inNormal);
+    vec3 tangent = DecodeOctahedral(inTangent);
+
     // World Space
-    vec4 worldPos = object.worldMatrix * vec4(inPosition, 1.0);
+    vec4 worldPos = worldMatrix * vec4(position, 1.0);
     fragWorldPos = worldPos.xyz;
 
     // Clip Space
     gl_Position = global.projectionMatrix * global.viewMatrix * worldPos;
 
-    // 3. Light Space Position (Gölge Haritası Koordinatı)
-    // Dünya pozisyonunu Işığın bakış açısına çeviriyoruz.
-    fragPosLightSpace = global.lightSpaceMatrix * worldPos;
-
-    // 4. Texture Coordinates
+    // 3. Texture Coordinates
     fragTexCoord = inTexCoord;
 
-    vec3 T = normalize(mat3(transpose(inverse(object.worldMatrix))) * inTangent);
-    vec3 N = normalize(mat3(transpose(inverse(object.worldMatrix))) * inNormal);
+    vec3 T = normalize(mat3(transpose(inverse(worldMatrix))) * tangent);
+    vec3 N = normalize(mat3(transpose(inverse(worldMatrix))) * normal);
 
     // Gram-Schmidt process to re-orthogonalize T
     T = normalize(T - dot(T, N) * N);
@@ -90,28 +116,53 @@ void main() {
 layout(location = 0) in vec3 fragWorldPos;
 layout(location = 1) in vec2 fragTexCoord;
 layout(location = 2) in mat3 fragTBN;
-layout(location = 5) in vec4 fragPosLightSpace; // Shadow Coordinate
 
 // Outputs
 layout(location = 0) out vec4 outColor;
 
-// SET 2: Material & Textures
-// VulkanShader.cpp -> Set 2, Binding 0: Properties
-layout(set = 2, binding = 0) uniform PerMaterialBuffer {
+// SET 2: Bindless Materials & Textures
+// Binding 0: One record per material (GPUMaterial), the properties padded to 64 bytes followed by the slots of its
+// textures in bindlessTextures, indexed by TextureType.
+struct MaterialData {
     vec4 diffuseColor;
     vec3 specularColor;
     float specularPower;
     vec2 tiling;
     vec2 offset;
-} material;
+    vec4 _pad0;
+    uint textureSlots[12];
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// Binding 1: Every texture any material samples (Combined Image Sampler)
+layout(set = 2, binding = 1) uniform sampler2D bindlessTextures[];
 
-// VulkanShader.cpp -> Set 2, Binding 1: Texture (Combined Image Sampler)
-layout(set = 2, binding = 1) uniform sampler2D albedoMap;
-layout(set = 2, binding = 2) uniform sampler2D normalMap;
+// The draw's material, pushed whenever it changes between batches.
+layout(push_constant) uniform MaterialPush {
+    uint materialIndex;
+} push;
+
+#define material materials[push.materialIndex]
+#define albedoMap bindlessTextures[material.textureSlots[0]]
+#define normalMap bindlessTextures[material.textureSlots[1]]
 
 // --- GÖLGE HESAPLAMA ---
-float CalculateShadow(vec4 posLightSpace) {
+// The cascade is picked by the camera view depth of the fragment, past the last split nothing is shadowed.
+float CalculateShadow(vec3 worldPos) {
+    float viewDepth = (global.viewMatrix * vec4(worldPos, 1.0)).z;
+    uint cascade = 0;
+    while (cascade < global.cascadeCount && viewDepth > global.cascadeSplits[cascade]) {
+        cascade++;
+    }
+    if (cascade >= global.cascadeCount) {
+        return 1.0;
+    }
+
     // 1. Perspective divide
+    vec4 posLightSpace = global.cascadeMatrices[cascade] * vec4(worldPos, 1.0);
     vec3 projCoords = posLightSpace.xyz / posLightSpace.w;
 
     // 2. Transform ONLY X and Y from [-1,1] to [0,1] for UV sampling
@@ -127,10 +178,10 @@ float CalculateShadow(vec4 posLightSpace) {
     float bias = 0.00005;
 
     // 4. Sample
-    // ERROR FIX: 'sampler2DShadow' takes a vec3(u, v, ref_z)
+    // 'sampler2DArrayShadow' takes a vec4(u, v, layer, ref_z)
     // It automatically performs the comparison: (projCoords.z - bias) < storedDepth
     // Returns 1.0 if visible (lit), 0.0 if occluded (shadow)
-    float shadow = texture(shadowMap, vec3(projCoords.xy, projCoords.z - bias));
+    float shadow = texture(shadowMap, vec4(projCoords.xy, cascade, projCoords.z - bias));
 
     return shadow;
 }
@@ -144,9 +195,10 @@ void main() {
     }
 
     // 2. Sample Normal Map and Unpack
-    // Normal maps are stored as [0, 1], we need [-1, 1]
-    vec3 normalSample = texture(normalMap, fragTexCoord * material.tiling + material.offset).rgb;
-    normalSample = normalSample * 2.0 - 1.0;
+    // Normal maps are stored as [0, 1], we need [-1, 1]. Only X and Y are read, BC5 maps don't store Z.
+    vec3 normalSample;
+    normalSample.xy = texture(normalMap, fragTexCoord * material.tiling + material.offset).rg * 2.0 - 1.0;
+    normalSample.z  = sqrt(max(1.0 - dot(normalSample.xy, normalSample.xy), 0.0));
 
     // 3. Transform to World Space using TBN
     vec3 N = normalize(fragTBN * normalSample);
@@ -169,7 +221,7 @@ void main() {
 
     // 4. GÖLGE HESABI
     // Gölge sadece Diffuse ve Specular'ı etkiler, Ambient hep vardır.
-    float shadow = CalculateShadow(fragPosLightSpace);
+    float shadow = CalculateShadow(fragWorldPos);
 
     // 5. Birleştirme
     vec3 lighting = (ambient + (diffuse + specular) * shadow) * texColor.rgb * material.diffuseColor.rgb;
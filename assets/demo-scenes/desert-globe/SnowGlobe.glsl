@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // =========================================================================
 // SET 0: Global Buffer
@@ -19,7 +20,9 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
     vec4 lightDirection;
     vec4 ambientLightColor;
 
-    mat4 lightSpaceMatrix;
+    mat4 cascadeMatrices[4];
+    vec4 cascadeSplits;
+    uint cascadeCount;
 } global;
 
 // =========================================================================
@@ -28,27 +31,54 @@ layout(set = 0, binding = 0) uniform PerPassBuffer {
 #if defined(VERTEX_SHADER)
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inTangent;
 layout(location = 3) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragWorldPos;
 layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec3 fragLocalPos; // Skybox örneklemesi için yerel pozisyon
 
-layout(set = 1, binding = 0) uniform PerObjectBuffer {
+// One record per instance (CBPerObject). Mesh vertices are packed, positions are unorm16 within the mesh bounds and
+// decode to inPosition * positionScale + positionOffset.
+struct ObjectData {
     mat4 worldMatrix;
-} object;
+    vec4 positionScale;
+    vec4 positionOffset;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer PerObjectBuffer {
+    ObjectData data[];
+} objects;
+
+// Object an instance draws, gl_InstanceIndex includes the draw's firstInstance. The identity on the CPU path, the
+// visible list the culling pass wrote on the GPU driven one.
+layout(std430, set = 1, binding = 1) readonly buffer InstanceIndexBuffer {
+    uint instanceIndices[];
+};
+
+// Unfolds a unit vector stored as its projection onto the octahedron, see PackVertices.
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
 
 void main() {
-    vec4 worldPos = object.worldMatrix * vec4(inPosition, 1.0);
+    ObjectData objectData = objects.data[instanceIndices[gl_InstanceIndex]];
+    mat4 worldMatrix = objectData.worldMatrix;
+    vec3 position = inPosition * objectData.positionScale.xyz + objectData.positionOffset.xyz;
+    vec3 normal = DecodeOctahedral(inNormal);
+
+    vec4 worldPos = worldMatrix * vec4(position, 1.0);
     fragWorldPos = worldPos.xyz;
 
     // Yerel pozisyonu fragmente taşı (Kürenin merkezi 0,0,0 kabul edilir)
-    fragLocalPos = inPosition;
+    fragLocalPos = position;
 
     // Normali dünya uzayına çevir
-    fragNormal = normalize(mat3(transpose(inverse(object.worldMatrix))) * inNormal);
+    fragNormal = normalize(mat3(transpose(inverse(worldMatrix))) * normal);
 
     gl_Position = global.projectionMatrix * global.viewMatrix * worldPos;
 }
@@ -67,7 +97,8 @@ layout(location = 2) in vec3 fragLocalPos;
 layout(location = 0) out vec4 outColor;
 
 // SET 2: Material (CBMaterial_Lit Yapısının Birebir Kopyası)
-layout(set = 2, binding = 0) uniform PerMaterialBuffer {
+// Every material is one record of the bindless material buffer, followed by the slots of its textures.
+struct MaterialData {
     vec4 diffuseColor;       // C++: diffuseColor (Cam Rengi + Opaklık)
 
     vec3 specularColor;  // C++: specularColor (Yansıma Rengi)
@@ -75,10 +106,25 @@ layout(set = 2, binding = 0) uniform PerMaterialBuffer {
 
     vec2 tiling;          // C++: tiling (Kullanılmıyor ama padding için şart)
     vec2 offset;          // C++: offset (Kullanılmıyor ama padding için şart)
-} material;
 
-// Cubemap Texture (Binding 1)
-layout(set = 2, binding = 1) uniform samplerCube envMap;
+    vec4 _pad0;           // C++: GPUMaterial properties are 64 bytes
+    uint textureSlots[12];
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// The draw's material, pushed whenever it changes between batches.
+layout(push_constant) uniform MaterialPush {
+    uint materialIndex;
+} push;
+
+#define material materials[push.materialIndex]
+
+// Cubemap Texture (Binding 1, the bindless array seen as cubes, the slot of the Albedo texture)
+layout(set = 2, binding = 1) uniform samplerCube bindlessCubeTextures[];
+#define envMap bindlessCubeTextures[material.textureSlots[0]]
 
 vec3 DrawSunOnSkybox(vec3 viewDir, vec3 lightDir, vec3 skyColor) {
     // Bakış yönümüz ile Işık yönü çakışıyor mu?
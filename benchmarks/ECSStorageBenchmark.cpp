@@ -0,0 +1,130 @@
+// Compares the sparse set path (ComponentArray + reverse lookup) against archetype chunks for the
+// Transform + MeshRenderer iteration RenderSystem does every frame.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ECS/ComponentArray.h"
+#include "ECS/Query.h"
+#include "Graphics/Components/MeshRenderer.h"
+#include "Scene/Components/Transform.h"
+
+using namespace PE;
+using Scene::Components::Transform;
+using Graphics::Components::MeshRenderer;
+
+namespace {
+constexpr int ITERATIONS = 10;
+
+struct Result {
+	double bestMs = 1e30;
+	double avgMs  = 0.0;
+	float  sink	  = 0.0f;
+};
+
+template <typename TFunc>
+Result Measure(TFunc &&fn) {
+	Result result;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		const auto	 start = std::chrono::steady_clock::now();
+		result.sink += fn();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		result.bestMs	= std::min(result.bestMs, ms);
+		result.avgMs += ms / ITERATIONS;
+	}
+	return result;
+}
+
+// Every entity gets a Transform, 3 out of 4 get a MeshRenderer. MeshRenderers are attached in shuffled order
+// so the two packed arrays disagree on ordering the way they do after some churn.
+std::vector<ECS::EntityID> MakeRenderableOrder(const uint32_t entityCount) {
+	std::vector<ECS::EntityID> ids(entityCount);
+	std::iota(ids.begin(), ids.end(), 0);
+	std::mt19937 rng(1234);
+	std::shuffle(ids.begin(), ids.end(), rng);
+	ids.resize(entityCount - entityCount / 4);
+	return ids;
+}
+
+MeshRenderer MakeMeshRenderer(const ECS::EntityID id) {
+	MeshRenderer mr;
+	mr.subMeshes.push_back({id % 64, id % 16});
+	return mr;
+}
+
+Transform MakeTransform(const ECS::EntityID id) {
+	Transform tf;
+	tf.position			 = Math::Vector3(static_cast<float>(id), 0.0f, 1.0f);
+	tf.worldMatrix[3][0] = static_cast<float>(id);
+	return tf;
+}
+
+void RunSparseSet(const uint32_t entityCount, const std::vector<ECS::EntityID> &renderables) {
+	ECS::ComponentArray<Transform>	  transforms;
+	ECS::ComponentArray<MeshRenderer> meshRenderers;
+	transforms.Initialize(entityCount);
+	meshRenderers.Initialize(entityCount);
+
+	for (ECS::EntityID id = 0; id < entityCount; ++id) {
+		const Transform tf = MakeTransform(id);
+		transforms.Add(id, &tf);
+	}
+	for (const ECS::EntityID id : renderables) {
+		const MeshRenderer mr = MakeMeshRenderer(id);
+		meshRenderers.Add(id, &mr);
+	}
+
+	const Result result = Measure([&] {
+		float acc = 0.0f;
+		for (const uint32_t entityID : meshRenderers.Index()) {
+			if (!transforms.Has(entityID)) continue;
+			const auto &mr = meshRenderers.Get(entityID);
+			const auto &tf = transforms.Get(entityID);
+			if (!mr.isVisible) continue;
+			acc += tf.worldMatrix[3][0] * static_cast<float>(mr.subMeshes.size());
+		}
+		return acc;
+	});
+
+	std::printf("  sparse set : best %8.3f ms  avg %8.3f ms  (sink %.0f)\n", result.bestMs, result.avgMs, result.sink);
+}
+
+void RunArchetype(const uint32_t entityCount, const std::vector<ECS::EntityID> &renderables) {
+	ECS::ArchetypeStorage storage;
+	storage.Initialize(entityCount);
+	storage.RegisterComponent<Transform>();
+	storage.RegisterComponent<MeshRenderer>();
+
+	for (ECS::EntityID id = 0; id < entityCount; ++id) storage.Add(id, MakeTransform(id));
+	for (const ECS::EntityID id : renderables) storage.Add(id, MakeMeshRenderer(id));
+
+	ECS::Query<Transform, MeshRenderer> query(storage);
+	const Result						result = Measure([&] {
+		   float acc = 0.0f;
+		   query.ForEachChunk(
+			   [&acc](std::span<const ECS::EntityID>, std::span<Transform> tfs, std::span<MeshRenderer> mrs) {
+				   for (size_t i = 0; i < tfs.size(); ++i) {
+					   if (!mrs[i].isVisible) continue;
+					   acc += tfs[i].worldMatrix[3][0] * static_cast<float>(mrs[i].subMeshes.size());
+				   }
+			   });
+		   return acc;
+	   });
+
+	std::printf("  archetype  : best %8.3f ms  avg %8.3f ms  (sink %.0f, %u entities matched)\n", result.bestMs,
+				result.avgMs, result.sink, query.GetCount());
+}
+}  // namespace
+
+int main() {
+	for (const uint32_t entityCount : {10'000u, 100'000u, 1'000'000u}) {
+		std::printf("%u entities, Transform + MeshRenderer iteration\n", entityCount);
+		const std::vector<ECS::EntityID> renderables = MakeRenderableOrder(entityCount);
+		RunSparseSet(entityCount, renderables);
+		RunArchetype(entityCount, renderables);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Scaling of JobSystem::ParallelFor on a synthetic 1M particle update (the fire branch of ParticleSystem), from one
+// worker up to std::thread::hardware_concurrency().
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Graphics/Components/ParticleEmitter.h"
+#include "Utilities/JobSystem.h"
+
+using namespace PE;
+using Graphics::Components::Particle;
+
+namespace {
+constexpr uint32_t PARTICLE_COUNT = 1'000'000;
+constexpr size_t   GRAIN_SIZE	  = 1024;
+constexpr int	   ITERATIONS	  = 20;
+constexpr float	   DT			  = 1.0f / 60.0f;
+constexpr float	   LIFE_TIME	  = 2.0f;
+
+std::vector<Particle> MakeParticles() {
+	std::vector<Particle> particles(PARTICLE_COUNT);
+	for (uint32_t i = 0; i < PARTICLE_COUNT; ++i) {
+		Particle &p = particles[i];
+		p.position	= Math::Vector3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100 % 100));
+		p.velocity	= Math::Vector3(0.1f, 1.5f, -0.1f);
+		p.color		= Math::Vector4(1.0f, 0.9f, 0.6f, 1.0f);
+		p.life		= 1.0e6f;  // never dies, the particle count stays fixed across iterations
+		p.size		= 1.0f;
+		p.rotation	= 0.0f;
+	}
+	return particles;
+}
+
+void Simulate(Particle &p) {
+	const float lifeRatio = std::clamp(1.0f - (std::fmod(p.life, LIFE_TIME) / LIFE_TIME), 0.0f, 1.0f);
+
+	p.life -= DT;
+	p.position += p.velocity * DT;
+
+	const float turbulence = std::sin(p.position.y * 2.0f + p.life * 5.0f) * 1.5f;
+	p.position.x += turbulence * DT;
+	p.position.z += turbulence * DT;
+
+	const Math::Vector4 startColor = {1.0f, 0.9f, 0.6f, 1.0f};
+	const Math::Vector4 midColor   = {1.0f, 0.4f, 0.0f, 0.9f};
+	const Math::Vector4 endColor   = {0.1f, 0.1f, 0.1f, 0.0f};
+
+	if (lifeRatio < 0.5f) {
+		const float t = lifeRatio / 0.5f;
+		p.color		  = Math::Lerp(startColor, midColor, t);
+		p.size		  = Math::Lerp(1.0f, 0.8f, t);
+	} else {
+		const float t = (lifeRatio - 0.5f) / 0.5f;
+		p.color		  = Math::Lerp(midColor, endColor, t);
+		p.size		  = Math::Lerp(0.8f, 1.5f, t);
+	}
+}
+
+double Run(const uint32_t workerCount, std::vector<Particle> &particles) {
+	Utilities::JobSystem::Initialize(workerCount);
+
+	double bestMs = 1e30;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		Utilities::JobSystem::ParallelFor(std::span(particles), GRAIN_SIZE, [](Particle &p, size_t) { Simulate(p); });
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		bestMs			= std::min(bestMs, ms);
+	}
+
+	Utilities::JobSystem::Shutdown();
+	return bestMs;
+}
+}  // namespace
+
+int main() {
+	std::vector<Particle> particles = MakeParticles();
+	const uint32_t		  maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+	std::printf("%u particles, grain %zu, best of %d\n", PARTICLE_COUNT, GRAIN_SIZE, ITERATIONS);
+
+	// 1, 2, 4, ... plus the full core count if it is not a power of two
+	std::vector<uint32_t> workerCounts;
+	for (uint32_t workers = 1; workers < maxWorkers; workers *= 2) workerCounts.push_back(workers);
+	workerCounts.push_back(maxWorkers);
+
+	double baselineMs = 0.0;
+	for (const uint32_t workers : workerCounts) {
+		const double ms = Run(workers, particles);
+		if (workers == 1) baselineMs = ms;
+		std::printf("  %2u worker(s): %8.3f ms  speedup %5.2fx\n", workers, ms, baselineMs / ms);
+	}
+
+	float sink = 0.0f;
+	for (const Particle &p : particles) sink += p.position.x;
+	std::printf("  (sink %.0f)\n", sink);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+// Import-time mesh simplification on the desert-globe props: the triangles of every LOD level, the time building the
+// chains takes, and the triangles a prop draws when it covers less and less of a 1080p screen with the default pixel
+// error. Other OBJ files can be passed as arguments.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Assets/MeshProcessing.h"
+#include "Assets/Model.h"
+#include "Graphics/RenderConfig.h"
+#include "Math/Bounds.h"
+
+using namespace PE;
+
+namespace {
+constexpr float SCREEN_HEIGHT = 1080.0f;
+// Share of the screen height the prop covers, from close up to a speck in the distance.
+constexpr float SCREEN_COVERAGE[] = {1.0f, 0.25f, 0.1f, 0.05f, 0.02f};
+constexpr float LOD_RATIOS[]	  = {0.5f, 0.25f, 0.1f};
+
+struct Level {
+	size_t triangles = 0;
+	float  error	 = 0.0f;
+};
+
+double ElapsedMs(const std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The coarsest level RenderSystem picks when an object of this extent covers coverage of the screen height. Distance
+// and field of view cancel out: the error covers error / extent * coverage * SCREEN_HEIGHT pixels.
+const Level &PickLevel(const std::vector<Level> &levels, const float extent, const float coverage,
+					   const float maxErrorPixels) {
+	const Level *picked = &levels[0];
+	for (const Level &level : levels) {
+		if (level.error / extent * coverage * SCREEN_HEIGHT > maxErrorPixels) break;
+		picked = &level;
+	}
+	return *picked;
+}
+}  // namespace
+
+int main(const int argc, char **argv) {
+	const std::filesystem::path scene = std::filesystem::path(PE_BENCHMARK_ASSETS_DIR) / "demo-scenes/desert-globe";
+
+	std::vector<std::filesystem::path> models;
+	for (int i = 1; i < argc; ++i) models.emplace_back(argv[i]);
+	if (models.empty()) {
+		models = {
+			scene / "candelabra_tree_1/realistic_hd_candelabra_tree_140.obj",
+			scene / "rock-1/rock-1.obj",
+			scene / "sharp_rock/sharp_rock.obj",
+			scene / "sharp-boulder-layered/sharp-boulder-layered.obj",
+			scene / "bonfire/bonfire.obj",
+			scene / "globe/globe_bottom.obj",
+		};
+	}
+
+	const float maxErrorPixels = Graphics::RenderConfig{}.lodErrorPixels;
+	std::printf("%-24s %9s %9s %9s %9s %9s |", "model", "LOD0", "LOD1", "LOD2", "LOD3", "build ms");
+	for (const float coverage : SCREEN_COVERAGE) std::printf(" %7.0f%%", coverage * 100.0f);
+	std::printf("\n");
+
+	for (const std::filesystem::path &path : models) {
+		const Assets::Model::Loader::ModelLoadResult result = Assets::Model::Loader::LoadOBJ(path);
+		if (!result.success) continue;
+
+		std::unordered_map<std::string, const Assets::Model::Loader::ProcessedMesh *> meshes;
+		for (const auto &mesh : result.meshes) meshes[mesh.assetInfo.name] = &mesh;
+
+		// Levels of every submesh, the full detail mesh first, and the extent of the whole model.
+		std::vector<std::vector<Level>> subMeshLevels;
+		Math::BoundingBox				box;
+		for (const auto &entry : result.modelAssetInfo.subMeshes) {
+			const auto &full = *meshes.at(entry.meshAssetName);
+			for (const Graphics::Vertex &vertex : full.meshData.Vertices) box.Grow(vertex.Position);
+
+			std::vector<Level> &levels = subMeshLevels.emplace_back();
+			levels.push_back({full.meshData.Indices.size() / 3, 0.0f});
+			for (const std::string &name : entry.lodMeshAssetNames) {
+				const auto &lod = *meshes.at(name);
+				levels.push_back({lod.meshData.Indices.size() / 3, lod.assetInfo.lodError});
+			}
+		}
+		const Math::Vector3 size   = box.max - box.min;
+		const float			extent = std::max({size.x, size.y, size.z});
+
+		// The import already built the chains, this times building them once more.
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto &entry : result.modelAssetInfo.subMeshes)
+			Assets::Mesh::Processing::GenerateLODs(meshes.at(entry.meshAssetName)->meshData, LOD_RATIOS);
+		const double buildMs = ElapsedMs(start);
+
+		// A submesh with a shorter chain draws its coarsest level in the columns past its end.
+		std::printf("%-24s", path.stem().string().substr(0, 24).c_str());
+		for (size_t l = 0; l <= Graphics::MAX_MESH_LODS; ++l) {
+			size_t triangles = 0;
+			for (const std::vector<Level> &levels : subMeshLevels)
+				triangles += levels[std::min(l, levels.size() - 1)].triangles;
+			std::printf(" %9zu", triangles);
+		}
+		std::printf(" %9.1f |", buildMs);
+
+		for (const float coverage : SCREEN_COVERAGE) {
+			size_t triangles = 0;
+			for (const std::vector<Level> &levels : subMeshLevels)
+				triangles += PickLevel(levels, extent, coverage, maxErrorPixels).triangles;
+			std::printf(" %8zu", triangles);
+		}
+		std::printf("\n");
+	}
+	return 0;
+}
\ No newline at end of file
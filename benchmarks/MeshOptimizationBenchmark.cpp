@@ -0,0 +1,106 @@
+// Import-time index optimization on the desert-globe props and a few generated primitives: ACMR and ATVR of a 16 entry
+// FIFO vertex cache in the order the loaders emit triangles and after OptimizeMesh, and the time optimizing takes.
+// Other OBJ files can be passed as arguments.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Assets/MeshProcessing.h"
+#include "Assets/Model.h"
+#include "Graphics/GeometryGenerator.h"
+
+using namespace PE;
+
+namespace {
+struct NamedMesh {
+	std::string		   name;
+	Graphics::MeshData meshData;
+};
+
+// Summed over the submeshes of a model, ratios are taken at the end.
+struct Totals {
+	double missesBefore = 0.0;
+	double missesAfter	= 0.0;
+	size_t triangles	= 0;
+	size_t vertices		= 0;
+	double ms			= 0.0;
+};
+
+void Measure(const Graphics::MeshData &meshData, Totals &totals) {
+	const size_t triangles = meshData.Indices.size() / 3;
+	const size_t vertices  = meshData.Vertices.size();
+	const auto	 before	   = Assets::Mesh::Processing::AnalyzeVertexCache(meshData.Indices, vertices);
+
+	Graphics::MeshData optimized = meshData;
+	const auto		   start	 = std::chrono::steady_clock::now();
+	Assets::Mesh::Processing::OptimizeMesh(optimized);
+	totals.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	const auto after = Assets::Mesh::Processing::AnalyzeVertexCache(optimized.Indices, optimized.Vertices.size());
+	totals.missesBefore += before.acmr * static_cast<double>(triangles);
+	totals.missesAfter += after.acmr * static_cast<double>(triangles);
+	totals.triangles += triangles;
+	totals.vertices += vertices;
+}
+
+void Print(const std::string &name, const Totals &totals) {
+	const auto triangles = static_cast<double>(totals.triangles);
+	const auto vertices	 = static_cast<double>(totals.vertices);
+	std::printf("%-24s %9zu %8.3f %8.3f %8.3f %8.3f %9.2f\n", name.substr(0, 24).c_str(), totals.triangles,
+				totals.missesBefore / triangles, totals.missesAfter / triangles, totals.missesBefore / vertices,
+				totals.missesAfter / vertices, totals.ms);
+}
+}  // namespace
+
+int main(const int argc, char **argv) {
+	const std::filesystem::path scene = std::filesystem::path(PE_BENCHMARK_ASSETS_DIR) / "demo-scenes/desert-globe";
+
+	std::vector<std::filesystem::path> models;
+	for (int i = 1; i < argc; ++i) models.emplace_back(argv[i]);
+	if (models.empty()) {
+		models = {
+			scene / "candelabra_tree_1/realistic_hd_candelabra_tree_140.obj",
+			scene / "rock-1/rock-1.obj",
+			scene / "sharp_rock/sharp_rock.obj",
+			scene / "sharp-boulder-layered/sharp-boulder-layered.obj",
+			scene / "bonfire/bonfire.obj",
+			scene / "globe/globe_bottom.obj",
+		};
+	}
+
+	std::printf("%-24s %9s %8s %8s %8s %8s %9s\n", "mesh", "triangles", "ACMR", "ACMR opt", "ATVR", "ATVR opt",
+				"opt ms");
+
+	for (const std::filesystem::path &path : models) {
+		const Assets::Model::Loader::ModelLoadResult result = Assets::Model::Loader::LoadOBJ(path);
+		if (!result.success) continue;
+
+		std::unordered_map<std::string, const Graphics::MeshData *> meshes;
+		for (const auto &mesh : result.meshes) meshes[mesh.assetInfo.name] = &mesh.meshData;
+
+		// Full detail submeshes only, LOD levels already come out in the simplifier's order.
+		Totals totals;
+		for (const auto &entry : result.modelAssetInfo.subMeshes) Measure(*meshes.at(entry.meshAssetName), totals);
+		Print(path.stem().string(), totals);
+	}
+
+	std::vector<NamedMesh> primitives(4);
+	primitives[0].name = "Sphere 64x64";
+	Graphics::GeometryGenerator::CreateSphere(1.0f, 64, 64, primitives[0].meshData);
+	primitives[1].name = "Geosphere 5";
+	Graphics::GeometryGenerator::CreateGeosphere(1.0f, 5, primitives[1].meshData);
+	primitives[2].name = "Cylinder 64x16";
+	Graphics::GeometryGenerator::CreateCylinder(1.0f, 1.0f, 2.0f, 64, 16, primitives[2].meshData);
+	primitives[3].name = "Grid 128x128";
+	Graphics::GeometryGenerator::CreateGrid(100.0f, 100.0f, 128, 128, primitives[3].meshData);
+
+	for (const NamedMesh &primitive : primitives) {
+		Totals totals;
+		Measure(primitive.meshData, totals);
+		Print(primitive.name, totals);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// Sorting a frame's render commands: std::sort over whole RenderCommands (what VulkanRenderer::Flush did) against
+// RenderQueue's radix sort of (key, index) entries, on one thread and on every core.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Graphics/RenderQueue.h"
+#include "Utilities/JobSystem.h"
+
+using namespace PE;
+using Graphics::RenderCommand;
+using Graphics::RenderQueue;
+
+namespace {
+constexpr int ITERATIONS = 10;
+
+// A forward pass worth of keys: a handful of shaders, a few hundred materials and meshes, random depths, 5%
+// transparent.
+std::vector<RenderCommand> MakeCommands(const size_t count) {
+	std::mt19937						 rng(42);
+	std::uniform_int_distribution<uint32_t> shader(0, 7), material(0, 255), mesh(0, 255), depth(0, 65535),
+		percent(0, 99);
+
+	std::vector<RenderCommand> commands(count);
+	for (size_t i = 0; i < count; ++i) {
+		RenderCommand &cmd = commands[i];
+		cmd.materialID	   = material(rng);
+		cmd.meshID		   = mesh(rng);
+		cmd.key = Graphics::RenderKey::Create(static_cast<uint8_t>(Graphics::RenderPass::Forward), shader(rng),
+											  cmd.materialID, cmd.meshID, static_cast<uint16_t>(depth(rng)));
+		cmd.flags		   = Graphics::RenderFlag_Visible;
+		if (percent(rng) < 5) cmd.flags |= Graphics::RenderFlag_ForceTransparent;
+		cmd.worldMatrix = Math::Matrix4Identity();
+	}
+	return commands;
+}
+
+template <typename TSetup, typename TSort>
+double BestOf(TSetup &&setup, TSort &&sort) {
+	double bestMs = 1e30;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		setup();
+		const auto start = std::chrono::steady_clock::now();
+		sort();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		bestMs			= std::min(bestMs, ms);
+	}
+	return bestMs;
+}
+
+double SortQueue(const std::vector<RenderCommand> &commands, RenderQueue &queue) {
+	return BestOf(
+		[&] {
+			queue.Clear();
+			for (const RenderCommand &cmd : commands) queue.Submit(cmd);
+		},
+		[&] { queue.Sort(); });
+}
+}  // namespace
+
+int main() {
+	const uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("best of %d, %u worker(s) for the parallel column\n", ITERATIONS, maxWorkers);
+	std::printf("  %9s %14s %14s %14s\n", "commands", "std::sort", "radix 1 thr", "radix par");
+
+	for (const size_t count : {size_t{10'000}, size_t{100'000}, size_t{1'000'000}}) {
+		const std::vector<RenderCommand> commands = MakeCommands(count);
+		std::vector<RenderCommand>		 sorted;
+
+		const double stdMs = BestOf([&] { sorted = commands; },
+									[&] {
+										std::sort(sorted.begin(), sorted.end(),
+												  [](const auto &a, const auto &b) { return a.key < b.key; });
+									});
+
+		RenderQueue queue;
+		Utilities::JobSystem::Initialize(1);
+		const double serialMs = SortQueue(commands, queue);
+		Utilities::JobSystem::Shutdown();
+
+		Utilities::JobSystem::Initialize(maxWorkers);
+		const double parallelMs = SortQueue(commands, queue);
+		Utilities::JobSystem::Shutdown();
+
+		std::printf("  %9zu %11.3f ms %11.3f ms %11.3f ms  (%.1fx / %.1fx)\n", count, stdMs, serialMs, parallelMs,
+					stdMs / serialMs, stdMs / parallelMs);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Shadow caster culling on a field of scattered props while the camera walks and turns over it: how many casters each
+// cascade draws against a single shadow map over the same distance, and the time fitting and culling takes a frame.
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Graphics/ShadowCascades.h"
+
+using namespace PE;
+using Graphics::MAX_SHADOW_CASCADES;
+using Graphics::ShadowCascade;
+
+namespace {
+constexpr int	 FRAMES		  = 256;
+constexpr size_t CASTER_COUNT = 100'000;
+
+struct Casters {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> radius;
+};
+
+// Props of 0.5 to 3 m radius on the ground of a 1 km square around the origin.
+Casters MakeCasters() {
+	std::mt19937						  rng(42);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f), radius(0.5f, 3.0f);
+
+	Casters casters;
+	for (size_t i = 0; i < CASTER_COUNT; ++i) {
+		const float r = radius(rng);
+		casters.x.push_back(position(rng));
+		casters.y.push_back(r);
+		casters.z.push_back(position(rng));
+		casters.radius.push_back(r);
+	}
+	return casters;
+}
+
+struct Result {
+	uint32_t cascadeCount = 0;
+	size_t	 casters[MAX_SHADOW_CASCADES]{};
+	double	 msPerFrame = 0.0;
+};
+
+Result Run(const Graphics::RenderConfig &config, const Casters &casters) {
+	const Math::Matrix4 projection	   = Math::Perspective(Math::Radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	const Math::Vector3 lightDirection = Math::Normalize(Math::Vector3(0.3f, -1.0f, 0.4f));
+
+	std::array<ShadowCascade, MAX_SHADOW_CASCADES> cascades;
+	std::vector<uint8_t>						   visible(CASTER_COUNT);
+
+	Result	   result;
+	const auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		const float			angle = 6.2831853f * static_cast<float>(frame) / FRAMES;
+		const Math::Vector3 eye(200.0f * std::cos(angle), 2.0f, 200.0f * std::sin(angle));
+		const Math::Vector3 forward(-std::sin(angle), -0.05f, std::cos(angle));
+		const Math::Matrix4 view = Math::Mat4LookAt(eye, eye + forward, Math::Vector3Up);
+
+		result.cascadeCount = Graphics::FitShadowCascades(view, projection, lightDirection, config, cascades);
+		for (uint32_t c = 0; c < result.cascadeCount; ++c) {
+			result.casters[c] += Graphics::CullShadowCasters(cascades[c], casters.x.data(), casters.y.data(),
+															 casters.z.data(), casters.radius.data(), CASTER_COUNT,
+															 config.shadowDistance, visible.data());
+		}
+	}
+	result.msPerFrame =
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+	for (size_t &count : result.casters) count /= FRAMES;
+	return result;
+}
+}  // namespace
+
+int main() {
+	const Casters casters = MakeCasters();
+	std::printf("%zu casters, average of %d frames\n", CASTER_COUNT, FRAMES);
+	std::printf("  %8s %10s %10s %10s %10s %10s %10s\n", "cascades", "c0", "c1", "c2", "c3", "drawn", "ms/frame");
+
+	for (uint8_t cascadeCount = 1; cascadeCount <= MAX_SHADOW_CASCADES; ++cascadeCount) {
+		Graphics::RenderConfig config;
+		config.shadowCascadeCount = cascadeCount;
+
+		const Result result = Run(config, casters);
+		size_t		 drawn	= 0;
+		std::printf("  %8u", result.cascadeCount);
+		for (uint32_t c = 0; c < MAX_SHADOW_CASCADES; ++c) {
+			if (c < result.cascadeCount) {
+				std::printf(" %10zu", result.casters[c]);
+				drawn += result.casters[c];
+			} else {
+				std::printf(" %10s", "-");
+			}
+		}
+		std::printf(" %10zu %10.3f\n", drawn, result.msPerFrame);
+	}
+	return 0;
+}
\ No newline at end of file
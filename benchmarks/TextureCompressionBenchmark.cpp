@@ -0,0 +1,96 @@
+// Load-time texture processing on a few desert-globe textures: mip chain generation and block compression, the
+// bytes uploaded before and after, and the time each step takes on all workers. Other images can be passed as
+// arguments, they are processed as albedo.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "Assets/Texture.h"
+#include "Assets/TextureProcessing.h"
+#include "Utilities/JobSystem.h"
+
+using namespace PE;
+namespace Processing = Assets::Texture::Processing;
+
+namespace {
+struct Source {
+	std::filesystem::path path;
+	Graphics::TextureType type;
+};
+
+const char *GetCompressionName(const Graphics::TextureCompression compression) {
+	switch (compression) {
+		case Graphics::TextureCompression::BC1: return "BC1";
+		case Graphics::TextureCompression::BC3: return "BC3";
+		case Graphics::TextureCompression::BC4: return "BC4";
+		case Graphics::TextureCompression::BC5: return "BC5";
+		case Graphics::TextureCompression::BC7: return "BC7";
+		default: return "RGBA8";
+	}
+}
+
+double ElapsedMs(const std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int main(const int argc, char **argv) {
+	const std::filesystem::path scene = std::filesystem::path(PE_BENCHMARK_ASSETS_DIR) / "demo-scenes/desert-globe";
+
+	std::vector<Source> sources;
+	for (int i = 1; i < argc; ++i) sources.push_back({argv[i], Graphics::TextureType::Albedo});
+	if (sources.empty()) {
+		sources = {
+			{scene / "2k_sun.jpg", Graphics::TextureType::Albedo},
+			{scene / "bonfire/Koster1_baseColor.png", Graphics::TextureType::Albedo},
+			{scene / "bonfire/Koster1_normal.png", Graphics::TextureType::Normal},
+			{scene / "bonfire/Koster1_metallicRoughness.png", Graphics::TextureType::Mask},
+			{scene / "dragon-scales-bl/dragon-scales_height.png", Graphics::TextureType::Displacement},
+		};
+	}
+
+	Utilities::JobSystem::Initialize();
+
+	size_t totalSource	   = 0;
+	size_t totalMipped	   = 0;
+	size_t totalCompressed = 0;
+	std::printf("%-36s %-11s %-5s %10s %10s %10s %9s %9s\n", "texture", "size", "fmt", "source KB", "mips KB",
+				"final KB", "mips ms", "bc ms");
+	for (const Source &source : sources) {
+		Graphics::Texture texture;
+		texture.SetParameters({.type = source.type});
+		if (!Assets::Texture::Loader::Load(source.path, texture)) continue;
+
+		const Graphics::TextureParameters &params	  = texture.GetTextureParameters();
+		const size_t					   sourceSize = texture.GetTextureData().size();
+
+		auto start = std::chrono::steady_clock::now();
+		Processing::GenerateMips(texture);
+		const double mipMs		= ElapsedMs(start);
+		const size_t mippedSize = texture.GetTextureData().size();
+
+		const Graphics::TextureCompression compression = Processing::GetCompression(source.type);
+		start											= std::chrono::steady_clock::now();
+		Processing::Compress(texture, compression);
+		const double compressMs = ElapsedMs(start);
+
+		totalSource += sourceSize;
+		totalMipped += mippedSize;
+		totalCompressed += texture.GetTextureData().size();
+
+		char extent[16];
+		std::snprintf(extent, sizeof(extent), "%ux%u", params.width, params.height);
+		std::printf("%-36s %-11s %-5s %10zu %10zu %10zu %9.2f %9.2f\n", source.path.filename().string().c_str(),
+					extent, GetCompressionName(compression), sourceSize / 1024, mippedSize / 1024,
+					texture.GetTextureData().size() / 1024, mipMs, compressMs);
+	}
+
+	Utilities::JobSystem::Shutdown();
+
+	if (totalMipped > 0)
+		std::printf("total: %zu KB source, %zu KB with mips, %zu KB compressed (%.1fx smaller)\n", totalSource / 1024,
+					totalMipped / 1024, totalCompressed / 1024,
+					static_cast<double>(totalMipped) / static_cast<double>(totalCompressed));
+	return 0;
+}
\ No newline at end of file
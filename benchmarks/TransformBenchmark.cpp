@@ -0,0 +1,94 @@
+// Local/world matrix rebuild for 100k transforms: the per-transform glm path TransformSystem used before, against the
+// structure-of-arrays SIMD kernel in Math/TransformBatch.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Math/TransformBatch.h"
+
+using namespace PE;
+
+namespace {
+constexpr uint32_t TRANSFORM_COUNT = 100'000;
+constexpr int	   ITERATIONS	   = 50;
+
+struct TransformInput {
+	Math::Vector3 position;
+	Math::Vector3 rotation;
+	Math::Vector3 scale;
+};
+
+std::vector<TransformInput> MakeTransforms() {
+	std::vector<TransformInput> transforms(TRANSFORM_COUNT);
+	for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i) {
+		const float f = static_cast<float>(i);
+		transforms[i] = {Math::Vector3(std::fmod(f, 100.0f), f * 0.01f, -f * 0.02f),
+						 Math::Vector3(f * 0.001f, f * 0.002f, -f * 0.003f),
+						 Math::Vector3(1.0f + std::fmod(f, 3.0f), 1.0f, 0.5f)};
+	}
+	return transforms;
+}
+
+void ComputeScalar(const TransformInput &input, const Math::Matrix4 &parentWorld, Math::Matrix4 &local,
+				   Math::Matrix4 &world) {
+	const Math::Matrix4 identity	= Math::Matrix4(1.0f);
+	const Math::Matrix4 translation = Math::Translate(identity, input.position);
+	Math::Matrix4		rotation	= Math::Rotate(identity, input.rotation.y, Math::Vector3(0.0f, 1.0f, 0.0f));
+	rotation						= Math::Rotate(rotation, input.rotation.x, Math::Vector3(1.0f, 0.0f, 0.0f));
+	rotation						= Math::Rotate(rotation, input.rotation.z, Math::Vector3(0.0f, 0.0f, 1.0f));
+	const Math::Matrix4 scale		= Math::Scale(identity, input.scale);
+
+	local = translation * rotation * scale;
+	world = parentWorld * local;
+}
+
+template <typename TFunc>
+double BestOf(TFunc &&func) {
+	double bestMs = 1e30;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		bestMs			= std::min(bestMs, ms);
+	}
+	return bestMs;
+}
+}  // namespace
+
+int main() {
+	const std::vector<TransformInput> transforms = MakeTransforms();
+	const Math::Matrix4				  parent	 = Math::Translate(Math::Matrix4(1.0f), Math::Vector3(1.0f, 2.0f, 3.0f));
+
+	std::vector<Math::Matrix4> scalarLocal(TRANSFORM_COUNT), scalarWorld(TRANSFORM_COUNT);
+	std::vector<Math::Matrix4> batchLocal(TRANSFORM_COUNT), batchWorld(TRANSFORM_COUNT);
+
+	const double scalarMs = BestOf([&] {
+		for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i)
+			ComputeScalar(transforms[i], parent, scalarLocal[i], scalarWorld[i]);
+	});
+
+	// Gathering into SoA is part of what TransformSystem pays every frame, so it is timed too.
+	Math::TransformBatch batch;
+	batch.Reserve(TRANSFORM_COUNT);
+	const double batchMs = BestOf([&] {
+		batch.Clear();
+		for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i)
+			batch.Push(transforms[i].position, transforms[i].rotation, transforms[i].scale, &parent, &batchLocal[i],
+					   &batchWorld[i]);
+		Math::ComputeTransformMatrices(batch, 0, batch.Size());
+	});
+
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i)
+		for (int c = 0; c < 4; ++c)
+			for (int r = 0; r < 4; ++r)
+				maxError = std::max(maxError, std::abs(scalarWorld[i][c][r] - batchWorld[i][c][r]));
+
+	std::printf("%u transforms, %zu lanes, best of %d\n", TRANSFORM_COUNT, Math::GetTransformBatchWidth(), ITERATIONS);
+	std::printf("  glm per transform: %8.3f ms\n", scalarMs);
+	std::printf("  SoA batch:         %8.3f ms  speedup %5.2fx\n", batchMs, scalarMs / batchMs);
+	std::printf("  max world matrix difference %g\n", maxError);
+	return 0;
+}
@@ -0,0 +1,143 @@
+// TransformSystem::OnUpdate on a 100k transform forest built through EntityManager, with one job system worker and
+// with several. Checks that every local and world matrix comes out bit-identical however many workers split the
+// levels, and that the states CameraSystem reads are Updated after the update that computed them and Clean after the
+// next one. Exits with 1 on the first failure.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ECS/EntityManager.h"
+#include "Scene/Components/Transform.h"
+#include "Scene/EntityFactory.h"
+#include "Scene/Systems/TransformSystem.h"
+#include "Utilities/JobSystem.h"
+
+using namespace PE;
+using Scene::Components::Transform;
+
+// EntityManager sets up the factory, whose primitive helpers would pull in the whole asset layer. Nothing here creates
+// primitives.
+namespace PE::Scene {
+ERROR_CODE EntityFactory::Initialize(ECS::EntityManager *) { return ERROR_CODE::OK; }
+void	   EntityFactory::Shutdown() {}
+}  // namespace PE::Scene
+
+namespace {
+constexpr uint32_t ROOT_COUNT		 = 64;
+constexpr uint32_t CHILDREN_PER_NODE = 4;
+constexpr uint32_t TRANSFORM_COUNT	 = 100'000;
+constexpr int	   ITERATIONS		 = 20;
+
+struct Result {
+	std::vector<Math::Matrix4> local;
+	std::vector<Math::Matrix4> world;
+	double					   bestMs = 0.0;
+};
+
+// Every entity of the forest is created before the first update, parents ahead of their children.
+std::vector<ECS::EntityID> CreateForest(ECS::EntityManager &entityManager) {
+	std::vector<ECS::EntityID> entities;
+	entities.reserve(TRANSFORM_COUNT);
+
+	const auto create = [&entityManager, &entities](const ECS::EntityID parentID) {
+		const float f = static_cast<float>(entities.size());
+		Transform	transform;
+		transform.position		 = Math::Vector3(std::fmod(f, 10.0f), f * 0.001f, -f * 0.002f);
+		transform.rotation		 = Math::Vector3(f * 0.001f, f * 0.002f, -f * 0.003f);
+		transform.scale			 = Math::Vector3(1.0f + std::fmod(f, 0.5f), 1.0f, 0.9f);
+		transform.parentEntityID = parentID;
+
+		const ECS::EntityID entityID = entityManager.CreateEntity();
+		entityManager.AddComponent(entityID, transform);
+		entities.push_back(entityID);
+	};
+
+	for (uint32_t root = 0; root < ROOT_COUNT; ++root) create(ECS::INVALID_ENTITY_ID);
+	// Breadth first, the parent of entity i is entity (i - ROOT_COUNT) / CHILDREN_PER_NODE.
+	for (size_t parent = 0; entities.size() < TRANSFORM_COUNT; ++parent)
+		for (uint32_t child = 0; child < CHILDREN_PER_NODE && entities.size() < TRANSFORM_COUNT; ++child)
+			create(entities[parent]);
+	return entities;
+}
+
+bool HasState(ECS::EntityManager &entityManager, const std::vector<ECS::EntityID> &entities,
+			  const Transform::TransformState state) {
+	return std::ranges::all_of(entities, [&entityManager, state](const ECS::EntityID entityID) {
+		return entityManager.GetTIComponent<Transform>(entityID)->state == state;
+	});
+}
+
+// Builds the forest, propagates it once and checks the state transitions, then times full propagations.
+bool Run(const uint32_t workerCount, Result &outResult) {
+	Utilities::JobSystem::Initialize(workerCount);
+
+	ECS::EntityManager entityManager;
+	entityManager.Initialize(TRANSFORM_COUNT, 8);
+	entityManager.RegisterComponent<Transform>(TRANSFORM_COUNT);
+
+	const Core::EngineConfig		 config;
+	Scene::Systems::TransformSystem transformSystem;
+	transformSystem.Initialize(ECS::ESystemStage::Transform, &entityManager, nullptr, nullptr, config);
+
+	const std::vector<ECS::EntityID> entities = CreateForest(entityManager);
+
+	transformSystem.OnUpdate(0.0f);
+	bool passed = HasState(entityManager, entities, Transform::TransformState::Updated);
+
+	outResult.local.resize(entities.size());
+	outResult.world.resize(entities.size());
+	for (size_t i = 0; i < entities.size(); ++i) {
+		const Transform &transform = *entityManager.GetTIComponent<Transform>(entities[i]);
+		outResult.local[i]		   = transform.localMatrix;
+		outResult.world[i]		   = transform.worldMatrix;
+	}
+
+	transformSystem.OnUpdate(0.0f);
+	passed = passed && HasState(entityManager, entities, Transform::TransformState::Clean);
+
+	// Marking the roots queues their whole subtrees, so every iteration recomputes the full forest.
+	outResult.bestMs = 1e30;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		for (uint32_t root = 0; root < ROOT_COUNT; ++root) transformSystem.MarkDirty(entities[root]);
+
+		const auto start = std::chrono::steady_clock::now();
+		transformSystem.OnUpdate(0.0f);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		outResult.bestMs = std::min(outResult.bestMs, ms);
+	}
+
+	transformSystem.Shutdown();
+	entityManager.Shutdown();
+	Utilities::JobSystem::Shutdown();
+	return passed;
+}
+
+bool IsBitIdentical(const Result &a, const Result &b) {
+	const size_t bytes = a.local.size() * sizeof(Math::Matrix4);
+	return a.local.size() == b.local.size() && std::memcmp(a.local.data(), b.local.data(), bytes) == 0 &&
+		   std::memcmp(a.world.data(), b.world.data(), bytes) == 0;
+}
+}  // namespace
+
+int main() {
+	// At least 4 workers even on small machines, so levels are split across threads.
+	const uint32_t maxWorkers = std::max(4u, std::thread::hardware_concurrency());
+
+	Result		   serial;
+	Result		   parallel;
+	const bool	   serialStates	  = Run(1, serial);
+	const bool	   parallelStates = Run(maxWorkers, parallel);
+	const bool	   identical	  = IsBitIdentical(serial, parallel);
+
+	std::printf("%u transforms, %zu lanes, best of %d\n", TRANSFORM_COUNT, Math::GetTransformBatchWidth(), ITERATIONS);
+	std::printf("  %2u worker(s): %8.3f ms\n", 1u, serial.bestMs);
+	std::printf("  %2u worker(s): %8.3f ms  speedup %5.2fx\n", maxWorkers, parallel.bestMs,
+				serial.bestMs / parallel.bestMs);
+	std::printf("  matrices %s, states %s\n", identical ? "bit-identical" : "MISMATCH",
+				serialStates && parallelStates ? "Updated then Clean" : "WRONG");
+	return identical && serialStates && parallelStates ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+// Uploads through VulkanUploadManager on a headless device: 1 MB uploads that go through the staging ring and 40 MB
+// uploads that get a staging buffer of their own, each submitted and waited on. Also checks that once their batches
+// are retired, the allocator is back to the memory it had before the uploads, so oversized staging isn't leaked. Exits
+// with 1 when it is, or when no Vulkan device is available.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Graphics/Vulkan/VulkanBuffer.h"
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Graphics/Vulkan/VulkanMemoryAllocator.h"
+#include "Graphics/Vulkan/VulkanUploadManager.h"
+
+using namespace PE;
+using namespace PE::Graphics::Vulkan;
+
+namespace {
+constexpr VkDeviceSize RING_SIZE		= 16ull * 1024 * 1024;
+constexpr VkDeviceSize RING_UPLOAD_SIZE = 1ull * 1024 * 1024;
+constexpr VkDeviceSize OVERSIZED_SIZE	= 40ull * 1024 * 1024;	// above half the ring and half a memory block
+constexpr int		   ITERATIONS		= 8;
+
+// Uploads size bytes of payload and waits until the GPU finished the copy.
+bool UploadAndWait(const VkDevice device, VulkanUploadManager &uploads, const VkBuffer destination,
+				   const std::vector<uint8_t> &payload, const VkDeviceSize size) {
+	uint64_t value = 0;
+	if (uploads.UploadBuffer(destination, 0, payload.data(), size, VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+							 VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT, value) < ERROR_CODE::WARN_START ||
+		uploads.Submit() < ERROR_CODE::WARN_START)
+		return false;
+
+	const VkSemaphore	timeline = uploads.GetTimelineSemaphore();
+	VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores	= &timeline;
+	waitInfo.pValues		= &value;
+	return vkWaitSemaphores(device, &waitInfo, UINT64_MAX) == VK_SUCCESS;
+}
+
+// Best time of one upload of the given size, or a negative value if an upload failed.
+double BestUploadMs(const VkDevice device, VulkanUploadManager &uploads, const VkBuffer destination,
+					const std::vector<uint8_t> &payload, const VkDeviceSize size) {
+	double bestMs = 1e30;
+	for (int i = 0; i < ITERATIONS; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		if (!UploadAndWait(device, uploads, destination, payload, size)) return -1.0;
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		bestMs			= std::min(bestMs, ms);
+	}
+	return bestMs;
+}
+
+void PrintStats(const char *label, const VulkanMemoryStats &stats) {
+	std::printf("  %-18s reserved %10llu  dedicated %10llu bytes in %u  allocations %u\n", label,
+				static_cast<unsigned long long>(stats.reservedBytes),
+				static_cast<unsigned long long>(stats.dedicatedBytes), stats.dedicatedCount, stats.allocationCount);
+}
+}  // namespace
+
+int main() {
+	VulkanDevice device;
+	if (device.Initialize(nullptr) < ERROR_CODE::WARN_START) {
+		std::printf("No Vulkan device available.\n");
+		return 1;
+	}
+	const VkDevice vkDevice = device.GetVkDevice();
+
+	VulkanMemoryAllocator allocator;
+	VulkanUploadManager	  uploads;
+	VulkanBuffer		  destination;
+	if (allocator.Initialize(&device) < ERROR_CODE::WARN_START ||
+		uploads.Initialize(&device, &allocator, RING_SIZE) < ERROR_CODE::WARN_START ||
+		destination.Initialize(vkDevice, &allocator, OVERSIZED_SIZE, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+							   VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) < ERROR_CODE::WARN_START) {
+		std::printf("Failed to set up the upload manager.\n");
+		return 1;
+	}
+
+	const std::vector<uint8_t> payload(OVERSIZED_SIZE, 0xA5);
+	const VulkanMemoryStats	   before = allocator.GetStats();
+
+	const double ringMs		 = BestUploadMs(vkDevice, uploads, destination.GetBuffer(), payload, RING_UPLOAD_SIZE);
+	const double oversizedMs = BestUploadMs(vkDevice, uploads, destination.GetBuffer(), payload, OVERSIZED_SIZE);
+	// Submit retires every batch that has completed, the last upload's included.
+	const bool				submitted = uploads.Submit() >= ERROR_CODE::WARN_START;
+	const VulkanMemoryStats after	  = allocator.GetStats();
+
+	std::printf("ring %u MB, best of %d\n", static_cast<uint32_t>(RING_SIZE >> 20), ITERATIONS);
+	std::printf("  %3u MB upload (ring):      %8.3f ms\n", static_cast<uint32_t>(RING_UPLOAD_SIZE >> 20), ringMs);
+	std::printf("  %3u MB upload (oversized): %8.3f ms\n", static_cast<uint32_t>(OVERSIZED_SIZE >> 20), oversizedMs);
+	PrintStats("before uploads:", before);
+	PrintStats("after retirement:", after);
+
+	const bool released = after.dedicatedBytes == before.dedicatedBytes &&
+						  after.dedicatedCount == before.dedicatedCount &&
+						  after.reservedBytes == before.reservedBytes && after.allocationCount == before.allocationCount;
+	const bool passed = ringMs >= 0.0 && oversizedMs >= 0.0 && submitted && released;
+	std::printf("  %s\n", passed ? "staging memory released" : "FAILED: uploads failed or staging memory leaked");
+
+	destination.Shutdown();
+	uploads.Shutdown();
+	allocator.Shutdown();
+	device.Shutdown();
+	return passed ? 0 : 1;
+}
\ No newline at end of file
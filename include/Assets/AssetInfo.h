@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "Graphics/RenderTypes.h"
+#include "Math/Bounds.h"
 #include "Math/Math.h"
 
 namespace PE::Assets {
@@ -32,8 +33,11 @@ struct TextureAssetInfo : AssetInfo {
 
 struct MeshAssetInfo : AssetInfo {
 	MeshAssetInfo() { type = AssetType::Mesh; }
-	uint32_t vertexCount = 0;
-	uint32_t indexCount	 = 0;
+	uint32_t			 vertexCount = 0;
+	uint32_t			 indexCount	 = 0;
+	Math::BoundingBox	 bounds;		   // object space
+	Math::BoundingSphere boundingSphere;   // object space, centered on the box
+	float				 lodError = 0.0f;  // object space distance to the full detail mesh, 0 for that one
 };
 
 struct ShaderAssetInfo : AssetInfo {
@@ -57,8 +61,9 @@ struct ModelAssetInfo : AssetInfo {
 	ModelAssetInfo() { type = AssetType::Model; }
 
 	struct SubMeshEntry {
-		std::string meshAssetName;
-		std::string materialAssetName;
+		std::string				 meshAssetName;
+		std::string				 materialAssetName;
+		std::vector<std::string> lodMeshAssetNames;	 // coarsest last
 	};
 
 	std::vector<SubMeshEntry> subMeshes;
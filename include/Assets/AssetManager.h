@@ -56,6 +56,7 @@ public:
 	static Graphics::MaterialID GetMaterialHandle(const std::string &fileName);
 	static Graphics::MeshID		GetMeshHandle(const std::string &fileName);
 	static ModelAssetInfo	   *GetModelAssetInfo(const std::string &fileName);
+	static const MeshAssetInfo *GetMeshAssetInfo(Graphics::MeshID id);
 
 	static const auto &GetTextureRegistry() { return s_texAssetRegistry; }
 	static const auto &GetMeshRegistry() { return s_meshAssetRegistry; }
@@ -96,8 +97,9 @@ private:
 	static void CreateDefaultMaterials();
 	static void CreateDefaultMeshes();
 
-	static inline Graphics::IRenderer *ref_renderer = nullptr;
-	static inline SystemState		   s_state		= SystemState::Uninitialized;
+	static inline Graphics::IRenderer *ref_renderer		  = nullptr;
+	static inline SystemState		   s_state			  = SystemState::Uninitialized;
+	static inline bool				   s_compressTextures = false;
 
 	static inline std::unordered_map<std::string, TextureAssetInfo *>  s_texAssetRegistry;
 	static inline std::unordered_map<std::string, MeshAssetInfo *>	   s_meshAssetRegistry;
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphics/RenderTypes.h"
+
+namespace PE::Assets::Mesh::Processing {
+// Entries of the FIFO post-transform vertex cache the index optimizations aim for and AnalyzeVertexCache models.
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+// A simplified level of a mesh. error is how far its surface strays from the full detail mesh, in object space units.
+struct LODLevel {
+	Graphics::MeshData meshData;
+	float			   error = 0.0f;
+};
+
+// Collapses edges of meshData, cheapest first, until at most targetIndexCount indices are left or every collapse that
+// is left would stray further than maxError. A collapse costs the quadric error of the planes it moves away from plus
+// how far apart the normals and texture coordinates it merges lie, so hard edges and UV seams go last. Border vertices
+// only slide along the border. Returns the error of the result, see LODLevel.
+float Simplify(const Graphics::MeshData &meshData, size_t targetIndexCount, float maxError,
+			   Graphics::MeshData &outMeshData);
+
+// Simplifies meshData to each of triangleRatios of its triangle count in turn, every level going on from the one
+// before. The chain ends early at a level that can't drop a quarter of the triangles of the one before it.
+std::vector<LODLevel> GenerateLODs(const Graphics::MeshData &meshData, std::span<const float> triangleRatios);
+
+// How well an index buffer reuses shaded vertices. acmr is the vertices shaded per triangle, 0.5 at best for large
+// meshes and 3 at worst, and atvr the vertices shaded per vertex of the mesh, 1 at best.
+struct VertexCacheStatistics {
+	float acmr = 0.0f;
+	float atvr = 0.0f;
+};
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+										 uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Orders triangles with Tipsify: fans around one vertex after another, picking the next among the vertices just used
+// that is still cached. Appends the first triangle of every run that ended in a dead end to outClusters if given,
+// OptimizeOverdraw reorders those runs.
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, std::vector<uint32_t> *outClusters = nullptr);
+
+// Sorts the clusters of a cache optimized index buffer so that the ones facing away from the center of the mesh go
+// first, as they are the likeliest to hide the rest from any side. Clusters are split further where it costs at most
+// threshold times their ACMR.
+void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Graphics::Vertex> vertices,
+					  std::span<const uint32_t> clusters, float threshold);
+
+// Stores vertices in the order the triangles first use them and drops unused ones.
+void OptimizeVertexFetch(Graphics::MeshData &meshData);
+
+// Runs the vertex cache, overdraw and vertex fetch optimizations in turn, the mesh draws the same surface after it.
+void OptimizeMesh(Graphics::MeshData &meshData);
+}  // namespace PE::Assets::Mesh::Processing
\ No newline at end of file
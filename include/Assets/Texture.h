@@ -1,4 +1,5 @@
 #pragma once
+#include <filesystem>
 #include <vector>
 
 #include "Graphics/Texture.h"
@@ -34,4 +35,10 @@ namespace Loader {
 bool Load(const std::filesystem::path &path, Graphics::Texture &texture);
 bool LoadCubemap(const std::vector<std::filesystem::path> &paths, Graphics::Texture &texture);
 };	// namespace Loader
+
+namespace Writer {
+// Saves tightly packed RGBA8 pixels as RGB, the format follows the extension (.png or .ppm). PNG data is stored
+// without deflate compression, so files are large but need no image library.
+bool Write(const std::filesystem::path &path, uint32_t width, uint32_t height, const unsigned char *rgba);
+}  // namespace Writer
 }  // namespace PE::Assets::Texture
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+#include "Graphics/Texture.h"
+
+namespace PE::Assets::Texture::Processing {
+// Block format textures of this type are compressed to. Normal maps keep X and Y in BC5, shaders rebuild Z.
+[[nodiscard]] Graphics::TextureCompression GetCompression(Graphics::TextureType type);
+
+// Levels of a full mip chain down to 1x1.
+[[nodiscard]] uint8_t GetFullMipCount(uint32_t width, uint32_t height);
+
+// Extends a single level of RGBA8 data to a full mip chain. Each level is a 2x2 box filter of the one above it,
+// averaged in linear space for sRGB textures and renormalized for normal maps.
+void GenerateMips(Graphics::Texture &texture);
+
+// Encodes every level and layer of RGBA8 data into the block format and switches the texture format to match. The
+// blocks are spread over the JobSystem when it is running.
+bool Compress(Graphics::Texture &texture, Graphics::TextureCompression compression);
+}  // namespace PE::Assets::Texture::Processing
\ No newline at end of file
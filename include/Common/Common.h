@@ -31,6 +31,8 @@ enum class ERROR_CODE {
 	VULKAN_SYNCOBJECTS_CREATION_FAILED,
 	VULKAN_SAMPLER_CREATION_FAILED,
 	VULKAN_MATERIAL_UPDATE_FAILED,
+	VULKAN_MEMORY_ALLOCATION_FAILED,
+	VULKAN_UPLOAD_FAILED,
 	DX11_BUFFER_CREATION_FAILED,
 	DX11_DEVICE_CREATION_FAILED,
 	DX11_PIPELINE_CREATION_FAILED,
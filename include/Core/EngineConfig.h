@@ -1,5 +1,7 @@
 #pragma once
+#include <filesystem>
 #include <string>
+#include <vector>
 
 #include "Graphics/RenderConfig.h"
 #include "Utilities/Logger.h"
@@ -13,5 +15,14 @@ struct EngineConfig {
 	Graphics::RenderConfig renderConfig;
 	uint16_t			   maxEntityCount		 = 1024;
 	uint16_t			   maxComponentTypeCount = 1024;
+	uint16_t			   workerThreadCount	 = 0;  // includes the main thread, 0 = hardware concurrency
+	bool				   parallelSystemUpdate	 = true;
+
+	// Headless runs render offscreen without a window for a fixed number of frames and save the listed ones.
+	bool				  headless			 = false;
+	uint32_t			  headlessFrameCount = 600;
+	std::vector<uint32_t> captureFrames;
+	std::filesystem::path captureDirectory	 = "Captures";
+	std::string			  captureFormat		 = "png";  // png or ppm
 };
 }  // namespace PE::Core
\ No newline at end of file
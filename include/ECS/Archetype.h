@@ -0,0 +1,121 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "ComponentType.h"
+#include "Entity.h"
+
+namespace PE::ECS {
+// Same bound as the per-entity component masks, so every type EntityManager accepts fits in a signature.
+constexpr uint32_t MAX_ARCHETYPE_COMPONENT_TYPES = MAX_COMPONENT_TYPES;
+constexpr uint32_t ARCHETYPE_CHUNK_SIZE			 = 16 * 1024;  // bytes, before per-type padding
+constexpr uint32_t ARCHETYPE_CHUNK_ALIGNMENT	 = 64;
+
+using ComponentSignature = std::bitset<MAX_ARCHETYPE_COMPONENT_TYPES>;
+
+// Type-erased description of a component so archetypes can move rows between chunks.
+struct ComponentInfo {
+	uint32_t typeID	   = UINT32_MAX;
+	uint32_t size	   = 0;
+	uint32_t alignment = 0;
+
+	void (*copyConstruct)(void *dst, const void *src) = nullptr;
+	void (*moveConstruct)(void *dst, void *src)		  = nullptr;
+	void (*destruct)(void *ptr)						  = nullptr;
+
+	[[nodiscard]] bool IsValid() const { return typeID != UINT32_MAX; }
+
+	template <typename T>
+	static ComponentInfo Create() {
+		ComponentInfo info;
+		info.typeID		   = ComponentType<T>::ID();
+		info.size		   = static_cast<uint32_t>(sizeof(T));
+		info.alignment	   = static_cast<uint32_t>(alignof(T));
+		info.copyConstruct = [](void *dst, const void *src) { new (dst) T(*static_cast<const T *>(src)); };
+		info.moveConstruct = [](void *dst, void *src) { new (dst) T(std::move(*static_cast<T *>(src))); };
+		info.destruct	   = [](void *ptr) { static_cast<T *>(ptr)->~T(); };
+		return info;
+	}
+};
+
+// Where an entity's row lives inside the archetype storage.
+struct EntityLocation {
+	uint32_t archetype = UINT32_MAX;
+	uint32_t chunk	   = UINT32_MAX;
+	uint32_t row	   = UINT32_MAX;
+};
+
+// Fixed-size block holding `capacity` rows laid out column by column (SoA).
+struct ArchetypeChunk {
+	std::byte *data	 = nullptr;
+	uint32_t   count = 0;
+};
+
+class Archetype {
+public:
+	Archetype(const ComponentSignature &signature, const std::vector<const ComponentInfo *> &components);
+	Archetype(const Archetype &)			= delete;
+	Archetype &operator=(const Archetype &) = delete;
+	Archetype(Archetype &&)					= delete;
+	Archetype &operator=(Archetype &&)		= delete;
+	~Archetype();
+
+	// Appends an uninitialized row for the entity. Caller has to construct every column.
+	EntityLocation AllocateRow(EntityID entityID, uint32_t archetypeIndex);
+
+	// Removes the row by moving the very last row into it. Returns the entity that got moved into the hole
+	// or INVALID_ENTITY_ID if the removed row was the last one. When destructRow is false the caller already
+	// destroyed or moved out the row's components.
+	EntityID RemoveRow(uint32_t chunkIndex, uint32_t row, bool destructRow);
+	void	 Clear();
+
+	[[nodiscard]] bool HasComponent(uint32_t typeID) const {
+		return typeID < MAX_ARCHETYPE_COMPONENT_TYPES && m_signature.test(typeID);
+	}
+	[[nodiscard]] void *GetComponent(uint32_t chunkIndex, uint32_t row, uint32_t typeID) const;
+	[[nodiscard]] void *GetColumn(uint32_t chunkIndex, uint32_t typeID) const;
+
+	template <typename T>
+	std::span<T> GetColumn(uint32_t chunkIndex) {
+		auto *column = static_cast<T *>(GetColumn(chunkIndex, ComponentType<T>::ID()));
+		return {column, m_chunks[chunkIndex].count};
+	}
+
+	[[nodiscard]] std::span<const EntityID> GetEntities(uint32_t chunkIndex) const {
+		const auto *ids = reinterpret_cast<const EntityID *>(m_chunks[chunkIndex].data);
+		return {ids, m_chunks[chunkIndex].count};
+	}
+
+	[[nodiscard]] const ComponentSignature				  &GetSignature() const { return m_signature; }
+	[[nodiscard]] const std::vector<const ComponentInfo *> &GetComponents() const { return m_components; }
+	[[nodiscard]] uint32_t								   GetChunkCount() const { return m_activeChunks; }
+	[[nodiscard]] uint32_t								   GetChunkCapacity() const { return m_chunkCapacity; }
+	[[nodiscard]] uint32_t								   GetEntityCount() const { return m_entityCount; }
+
+	// Cached transitions to neighbour archetypes (signature +/- one component type).
+	std::unordered_map<uint32_t, uint32_t> addEdges;
+	std::unordered_map<uint32_t, uint32_t> removeEdges;
+
+private:
+	[[nodiscard]] std::byte *RowPtr(uint32_t chunkIndex, uint32_t column, uint32_t row) const {
+		return m_chunks[chunkIndex].data + m_columnOffsets[column] + row * m_components[column]->size;
+	}
+
+	ComponentSignature				 m_signature;
+	std::vector<const ComponentInfo *> m_components;
+	std::vector<uint32_t>			 m_columnOffsets;						  // byte offset of each column in a chunk
+	std::vector<int16_t>			 m_columnOf;							  // typeID -> column, -1 if absent
+	std::vector<ArchetypeChunk>		 m_chunks;								  // chunks are kept allocated for reuse
+	uint32_t						 m_chunkCapacity = 0;					  // rows per chunk
+	uint32_t						 m_chunkBytes	 = ARCHETYPE_CHUNK_SIZE;  // allocation size of a chunk
+	uint32_t						 m_activeChunks	 = 0;
+	uint32_t						 m_entityCount	 = 0;
+};
+}  // namespace PE::ECS
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Archetype.h"
+#include "PagedSparseArray.h"
+#include "Common/Common.h"
+#include "Utilities/Logger.h"
+
+namespace PE::ECS {
+// Groups entities by their exact component signature. Every archetype stores its rows in fixed-size chunks so
+// multi-component iteration walks contiguous columns instead of hopping through per-type reverse maps.
+class ArchetypeStorage {
+public:
+	ArchetypeStorage()									  = default;
+	ArchetypeStorage(const ArchetypeStorage &)			  = delete;
+	ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+	ArchetypeStorage(ArchetypeStorage &&)				  = delete;
+	ArchetypeStorage &operator=(ArchetypeStorage &&)	  = delete;
+	~ArchetypeStorage();
+
+	ERROR_CODE Initialize(uint32_t maxEntities);
+	ERROR_CODE Shutdown();
+
+	template <typename T>
+	ERROR_CODE RegisterComponent();
+
+	template <typename T>
+	ERROR_CODE Add(EntityID entityID, const T &component);
+	template <typename T>
+	ERROR_CODE Remove(EntityID entityID);
+	template <typename T>
+	[[nodiscard]] bool Has(EntityID entityID) const;
+	template <typename T>
+	T *Get(EntityID entityID);
+
+	void DestroyEntity(EntityID entityID);
+	void Clear();
+
+	[[nodiscard]] bool								  IsRegistered(uint32_t typeID) const;
+	[[nodiscard]] const EntityLocation				  &GetLocation(EntityID entityID) const;
+	[[nodiscard]] Archetype							  &GetArchetype(uint32_t index) { return *m_archetypes[index]; }
+	[[nodiscard]] uint32_t							  GetArchetypeCount() const;
+	[[nodiscard]] const std::vector<std::unique_ptr<Archetype>> &GetArchetypes() const { return m_archetypes; }
+
+private:
+	ERROR_CODE RegisterComponentInfo(const ComponentInfo &info);
+	uint32_t   FindOrCreateArchetype(const ComponentSignature &signature);
+	uint32_t   GetAddTarget(uint32_t archetypeIndex, uint32_t typeID);
+	uint32_t   GetRemoveTarget(uint32_t archetypeIndex, uint32_t typeID);
+	// Location slot of an entity, allocating its page on first use.
+	EntityLocation &AssureLocation(EntityID entityID) { return m_locations.Assure(GetEntityIndex(entityID)); }
+
+	// Moves the entity's row into the target archetype, carrying over shared columns. The row of any column that
+	// only exists in the target is left uninitialized for the caller.
+	EntityLocation MoveEntity(EntityID entityID, uint32_t targetArchetype);
+	void		   PatchMovedEntity(EntityID movedEntity, const EntityLocation &location);
+
+	SystemState								m_state = SystemState::Uninitialized;
+	std::vector<ComponentInfo>				m_componentInfos;  // typeID -> info
+	std::vector<std::unique_ptr<Archetype>> m_archetypes;	   // index 0 is the empty archetype
+	std::unordered_map<ComponentSignature, uint32_t> m_archetypeLookup;
+	PagedSparseArray<EntityLocation>				 m_locations;  // by entity index, archetype UINT32_MAX if none
+};
+
+template <typename T>
+ERROR_CODE ArchetypeStorage::RegisterComponent() {
+	return RegisterComponentInfo(ComponentInfo::Create<T>());
+}
+
+template <typename T>
+ERROR_CODE ArchetypeStorage::Add(const EntityID entityID, const T &component) {
+	const uint32_t typeID = ComponentType<T>::ID();
+	if (!IsRegistered(typeID)) {
+		PE_LOG_FATAL("Component not registered in archetype storage.");
+		return ERROR_CODE::COMPONENT_NOT_REGISTERED;
+	}
+
+	EntityLocation &location = AssureLocation(entityID);
+	if (location.archetype == UINT32_MAX) location = m_archetypes[0]->AllocateRow(entityID, 0);
+
+	if (m_archetypes[location.archetype]->HasComponent(typeID)) {
+		PE_LOG_WARN("Entity already has the component.");
+		return ERROR_CODE::ENTITY_HAS_COMPONENT;
+	}
+
+	const uint32_t target = GetAddTarget(location.archetype, typeID);
+	if (target == UINT32_MAX) return ERROR_CODE::MAX_COMPONENT_TYPES_REACHED;
+
+	const EntityLocation newLocation = MoveEntity(entityID, target);
+	void *dst = m_archetypes[newLocation.archetype]->GetComponent(newLocation.chunk, newLocation.row, typeID);
+	new (dst) T(component);
+
+	return ERROR_CODE::OK;
+}
+
+template <typename T>
+ERROR_CODE ArchetypeStorage::Remove(const EntityID entityID) {
+	const uint32_t typeID = ComponentType<T>::ID();
+	if (!Has<T>(entityID)) {
+		PE_LOG_WARN("Entity doesn't have the component.");
+		return ERROR_CODE::ENTITY_HAS_NOT_COMPONENT;
+	}
+
+	const EntityLocation &location = AssureLocation(entityID);
+	Archetype			 &source   = *m_archetypes[location.archetype];
+	static_cast<T *>(source.GetComponent(location.chunk, location.row, typeID))->~T();
+
+	MoveEntity(entityID, GetRemoveTarget(location.archetype, typeID));
+	return ERROR_CODE::OK;
+}
+
+template <typename T>
+bool ArchetypeStorage::Has(const EntityID entityID) const {
+	const EntityLocation *location = m_locations.Find(GetEntityIndex(entityID));
+	if (!location || location->archetype == UINT32_MAX) return false;
+	return m_archetypes[location->archetype]->HasComponent(ComponentType<T>::ID());
+}
+
+template <typename T>
+T *ArchetypeStorage::Get(const EntityID entityID) {
+	if (!Has<T>(entityID)) {
+		PE_LOG_FATAL("Entity doesn't have the component.");
+		return nullptr;
+	}
+
+	const EntityLocation &location = AssureLocation(entityID);
+	return static_cast<T *>(
+		m_archetypes[location.archetype]->GetComponent(location.chunk, location.row, ComponentType<T>::ID()));
+}
+}  // namespace PE::ECS
\ No newline at end of file
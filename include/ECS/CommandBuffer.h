@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "ComponentType.h"
+#include "Entity.h"
+#include "Common/Common.h"
+
+namespace PE::ECS {
+class EntityManager;
+
+// Records structural changes instead of applying them, so jobs can create, destroy and reshape entities while other
+// systems iterate the component storage. EntityManager keeps one buffer per job system worker and plays all of them
+// back in a single sorted pass once the frame's systems are done (or on FlushCommandBuffers).
+class CommandBuffer {
+public:
+	enum class CommandType : uint8_t { CreateEntity, AddComponent, RemoveComponent, DestroyEntity };
+
+	// Typed entry points for a component type, filled in once per type by ComponentCommands<T>.
+	struct ComponentCommandTable {
+		ERROR_CODE (*add)(EntityManager &entityManager, EntityID entityID, const void *component);
+		ERROR_CODE (*remove)(EntityManager &entityManager, EntityID entityID);
+		void (*destruct)(void *component);
+	};
+
+	struct Command {
+		CommandType					 type;
+		uint32_t					 typeID;	 // UINT32_MAX for entity commands
+		EntityID					 entityID;
+		uint32_t					 sequence;	 // record order inside this buffer
+		void						*component;	 // arena copy for AddComponent
+		const ComponentCommandTable *table;
+	};
+
+	explicit CommandBuffer(EntityManager *entityManager) : ref_eM(entityManager) {}
+	CommandBuffer(const CommandBuffer &)			= delete;
+	CommandBuffer &operator=(const CommandBuffer &) = delete;
+	CommandBuffer(CommandBuffer &&)					= delete;
+	CommandBuffer &operator=(CommandBuffer &&)		= delete;
+	~CommandBuffer();
+
+	// The ID is reserved right away and can be used by later commands, the entity is alive after playback.
+	EntityID CreateEntity();
+	void	 DestroyEntity(EntityID entityID);
+	template <typename TIComponent>
+	void AddComponent(EntityID entityID, const TIComponent &component);
+	template <typename TIComponent>
+	void RemoveComponent(EntityID entityID);
+
+	[[nodiscard]] const std::vector<Command> &GetCommands() const { return m_commands; }
+	[[nodiscard]] bool						  IsEmpty() const { return m_commands.empty(); }
+	// Destroys the recorded component copies and rewinds the arena, its blocks are kept for the next frame.
+	void									  Reset();
+
+private:
+	static constexpr size_t ARENA_BLOCK_SIZE = 16 * 1024;
+
+	struct ArenaBlock {
+		std::unique_ptr<std::byte[]> data;
+		size_t						 size;
+	};
+
+	void *Allocate(size_t size, size_t alignment);
+	void  Record(CommandType type, uint32_t typeID, EntityID entityID, void *component,
+				 const ComponentCommandTable *table);
+
+	EntityManager		   *ref_eM;
+	std::vector<Command>	m_commands;
+	std::vector<ArenaBlock> m_blocks;
+	size_t					m_blockIndex  = 0;
+	size_t					m_blockOffset = 0;
+};
+
+template <typename TIComponent>
+struct ComponentCommands {
+	static ERROR_CODE Add(EntityManager &entityManager, EntityID entityID, const void *component);
+	static ERROR_CODE Remove(EntityManager &entityManager, EntityID entityID);
+	static void		  Destruct(void *component) { static_cast<TIComponent *>(component)->~TIComponent(); }
+
+	static constexpr CommandBuffer::ComponentCommandTable TABLE{Add, Remove, Destruct};
+};
+
+template <typename TIComponent>
+void CommandBuffer::AddComponent(const EntityID entityID, const TIComponent &component) {
+	static_assert(alignof(TIComponent) <= alignof(std::max_align_t), "Over-aligned components can't be recorded.");
+
+	void *copy = Allocate(sizeof(TIComponent), alignof(TIComponent));
+	new (copy) TIComponent(component);
+	Record(CommandType::AddComponent, ComponentType<TIComponent>::ID(), entityID, copy,
+		   &ComponentCommands<TIComponent>::TABLE);
+}
+
+template <typename TIComponent>
+void CommandBuffer::RemoveComponent(const EntityID entityID) {
+	Record(CommandType::RemoveComponent, ComponentType<TIComponent>::ID(), entityID, nullptr,
+		   &ComponentCommands<TIComponent>::TABLE);
+}
+}  // namespace PE::ECS
\ No newline at end of file
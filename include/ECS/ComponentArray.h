@@ -1,11 +1,15 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
 #include "Common/Common.h"
+#include "Entity.h"
 #include "IComponentArray.h"
+#include "PagedSparseArray.h"
 #include "Utilities/Logger.h"
 
 namespace PE::ECS {
@@ -21,29 +25,44 @@ public:
 
 	uint32_t	Add(uint32_t entityID, const void *componentData) override;
 	RemovalInfo Remove(uint32_t entityID) override;
+	// Swap-removes a set of entities in descending packed order, so the element moved into a hole is never one that
+	// still has to go.
+	void		RemoveBatch(std::span<const uint32_t> entityIDs) override;
 
 	[[nodiscard]] bool Has(uint32_t entityID) const override;
 
 	// Access methods
 	T		&Get(uint32_t entityID);
 	const T &Get(uint32_t entityID) const;
-	void	 EnsureReverseCapacity(uint32_t entityID);
 
 	// Iterator over active packed data
 	std::vector<T>							  &Data() { return m_data; }
 	std::vector<uint32_t>					  &Index() { return m_index; }
-	std::vector<uint32_t>					  &Reverse() { return m_reverse; }
 	[[nodiscard]] const std::vector<uint32_t> &Index() const { return m_index; }
 	[[nodiscard]] uint32_t					   GetCount() const override { return m_size; }
+	[[nodiscard]] size_t					   GetSparseBytes() const { return m_reverse.GetAllocatedBytes(); }
 	void									   Clear() override;
 
-private:
-	std::vector<T>		  m_data	= std::vector<T>();			// packed component data
-	std::vector<uint32_t> m_index	= std::vector<uint32_t>();	// maps packed-slot -> entityID
-	std::vector<uint32_t> m_reverse = std::vector<uint32_t>();	// maps entityID -> packed index, UINT32_MAX if none
+	// Off by default. A system that mirrors this array reads what was added and removed since its last ClearChanges
+	// instead of diffing the whole array. Turning it on reports every current entity as added.
+	void									   SetChangeTracking(bool enabled);
+	[[nodiscard]] const std::vector<uint32_t> &GetAddedEntities() const { return m_added; }
+	[[nodiscard]] const std::vector<uint32_t> &GetRemovedEntities() const { return m_removed; }
+	[[nodiscard]] bool						   WasCleared() const { return m_wasCleared; }
+	void									   ClearChanges();
 
-	SystemState m_state = SystemState::Uninitialized;
-	uint32_t	m_size	= 0;
+private:
+	std::vector<T>			   m_data;				   // packed component data
+	std::vector<uint32_t>	   m_index;				   // packed slot -> entityID (with generation)
+	PagedSparseArray<uint32_t> m_reverse{UINT32_MAX};  // entity index -> packed slot, UINT32_MAX if none
+	std::vector<uint32_t>	   m_batchScratch;		   // packed slots of a RemoveBatch call
+	std::vector<uint32_t>	   m_added;				   // entity IDs, only filled while tracking changes
+	std::vector<uint32_t>	   m_removed;
+
+	SystemState	m_state		   = SystemState::Uninitialized;
+	uint32_t	m_size		   = 0;
+	bool		m_trackChanges = false;
+	bool		m_wasCleared   = false;
 };
 
 template <typename T>
@@ -55,9 +74,11 @@ template <typename T>
 ERROR_CODE ComponentArray<T>::Initialize(uint32_t maxCount) {
 	PE_CHECK_STATE_INIT(m_state, "ComponentArray is already initialized.");
 	m_state = SystemState::Initializing;
+	// maxCount is only a capacity hint, the reverse map allocates its pages when entities show up.
 	m_data.reserve(maxCount);
 	m_index.reserve(maxCount);
-	m_reverse.assign(maxCount, UINT32_MAX);	 // pre-fill as unknown
+	m_reverse.Clear();
+	m_reverse.Reserve(maxCount);
 	m_size = 0;
 
 	m_state = SystemState::Running;
@@ -71,8 +92,9 @@ ERROR_CODE ComponentArray<T>::Shutdown() {
 	m_state = SystemState::ShuttingDown;
 	m_data.clear();
 	m_index.clear();
-	m_reverse.clear();
+	m_reverse.Clear();
 	m_size = 0;
+	ClearChanges();
 
 	m_state = SystemState::Uninitialized;
 	return ERROR_CODE::OK;
@@ -80,24 +102,30 @@ ERROR_CODE ComponentArray<T>::Shutdown() {
 
 template <typename T>
 uint32_t ComponentArray<T>::Add(const uint32_t entityID, const void *componentData) {
-	EnsureReverseCapacity(entityID);
-	if (m_reverse[entityID] != UINT32_MAX) PE_LOG_FATAL("Entity already in reverse.");
+	uint32_t &reverse = m_reverse.Assure(GetEntityIndex(entityID));
+	if (reverse != UINT32_MAX) PE_LOG_FATAL("Entity already in reverse.");
 
 	uint32_t packedIndex = m_size;
 	m_data.push_back(*static_cast<const T *>(componentData));
 	m_index.push_back(entityID);
-	m_reverse[entityID] = packedIndex;
+	reverse = packedIndex;
 	m_size++;
+
+	if (m_trackChanges) m_added.push_back(entityID);
 	return entityID;
 }
 
 template <typename T>
 RemovalInfo ComponentArray<T>::Remove(const uint32_t entityID) {
-	if (entityID >= m_reverse.size()) PE_LOG_FATAL("Entity does not exist.");
+	uint32_t *reverse = m_reverse.Find(GetEntityIndex(entityID));
+	if (!reverse) {
+		PE_LOG_FATAL("Entity does not exist.");
+		return {INVALID_ENTITY_ID, UINT32_MAX};
+	}
 
-	uint32_t packed = m_reverse[entityID];
+	uint32_t packed = *reverse;
 
-	if (packed == UINT32_MAX || packed >= m_size) PE_LOG_FATAL("Entity does not exist.");
+	if (packed == UINT32_MAX || packed >= m_size || m_index[packed] != entityID) PE_LOG_FATAL("Entity does not exist.");
 
 	uint32_t	   lastPacked = m_size - 1;
 	const uint32_t lastEntity = m_index[lastPacked];
@@ -106,60 +134,109 @@ RemovalInfo ComponentArray<T>::Remove(const uint32_t entityID) {
 	if (packed != lastPacked) {
 		m_data[packed]		  = std::move(m_data[lastPacked]);
 		m_index[packed]		  = lastEntity;
-		m_reverse[lastEntity] = packed;
+		*m_reverse.Find(GetEntityIndex(lastEntity)) = packed;
 	}
 
 	m_data.pop_back();
 	m_index.pop_back();
 
-	m_reverse[entityID] = UINT32_MAX;
+	*reverse = UINT32_MAX;
 	m_size--;
 
+	if (m_trackChanges) m_removed.push_back(entityID);
+
 	return {lastEntity, packed};  // lastEntity now at packed (or returned even if same)
 }
 
+template <typename T>
+void ComponentArray<T>::RemoveBatch(const std::span<const uint32_t> entityIDs) {
+	m_batchScratch.clear();
+	for (const uint32_t entityID : entityIDs) {
+		const uint32_t *reverse = m_reverse.Find(GetEntityIndex(entityID));
+		if (!reverse || *reverse >= m_size || m_index[*reverse] != entityID) {
+			PE_LOG_FATAL("Entity does not exist.");
+			continue;
+		}
+		m_batchScratch.push_back(*reverse);
+		if (m_trackChanges) m_removed.push_back(entityID);
+	}
+
+	std::sort(m_batchScratch.begin(), m_batchScratch.end(), std::greater<>());
+	m_batchScratch.erase(std::unique(m_batchScratch.begin(), m_batchScratch.end()), m_batchScratch.end());
+
+	for (const uint32_t packed : m_batchScratch) {
+		const uint32_t lastPacked = m_size - 1;
+		const uint32_t lastEntity = m_index[lastPacked];
+		*m_reverse.Find(GetEntityIndex(m_index[packed])) = UINT32_MAX;
+
+		if (packed != lastPacked) {
+			m_data[packed]		  = std::move(m_data[lastPacked]);
+			m_index[packed]		  = lastEntity;
+			*m_reverse.Find(GetEntityIndex(lastEntity)) = packed;
+		}
+
+		m_data.pop_back();
+		m_index.pop_back();
+		m_size--;
+	}
+}
+
 template <typename T>
 bool ComponentArray<T>::Has(uint32_t entityID) const {
-	return entityID < m_reverse.size() && m_reverse[entityID] != UINT32_MAX && m_reverse[entityID] < m_size;
+	// The packed slot stores the full ID, so a stale handle whose index got recycled fails the last compare.
+	const uint32_t *packed = m_reverse.Find(GetEntityIndex(entityID));
+	return packed && *packed < m_size && m_index[*packed] == entityID;
 }
 
 template <typename T>
 T &ComponentArray<T>::Get(uint32_t entityID) {
-	if (entityID >= m_reverse.size()) PE_LOG_FATAL("Entity ID can't bigger than reverse vector size!");
+	const uint32_t packed = m_reverse.Get(GetEntityIndex(entityID));
+	if (packed == UINT32_MAX) PE_LOG_FATAL("Entity doesn't have a slot in this component array!");
 
-	uint32_t packed = m_reverse[entityID];
 	assert(packed != UINT32_MAX);
 	assert(packed < m_size);
+	assert(m_index[packed] == entityID);
 	return m_data[packed];
 }
 
 template <typename T>
 const T &ComponentArray<T>::Get(uint32_t entityID) const {
-	assert(entityID < m_reverse.size());
-	uint32_t packed = m_reverse[entityID];
+	const uint32_t packed = m_reverse.Get(GetEntityIndex(entityID));
 	assert(packed != UINT32_MAX);
 	assert(packed < m_size);
+	assert(m_index[packed] == entityID);
 	return m_data[packed];
 }
 
-template <typename T>
-void ComponentArray<T>::EnsureReverseCapacity(uint32_t entityID) {
-	if (entityID >= m_reverse.size()) {
-		size_t old = m_reverse.size();
-		m_reverse.resize(entityID + 1, UINT32_MAX);
-		PE_LOG_INFO("Resized reverse from " + std::to_string(old) + " to " + std::to_string(m_reverse.size()));
-	}
-}
-
 template <typename T>
 void ComponentArray<T>::Clear() {
 	m_size = 0;
 	std::fill(m_data.begin(), m_data.end(), T());
 	std::fill(m_index.begin(), m_index.end(), UINT32_MAX);
-	std::fill(m_reverse.begin(), m_reverse.end(), UINT32_MAX);
 
 	m_data.clear();
 	m_index.clear();
-	m_reverse.clear();
+	m_reverse.Clear();
+
+	// Whatever happened before the clear no longer matters to a tracking system.
+	if (m_trackChanges) {
+		m_added.clear();
+		m_removed.clear();
+		m_wasCleared = true;
+	}
+}
+
+template <typename T>
+void ComponentArray<T>::SetChangeTracking(const bool enabled) {
+	m_trackChanges = enabled;
+	ClearChanges();
+	if (enabled) m_added.assign(m_index.begin(), m_index.end());
+}
+
+template <typename T>
+void ComponentArray<T>::ClearChanges() {
+	m_added.clear();
+	m_removed.clear();
+	m_wasCleared = false;
 }
 }  // namespace PE::ECS
\ No newline at end of file
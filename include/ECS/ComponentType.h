@@ -1,8 +1,13 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cstdint>
 
 namespace PE::ECS {
+// Upper bound for ComponentType<T>::ID() values tracked per entity by EntityManager.
+constexpr uint32_t MAX_COMPONENT_TYPES = 128;
+
 // INTERNAL: Implementation Details (Do not use directly)
 namespace Internal {
 inline uint32_t FetchNextComponentID() {
@@ -20,4 +25,26 @@ public:
 		return id;
 	}
 };
+
+// One bit per component type attached to an entity. ForEach only visits set bits, so walking an entity's components
+// costs the number of words plus the number of attached components.
+struct ComponentMask {
+	static constexpr uint32_t WORD_COUNT = MAX_COMPONENT_TYPES / 64;
+
+	std::array<uint64_t, WORD_COUNT> words{};
+
+	void Set(const uint32_t typeID) { words[typeID / 64] |= 1ull << (typeID % 64); }
+	void Reset(const uint32_t typeID) { words[typeID / 64] &= ~(1ull << (typeID % 64)); }
+	void Clear() { words.fill(0); }
+
+	[[nodiscard]] bool Test(const uint32_t typeID) const { return (words[typeID / 64] >> (typeID % 64)) & 1ull; }
+
+	template <typename TFunc>
+	void ForEach(TFunc &&fn) const {
+		for (uint32_t word = 0; word < WORD_COUNT; ++word) {
+			for (uint64_t bits = words[word]; bits != 0; bits &= bits - 1)
+				fn(word * 64 + static_cast<uint32_t>(std::countr_zero(bits)));
+		}
+	}
+};
 }  // namespace PE::ECS
\ No newline at end of file
@@ -3,8 +3,22 @@
 #include <cstdint>
 
 namespace PE::ECS {
-using EntityID						 = uint32_t;
-constexpr uint32_t INVALID_ENTITY_ID = UINT32_MAX;
+// [generation:12 | index:20]. The index addresses component storage, the generation is bumped every time the index
+// is recycled so a handle kept past DestroyEntity no longer matches the live entity in that slot.
+using EntityID = uint32_t;
+
+constexpr uint32_t ENTITY_INDEX_BITS	  = 20;
+constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+constexpr uint32_t ENTITY_INDEX_MASK	  = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+constexpr uint32_t MAX_ENTITY_COUNT		  = ENTITY_INDEX_MASK;	// the all-ones index is never handed out
+constexpr uint32_t INVALID_ENTITY_ID	  = UINT32_MAX;
+
+constexpr uint32_t GetEntityIndex(const EntityID id) { return id & ENTITY_INDEX_MASK; }
+constexpr uint32_t GetEntityGeneration(const EntityID id) { return id >> ENTITY_INDEX_BITS; }
+constexpr EntityID MakeEntityID(const uint32_t index, const uint32_t generation) {
+	return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
 
 struct Entity {
 	bool Initialize(uint32_t);
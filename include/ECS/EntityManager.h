@@ -1,17 +1,26 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
-#include <stack>
+#include <span>
 #include <vector>
 
+#include "ArchetypeStorage.h"
+#include "CommandBuffer.h"
 #include "ComponentArray.h"
 #include "ComponentType.h"
 #include "Entity.h"
 #include "ISystem.h"
+#include "Query.h"
+#include "SystemScheduler.h"
 
 namespace PE::ECS {
+// SparseSet keeps one ComponentArray per type (GetCompArr). Archetype groups entities by signature in chunks and
+// is iterated through CreateQuery.
+enum class StorageMode : uint8_t { SparseSet, Archetype };
+
 class EntityManager {
 public:
 	EntityManager()									= default;
@@ -21,15 +30,26 @@ public:
 	EntityManager &operator=(EntityManager &&)		= delete;
 	~EntityManager()								= default;
 
-	// Initialize with maximum number of entities and component types
-	ERROR_CODE Initialize(uint32_t maxEntities, uint32_t maxComponentTypes);
+	// Initialize with the expected number of entities and component types. Both grow at runtime when exceeded.
+	ERROR_CODE Initialize(uint32_t maxEntities, uint32_t maxComponentTypes,
+						  StorageMode storageMode = StorageMode::SparseSet);
 	void	   Update(float dt);
 	ERROR_CODE Shutdown();
 
 	// Entity lifecycle
-	EntityID   CreateEntity();
-	ERROR_CODE DestroyEntity(EntityID id);
-	void	   ClearAllEntities();
+	EntityID			   CreateEntity();
+	ERROR_CODE			   DestroyEntity(EntityID id);
+	// Component removals are grouped per type, so each array swap-removes its part of the batch in one pass.
+	ERROR_CODE			   DestroyEntities(std::span<const EntityID> ids);
+	void				   ClearAllEntities();
+	[[nodiscard]] bool	   IsAlive(EntityID id) const;
+	[[nodiscard]] uint32_t GetEntityCount() const { return m_aliveCount; }
+
+	// Deferred structural changes. ReserveEntity and GetCommandBuffer are safe to call from jobs, the recorded
+	// commands are played back after the systems in Update or on FlushCommandBuffers.
+	[[nodiscard]] EntityID		 ReserveEntity();
+	[[nodiscard]] CommandBuffer &GetCommandBuffer();
+	void						 FlushCommandBuffers();
 
 	// Component registration + access
 	template <typename TIComponent>
@@ -52,39 +72,93 @@ public:
 	// System registration + update
 	ERROR_CODE RegisterSystem(ISystem *system);
 	ERROR_CODE UnregisterSystem(const ISystem *system);
+	// false runs every system on the calling thread in stage order, handy while debugging
+	void	   SetParallelUpdate(bool enabled) { m_parallelUpdate = enabled; }
 	template <class T>
 	ComponentArray<T> &GetCompArr();
+	template <typename... TIComponents>
+	Query<TIComponents...> CreateQuery();
+
+	[[nodiscard]] StorageMode GetStorageMode() const { return m_storageMode; }
 
 private:
-	SystemState			 m_state = SystemState::Uninitialized;
+	struct PlaybackEntry {
+		const CommandBuffer::Command *command;
+		uint32_t					  bufferIndex;
+	};
+
+	void ActivateEntity(EntityID id);
+	void ReleaseEntity(EntityID id);
+	void SyncCommandBufferCount();
+	void FlushPendingRemovals(uint32_t typeID);
+
+	SystemState			 m_state	   = SystemState::Uninitialized;
+	StorageMode			 m_storageMode = StorageMode::SparseSet;
 	uint32_t			 ref_maxEntities{0};
 	uint32_t			 ref_maxComponentTypes{0};
-	std::stack<EntityID> m_freeEntities;  // recycled IDs
 
-	// Flat mapping: [typeID * ref_maxEntities + entityID] -> componentIndex or UINT32_MAX
-	std::vector<uint32_t>						  m_allComponentIndices;
+	// Slot i holds the live ID of entity index i. A free slot holds the next free index and the generation it gets
+	// on reuse instead, so the free list lives in the same array and nothing is filled up front.
+	std::vector<EntityID>	   m_entities;
+	std::vector<ComponentMask> m_componentMasks;  // by entity index
+	uint32_t				   m_freeHead	= ENTITY_INDEX_MASK;
+	uint32_t				   m_aliveCount = 0;
+	// Fresh indices handed out so far. Runs ahead of m_entities while reserved entities wait for playback.
+	std::atomic<uint32_t>	   m_nextEntityIndex{0};
+
+	// One command buffer per job system worker, so recording never contends.
+	std::vector<std::unique_ptr<CommandBuffer>> m_commandBuffers;
+	std::vector<PlaybackEntry>					m_playbackScratch;
+	std::vector<EntityID>						m_destroyScratch;
+	std::vector<EntityID>						m_removeScratch;
+	std::vector<std::vector<EntityID>>			m_typeRemoveScratch;  // by type ID
+
 	std::vector<std::unique_ptr<IComponentArray>> m_componentArrays;
+	ArchetypeStorage							  m_archetypeStorage;
 
 	// Game systems (ordered by stage)
-	std::array<std::vector<ISystem *>, static_cast<size_t>(ESystemStage::Count)> m_systems;
+	SystemScheduler::StageList m_systems;
+	SystemScheduler			   m_scheduler;
+	bool					   m_isScheduleDirty = true;
+	bool					   m_parallelUpdate	 = true;
 };
 
 // Template implementations
 template <typename T>
 ComponentArray<T> &EntityManager::GetCompArr() {
 	const uint32_t typeID = ComponentType<T>::ID();
+	if (m_storageMode != StorageMode::SparseSet || typeID >= m_componentArrays.size() || !m_componentArrays[typeID]) {
+		PE_LOG_FATAL("Component arrays only exist for registered components in sparse set mode.");
+		// Hand out an empty array instead of dereferencing a missing one, callers then see no entities.
+		static ComponentArray<T> emptyArray;
+		return emptyArray;
+	}
+
 	return *static_cast<ComponentArray<T> *>(m_componentArrays[typeID].get());
 }
 
+template <typename... TIComponents>
+Query<TIComponents...> EntityManager::CreateQuery() {
+	if (m_storageMode != StorageMode::Archetype) PE_LOG_FATAL("Queries need archetype storage mode.");
+	return Query<TIComponents...>(m_archetypeStorage);
+}
+
 template <typename TIComponent>
 ERROR_CODE EntityManager::RegisterComponent(uint32_t componentCount) {
 	const uint32_t typeID = ComponentType<TIComponent>::ID();
-	if (typeID >= ref_maxComponentTypes) {
-		// TODO: Add reallocation for increased size of m_allComponentIndices
-		PE_LOG_ERROR("Too many component types. Consider increasing ref_maxComponentTypes.");
+	if (typeID >= MAX_COMPONENT_TYPES) {
+		PE_LOG_ERROR("Too many component types. Consider increasing MAX_COMPONENT_TYPES.");
 		return ERROR_CODE::MAX_COMPONENT_TYPES_REACHED;
 	}
 
+	// Nothing is sized per type and entity anymore, growing only touches the array table.
+	if (typeID >= ref_maxComponentTypes) {
+		ref_maxComponentTypes = typeID + 1;
+		m_componentArrays.resize(ref_maxComponentTypes);
+	}
+
+	if (m_storageMode == StorageMode::Archetype) return m_archetypeStorage.RegisterComponent<TIComponent>();
+
 	if (m_componentArrays[typeID]) {
 		PE_LOG_FATAL("Component is already registered!");
 		return ERROR_CODE::COMPONENT_ALREADY_REGISTERED;
@@ -112,80 +186,90 @@ ERROR_CODE EntityManager::UnregisterComponent() {
 
 	m_componentArrays[typeID]->Shutdown();
 	m_componentArrays[typeID] = nullptr;
+	for (ComponentMask &mask : m_componentMasks) mask.Reset(typeID);
 	return ERROR_CODE::OK;
 }
 
 template <typename TIComponent>
 ERROR_CODE EntityManager::AddComponent(EntityID entityID, const TIComponent &component) {
-	if (entityID >= ref_maxEntities) {
+	if (!IsAlive(entityID)) {
 		PE_LOG_FATAL("Wrong entity ID.");
 		return ERROR_CODE::WRONG_ENTITY_ID;
 	}
 
 	const uint32_t typeID = ComponentType<TIComponent>::ID();
-	auto		  &array  = static_cast<ComponentArray<TIComponent> &>(*m_componentArrays[typeID]);
-	const uint32_t idx	  = array.Add(entityID, &component);
+	ComponentMask &mask	  = m_componentMasks[GetEntityIndex(entityID)];
+	if (mask.Test(typeID)) {
+		PE_LOG_WARN("Entity already has the component.");
+		return ERROR_CODE::ENTITY_HAS_COMPONENT;
+	}
 
-	m_allComponentIndices[typeID * ref_maxEntities + entityID] = idx;
+	if (m_storageMode == StorageMode::Archetype) {
+		ERROR_CODE result;
+		PE_CHECK(result, m_archetypeStorage.Add(entityID, component));
+	} else {
+		auto &array = static_cast<ComponentArray<TIComponent> &>(*m_componentArrays[typeID]);
+		array.Add(entityID, &component);
+	}
 
+	mask.Set(typeID);
 	return ERROR_CODE::OK;
 }
 
 template <typename TIComponent>
 ERROR_CODE EntityManager::RemoveComponent(const EntityID entityID) {
-	if (entityID >= ref_maxEntities) {
+	if (!IsAlive(entityID)) {
 		PE_LOG_FATAL("Wrong entity ID.");
 		return ERROR_CODE::WRONG_ENTITY_ID;
 	}
 
 	const uint32_t typeID = ComponentType<TIComponent>::ID();
-	const int32_t  idx	  = m_allComponentIndices[typeID * ref_maxEntities + entityID];
-
-	if (idx == UINT32_MAX) {
+	ComponentMask &mask	  = m_componentMasks[GetEntityIndex(entityID)];
+	if (!mask.Test(typeID)) {
 		PE_LOG_WARN("Component ID is default value.");
 		return ERROR_CODE::COMPONENT_IS_IN_DEFAULT_STATE;
 	}
 
-	const auto [movedSlot, newPackedIdx] = m_componentArrays[typeID]->Remove(idx);
-
-	// Clear the removed entity's mapping
-	m_allComponentIndices[typeID * ref_maxEntities + entityID] = UINT32_MAX;
-
-	// Update the mapping for the moved slot/entity
-	m_allComponentIndices[typeID * ref_maxEntities + movedSlot] = newPackedIdx;
+	if (m_storageMode == StorageMode::Archetype) {
+		ERROR_CODE result;
+		PE_CHECK(result, m_archetypeStorage.Remove<TIComponent>(entityID));
+	} else {
+		m_componentArrays[typeID]->Remove(entityID);
+	}
 
+	mask.Reset(typeID);
 	return ERROR_CODE::OK;
 }
 
 template <typename TIComponent>
 TIComponent *EntityManager::GetTIComponent(const EntityID entityID) {
-	if (entityID >= ref_maxEntities) {
+	if (!IsAlive(entityID)) {
 		PE_LOG_FATAL("Wrong entity ID.");
 		return nullptr;
 	}
 
 	const uint32_t typeID = ComponentType<TIComponent>::ID();
-	const uint32_t idx	  = m_allComponentIndices[typeID * ref_maxEntities + entityID];
-
-	if (idx == UINT32_MAX) {
+	if (!m_componentMasks[GetEntityIndex(entityID)].Test(typeID)) {
 		PE_LOG_FATAL("Entity doesn't have the component.");
 		return nullptr;
 	}
 
+	if (m_storageMode == StorageMode::Archetype) return m_archetypeStorage.Get<TIComponent>(entityID);
+
 	IComponentArray *arrBase = m_componentArrays[typeID].get();
 
 	if (!arrBase) {
-		PE_LOG_FATAL("Component array pointer is null, but index map was valid!");
+		PE_LOG_FATAL("Component array pointer is null, but the entity mask was set!");
 		return nullptr;
 	}
 
-	if (!arrBase->Has(idx)) {
-		PE_LOG_FATAL("Entity idx exists, but array::Has(idx) returned false.");
+	if (!arrBase->Has(entityID)) {
+		PE_LOG_FATAL("Entity mask has the component, but array::Has(entityID) returned false.");
 		return nullptr;
 	}
 
 	auto componentArray = static_cast<ComponentArray<TIComponent> *>(arrBase);
-	return &(componentArray->Get(idx));
+	return &(componentArray->Get(entityID));
 }
 
 template <typename TIComponent>
@@ -205,12 +289,27 @@ std::tuple<TIComponents *...> EntityManager::GetTIComponents(EntityID entityID)
 
 template <typename TIComponent>
 bool EntityManager::HasComponent(const EntityID entityID) const {
-	if (entityID >= ref_maxEntities) {
+	if (!IsAlive(entityID)) {
 		PE_LOG_WARN("Wrong entity ID.");
 		return false;
 	}
 
-	const uint32_t typeID = ComponentType<TIComponent>::ID();
-	return m_allComponentIndices[typeID * ref_maxEntities + entityID] != UINT32_MAX;
+	return m_componentMasks[GetEntityIndex(entityID)].Test(ComponentType<TIComponent>::ID());
+}
+
+template <typename TIComponent>
+ERROR_CODE ComponentCommands<TIComponent>::Add(EntityManager &entityManager, const EntityID entityID,
+											   const void *component) {
+	return entityManager.AddComponent(entityID, *static_cast<const TIComponent *>(component));
+}
+
+template <typename TIComponent>
+ERROR_CODE ComponentCommands<TIComponent>::Remove(EntityManager &entityManager, const EntityID entityID) {
+	return entityManager.RemoveComponent<TIComponent>(entityID);
+}
+
+inline bool EntityManager::IsAlive(const EntityID id) const {
+	const uint32_t index = GetEntityIndex(id);
+	return index < m_entities.size() && m_entities[index] == id;
 }
 }  // namespace PE::ECS
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 #include "Common/Common.h"
 
@@ -16,6 +17,7 @@ struct IComponentArray {
 	virtual ERROR_CODE			   Shutdown()										 = 0;
 	virtual uint32_t			   Add(uint32_t entityId, void const *componentData) = 0;
 	virtual RemovalInfo			   Remove(uint32_t componentIdx)					 = 0;
+	virtual void				   RemoveBatch(std::span<const uint32_t> entityIDs)	 = 0;
 	[[nodiscard]] virtual bool	   Has(uint32_t componentIdx) const					 = 0;
 	[[nodiscard]] virtual uint32_t GetCount() const									 = 0;
 	virtual void				   Clear()											 = 0;
@@ -1,19 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <bitset>
 #include <cstdint>
 
 #include "Common/Common.h"
+#include "ComponentType.h"
 #include "Utilities/Logger.h"
 
 namespace PE::ECS {
 enum class ESystemStage {
 	EarlyUpdate = 0,
-	Transform,
-	Animation,
-	Physics,
 	SceneControl,
 	GameLogic,	// TODO: For user scripts. Make an ordering mechanism between those logics.
+	Animation,
+	Physics,
+	Transform,
 	Camera,
 	GUI,
 	Particle,
@@ -25,21 +27,43 @@ enum class ESystemStage {
 using ISystemTypeID = uint32_t;
 ISystemTypeID GenerateISystemTypeID();
 
+constexpr uint32_t MAX_SYSTEM_ACCESS_TYPES = 128;
+using SystemAccessMask					   = std::bitset<MAX_SYSTEM_ACCESS_TYPES>;
+
+// What a system touches during OnUpdate. Bits are ComponentType<T>::ID(), so shared non-component objects (e.g. the
+// renderer) can be declared by their type as well. The scheduler orders two systems only if their accesses conflict.
+struct SystemAccess {
+	SystemAccessMask reads;
+	SystemAccessMask writes;
+	bool			 exclusive	= false;  // conflicts with every other system
+	bool			 mainThread = false;  // has to run on the thread calling EntityManager::Update (GLFW, ImGui)
+};
+
 class ISystem {
 public:
 	virtual ~ISystem()					  = default;
 	virtual void	   OnUpdate(float dt) = 0;
 	virtual ERROR_CODE Shutdown()		  = 0;
 
-	[[nodiscard]] ISystemTypeID GetID() const;
-	[[nodiscard]] ESystemStage	GetStage() const;
+	[[nodiscard]] ISystemTypeID		  GetID() const;
+	[[nodiscard]] ESystemStage		  GetStage() const;
+	[[nodiscard]] const SystemAccess &GetAccess() const { return m_access; }
 	template <typename TSystem>
 	static ISystemTypeID GetUniqueISystemTypeID();
 
 protected:
+	template <typename... TComponents>
+	void DeclareReads();
+	template <typename... TComponents>
+	void DeclareWrites();
+
 	ISystemTypeID m_typeID = UINT32_MAX;
 	ESystemStage  m_stage  = ESystemStage::Count;
 	SystemState	  m_state  = SystemState::Uninitialized;
+	SystemAccess  m_access;
+
+private:
+	static void DeclareAccess(SystemAccessMask &mask, uint32_t typeID);
 };
 
 inline ISystemTypeID GenerateISystemTypeID() {
@@ -61,6 +85,24 @@ inline ESystemStage ISystem::GetStage() const {
 	return ESystemStage::Count;
 }
 
+inline void ISystem::DeclareAccess(SystemAccessMask &mask, const uint32_t typeID) {
+	if (typeID >= MAX_SYSTEM_ACCESS_TYPES) {
+		PE_LOG_FATAL("Component type ID exceeds MAX_SYSTEM_ACCESS_TYPES.");
+		return;
+	}
+	mask.set(typeID);
+}
+
+template <typename... TComponents>
+void ISystem::DeclareReads() {
+	(DeclareAccess(m_access.reads, ComponentType<TComponents>::ID()), ...);
+}
+
+template <typename... TComponents>
+void ISystem::DeclareWrites() {
+	(DeclareAccess(m_access.writes, ComponentType<TComponents>::ID()), ...);
+}
+
 template <typename TISystem>
 ISystemTypeID ISystem::GetUniqueISystemTypeID() {
 	static_assert(std::is_base_of_v<ISystem, TISystem>, "TISystem must inherit from ISystem");
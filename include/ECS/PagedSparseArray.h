@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PE::ECS {
+// Sparse side of a sparse set, split into fixed-size pages that are allocated the first time an index inside them is
+// assured. Lookups into missing pages report empty, so memory follows the indices actually used instead of the
+// highest index the engine was configured for, and there is no upper bound to resize against.
+template <typename T, uint32_t PAGE_SIZE = 1024>
+class PagedSparseArray {
+	static_assert((PAGE_SIZE & (PAGE_SIZE - 1)) == 0, "PAGE_SIZE must be a power of two");
+
+public:
+	explicit PagedSparseArray(const T &emptyValue = T{}) : m_emptyValue(emptyValue) {}
+
+	// nullptr if the page holding index was never allocated.
+	[[nodiscard]] T *Find(const uint32_t index) {
+		const uint32_t page = index / PAGE_SIZE;
+		if (page >= m_pages.size() || !m_pages[page]) return nullptr;
+		return &m_pages[page][index % PAGE_SIZE];
+	}
+
+	[[nodiscard]] const T *Find(const uint32_t index) const {
+		const uint32_t page = index / PAGE_SIZE;
+		if (page >= m_pages.size() || !m_pages[page]) return nullptr;
+		return &m_pages[page][index % PAGE_SIZE];
+	}
+
+	// Allocates the page if needed, new slots start as the empty value.
+	T &Assure(const uint32_t index) {
+		const uint32_t page = index / PAGE_SIZE;
+		if (page >= m_pages.size()) m_pages.resize(page + 1);
+		if (!m_pages[page]) {
+			m_pages[page] = std::make_unique<T[]>(PAGE_SIZE);
+			std::fill_n(m_pages[page].get(), PAGE_SIZE, m_emptyValue);
+		}
+		return m_pages[page][index % PAGE_SIZE];
+	}
+
+	[[nodiscard]] T Get(const uint32_t index) const {
+		const T *value = Find(index);
+		return value ? *value : m_emptyValue;
+	}
+
+	// Sizes the page table for indices below count without allocating any page.
+	void Reserve(const uint32_t count) { m_pages.reserve((count + PAGE_SIZE - 1) / PAGE_SIZE); }
+	void Clear() { m_pages.clear(); }
+
+	[[nodiscard]] size_t GetAllocatedPageCount() const {
+		return static_cast<size_t>(
+			std::count_if(m_pages.begin(), m_pages.end(), [](const auto &page) { return page != nullptr; }));
+	}
+	[[nodiscard]] size_t GetAllocatedBytes() const { return GetAllocatedPageCount() * PAGE_SIZE * sizeof(T); }
+
+private:
+	std::vector<std::unique_ptr<T[]>> m_pages;
+	T								  m_emptyValue;
+};
+}  // namespace PE::ECS
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "ArchetypeStorage.h"
+
+namespace PE::ECS {
+// Usage:
+//   Query<Transform, MeshRenderer> query(storage);
+//   query.ForEachChunk([](std::span<const EntityID> ids, std::span<Transform> tfs, std::span<MeshRenderer> mrs) {});
+// Matching archetypes are cached and only re-scanned when new archetypes were created.
+template <typename... TComponents>
+class Query {
+public:
+	explicit Query(ArchetypeStorage &storage) : ref_storage(&storage) {
+		(AddToSignature(ComponentType<TComponents>::ID()), ...);
+	}
+
+	// fn(std::span<const EntityID>, std::span<TComponents>...) once per non-empty chunk.
+	template <typename TFunc>
+	void ForEachChunk(TFunc &&fn) {
+		Refresh();
+		for (const uint32_t archetypeIndex : m_matches) {
+			Archetype	  &archetype  = ref_storage->GetArchetype(archetypeIndex);
+			const uint32_t chunkCount = archetype.GetChunkCount();
+			for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+				fn(archetype.GetEntities(chunk), archetype.template GetColumn<TComponents>(chunk)...);
+		}
+	}
+
+	// fn(EntityID, TComponents &...) once per matching entity.
+	template <typename TFunc>
+	void ForEach(TFunc &&fn) {
+		ForEachChunk([&fn](std::span<const EntityID> entities, std::span<TComponents>... columns) {
+			for (size_t i = 0; i < entities.size(); ++i) fn(entities[i], columns[i]...);
+		});
+	}
+
+	[[nodiscard]] uint32_t GetCount() {
+		Refresh();
+		uint32_t count = 0;
+		for (const uint32_t archetypeIndex : m_matches)
+			count += ref_storage->GetArchetype(archetypeIndex).GetEntityCount();
+		return count;
+	}
+
+private:
+	void AddToSignature(const uint32_t typeID) {
+		if (typeID >= MAX_ARCHETYPE_COMPONENT_TYPES) {
+			PE_LOG_ERROR("Component type ID doesn't fit in an archetype signature, the query matches nothing.");
+			m_isValid = false;
+			return;
+		}
+		m_signature.set(typeID);
+	}
+
+	void Refresh() {
+		if (!m_isValid) return;
+
+		const uint32_t archetypeCount = ref_storage->GetArchetypeCount();
+		for (; m_scannedArchetypes < archetypeCount; ++m_scannedArchetypes) {
+			const ComponentSignature &signature = ref_storage->GetArchetype(m_scannedArchetypes).GetSignature();
+			if ((signature & m_signature) == m_signature) m_matches.push_back(m_scannedArchetypes);
+		}
+	}
+
+	ArchetypeStorage	 *ref_storage = nullptr;
+	ComponentSignature	  m_signature;
+	std::vector<uint32_t> m_matches;
+	uint32_t			  m_scannedArchetypes = 0;
+	bool				  m_isValid			  = true;
+};
+}  // namespace PE::ECS
\ No newline at end of file
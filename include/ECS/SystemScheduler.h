@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ISystem.h"
+#include "Utilities/JobSystem.h"
+
+namespace PE::ECS {
+// Builds a dependency graph over the registered systems and runs it. An edge A -> B exists when A comes first in
+// stage order (registration order within a stage) and their declared accesses conflict, so non-conflicting systems
+// run concurrently on the job system. The serial path walks the same order on the calling thread.
+class SystemScheduler {
+public:
+	using StageList = std::array<std::vector<ISystem *>, static_cast<size_t>(ESystemStage::Count)>;
+
+	SystemScheduler()									= default;
+	SystemScheduler(const SystemScheduler &)			= delete;
+	SystemScheduler &operator=(const SystemScheduler &) = delete;
+	SystemScheduler(SystemScheduler &&)					= delete;
+	SystemScheduler &operator=(SystemScheduler &&)		= delete;
+	~SystemScheduler()									= default;
+
+	void Build(const StageList &stages);
+	void Run(float dt, bool parallel);
+	void Clear();
+
+	[[nodiscard]] static bool Conflicts(const SystemAccess &a, const SystemAccess &b);
+
+	[[nodiscard]] uint32_t GetSystemCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+	[[nodiscard]] uint32_t GetEdgeCount() const { return m_edgeCount; }
+
+private:
+	struct Node {
+		ISystem				 *system			= nullptr;
+		std::vector<uint32_t> successors;
+		uint32_t			  dependencyCount = 0;
+		bool				  mainThread	  = false;
+	};
+
+	void RunSerial(float dt);
+	void RunParallel(float dt);
+	void Dispatch(uint32_t nodeIndex, float dt, Utilities::JobCounter &counter);
+	void Execute(uint32_t nodeIndex, float dt, Utilities::JobCounter &counter);
+
+	std::vector<Node>						  m_nodes;	// in stage order
+	std::unique_ptr<std::atomic<uint32_t>[]> m_pendingDependencies;
+	std::atomic<uint32_t>					  m_remainingSystems{0};
+	std::mutex								  m_mainThreadMutex;
+	std::vector<uint32_t>					  m_mainThreadReady;
+	uint32_t								  m_edgeCount = 0;
+};
+}  // namespace PE::ECS
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 
 #include "Graphics/RenderTypes.h"
@@ -8,6 +9,10 @@ struct MeshRenderer {
 	struct SubMeshInfo {
 		MeshID	   meshID	  = INVALID_HANDLE;
 		MaterialID materialID = INVALID_HANDLE;
+		// Coarser levels of meshID by growing error. RenderSystem draws the coarsest one whose error stays under
+		// RenderConfig::lodErrorPixels on screen, bounds always come from meshID.
+		std::array<MeshLOD, MAX_MESH_LODS> lods{};
+		uint8_t							   lodCount = 0;
 	};
 
 	std::vector<SubMeshInfo> subMeshes;
@@ -31,6 +31,8 @@ public:
 
 	ERROR_CODE Shutdown() override;
 	ERROR_CODE OnResize(const RenderConfig &config) override;
+	// D3D11 has no pipeline objects to build ahead of time.
+	ERROR_CODE PrewarmPipelines() override { return ERROR_CODE::OK; }
 
 	ERROR_CODE InitGUI() override {
 		PE_LOG_FATAL("Not implemented");
@@ -85,6 +87,19 @@ public:
 		PE_LOG_ERROR("Not implemented");
 		return RenderStats();
 	}
+	void SetCullingStats(uint32_t visibleCount, uint32_t culledCount) override {}
+	bool SupportsBlockCompression() const override { return false; }
+	void RequestCapture(const std::filesystem::path &path) override { PE_LOG_ERROR("Not implemented"); }
+	// GPU profiling is only implemented by the Vulkan renderer.
+	const GPUProfile *GetGPUProfile() const override { return nullptr; }
+	// So is GPU driven culling, every submesh is submitted.
+	bool	   IsGPUDriven() const override { return false; }
+	InstanceID CreateInstance(MeshID meshID, MaterialID materialID, uint8_t renderFlags, const Math::Matrix4 &world,
+							  const Math::BoundingSphere &bounds) override {
+		return INVALID_HANDLE;
+	}
+	void UpdateInstance(InstanceID id, const Math::Matrix4 &world, const Math::BoundingSphere &bounds) override {}
+	void DestroyInstance(InstanceID id) override {}
 
 private:
 	const Core::EngineConfig *ref_engineConfig	 = nullptr;
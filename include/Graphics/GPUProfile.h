@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Common/Common.h"
+
+namespace PE::Graphics {
+// Sections of a frame the GPU profiler brackets with timestamps, in recording order.
+enum class GPUPass : uint8_t { Culling, Shadow, Forward, Particles, GUI, Count };
+constexpr size_t GPU_PASS_COUNT = static_cast<size_t>(GPUPass::Count);
+
+const char *GetGPUPassName(GPUPass pass);
+
+// Pipeline statistics of one pass, zero when the device can't query them.
+struct GPUPassStatistics {
+	uint64_t inputPrimitives	 = 0;
+	uint64_t vertexInvocations	 = 0;
+	uint64_t clippingPrimitives	 = 0;  // primitives that reached the rasterizer
+	uint64_t fragmentInvocations = 0;
+};
+
+// GPU results of one frame, read back once the frame's fence has signaled.
+struct GPUFrameTimings {
+	uint64_t									  frameIndex = 0;
+	double										  frameMs	 = 0.0;	 // first pass begin to last pass end
+	std::array<double, GPU_PASS_COUNT>			  passMs{};
+	std::array<GPUPassStatistics, GPU_PASS_COUNT> statistics{};
+};
+
+// Rolling window of the last HISTORY_SIZE frames the renderer read back.
+class GPUProfile {
+public:
+	static constexpr size_t HISTORY_SIZE = 512;
+
+	void AddFrame(const GPUFrameTimings &frame);
+	void SetHasStatistics(const bool hasStatistics) { m_hasStatistics = hasStatistics; }
+
+	[[nodiscard]] bool	 IsEmpty() const { return m_frames.empty(); }
+	[[nodiscard]] size_t GetFrameCount() const { return m_frames.size(); }
+	[[nodiscard]] bool	 HasStatistics() const { return m_hasStatistics; }
+	// Most recent frame, only valid when the profile isn't empty.
+	[[nodiscard]] const GPUFrameTimings &GetLatest() const;
+
+	// Nearest rank percentile (0 to 100) of the pass over the window, GPUPass::Count for the whole frame.
+	[[nodiscard]] double GetPercentileMs(GPUPass pass, double percentile) const;
+
+	// One row per frame in the window, oldest first.
+	ERROR_CODE WriteCSV(const std::filesystem::path &path) const;
+
+private:
+	std::vector<GPUFrameTimings> m_frames;	// ring, m_next is the oldest once it's full
+	size_t						 m_next			 = 0;
+	bool						 m_hasStatistics = false;
+};
+}  // namespace PE::Graphics
\ No newline at end of file
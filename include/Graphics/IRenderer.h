@@ -7,6 +7,7 @@
 #include "Components/ParticleEmitter.h"
 #include "Core/EngineConfig.h"
 #include "GLFW/glfw3.h"
+#include "GPUProfile.h"
 #include "Material.h"
 #include "RenderTypes.h"
 
@@ -18,10 +19,22 @@ struct GLFWwindow;
 
 namespace PE::Graphics {
 struct RenderStats {
-	uint32_t vertexCount   = 0;
-	uint32_t indexCount	   = 0;
-	uint32_t triangleCount = 0;
-	uint32_t drawCalls	   = 0;
+	uint32_t vertexCount	 = 0;
+	uint32_t indexCount		 = 0;
+	uint32_t triangleCount	 = 0;
+	uint32_t drawCalls		 = 0;
+	uint32_t shadowDrawCalls = 0;  // part of drawCalls spent on shadow cascades
+	uint32_t visibleObjects	 = 0;  // submeshes that passed frustum culling
+	uint32_t culledObjects	 = 0;
+
+	// Device memory, in bytes. Reserved is what the driver handed out, used and free split it.
+	uint64_t gpuMemoryReserved	 = 0;
+	uint64_t gpuMemoryUsed		 = 0;
+	uint64_t gpuMemoryFree		 = 0;
+	uint64_t gpuMemoryFragmented = 0;  // free bytes a large allocation can't use
+	uint32_t gpuMemoryBlocks	 = 0;
+	uint32_t gpuAllocations		 = 0;
+	uint32_t gpuDedicated		 = 0;
 };
 
 /**
@@ -39,6 +52,9 @@ public:
 	virtual ERROR_CODE Shutdown()															  = 0;
 	virtual ERROR_CODE OnResize(const RenderConfig &config)									  = 0;
 
+	// Builds the pipelines the loaded materials need up front, so the first frame that draws them doesn't stall.
+	virtual ERROR_CODE PrewarmPipelines() = 0;
+
 	virtual ERROR_CODE InitGUI()	 = 0;
 	virtual void	   NewFrameGUI() = 0;
 	virtual void	   ShutdownGUI() = 0;
@@ -60,6 +76,26 @@ public:
 	[[nodiscard]] virtual Material &GetMaterial(MaterialID id) = 0;
 
 	[[nodiscard]] virtual RenderStats GetStats() const = 0;
+	// Culling happens before submission, so the RenderSystem reports its counts once the frame is flushed.
+	virtual void SetCullingStats(uint32_t visibleCount, uint32_t culledCount) = 0;
+	// Whether textures can be uploaded in the BC formats of Processing::Compress.
+	[[nodiscard]] virtual bool SupportsBlockCompression() const = 0;
+	// Writes the next flushed frame to path, as PNG or PPM by its extension. Only the offscreen target of headless
+	// runs can be read back.
+	virtual void RequestCapture(const std::filesystem::path &path) = 0;
+	// GPU time and pipeline statistics of each pass over the last frames, nullptr when the backend can't profile.
+	[[nodiscard]] virtual const GPUProfile *GetGPUProfile() const = 0;
+
+	// GPU driven culling keeps an instance per opaque submesh on the GPU instead of submitting it every frame, and
+	// culls and batches the instances there. Only available when RenderConfig::gpuDrivenCulling is set and the device
+	// supports it.
+	[[nodiscard]] virtual bool IsGPUDriven() const = 0;
+	// renderFlags and bounds as in RenderCommand. INVALID_HANDLE when the instance doesn't fit, submit it instead.
+	virtual InstanceID CreateInstance(MeshID meshID, MaterialID materialID, uint8_t renderFlags,
+									  const Math::Matrix4 &world, const Math::BoundingSphere &bounds) = 0;
+	// Instances keep their flags, only the transform changes.
+	virtual void UpdateInstance(InstanceID id, const Math::Matrix4 &world, const Math::BoundingSphere &bounds) = 0;
+	virtual void DestroyInstance(InstanceID id)																   = 0;
 
 private:
 	virtual TextureID  CreateTexture(const std::string &name, const unsigned char *data,
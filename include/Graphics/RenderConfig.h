@@ -6,13 +6,16 @@ enum class SupportedGraphicAPI { None, D3D11, Vulkan };
 
 enum class RenderPathType { Forward, Deferred };
 
+constexpr uint32_t MAX_SHADOW_CASCADES = 4;
+
 struct RenderConfig {
 	SupportedGraphicAPI graphicAPI		  = SupportedGraphicAPI::Vulkan;
 	RenderPathType		renderPath		  = RenderPathType::Forward;
 	bool				enableVSync		  = false;
 	bool				enable4xMSAA	  = true;
+	bool				compressTextures  = true;	// block-compress textures at load when the device supports it
+	bool				gpuDrivenCulling  = false;	// cull opaque meshes and build their draws in a compute pass
 	uint8_t				maxFramesInFlight = 2;
-	uint8_t				maxMaterialCount  = 32;
 	uint8_t				msaaCount		  = 4;
 	// Mutable because those can change afterward
 	mutable uint8_t	 maxMsaaQuality			  = 0;
@@ -20,6 +23,19 @@ struct RenderConfig {
 	mutable uint16_t height					  = 1080;
 	uint16_t		 maxCameraCount			  = 3;
 	uint16_t		 maxDirectionalLightCount = 1;
+	uint16_t		 maxMaterialCount		  = 4096;  // records in the bindless material buffer
+	uint16_t		 maxBindlessTextures	  = 4096;  // texture and sampler pairs in the bindless texture array
 	uint32_t		 maxParticlesPerFrame	  = 50000;
+	float			 lodErrorPixels			  = 1.0f;  // screen space error a mesh LOD may show, 0 draws full detail
+
+	// Cascaded shadow map of the directional light, every cascade gets its own square layer.
+	uint8_t	 shadowCascadeCount	 = 4;  // 1 to MAX_SHADOW_CASCADES
+	uint16_t shadowMapResolution = 2048;
+	float	 shadowDistance		 = 150.0f;	// camera view depth the last cascade ends at
+	float	 shadowSplitLambda	 = 0.75f;	// 0 splits the distance evenly, 1 logarithmically
+
+	// Buffers of the GPU driven path, only created with gpuDrivenCulling.
+	uint32_t maxGPUInstances	   = 1 << 19;  // submesh instances the culling buffers hold
+	uint16_t maxIndirectDrawGroups = 4096;	   // mesh and material pairs, one indirect draw each per view
 };
 }  // namespace PE::Graphics
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphics/RenderTypes.h"
+
+namespace PE::Graphics {
+// Render commands in submission order plus a sorted draw order over them. Sorting moves 16 byte (key, index) entries
+// with an 11-bit LSD radix sort instead of swapping whole commands, and the command index doubles as the slot of the
+// command's per-object data, so nothing has to be reordered to match.
+//
+// Opaque commands follow RenderKey order (layer, shader, material, then front to back). Commands flagged
+// RenderFlag_ForceTransparent can't be grouped by state without breaking blending, they come after all opaque ones
+// ordered by layer and then back to front.
+class RenderQueue {
+public:
+	struct SortEntry {
+		uint64_t key;
+		uint32_t index;	 // into GetCommands()
+	};
+
+	void Submit(const RenderCommand &command);
+	// Splits the radix passes across the job system for large queues when it is running.
+	void Sort();
+	void Clear();
+
+	[[nodiscard]] const std::vector<RenderCommand> &GetCommands() const { return m_commands; }
+	// Valid after Sort: opaque entries followed by transparent ones.
+	[[nodiscard]] std::span<const SortEntry> GetSorted() const { return m_sorted; }
+	[[nodiscard]] std::span<const SortEntry> GetOpaque() const { return GetSorted().first(m_opaque.size()); }
+	[[nodiscard]] std::span<const SortEntry> GetTransparent() const { return GetSorted().subspan(m_opaque.size()); }
+	[[nodiscard]] size_t					 Size() const { return m_commands.size(); }
+	[[nodiscard]] bool						 IsEmpty() const { return m_commands.empty(); }
+
+private:
+	void RadixSort(std::vector<SortEntry> &entries);
+
+	std::vector<RenderCommand> m_commands;
+	std::vector<SortEntry>	   m_opaque;
+	std::vector<SortEntry>	   m_transparent;
+	std::vector<SortEntry>	   m_sorted;
+	std::vector<SortEntry>	   m_scratch;
+	std::vector<uint32_t>	   m_histograms;  // RADIX_SIZE counters per chunk
+};
+}  // namespace PE::Graphics
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <cstdint>
 
 #include "ECS/Entity.h"
+#include "Graphics/RenderConfig.h"
+#include "Math/Bounds.h"
 #include "Math/Math.h"
 #include "Utilities/EnumReflection.h"
 #include "Vertex.h"
@@ -19,18 +21,29 @@ using MaterialID	 = uint32_t;
 using MeshID		 = uint32_t;
 using RenderTargetID = uint32_t;
 using SamplerID		 = uint32_t;
+using InstanceID	 = uint32_t;
 
 constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
 
 enum class RenderPass : uint8_t { GBuffer = 0, Shadow = 1, Lighting = 2, Forward = 3, UI = 4 };
 
+// layer:4 | shader:12 | material:16 | mesh:16 | depth:16. The mesh sits above depth so draws of one mesh with one
+// material end up next to each other and the renderer can merge them into a single instanced draw.
 struct RenderKey {
 	uint64_t value;
 
-	static uint64_t Create(const uint8_t layer, const ShaderID shaderID, const MaterialID matID, const uint32_t depth) {
+	static uint64_t Create(const uint8_t layer, const ShaderID shaderID, const MaterialID matID, const MeshID meshID,
+						   const uint16_t depth) {
 		return (static_cast<uint64_t>(layer) << 60) | ((static_cast<uint64_t>(shaderID) & 0xFFF) << 48) |
-			   ((static_cast<uint64_t>(matID) & 0xFFFF) << 32) | (depth & 0xFFFFFFFF);
+			   ((static_cast<uint64_t>(matID) & 0xFFFF) << 32) | ((static_cast<uint64_t>(meshID) & 0xFFFF) << 16) |
+			   depth;
 	}
+
+	static uint8_t	GetLayer(const uint64_t key) { return static_cast<uint8_t>(key >> 60); }
+	static uint32_t GetShader(const uint64_t key) { return static_cast<uint32_t>((key >> 48) & 0xFFF); }
+	static uint32_t GetMaterial(const uint64_t key) { return static_cast<uint32_t>((key >> 32) & 0xFFFF); }
+	static uint32_t GetMesh(const uint64_t key) { return static_cast<uint32_t>((key >> 16) & 0xFFFF); }
+	static uint16_t GetDepth(const uint64_t key) { return static_cast<uint16_t>(key & 0xFFFF); }
 };
 
 // TODO: Make enum class
@@ -39,7 +52,8 @@ enum RenderFlags : uint8_t {
 	RenderFlag_Visible			= 1 << 0,
 	RenderFlag_CastShadows		= 1 << 1,
 	RenderFlag_ReceiveShadows	= 1 << 2,
-	RenderFlag_ForceTransparent = 1 << 3
+	RenderFlag_ForceTransparent = 1 << 3,
+	RenderFlag_Culled			= 1 << 4  // outside the camera frustum, only drawn into the shadow map
 };
 
 struct RenderCommand {
@@ -49,6 +63,9 @@ struct RenderCommand {
 	Math::Matrix4 worldMatrix{};
 	uint32_t	  ownerEntityID = ECS::INVALID_ENTITY_ID;
 	uint8_t		  flags			= RenderFlag_None;
+
+	// World space bounds, shadow cascades cull their casters with them.
+	Math::BoundingSphere bounds;
 };
 
 enum class PrimitiveType { Box, Sphere, Geosphere, Cylinder, Grid, Quad, FullscreenQuad, DesertMesh };
@@ -58,6 +75,15 @@ struct MeshData {
 	std::vector<uint32_t> Indices;
 };
 
+// Coarser levels a submesh carries besides its full detail mesh.
+constexpr uint32_t MAX_MESH_LODS = 3;
+
+// A simplified level of a mesh. error is how far it strays from the full detail mesh, in object space units.
+struct MeshLOD {
+	MeshID meshID = INVALID_HANDLE;
+	float  error  = 0.0f;
+};
+
 enum class TextureType : uint8_t {
 	Albedo,
 	Normal,
@@ -91,15 +117,27 @@ static inline constexpr std::array<Utilities::EnumEntry<TextureType>, static_cas
 				  {"Generic_0", TextureType::Generic_0},
 				  {"Generic_1", TextureType::Generic_1}}};
 
+// How texture data is encoded. None is RGBA8, the others are 4x4 block formats.
+enum class TextureCompression : uint8_t {
+	None,
+	BC1,  // RGB, 8 bytes per block
+	BC3,  // RGBA, 16 bytes per block
+	BC4,  // R, 8 bytes per block
+	BC5,  // RG, 16 bytes per block
+	BC7,  // RGBA, 16 bytes per block
+	Count
+};
+
 struct TextureParameters {
-	TextureType type		= TextureType::Albedo;
-	uint16_t	width		= 1;
-	uint16_t	height		= 1;
-	uint8_t		depth		= 32;
-	uint8_t		mipLevels	= 1;
-	uint8_t		arrayLayers = 1;
-	uint8_t		samples		= 1;
-	bool		isCubemap	= false;
+	TextureType		   type		   = TextureType::Albedo;
+	uint16_t		   width	   = 1;
+	uint16_t		   height	   = 1;
+	uint8_t			   depth	   = 32;
+	uint8_t			   mipLevels   = 1;
+	uint8_t			   arrayLayers = 1;
+	uint8_t			   samples	   = 1;
+	bool			   isCubemap   = false;
+	TextureCompression compression = TextureCompression::None;
 
 	union {
 #ifdef PE_D3D11
@@ -222,11 +260,18 @@ struct alignas(16) CBPerPass {
 	Math::Vector4 lightDirection;
 	Math::Vector4 ambientLightColor;
 
-	Math::Matrix4 lightSpaceMatrix;
+	// Directional light shadow cascades, cascadeSplits[i] is the camera view depth cascade i ends at.
+	Math::Matrix4 cascadeMatrices[MAX_SHADOW_CASCADES];
+	Math::Vector4 cascadeSplits;
+	uint32_t	  cascadeCount;
+	float		  _pad1[3];
 };
 
 struct alignas(16) CBPerObject {
 	Math::Matrix4 world;
+	// VertexQuantization of the mesh, vertex shaders decode positions with it.
+	Math::Vector4 positionScale;
+	Math::Vector4 positionOffset;
 };
 
 struct alignas(16) CBMaterial_Lit {
@@ -19,7 +19,7 @@ public:
 		return id;
 	}
 
-	bool Has(uint32_t id) {
+	bool Has(uint32_t id) const {
 		if (id >= m_data.size()) {
 			return false;
 		}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Graphics/RenderConfig.h"
+#include "Math/Bounds.h"
+
+namespace PE::Graphics {
+// One slice of the camera frustum as seen by the directional light. The slice is wrapped in a sphere, so the cascade
+// keeps its size while the camera turns and only its texel snapped center moves.
+struct ShadowCascade {
+	Math::Matrix4 lightView;	   // world to light space rotation, the same for every cascade
+	Math::Matrix4 viewProjection;  // world to cascade clip space
+	Math::Vector3 center;		   // light space, snapped to whole texels
+	float		  radius	 = 0.0f;
+	float		  splitDepth = 0.0f;  // camera view depth the cascade ends at
+};
+
+// Splits the camera frustum up to config.shadowDistance into config.shadowCascadeCount slices, blending uniform and
+// logarithmic split depths by config.shadowSplitLambda, and fits a cascade around each. lightDirection points from
+// the light into the scene. Returns how many cascades were written.
+uint32_t FitShadowCascades(const Math::Matrix4 &view, const Math::Matrix4 &projection,
+						   const Math::Vector3 &lightDirection, const RenderConfig &config,
+						   std::span<ShadowCascade, MAX_SHADOW_CASCADES> outCascades);
+
+// Tests caster bounds against the cascade. The test volume is open towards the light, a caster in front of the cascade
+// still throws its shadow into it. visible[i] is 1 if caster i reaches the cascade and 0 otherwise. The near plane of
+// viewProjection is then pulled back to the closest visible caster, at most maxCasterDistance in front of the cascade.
+// Returns the number of visible casters.
+size_t CullShadowCasters(ShadowCascade &cascade, const float *centerX, const float *centerY, const float *centerZ,
+						 const float *radius, size_t count, float maxCasterDistance, uint8_t *visible);
+
+// The volume CullShadowCasters tests, for culling that happens elsewhere. The closest caster isn't known here, so the
+// near plane of viewProjection is pulled back the whole maxCasterDistance.
+Math::Frustum GetShadowCasterFrustum(ShadowCascade &cascade, float maxCasterDistance);
+}  // namespace PE::Graphics
\ No newline at end of file
@@ -14,7 +14,8 @@ public:
 	~GUISystem() override = default;
 
 	ERROR_CODE Initialize(ECS::ESystemStage stage, ECS::EntityManager *entityManager,
-						  Scene::Systems::SceneControlSystem *sceneControlSystem, IRenderer *renderer);
+						  Scene::Systems::SceneControlSystem *sceneControlSystem,
+						  Scene::Systems::TransformSystem *transformSystem, IRenderer *renderer);
 	ERROR_CODE Shutdown() override;
 	void	   OnUpdate(float dt) override;
 	void	   ToggleGUI();
@@ -23,6 +24,8 @@ private:
 	void Render() const;
 
 	void DrawPerformanceStats(float dt);
+	// Per-pass GPU times of the renderer's profiler, part of the performance stats window.
+	void DrawGPUProfile();
 	void DrawHierarchy();
 	void DrawInspector();
 	void DrawAssetBrowser();
@@ -30,8 +33,9 @@ private:
 	void DrawEntityNodeRecursive(uint32_t													entityID,
 								 const std::unordered_map<uint32_t, std::vector<uint32_t>> &childrenMap);
 
-	ECS::EntityManager *ref_eM		 = nullptr;
-	IRenderer		   *ref_renderer = nullptr;
+	ECS::EntityManager				*ref_eM				 = nullptr;
+	Scene::Systems::TransformSystem *ref_transformSystem = nullptr;
+	IRenderer						*ref_renderer		 = nullptr;
 
 	Utilities::Timer *m_fpsTimer	   = nullptr;
 	bool			  m_shouldRender   = true;
@@ -1,10 +1,16 @@
 #pragma once
+#include <vector>
+
 #include "../../ECS/ISystem.h"
 #include "CameraSystem.h"
 #include "ECS/EntityManager.h"
+#include "ECS/PagedSparseArray.h"
+#include "Graphics/Components/MeshRenderer.h"
 #include "Graphics/IRenderer.h"
 #include "Graphics/RenderConfig.h"
 #include "Graphics/Vulkan/VulkanRenderer.h"
+#include "Math/Bounds.h"
+#include "Scene/Systems/TransformSystem.h"
 
 namespace PE::Graphics::Systems {
 class RenderSystem : public ECS::ISystem {
@@ -16,8 +22,10 @@ public:
 	RenderSystem &operator=(RenderSystem &&)	  = delete;
 	~RenderSystem() override					  = default;
 
+	// transformSystem reports which GPU driven instances moved, see SyncGPUEntity.
 	ERROR_CODE Initialize(ECS::ESystemStage stage, ECS::EntityManager *entityManager, CameraSystem *cameraSystem,
-						  GLFWwindow *window, Core::EngineConfig &config);
+						  Scene::Systems::TransformSystem *transformSystem, GLFWwindow *window,
+						  Core::EngineConfig &config);
 	ERROR_CODE Shutdown() override;
 
 	void OnUpdate(float dt) override;
@@ -31,14 +39,51 @@ public:
 	[[nodiscard]] IRenderer *GetRenderer() const { return m_renderer; }
 
 private:
+	// Renderer instances of an entity on the GPU driven path, one per submesh. flags and subMeshCount are what they
+	// were created from, instances is empty while the entity is submitted instead.
+	struct GPUEntity {
+		ECS::EntityID			entityID	 = ECS::INVALID_ENTITY_ID;
+		uint8_t					flags		 = RenderFlag_None;
+		uint32_t				subMeshCount = 0;
+		std::vector<InstanceID> instances;
+	};
+
 	ERROR_CODE InitializeRenderer(GLFWwindow *window, const Core::EngineConfig &config);
+	void	   CacheMeshBounds(MeshID meshID);
+	[[nodiscard]] const Math::BoundingSphere &GetMeshSphere(MeshID meshID) const;
+
+	// Creates the entity's instances the first time it is seen and again when its flags or submesh count change.
+	// Returns true if the instances draw it, false if it has to be submitted. Swapping a submesh's mesh or material
+	// in place isn't picked up. Instances draw the full detail meshes, LODs are only picked for submitted entities.
+	bool	   SyncGPUEntity(ECS::EntityID entityID, const Components::MeshRenderer &meshRenderer,
+							 const Math::Matrix4 &world);
+	void	   RemoveGPUEntity(ECS::EntityID entityID);
+	void	   ReleaseGPUInstances(GPUEntity &entity);
+	GPUEntity *FindGPUEntity(ECS::EntityID entityID);
+
+	ECS::EntityManager				*ref_entityManager	 = nullptr;
+	CameraSystem					*ref_cameraSystem	 = nullptr;
+	Scene::Systems::TransformSystem	*ref_transformSystem = nullptr;
+	Core::EngineConfig				*ref_engineConfig;
+	RenderConfig					*ref_renderConfig;
+	ECS::EntityID					 ref_activeCamEntityID = UINT32_MAX;
+	RenderPathType					 m_currentPathType;
+	IRenderer						*m_renderer	= nullptr;
+
+	// Reused every frame by the command build, m_commandOffsets[i] is the first command of the i-th MeshRenderer.
+	std::vector<RenderCommand> m_commandScratch;
+	std::vector<uint32_t>	   m_commandOffsets;
+
+	// World space bounding spheres of the commands above, split per component for the SIMD culling pass.
+	std::vector<float>				  m_sphereX;
+	std::vector<float>				  m_sphereY;
+	std::vector<float>				  m_sphereZ;
+	std::vector<float>				  m_sphereRadius;
+	std::vector<uint8_t>			  m_commandVisible;
+	std::vector<Math::BoundingSphere> m_meshSpheres;  // object space bounds by MeshID, radius < 0 if not cached yet
 
-	ECS::EntityManager *ref_entityManager = nullptr;
-	CameraSystem	   *ref_cameraSystem  = nullptr;
-	Core::EngineConfig *ref_engineConfig;
-	RenderConfig	   *ref_renderConfig;
-	ECS::EntityID		ref_activeCamEntityID = UINT32_MAX;
-	RenderPathType		m_currentPathType;
-	IRenderer		   *m_renderer = nullptr;
+	// Entities the GPU driven path has seen, packed. m_gpuEntitySlots maps an entity index to its record.
+	std::vector<GPUEntity>			m_gpuEntities;
+	ECS::PagedSparseArray<uint32_t> m_gpuEntitySlots{UINT32_MAX};
 };
 }  // namespace PE::Graphics::Systems
\ No newline at end of file
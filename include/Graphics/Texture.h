@@ -1,9 +1,42 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 
 #include "RenderTypes.h"
 
 namespace PE::Graphics {
+// Bytes per 4x4 block, 0 for uncompressed data.
+[[nodiscard]] inline uint32_t GetBlockSize(const TextureCompression compression) {
+	switch (compression) {
+		case TextureCompression::BC1:
+		case TextureCompression::BC4: return 8;
+		case TextureCompression::BC3:
+		case TextureCompression::BC5:
+		case TextureCompression::BC7: return 16;
+		default: return 0;
+	}
+}
+
+[[nodiscard]] inline uint32_t GetMipExtent(const uint32_t extent, const uint32_t level) {
+	return std::max(extent >> level, 1u);
+}
+
+// Bytes of one layer of a mip level. Block compressed levels are rounded up to whole blocks.
+[[nodiscard]] inline size_t GetMipLevelSize(const TextureParameters &params, const uint32_t level) {
+	const size_t width	= GetMipExtent(params.width, level);
+	const size_t height = GetMipExtent(params.height, level);
+	if (const uint32_t blockSize = GetBlockSize(params.compression); blockSize > 0)
+		return ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+	return width * height * 4;
+}
+
+// Texture data holds the mip levels in order, with the layers of each level back to back.
+[[nodiscard]] inline size_t GetTextureDataSize(const TextureParameters &params) {
+	size_t size = 0;
+	for (uint32_t level = 0; level < params.mipLevels; ++level) size += GetMipLevelSize(params, level);
+	return size * params.arrayLayers;
+}
+
 class Texture {
 public:
 	Texture() = default;
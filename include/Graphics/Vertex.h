@@ -1,5 +1,8 @@
 #pragma once
 #include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 #include "Math/Math.h"
 
@@ -17,12 +20,22 @@ struct Vertex {
 	Math::Vector3 Normal{};
 	Math::Vector3 Tangent{};
 	Math::Vector2 TexC{};
+};
+
+// Layout the Vulkan renderer stores meshes in, 20 bytes to the 44 of Vertex. Positions are unorm16 within the bounds of
+// their mesh and go back to object space through its VertexQuantization, normals and tangents are octahedral snorm16
+// and UVs half floats.
+struct PackedVertex {
+	uint16_t Position[4]{};	 // w is unused, three component 16-bit formats are optional for vertex input
+	int16_t	 Normal[2]{};
+	int16_t	 Tangent[2]{};
+	uint16_t TexC[2]{};
 
 #ifdef PE_VULKAN
 	static VkVertexInputBindingDescription GetBindingDescription() {
 		constexpr VkVertexInputBindingDescription bindingDescription{
 			.binding   = 0,
-			.stride	   = sizeof(Vertex),
+			.stride	   = sizeof(PackedVertex),
 			.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
 		};
 		return bindingDescription;
@@ -33,23 +46,23 @@ struct Vertex {
 
 		attributeDescriptions[0].binding  = 0;
 		attributeDescriptions[0].location = 0;
-		attributeDescriptions[0].format	  = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[0].offset	  = offsetof(Vertex, Position);
+		attributeDescriptions[0].format	  = VK_FORMAT_R16G16B16A16_UNORM;
+		attributeDescriptions[0].offset	  = offsetof(PackedVertex, Position);
 
 		attributeDescriptions[1].binding  = 0;
 		attributeDescriptions[1].location = 1;
-		attributeDescriptions[1].format	  = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[1].offset	  = offsetof(Vertex, Normal);
+		attributeDescriptions[1].format	  = VK_FORMAT_R16G16_SNORM;
+		attributeDescriptions[1].offset	  = offsetof(PackedVertex, Normal);
 
 		attributeDescriptions[2].binding  = 0;
 		attributeDescriptions[2].location = 2;
-		attributeDescriptions[2].format	  = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[2].offset	  = offsetof(Vertex, Tangent);
+		attributeDescriptions[2].format	  = VK_FORMAT_R16G16_SNORM;
+		attributeDescriptions[2].offset	  = offsetof(PackedVertex, Tangent);
 
 		attributeDescriptions[3].binding  = 0;
 		attributeDescriptions[3].location = 3;
-		attributeDescriptions[3].format	  = VK_FORMAT_R32G32_SFLOAT;
-		attributeDescriptions[3].offset	  = offsetof(Vertex, TexC);
+		attributeDescriptions[3].format	  = VK_FORMAT_R16G16_SFLOAT;
+		attributeDescriptions[3].offset	  = offsetof(PackedVertex, TexC);
 
 		return attributeDescriptions;
 	}
@@ -59,16 +72,25 @@ struct Vertex {
 
 		attributeDescriptions[0].binding  = 0;
 		attributeDescriptions[0].location = 0;
-		attributeDescriptions[0].format	  = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[0].offset	  = offsetof(Vertex, Position);
+		attributeDescriptions[0].format	  = VK_FORMAT_R16G16B16A16_UNORM;
+		attributeDescriptions[0].offset	  = offsetof(PackedVertex, Position);
 
 		attributeDescriptions[1].binding  = 0;
 		attributeDescriptions[1].location = 1;
-		attributeDescriptions[1].format	  = VK_FORMAT_R32G32_SFLOAT;
-		attributeDescriptions[1].offset	  = offsetof(Vertex, TexC);
+		attributeDescriptions[1].format	  = VK_FORMAT_R16G16_SFLOAT;
+		attributeDescriptions[1].offset	  = offsetof(PackedVertex, TexC);
 
 		return attributeDescriptions;
 	}
 #endif
 };
+
+// Maps the positions of a mesh's PackedVertices back to object space, position = packed * scale + offset.
+struct VertexQuantization {
+	Math::Vector3 scale{1.0f};
+	Math::Vector3 offset{0.0f};
+};
+
+// Packs vertices for upload and returns the quantization their positions were stored with.
+VertexQuantization PackVertices(std::span<const Vertex> vertices, std::vector<PackedVertex> &outVertices);
 }  // namespace PE::Graphics
\ No newline at end of file
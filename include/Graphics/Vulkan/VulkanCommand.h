@@ -1,9 +1,11 @@
 #pragma once
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <vector>
 
 #include "Common/Common.h"
+#include "Graphics/RenderConfig.h"
 
 namespace PE::Graphics::Vulkan {
 class VulkanDevice;
@@ -16,19 +18,38 @@ public:
 	VulkanCommand(VulkanCommand &&)					= delete;
 	VulkanCommand &operator=(VulkanCommand &&)		= delete;
 	~VulkanCommand()								= default;
-	ERROR_CODE Initialize(VulkanDevice *device, uint32_t framesInFlight);
+	// recordingSlots is how many threads may record secondary buffers at once, every slot gets its own pools.
+	ERROR_CODE Initialize(VulkanDevice *device, uint32_t framesInFlight, uint32_t recordingSlots = 1);
 	void	   Shutdown();
 
 	ERROR_CODE CreateCommandPool();
 	ERROR_CODE CreateCommandBuffers(uint32_t frames);
+	ERROR_CODE CreateSecondaryCommandBuffers(uint32_t frames, uint32_t recordingSlots);
 
 	[[nodiscard]] VkCommandPool	  GetCommandPool() const { return m_commandPool; }
 	[[nodiscard]] VkCommandBuffer GetCommandBuffer(uint32_t index) const { return m_commandBuffers[index]; }
 
+	// A slot's pool is only touched by the thread recording that slot, so recording needs no locking. The frame's
+	// pools are reset together once its fence has signaled.
+	[[nodiscard]] VkCommandBuffer GetSecondaryCommandBuffer(uint32_t frame, uint32_t slot, uint32_t buffer) const;
+	[[nodiscard]] uint32_t		  GetRecordingSlotCount() const { return m_recordingSlots; }
+	void						  ResetSecondaryCommandBuffers(uint32_t frame);
+
+	// Secondary buffers every slot has per frame, one for each pass that is recorded in parallel: every shadow cascade
+	// and the main pass.
+	static constexpr uint32_t SECONDARY_BUFFERS_PER_SLOT = MAX_SHADOW_CASCADES + 1;
+
 private:
+	struct SecondaryPool {
+		VkCommandPool											pool = VK_NULL_HANDLE;
+		std::array<VkCommandBuffer, SECONDARY_BUFFERS_PER_SLOT>	buffers{};
+	};
+
 	SystemState					 m_state	   = SystemState::Uninitialized;
 	VulkanDevice				*ref_device	   = nullptr;
 	VkCommandPool				 m_commandPool = VK_NULL_HANDLE;
 	std::vector<VkCommandBuffer> m_commandBuffers;
+	std::vector<SecondaryPool>	 m_secondaryPools;	// frame major, m_recordingSlots per frame
+	uint32_t					 m_recordingSlots = 0;
 };
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <span>
 #include <vector>
 
 #include "Common/Common.h"
@@ -17,6 +18,9 @@ class VulkanDevice {
 	struct QueueFamilyIndices {
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
+		// Family uploads are submitted to. A transfer-only family when the device has one, the graphics family
+		// otherwise.
+		std::optional<uint32_t> transferFamily;
 		[[nodiscard]] bool		IsComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
 	};
 
@@ -36,7 +40,11 @@ public:
 	[[nodiscard]] VkSurfaceKHR				GetSurface() const { return m_surface; }
 	[[nodiscard]] VkQueue					GetGraphicsQueue() const { return m_graphicsQueue; }
 	[[nodiscard]] VkQueue					GetPresentQueue() const { return m_presentQueue; }
+	[[nodiscard]] VkQueue					GetTransferQueue() const { return m_transferQueue; }
 	[[nodiscard]] const QueueFamilyIndices &GetQueueFamilies() const { return m_indices; }
+	[[nodiscard]] bool						SupportsBlockCompression() const { return m_supportsBlockCompression; }
+	[[nodiscard]] bool						SupportsPipelineStatistics() const { return m_supportsPipelineStatistics; }
+	[[nodiscard]] bool						SupportsGPUCulling() const { return m_supportsGPUCulling; }
 
 	uint32_t				FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 	SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice physicalDevice);
@@ -52,10 +60,12 @@ private:
 	uint32_t		   RateDeviceSuitability(VkPhysicalDevice physicalDevice);
 	bool			   CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice);
 	QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice physicalDevice);
+	uint32_t		   FindTransferFamily(VkPhysicalDevice physicalDevice, uint32_t graphicsFamily);
 
-	[[nodiscard]] bool						CheckValidationLayerSupport() const;
-	[[nodiscard]] std::vector<const char *> GetRequiredExtensions() const;
-	void									LogEverySupportedExtensions();
+	[[nodiscard]] bool						   CheckValidationLayerSupport() const;
+	[[nodiscard]] std::vector<const char *>	   GetRequiredExtensions() const;
+	[[nodiscard]] std::span<const char *const> GetDeviceExtensions() const;
+	void									   LogEverySupportedExtensions();
 	void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
 
 	static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT		messageSeverity,
@@ -74,7 +84,11 @@ private:
 
 	VkQueue			   m_graphicsQueue = VK_NULL_HANDLE;
 	VkQueue			   m_presentQueue  = VK_NULL_HANDLE;
+	VkQueue			   m_transferQueue = VK_NULL_HANDLE;
 	QueueFamilyIndices m_indices;
+	bool			   m_supportsBlockCompression	= false;
+	bool			   m_supportsPipelineStatistics = false;
+	bool			   m_supportsGPUCulling			= false;
 
 #ifdef NDEBUG
 	const bool m_enableValidationLayers = false;
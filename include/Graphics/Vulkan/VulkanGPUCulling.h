@@ -0,0 +1,163 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Graphics/RenderConfig.h"
+#include "Graphics/RenderTypes.h"
+#include "Graphics/Vulkan/VulkanBuffer.h"
+#include "Graphics/Vulkan/VulkanTypes.h"
+#include "Math/Bounds.h"
+
+namespace PE::Graphics::Vulkan {
+class VulkanDevice;
+
+// GPU driven path for opaque submeshes. Instances keep their world matrix and bounds in device local buffers that are
+// only written when they change, so a frame records the same few commands for a thousand instances as for half a
+// million. Each frame a compute pass tests every instance against the camera and shadow cascade frustums, appends the
+// visible ones to the list of their draw group, one group per mesh and material, and compacts the groups that saw
+// anything into VkDrawIndexedIndirectCommands. Vertex shaders find their world matrix through that list.
+class VulkanGPUCulling {
+public:
+	// View 0 is the camera, view 1 + c shadow cascade c.
+	static constexpr uint32_t MAX_VIEWS = 1 + MAX_SHADOW_CASCADES;
+
+	// Camera draws of one material, recorded as a single indirect count draw.
+	struct Bucket {
+		MaterialID materialID	= INVALID_HANDLE;
+		uint32_t   firstCommand = 0;
+		uint32_t   groupCount	= 0;
+	};
+
+	// Index range a draw group draws, known once its mesh is uploaded.
+	struct MeshRange {
+		uint32_t indexCount	  = 0;
+		uint32_t firstIndex	  = 0;
+		int32_t	 vertexOffset = 0;
+	};
+
+	VulkanGPUCulling()									  = default;
+	VulkanGPUCulling(const VulkanGPUCulling &)			  = delete;
+	VulkanGPUCulling &operator=(const VulkanGPUCulling &) = delete;
+	VulkanGPUCulling(VulkanGPUCulling &&)				  = delete;
+	VulkanGPUCulling &operator=(VulkanGPUCulling &&)	  = delete;
+	~VulkanGPUCulling()									  = default;
+	// instanceSetLayout is the per-object layout of the graphics pipelines, GetInstanceSet is allocated with it.
+	ERROR_CODE Initialize(VulkanDevice *device, VulkanMemoryAllocator *allocator, const RenderConfig &config,
+						  VkDescriptorSetLayout instanceSetLayout, VkPipelineCache cache);
+	void	   Shutdown();
+
+	// renderFlags takes RenderFlag_Visible and RenderFlag_CastShadows, bounds are in world space. object keeps its
+	// position quantization for the instance's lifetime, updates only replace the world matrix. Returns INVALID_HANDLE
+	// when the instance or draw group capacity is used up.
+	InstanceID CreateInstance(MeshID meshID, MaterialID materialID, uint8_t renderFlags, const CBPerObject &object,
+							  const Math::BoundingSphere &bounds);
+	void	   UpdateInstance(InstanceID id, const Math::Matrix4 &world, const Math::BoundingSphere &bounds);
+	void	   DestroyInstance(InstanceID id);
+
+	// Draw groups are culled away until their mesh and material are uploaded. resolve(meshID, materialID, range)
+	// returns false while they aren't and fills the mesh's index range once they are.
+	template <typename Resolve>
+	void ActivateGroups(Resolve &&resolve);
+
+	// Reads back how many instances the camera saw in the frame the slot recorded last. Call after its fence signaled.
+	void CollectResults(uint32_t frame);
+	// Uploads what changed since the last frame and records the culling pass against views, the camera first and then
+	// the shadow cascades. Draws recorded after it read its results.
+	void RecordCulling(VkCommandBuffer cmd, uint32_t frame, std::span<const Math::Frustum> views);
+	void DrawBucket(VkCommandBuffer cmd, uint32_t bucket) const;
+	void DrawShadowCascade(VkCommandBuffer cmd, uint32_t cascade) const;
+
+	[[nodiscard]] std::span<const Bucket> GetBuckets() const { return m_buckets; }
+	// Set 1 of the graphics pipelines while drawing the results, per-object records and visible lists of every view.
+	[[nodiscard]] VkDescriptorSet GetInstanceSet() const { return m_instanceSet; }
+	[[nodiscard]] uint32_t		  GetInstanceCount() const { return m_liveInstanceCount; }
+	[[nodiscard]] uint32_t		  GetVisibleCount() const { return m_visibleCount; }
+
+private:
+	struct Group {
+		MeshID	   meshID		 = INVALID_HANDLE;
+		MaterialID materialID	 = INVALID_HANDLE;
+		uint32_t   bucket		 = 0;
+		uint32_t   instanceCount = 0;
+		bool	   active		 = false;
+	};
+
+	struct FrameResources {
+		VulkanBuffer	cullData;	// views and counts of the frame
+		VulkanBuffer	staging;	// records written since the last frame, grows with them
+		VulkanBuffer	readback;	// camera visible count
+		VkDescriptorSet set		= VK_NULL_HANDLE;
+		bool			pending = false;  // recorded and not read back yet
+	};
+
+	ERROR_CODE CreateBuffers(uint32_t framesInFlight);
+	ERROR_CODE CreateDescriptors(VkDescriptorSetLayout instanceSetLayout);
+	ERROR_CODE CreatePipelines(VkPipelineCache cache);
+	uint32_t   FindOrCreateGroup(MeshID meshID, MaterialID materialID);
+	void	   ActivateGroup(uint32_t groupIndex, const MeshRange &range);
+	void	   MarkDirty(InstanceID id);
+	// Lays the groups out again after their instance counts or buckets changed.
+	void	   UpdateGroupLayout();
+	void	   RecordUploads(VkCommandBuffer cmd, FrameResources &frame);
+
+	SystemState			   m_state			  = SystemState::Uninitialized;
+	VkDevice			   ref_vkDevice		  = VK_NULL_HANDLE;
+	VulkanMemoryAllocator *ref_allocator	  = nullptr;
+	uint32_t			   m_instanceCapacity = 0;
+	uint32_t			   m_groupCapacity	  = 0;
+
+	// CPU copies of the instance records, slots below m_instanceCount are dispatched. Freed slots are reused.
+	std::vector<CBPerObject>		m_objects;
+	std::vector<GPUCullInstance>	m_instances;
+	std::vector<InstanceID>			m_freeInstances;
+	std::vector<InstanceID>			m_dirtyInstances;
+	std::vector<uint8_t>			m_instanceDirty;
+	uint32_t						m_instanceCount		= 0;
+	uint32_t						m_liveInstanceCount = 0;
+
+	std::vector<Group>						 m_groups;
+	std::vector<GPUDrawGroup>				 m_groupRecords;
+	std::vector<uint32_t>					 m_pendingGroups;  // not active yet
+	std::unordered_map<uint64_t, uint32_t>	 m_groupLookup;	   // mesh and material pair to group
+	std::vector<Bucket>						 m_buckets;
+	std::unordered_map<MaterialID, uint32_t> m_bucketLookup;
+	bool									 m_groupsDirty = false;
+	std::vector<VkBufferCopy>				 m_objectCopies;
+	std::vector<VkBufferCopy>				 m_instanceCopies;
+
+	VulkanBuffer m_objectBuffer;
+	VulkanBuffer m_instanceBuffer;
+	VulkanBuffer m_groupBuffer;
+	VulkanBuffer m_groupCountBuffer;
+	VulkanBuffer m_visibleBuffer;
+	VulkanBuffer m_commandBuffer;
+	VulkanBuffer m_drawCountBuffer;
+
+	std::vector<FrameResources>	m_frames;
+	VkDescriptorSetLayout		m_cullSetLayout	  = VK_NULL_HANDLE;
+	VkDescriptorPool			m_descriptorPool  = VK_NULL_HANDLE;
+	VkDescriptorSet				m_instanceSet	  = VK_NULL_HANDLE;
+	VkPipelineLayout			m_pipelineLayout  = VK_NULL_HANDLE;
+	VkPipeline					m_cullPipeline	  = VK_NULL_HANDLE;
+	VkPipeline					m_compactPipeline = VK_NULL_HANDLE;
+	uint32_t					m_visibleCount	  = 0;
+};
+
+template <typename Resolve>
+void VulkanGPUCulling::ActivateGroups(Resolve &&resolve) {
+	for (size_t i = 0; i < m_pendingGroups.size();) {
+		const Group &group = m_groups[m_pendingGroups[i]];
+		if (MeshRange range; resolve(group.meshID, group.materialID, range)) {
+			ActivateGroup(m_pendingGroups[i], range);
+			m_pendingGroups[i] = m_pendingGroups.back();
+			m_pendingGroups.pop_back();
+		} else {
+			i++;
+		}
+	}
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
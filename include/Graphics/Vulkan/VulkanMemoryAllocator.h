@@ -0,0 +1,109 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/Common.h"
+
+namespace PE::Graphics::Vulkan {
+class VulkanDevice;
+struct VulkanMemoryBlock;
+
+// A range of device memory owned by a VulkanMemoryAllocator. Resources bind at memory + offset.
+struct VulkanAllocation {
+	VkDeviceMemory	   memory	  = VK_NULL_HANDLE;
+	VkDeviceSize	   offset	  = 0;
+	VkDeviceSize	   size		  = 0;
+	VkDeviceSize	   alignment  = 0;
+	void			  *mappedData = nullptr;  // persistently mapped for HOST_VISIBLE memory
+	VulkanMemoryBlock *block	  = nullptr;  // nullptr for dedicated allocations
+	uint32_t		   node		  = UINT32_MAX;
+
+	[[nodiscard]] bool IsValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+struct VulkanMemoryStats {
+	VkDeviceSize reservedBytes	 = 0;  // block and dedicated memory allocated from the driver
+	VkDeviceSize usedBytes		 = 0;
+	VkDeviceSize freeBytes		 = 0;
+	VkDeviceSize fragmentedBytes = 0;  // free bytes outside the largest free range of their block
+	VkDeviceSize dedicatedBytes	 = 0;  // part of reservedBytes and usedBytes
+	uint32_t	 blockCount		 = 0;
+	uint32_t	 dedicatedCount	 = 0;
+	uint32_t	 allocationCount = 0;
+};
+
+// Sub-allocates buffers and images from large vkAllocateMemory blocks, so loading hundreds of textures costs a
+// handful of driver allocations instead of running into maxMemoryAllocationCount. Every memory type has one pool of
+// blocks for buffers and one for images, keeping linear and optimal resources apart makes bufferImageGranularity a
+// non-issue. Ranges inside a block come from a TLSFAllocator. Resources the driver wants dedicated memory for, or that
+// take more than half a block, get their own allocation.
+class VulkanMemoryAllocator {
+public:
+	// Called by Defragment with the resource's old and new range. The owner has to recreate its resource at to and
+	// return true, the allocator then frees from. Runs under the allocator lock, so it can't call back into it.
+	using RelocateFunction = std::function<bool(const VulkanAllocation &from, const VulkanAllocation &to)>;
+
+	VulkanMemoryAllocator()											= default;
+	VulkanMemoryAllocator(const VulkanMemoryAllocator &)			= delete;
+	VulkanMemoryAllocator &operator=(const VulkanMemoryAllocator &)	= delete;
+	VulkanMemoryAllocator(VulkanMemoryAllocator &&)					= delete;
+	VulkanMemoryAllocator &operator=(VulkanMemoryAllocator &&)		= delete;
+	// Out of line, VulkanMemoryBlock is only complete in the source file.
+	~VulkanMemoryAllocator();
+
+	ERROR_CODE Initialize(VulkanDevice *device);
+	void	   Shutdown();
+
+	// Allocate memory for the resource and bind it.
+	ERROR_CODE AllocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, VulkanAllocation &outAllocation);
+	ERROR_CODE AllocateForImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties,
+								VulkanAllocation &outAllocation);
+	// Resets allocation, freeing an invalid one is a no-op.
+	void Free(VulkanAllocation &allocation);
+
+	// Defragmentation hooks. Only allocations with a relocate function are moved, out of the emptiest block of each
+	// pool into the others. Returns how many moved, blocks left empty are released.
+	void	 SetRelocateFunction(const VulkanAllocation &allocation, RelocateFunction relocate);
+	uint32_t Defragment(uint32_t maxMoves);
+
+	[[nodiscard]] VulkanMemoryStats GetStats() const;
+	[[nodiscard]] VkDevice			GetVkDevice() const { return ref_vkDevice; }
+
+private:
+	static constexpr VkDeviceSize MAX_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+	struct Pool {
+		uint32_t										memoryTypeIndex = 0;
+		VkDeviceSize									blockSize		= 0;
+		std::vector<std::unique_ptr<VulkanMemoryBlock>> blocks;
+	};
+
+	ERROR_CODE Allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, bool optimalImage,
+						bool dedicated, const VkMemoryDedicatedAllocateInfo &dedicatedInfo,
+						VulkanAllocation &outAllocation);
+	ERROR_CODE AllocateDedicated(VkDeviceSize size, uint32_t memoryTypeIndex,
+								 const VkMemoryDedicatedAllocateInfo &dedicatedInfo, VulkanAllocation &outAllocation);
+
+	VulkanMemoryBlock *CreateBlock(Pool &pool);
+	void			   ReleaseBlock(Pool &pool, const VulkanMemoryBlock *block);
+	[[nodiscard]] bool AllocateFromBlock(VulkanMemoryBlock &block, VkDeviceSize size, VkDeviceSize alignment,
+										 VulkanAllocation &outAllocation) const;
+
+	[[nodiscard]] uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+	[[nodiscard]] bool	   IsHostVisible(uint32_t memoryTypeIndex) const;
+
+	VulkanDevice *ref_device   = nullptr;
+	VkDevice	  ref_vkDevice = VK_NULL_HANDLE;
+
+	SystemState						 m_state = SystemState::Uninitialized;
+	VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+	std::vector<Pool>				 m_pools;  // two per memory type, buffers then images
+	VkDeviceSize					 m_dedicatedBytes = 0;
+	uint32_t						 m_dedicatedCount = 0;
+	mutable std::mutex				 m_mutex;
+};
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -12,11 +12,13 @@ public:
 	VulkanPipeline &operator=(VulkanPipeline &&) noexcept;
 	~VulkanPipeline() = default;
 
+	// cache may be VK_NULL_HANDLE, pipelines created with the same cache can be built on different threads.
 	ERROR_CODE Initialize(VulkanDevice *device, const VulkanShader &shader, VkPipelineLayout layout, VkExtent2D extent,
-						  const PipelineDescription &desc);
+						  const PipelineDescription &desc, VkPipelineCache cache = VK_NULL_HANDLE);
 	ERROR_CODE Initialize(VulkanDevice *device, const VulkanShader &shader, VkPipelineLayout layout, VkExtent2D extent,
 						  const PipelineDescription &desc, const std::vector<VkVertexInputBindingDescription> &bindings,
-						  const std::vector<VkVertexInputAttributeDescription> &attributes);
+						  const std::vector<VkVertexInputAttributeDescription> &attributes,
+						  VkPipelineCache										cache = VK_NULL_HANDLE);
 
 	void Shutdown();
 
@@ -0,0 +1,56 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "Common/Common.h"
+
+namespace PE::Graphics::Vulkan {
+class VulkanDevice;
+
+// VkPipelineCache that survives restarts. Shutdown writes the driver's blob behind a header naming the GPU and driver
+// it came from, a file written by another device or driver version is ignored and the cache starts empty.
+class VulkanPipelineCache {
+public:
+	VulkanPipelineCache()										= default;
+	VulkanPipelineCache(const VulkanPipelineCache &)			= delete;
+	VulkanPipelineCache &operator=(const VulkanPipelineCache &) = delete;
+	VulkanPipelineCache(VulkanPipelineCache &&)					= delete;
+	VulkanPipelineCache &operator=(VulkanPipelineCache &&)		= delete;
+	~VulkanPipelineCache()										= default;
+	ERROR_CODE Initialize(VulkanDevice *device, const std::filesystem::path &filePath);
+	void	   Shutdown();
+
+	ERROR_CODE Save() const;
+
+	// Vulkan synchronizes the cache internally, pipelines may be created with it from several threads.
+	[[nodiscard]] VkPipelineCache GetHandle() const { return m_cache; }
+
+private:
+	static constexpr uint32_t FILE_MAGIC   = 0x43505045;  // "EPPC"
+	static constexpr uint32_t FILE_VERSION = 1;
+
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint8_t	 deviceUUID[VK_UUID_SIZE];
+		uint8_t	 pipelineCacheUUID[VK_UUID_SIZE];
+		uint32_t reserved;	// fills what would be padding before dataSize, written as zero
+		uint64_t dataSize;
+	};
+
+	[[nodiscard]] FileHeader		MakeHeader() const;
+	// Field by field, everything but reserved and dataSize.
+	[[nodiscard]] static bool		IsSameDevice(const FileHeader &a, const FileHeader &b);
+	[[nodiscard]] std::vector<char> LoadData() const;
+
+	SystemState			  m_state	 = SystemState::Uninitialized;
+	VulkanDevice		 *ref_device = nullptr;
+	VkPipelineCache		  m_cache	 = VK_NULL_HANDLE;
+	std::filesystem::path m_filePath;
+};
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
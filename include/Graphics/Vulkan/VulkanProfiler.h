@@ -0,0 +1,56 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "Common/Common.h"
+#include "Graphics/GPUProfile.h"
+
+namespace PE::Graphics::Vulkan {
+class VulkanDevice;
+
+// Query pool profiler for the passes of RecordCommandBuffer. Every frame in flight owns a timestamp pool with a begin
+// and end query per pass, and a pipeline statistics pool with one query per pass when the device supports them. A
+// frame's results are read once its fence has signaled, maxFramesInFlight frames later, so reading never stalls.
+class VulkanProfiler {
+public:
+	VulkanProfiler()								  = default;
+	VulkanProfiler(const VulkanProfiler &)			  = delete;
+	VulkanProfiler &operator=(const VulkanProfiler &) = delete;
+	VulkanProfiler(VulkanProfiler &&)				  = delete;
+	VulkanProfiler &operator=(VulkanProfiler &&)	  = delete;
+	~VulkanProfiler()								  = default;
+	ERROR_CODE Initialize(VulkanDevice *device, uint32_t framesInFlight);
+	void	   Shutdown();
+
+	// Adds what the frame slot recorded last to the profile. Call after the slot's fence has signaled.
+	void CollectResults(uint32_t frame);
+	// Resets the slot's queries, recorded before any pass of the frame.
+	void BeginFrame(VkCommandBuffer cmd, uint32_t frame);
+	void BeginPass(VkCommandBuffer cmd, GPUPass pass) const;
+	void EndPass(VkCommandBuffer cmd, GPUPass pass) const;
+
+	// Statistics secondary command buffers have to inherit while a pass query is active, 0 without them.
+	[[nodiscard]] VkQueryPipelineStatisticFlags GetStatisticFlags() const { return m_statisticFlags; }
+	[[nodiscard]] bool							IsEnabled() const { return m_state == SystemState::Running; }
+	[[nodiscard]] const GPUProfile			   &GetProfile() const { return m_profile; }
+
+private:
+	struct FrameQueries {
+		VkQueryPool timestamps = VK_NULL_HANDLE;
+		VkQueryPool statistics = VK_NULL_HANDLE;
+		uint64_t	frameIndex = 0;
+		bool		pending	   = false;	 // recorded and not read back yet
+	};
+
+	SystemState					  m_state		   = SystemState::Uninitialized;
+	VulkanDevice				 *ref_device	   = nullptr;
+	std::vector<FrameQueries>	  m_frames;
+	uint32_t					  m_recordingFrame = 0;
+	uint64_t					  m_frameCounter   = 0;
+	double						  m_msPerTick	   = 0.0;
+	uint64_t					  m_timestampMask  = 0;
+	VkQueryPipelineStatisticFlags m_statisticFlags = 0;
+	GPUProfile					  m_profile;
+};
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
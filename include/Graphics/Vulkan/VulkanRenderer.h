@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <span>
 #include <vector>
 
@@ -7,17 +8,26 @@
 #include "Graphics/IRenderer.h"
 #include "Graphics/Material.h"
 #include "Graphics/RenderConfig.h"
+#include "Graphics/RenderQueue.h"
 #include "Graphics/ResourcePool.h"
+#include "Graphics/ShadowCascades.h"
 #include "Graphics/Vulkan/VulkanBuffer.h"
 #include "Graphics/Vulkan/VulkanCommand.h"
 #include "Graphics/Vulkan/VulkanDevice.h"
+#include "Graphics/Vulkan/VulkanGPUCulling.h"
+#include "Graphics/Vulkan/VulkanMemoryAllocator.h"
+#include "Graphics/Vulkan/VulkanPipelineCache.h"
+#include "Graphics/Vulkan/VulkanProfiler.h"
 #include "Graphics/Vulkan/VulkanShader.h"
 #include "Graphics/Vulkan/VulkanSwapchain.h"
 #include "Graphics/Vulkan/VulkanTypes.h"
+#include "Graphics/Vulkan/VulkanUploadManager.h"
 #include "VulkanPipeline.h"
 
 namespace PE::Graphics::Vulkan {
-constexpr VkDeviceSize MAX_VERTEX_BUFFER_SIZE = 1024 * 1024 * 256;
+// PackedVertex is under half the size of Vertex, 128 MB of them are more vertices than 256 MB of Vertex were.
+constexpr VkDeviceSize MAX_VERTEX_BUFFER_SIZE = 1024 * 1024 * 128;
+constexpr VkDeviceSize MAX_INDEX_BUFFER_SIZE  = 1024 * 1024 * 256;
 
 class VulkanRenderer : public IRenderer {
 public:
@@ -30,6 +40,7 @@ public:
 
 	ERROR_CODE Initialize(GLFWwindow *windowHandle, const Core::EngineConfig &config) override;
 	ERROR_CODE CreateDefaultResources() override;
+	ERROR_CODE PrewarmPipelines() override;
 	ERROR_CODE Shutdown() override;
 	ERROR_CODE OnResize(const RenderConfig &config) override;
 
@@ -59,8 +70,23 @@ public:
 	void	  WaitIdle();
 
 	[[nodiscard]] RenderStats GetStats() const override;
+	void					  SetCullingStats(uint32_t visibleCount, uint32_t culledCount) override;
+	[[nodiscard]] bool SupportsBlockCompression() const override { return ref_device->SupportsBlockCompression(); }
+	void			   RequestCapture(const std::filesystem::path &path) override;
+	// Null when the graphics queue can't write timestamps.
+	[[nodiscard]] const GPUProfile *GetGPUProfile() const override;
+
+	// Null m_gpuCulling when it is disabled or the device can't draw indirect counts, instances are then refused.
+	[[nodiscard]] bool IsGPUDriven() const override { return m_gpuCulling != nullptr; }
+	// Forwarded to m_gpuCulling.
+	InstanceID CreateInstance(MeshID meshID, MaterialID materialID, uint8_t renderFlags, const Math::Matrix4 &world,
+							  const Math::BoundingSphere &bounds) override;
+	void	   UpdateInstance(InstanceID id, const Math::Matrix4 &world, const Math::BoundingSphere &bounds) override;
+	void	   DestroyInstance(InstanceID id) override;
 
 private:
+	static constexpr uint32_t MAX_SHADER_PASSES = 2;
+
 	TextureID  CreateTexture(const std::string &name, const unsigned char *data,
 							 const TextureParameters &params) override;
 	MeshID	   CreateMesh(const std::string &name, const MeshData &meshData) override;
@@ -86,13 +112,38 @@ private:
 	ERROR_CODE			   CreateDescriptorSets();
 	ERROR_CODE			   CreateSyncObjects(int maxFramesInFlight);
 	void CreateImage(VulkanTextureWrapper &tW, VkImageTiling tiling, VkMemoryPropertyFlags properties);
-	void TransitionImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t layerCount);
-	void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
-	VkImageView		CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
-									VkImageViewType viewType, uint32_t layerCount) const;
-	void			RecreateSwapchain(int width, int height);
-	VkCommandBuffer BeginSingleTimeCommands();
-	void			EndSingleTimeCommands(VkCommandBuffer commandBuffer);
+	VkImageView CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+								VkImageViewType viewType, uint32_t layerCount, uint32_t mipLevels = 1,
+								uint32_t baseLayer = 0) const;
+	void		RecreateSwapchain(int width, int height);
+	// Draw slots in the per-object buffer this frame, sorted entries past it are not drawn.
+	[[nodiscard]] size_t GetInstanceSlotCount() const;
+	// Fits the cascades to the frame's camera, culls the casters of each and uploads m_perPassData.
+	void				 UpdateShadowCascades();
+	ERROR_CODE			 BuildDrawBatches();
+	ERROR_CODE			 RecordPassInParallel(VkCommandBuffer cmd, uint32_t pass, std::span<const DrawBatch> batches,
+											  const VkCommandBufferInheritanceRenderingInfo &inheritance);
+	void				 SetPassViewport(VkCommandBuffer cmd, uint32_t pass) const;
+	void				 BindPassState(VkCommandBuffer cmd, uint32_t pass) const;
+	void				 RecordDrawBatches(VkCommandBuffer cmd, VkPipelineLayout layout,
+										   std::span<const DrawBatch> batches) const;
+	// Records the pass directly into cmd, the culled GPU instances first and then the submitted batches.
+	ERROR_CODE			 RecordGPUDrivenPass(VkCommandBuffer cmd, uint32_t pass, std::span<const DrawBatch> batches);
+	// Main pass pipelines of a shader in draw order, returns how many of outDescs were filled.
+	[[nodiscard]] uint32_t GetMainPassDescriptions(ShaderID shaderID,
+												   std::array<PipelineDescription, MAX_SHADER_PASSES> &outDescs) const;
+	VulkanPipeline		  *GetOrCreatePipeline(const PipelineDescription &desc);
+	// Uploads still in flight keep their resources out of the frame, see m_completedUploadValue.
+	[[nodiscard]] bool IsMeshReady(MeshID id) const;
+	[[nodiscard]] bool IsTextureReady(TextureID id) const;
+	[[nodiscard]] bool IsMaterialReady(MaterialID id) const;
+	// Per-object record of an instance of the mesh, its world matrix and how to decode the mesh's packed positions.
+	[[nodiscard]] CBPerObject GetObjectData(MeshID meshID, const Math::Matrix4 &world) const;
+	// Element of the bindless texture array sampling the texture with the sampler, written on first use.
+	uint32_t GetBindlessSlot(TextureID texID, SamplerType sampler);
+	// Copies the finished image into m_captureBuffer, WriteCapture saves it once the frame fence signals.
+	void RecordCapture(VkCommandBuffer cmd, uint32_t imageIndex) const;
+	void WriteCapture(VkFence fence);
 
 private:
 	GLFWwindow				 *ref_window = nullptr;
@@ -106,28 +157,28 @@ private:
 	RenderStats		 m_stats;
 	VulkanSwapchain *m_swapChain		= nullptr;
 	VulkanCommand	*m_command			= nullptr;
-	VulkanPipeline	*m_currentPipeline	= nullptr;
 	VulkanPipeline	*m_particlePipeline = nullptr;
 	VulkanPipeline	*m_shadowPipeline	= nullptr;
 
-	std::vector<VkDescriptorSetLayout>			   m_descriptorSetLayouts;
-	std::vector<VkDescriptorSet>				   m_perPassDescriptorSets;
-	std::vector<VkDescriptorSet>				   m_perObjectDescriptorSets;
-	std::vector<VkDescriptorSet>				   m_materialDescriptorSets;
-	std::unordered_map<TextureID, VkDescriptorSet> m_particleTextureSets;
+	std::vector<VkDescriptorSetLayout> m_descriptorSetLayouts;
+	std::vector<VkDescriptorSet>	   m_perPassDescriptorSets;
+	std::vector<VkDescriptorSet>	   m_perObjectDescriptorSets;
+	VkDescriptorSet					   m_bindlessSet = VK_NULL_HANDLE;
+
+	VkDescriptorSetLayout m_perPassSetLayout   = VK_NULL_HANDLE;
+	VkDescriptorSetLayout m_perObjectSetLayout = VK_NULL_HANDLE;
+	VkDescriptorSetLayout m_bindlessSetLayout  = VK_NULL_HANDLE;
 
-	VkDescriptorSetLayout m_perPassSetLayout	 = VK_NULL_HANDLE;
-	VkDescriptorSetLayout m_perObjectSetLayout	 = VK_NULL_HANDLE;
-	VkDescriptorSetLayout m_perMaterialSetLayout = VK_NULL_HANDLE;
-	VkDescriptorSetLayout m_particleSetLayout	 = VK_NULL_HANDLE;
+	// Bindless texture array slots by texture ID and sampler, see GetBindlessSlot.
+	std::unordered_map<uint64_t, uint32_t> m_bindlessSlots;
+	uint32_t							   m_bindlessTextureCapacity = 0;
 
 	VkPipelineLayout m_pipelineLayout		  = VK_NULL_HANDLE;
 	VkPipelineLayout m_particlePipelineLayout = VK_NULL_HANDLE;
 	VkPipelineLayout m_shadowPipelineLayout	  = VK_NULL_HANDLE;
 
 	VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
-
-	VkDeviceSize m_dynamicAlignment = 0;
+	VkDescriptorPool m_bindlessPool	  = VK_NULL_HANDLE;
 
 	std::vector<VkSemaphore> m_imageAvailableSemaphores;
 	std::vector<VkSemaphore> m_renderFinishedSemaphores;
@@ -136,20 +187,45 @@ private:
 	// IMGUI
 	VkDescriptorPool m_imguiPool = VK_NULL_HANDLE;
 
+	VulkanMemoryAllocator *m_memoryAllocator = nullptr;
+	VulkanPipelineCache	 *m_pipelineCache	= nullptr;
+	VulkanUploadManager	 *m_uploadManager	= nullptr;
+	VulkanProfiler		 *m_profiler		= nullptr;
+	VulkanGPUCulling	 *m_gpuCulling		= nullptr;
 	std::unordered_map<PipelineDescription, VulkanPipeline *, PipelineDescription::PipelineDescriptionHash>
 		m_pipelineDescriptions;
 
-	std::vector<RenderCommand>	m_renderQueue;
+	RenderQueue					m_renderQueue;
 	std::vector<VulkanBuffer *> m_perPassBuffers;
 	std::vector<VulkanBuffer *> m_perObjectBuffers;
-	std::vector<VulkanBuffer *> m_perMaterialBuffers;
 	std::vector<VulkanBuffer *> m_particleInstanceBuffers;
-	VulkanBuffer			   *m_vertexBuffer = nullptr;
-	VulkanBuffer			   *m_indexBuffer  = nullptr;
+	VulkanBuffer			   *m_vertexBuffer	 = nullptr;
+	VulkanBuffer			   *m_indexBuffer	 = nullptr;
+	VulkanBuffer			   *m_materialBuffer = nullptr;
+	// Identity instance indices of the submitted draws, see InstanceIndexBuffer in the shaders. Written once.
+	VulkanBuffer *m_instanceIndexBuffer = nullptr;
 
 	VulkanTextureWrapper	   m_depthTexture;
 	ShadowMapResources		   m_shadowMap;
 	std::vector<ParticleBatch> m_particleBatches;
+	std::vector<DrawBatch>	   m_mainBatches;
+
+	// Camera and light data of the frame, uploaded in Flush once the shadow cascades are fitted to it.
+	CBPerPass m_perPassData{};
+
+	// Cascades of this frame and the shadow draws of each. The caster arrays follow the opaque part of the sorted
+	// queue, bit c of m_casterCascades is set if the caster in that slot reaches cascade c.
+	std::array<ShadowCascade, MAX_SHADOW_CASCADES>			m_shadowCascades;
+	std::array<std::vector<DrawBatch>, MAX_SHADOW_CASCADES>	m_shadowBatches;
+	std::vector<float>										m_casterX;
+	std::vector<float>										m_casterY;
+	std::vector<float>										m_casterZ;
+	std::vector<float>										m_casterRadius;
+	std::vector<uint8_t>									m_casterVisible;
+	std::vector<uint8_t>									m_casterCascades;
+	// Camera and cascade frustums the GPU culling pass tests against, the camera first.
+	std::array<Math::Frustum, VulkanGPUCulling::MAX_VIEWS> m_cullViews;
+	uint32_t											   m_cullViewCount = 0;
 
 	std::array<VkSampler, static_cast<size_t>(SamplerType::Count)> m_globalSamplers;
 	ResourcePool<VulkanRenderTargetWrapper>						   m_renderTargets;
@@ -160,5 +236,10 @@ private:
 
 	uint32_t			m_currentFrame		 = 0;
 	std::pair<int, int> m_lastWidthAndHeight = {0, 0};
+	// Upload timeline value read when the frame started recording, only uploads up to it are drawn and acquired.
+	uint64_t m_completedUploadValue = 0;
+	// Pending frame capture, empty when the next frame is not saved.
+	std::filesystem::path m_capturePath;
+	VulkanBuffer		 *m_captureBuffer = nullptr;
 };
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
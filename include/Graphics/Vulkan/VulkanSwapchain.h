@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "Common/Common.h"
+#include "Graphics/Vulkan/VulkanMemoryAllocator.h"
 
 namespace PE::Graphics::Vulkan {
 class VulkanDevice;
@@ -14,7 +15,10 @@ public:
 	VulkanSwapchain()  = default;
 	~VulkanSwapchain() = default;
 
-	ERROR_CODE Initialize(GLFWwindow *windowHandle, VulkanDevice *vulkanDevice, float width, float height);
+	// Without a window the swapchain is offscreen: imageCount plain images that are handed out in turn and never
+	// presented. A window surface picks its own image count.
+	ERROR_CODE Initialize(GLFWwindow *windowHandle, VulkanDevice *vulkanDevice, VulkanMemoryAllocator *allocator,
+						  float width, float height, uint32_t imageCount);
 	void	   Shutdown();
 
 	VkResult AcquireNextImage(VkSemaphore imageAvailableSemaphore, uint32_t &outImageIndex);
@@ -25,20 +29,26 @@ public:
 	[[nodiscard]] VkExtent2D				GetExtent() const { return m_swapChainExtent; }
 	[[nodiscard]] std::vector<VkImage>	   &GetImages() { return m_swapChainImages; }
 	[[nodiscard]] std::vector<VkImageView> &GetImageViews() { return m_swapChainImageViews; }
+	[[nodiscard]] bool						IsOffscreen() const { return ref_window == nullptr; }
+	// Layout an image is left in once a frame is done with it, offscreen images stay readable by transfers.
+	[[nodiscard]] VkImageLayout GetFinalLayout() const;
 
 	void Recreate(int width, int height);
 
 private:
 	ERROR_CODE CreateSwapchain(float width, float height, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 	ERROR_CODE CreateImageViews();
+	ERROR_CODE CreateOffscreenImages(float width, float height);
+	void	   DestroyOffscreenImages();
 
 	VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &formats);
 	VkPresentModeKHR   ChooseSwapPresentMode(const std::vector<VkPresentModeKHR> &modes);
 	VkExtent2D		   ChooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities, int width, int height);
 
 private:
-	GLFWwindow	 *ref_window;
-	VulkanDevice *ref_vulkanDevice;
+	GLFWwindow			  *ref_window;
+	VulkanDevice		  *ref_vulkanDevice;
+	VulkanMemoryAllocator *ref_allocator = nullptr;
 
 	SystemState				 m_state	   = SystemState::Uninitialized;
 	VkSwapchainKHR			 m_vkSwapchain = VK_NULL_HANDLE;
@@ -46,5 +56,9 @@ private:
 	VkExtent2D				 m_swapChainExtent;
 	std::vector<VkImage>	 m_swapChainImages;
 	std::vector<VkImageView> m_swapChainImageViews;
+
+	uint32_t					  m_offscreenImageCount = 0;
+	uint32_t					  m_nextOffscreenImage	= 0;
+	std::vector<VulkanAllocation> m_offscreenAllocations;
 };
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
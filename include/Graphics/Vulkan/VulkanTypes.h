@@ -1,11 +1,15 @@
 #pragma once
 #include <vulkan/vulkan_core.h>
 
+#include <array>
 #include <utility>
 
 #include "Graphics/RenderTypes.h"
+#include "Graphics/Vulkan/VulkanMemoryAllocator.h"
 
 namespace PE::Graphics::Vulkan {
+class VulkanPipeline;
+
 struct PipelineDescription {
 	ShaderID shaderID = INVALID_HANDLE;
 
@@ -45,9 +49,9 @@ struct PipelineDescription {
 };
 
 struct VulkanTextureWrapper {
-	VkImage		   image	 = VK_NULL_HANDLE;
-	VkImageView	   imageView = VK_NULL_HANDLE;
-	VkDeviceMemory memory	 = VK_NULL_HANDLE;
+	VkImage			 image	   = VK_NULL_HANDLE;
+	VkImageView		 imageView = VK_NULL_HANDLE;
+	VulkanAllocation allocation;
 
 	uint32_t width		= 0;
 	uint32_t height		= 0;
@@ -61,6 +65,7 @@ struct VulkanTextureWrapper {
 	VkImageCreateFlags	  flags	  = 0;
 
 	VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	uint64_t	  uploadValue	= 0;  // upload timeline value the image is complete at
 
 	VulkanTextureWrapper() = default;
 
@@ -73,7 +78,7 @@ struct VulkanTextureWrapper {
 		if (this != &other) {
 			image	   = std::exchange(other.image, VK_NULL_HANDLE);
 			imageView  = std::exchange(other.imageView, VK_NULL_HANDLE);
-			memory	   = std::exchange(other.memory, VK_NULL_HANDLE);
+			allocation = std::exchange(other.allocation, {});
 			width	   = std::exchange(other.width, 0);
 			height	   = std::exchange(other.height, 0);
 			depth	   = std::exchange(other.depth, 1);
@@ -86,6 +91,7 @@ struct VulkanTextureWrapper {
 			flags	= std::exchange(other.flags, 0);
 
 			currentLayout = std::exchange(other.currentLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+			uploadValue	  = std::exchange(other.uploadValue, 0);
 		}
 		return *this;
 	}
@@ -98,6 +104,9 @@ struct VulkanMeshWrapper {
 	uint32_t vertexCount  = 0;
 	uint32_t firstVertex  = 0;
 	uint32_t firstIndex	  = 0;
+	uint64_t uploadValue  = 0;	// upload timeline value of the later of both ranges
+
+	VertexQuantization quantization;
 
 	VulkanMeshWrapper() = default;
 
@@ -114,17 +123,19 @@ struct VulkanMeshWrapper {
 			vertexCount	 = std::exchange(other.vertexCount, 0);
 			firstVertex	 = std::exchange(other.firstVertex, 0);
 			firstIndex	 = std::exchange(other.firstIndex, 0);
+			uploadValue	 = std::exchange(other.uploadValue, 0);
+			quantization = other.quantization;
 		}
 		return *this;
 	}
 };
 
 struct VulkanRenderTargetWrapper {
-	VkImage		   image	 = VK_NULL_HANDLE;
-	VkImageView	   imageView = VK_NULL_HANDLE;
-	VkDeviceMemory memory	 = VK_NULL_HANDLE;
-	VkFormat	   format	 = VK_FORMAT_UNDEFINED;
-	TextureID	   textureID = 0;
+	VkImage			 image	   = VK_NULL_HANDLE;
+	VkImageView		 imageView = VK_NULL_HANDLE;
+	VulkanAllocation allocation;
+	VkFormat		 format	   = VK_FORMAT_UNDEFINED;
+	TextureID		 textureID = 0;
 
 	VulkanRenderTargetWrapper() = default;
 
@@ -135,19 +146,65 @@ struct VulkanRenderTargetWrapper {
 
 	VulkanRenderTargetWrapper &operator=(VulkanRenderTargetWrapper &&other) noexcept {
 		if (this != &other) {
-			image	  = std::exchange(other.image, VK_NULL_HANDLE);
-			imageView = std::exchange(other.imageView, VK_NULL_HANDLE);
-			memory	  = std::exchange(other.memory, VK_NULL_HANDLE);
-			format	  = std::exchange(other.format, VK_FORMAT_UNDEFINED);
-			textureID = std::exchange(other.textureID, 0);
+			image	   = std::exchange(other.image, VK_NULL_HANDLE);
+			imageView  = std::exchange(other.imageView, VK_NULL_HANDLE);
+			allocation = std::exchange(other.allocation, {});
+			format	   = std::exchange(other.format, VK_FORMAT_UNDEFINED);
+			textureID  = std::exchange(other.textureID, 0);
 		}
 		return *this;
 	}
 };
 
+// One layer per cascade. texture.imageView is the array view the shaders sample, every cascade renders into its own
+// single layer view.
 struct ShadowMapResources {
-	VulkanTextureWrapper texture;
-	VkSampler			 sampler = VK_NULL_HANDLE;
-	const uint32_t		 dim	 = 4096;
+	VulkanTextureWrapper						 texture;
+	std::array<VkImageView, MAX_SHADOW_CASCADES> layerViews{};
+	VkSampler									 sampler	  = VK_NULL_HANDLE;
+	uint32_t									 dim		  = 2048;
+	uint32_t									 cascadeCount = 1;
+};
+
+// Bytes every CBMaterial_* block gets in a GPUMaterial, the largest one fills them.
+constexpr size_t MATERIAL_PROPERTY_SIZE = 64;
+
+// A material's record in the bindless material buffer, draws select it through the material index push constant.
+// textureSlots[i] is the element of the bindless texture array the material samples as TextureType i.
+struct alignas(16) GPUMaterial {
+	uint8_t	 properties[MATERIAL_PROPERTY_SIZE];
+	uint32_t textureSlots[static_cast<size_t>(TextureType::Count)];
+};
+static_assert(sizeof(CBMaterial_PBR) <= MATERIAL_PROPERTY_SIZE, "Material properties must fit their GPUMaterial.");
+
+// An instance's record in the buffer the GPU culling pass reads, see VulkanGPUCulling.
+struct alignas(16) GPUCullInstance {
+	Math::Vector4 sphere{};						// world space center and radius
+	uint32_t	  groupIndex = INVALID_HANDLE;	// INVALID_HANDLE for free slots
+	uint32_t	  flags		 = 0;				// RenderFlag_Visible and RenderFlag_CastShadows
+	uint32_t	  _pad0[2]{};
+};
+
+// One mesh and material pair of the GPU driven path. Its visible instances are packed from firstInstance on in the
+// visible list of each view, and it becomes one VkDrawIndexedIndirectCommand of each view that sees any.
+struct GPUDrawGroup {
+	uint32_t indexCount	   = 0;
+	uint32_t firstIndex	   = 0;
+	int32_t	 vertexOffset  = 0;
+	uint32_t firstInstance = 0;
+	uint32_t firstCommand  = 0;	 // camera commands of its material start here
+	uint32_t bucket		   = 0;	 // draw count of its material
+	uint32_t active		   = 0;	 // 0 until its mesh and material are uploaded
+	uint32_t _pad0		   = 0;
+};
+
+// One instanced draw of the sorted queue. Batches are resolved on the render thread, so the threads recording them
+// never touch the pipeline cache.
+struct DrawBatch {
+	VulkanPipeline *pipeline	  = nullptr;
+	MaterialID		materialID	  = INVALID_HANDLE;	 // INVALID_HANDLE keeps the pushed material index
+	MeshID			meshID		  = INVALID_HANDLE;
+	uint32_t		firstInstance = 0;
+	uint32_t		instanceCount = 0;
 };
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Graphics/Vulkan/VulkanBuffer.h"
+
+namespace PE::Graphics::Vulkan {
+class VulkanDevice;
+
+// Streams data into device local buffers and images without waiting on the GPU. Data is copied into a persistently
+// mapped staging ring, the copies are recorded into a batch that goes to the transfer queue in a single submission,
+// and each batch signals the next value of a timeline semaphore. Every upload reports the value it is complete at.
+// When the transfer queue is another family than graphics, batches release the resources they wrote and the graphics
+// queue has to acquire them with RecordAcquireBarriers before using them.
+class VulkanUploadManager {
+public:
+	VulkanUploadManager()										= default;
+	VulkanUploadManager(const VulkanUploadManager &)			= delete;
+	VulkanUploadManager &operator=(const VulkanUploadManager &) = delete;
+	VulkanUploadManager(VulkanUploadManager &&)					= delete;
+	VulkanUploadManager &operator=(VulkanUploadManager &&)		= delete;
+	~VulkanUploadManager()										= default;
+	ERROR_CODE Initialize(VulkanDevice *device, VulkanMemoryAllocator *allocator, VkDeviceSize ringSize);
+	void	   Shutdown();
+
+	// dstStage and dstAccess are how the graphics queue reads the range once the upload is complete.
+	ERROR_CODE UploadBuffer(VkBuffer buffer, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+							VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, uint64_t &outUploadValue);
+	// Copies the regions, whose buffer offsets are relative to data, and leaves every level and layer of the image in
+	// SHADER_READ_ONLY_OPTIMAL for fragment shaders.
+	ERROR_CODE UploadImage(VkImage image, uint32_t mipLevels, uint32_t layerCount,
+						   std::span<const VkBufferImageCopy> regions, const void *data, VkDeviceSize size,
+						   uint64_t &outUploadValue);
+
+	// Uploads wait in the open batch until it is submitted, either here or when the ring runs out of space.
+	ERROR_CODE Submit();
+
+	// Every upload at or below this value has finished on the GPU.
+	[[nodiscard]] uint64_t	  GetCompletedValue() const;
+	[[nodiscard]] VkSemaphore GetTimelineSemaphore() const { return m_timeline; }
+	// Records the acquire half of the ownership transfers of every upload up to uploadValue. The submission of cmd
+	// has to wait for uploadValue on the timeline semaphore.
+	void RecordAcquireBarriers(VkCommandBuffer cmd, uint64_t uploadValue);
+
+private:
+	static constexpr uint32_t	  MAX_BATCHES		= 4;
+	static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+	struct Batch {
+		VkCommandPool	pool	  = VK_NULL_HANDLE;
+		VkCommandBuffer	cmd		  = VK_NULL_HANDLE;
+		uint64_t		value	  = 0;	// signaled on the timeline once the batch is done
+		VkDeviceSize	ringEnd	  = 0;	// ring head when the batch was submitted
+		bool			recording = false;
+		bool			inFlight  = false;
+		// Release barriers, recorded together when the batch is submitted.
+		std::vector<VkBufferMemoryBarrier2> bufferReleases;
+		std::vector<VkImageMemoryBarrier2>	imageReleases;
+		// Staging of uploads too big for the ring, released with the batch.
+		std::vector<VulkanBuffer> oversized;
+	};
+
+	ERROR_CODE SubmitBatch();
+	// Returns the batch uploads are recorded into, opening one when nothing is recording.
+	Batch *GetOpenBatch();
+	// Copies data into the ring, or into a buffer of its own when it takes more than half the ring.
+	ERROR_CODE		   Stage(const void *data, VkDeviceSize size, VkBuffer &outBuffer, VkDeviceSize &outOffset);
+	void			   WaitForBatch(const Batch &batch) const;
+	void			   RetireBatch(Batch &batch);
+	void			   RetireCompletedBatches();
+	[[nodiscard]] bool IsSameFamily() const { return m_transferFamily == m_graphicsFamily; }
+
+	SystemState			   m_state			= SystemState::Uninitialized;
+	VkDevice			   ref_vkDevice		= VK_NULL_HANDLE;
+	VulkanMemoryAllocator *ref_allocator	= nullptr;
+	VkQueue				   m_queue			= VK_NULL_HANDLE;
+	uint32_t			   m_transferFamily	= 0;
+	uint32_t			   m_graphicsFamily	= 0;
+	VkSemaphore			   m_timeline		= VK_NULL_HANDLE;
+	uint64_t			   m_nextValue		= 1;
+
+	VulkanBuffer m_ring;
+	uint8_t		*m_ringData	= nullptr;
+	VkDeviceSize m_ringSize	= 0;
+	VkDeviceSize m_ringHead	= 0;
+	VkDeviceSize m_ringTail	= 0;
+
+	std::array<Batch, MAX_BATCHES>							 m_batches;
+	uint32_t												 m_current = 0;
+	std::vector<std::pair<uint64_t, VkBufferMemoryBarrier2>> m_bufferAcquires;
+	std::vector<std::pair<uint64_t, VkImageMemoryBarrier2>>	 m_imageAcquires;
+	std::mutex												 m_mutex;
+};
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
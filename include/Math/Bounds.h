@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Math/Math.h"
+
+namespace PE::Math {
+// An empty box has min > max, growing it by any point makes it valid.
+struct BoundingBox {
+	Vector3 min = Vector3(Infinity);
+	Vector3 max = Vector3(-Infinity);
+
+	void Grow(const Vector3 &point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+	[[nodiscard]] bool	  IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+	[[nodiscard]] Vector3 GetCenter() const { return (min + max) * 0.5f; }
+};
+
+struct BoundingSphere {
+	Vector3 center = Vector3Zero;
+	float	radius = 0.0f;
+};
+
+// Six inward facing planes, xyz is the unit normal and w the distance, so dot(n, p) + w >= 0 is inside.
+struct Frustum {
+	enum Plane : uint8_t { Left, Right, Bottom, Top, Near, Far, Count };
+	Vector4 planes[Count];
+};
+
+// Planes of a view-projection matrix with the engine's zero to one clip depth.
+[[nodiscard]] Frustum ExtractFrustum(const Matrix4 &viewProjection);
+
+// Length of the longest axis of matrix, how much it stretches a distance at most.
+[[nodiscard]] inline float GetMaxScale(const Matrix4 &matrix) {
+	return std::sqrt(
+		Max(LengthSq(Vector3(matrix[0])), Max(LengthSq(Vector3(matrix[1])), LengthSq(Vector3(matrix[2])))));
+}
+
+// Moves the sphere into the space of matrix, the radius grows by the largest axis scale so it stays conservative.
+[[nodiscard]] inline BoundingSphere TransformSphere(const BoundingSphere &sphere, const Matrix4 &matrix) {
+	return {Vector3(matrix * Vector4(sphere.center, 1.0f)), sphere.radius * GetMaxScale(matrix)};
+}
+
+// Tests count spheres given as separate center and radius arrays, 4 per SSE2 register. visible[i] is 1 if sphere i
+// touches the frustum and 0 otherwise, the number of visible spheres is returned.
+size_t CullSpheres(const Frustum &frustum, const float *centerX, const float *centerY, const float *centerZ,
+				   const float *radius, size_t count, uint8_t *visible);
+}  // namespace PE::Math
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Math/Math.h"
+
+namespace PE::Math {
+// Batched TRS -> matrix kernel. Inputs are structure of arrays so a SIMD register holds the same component of 4
+// (SSE2) or 8 (AVX2, PE_ENABLE_AVX2) transforms, the resulting matrices are scattered to wherever the caller points.
+//
+// local = translate * rotateY * rotateX * rotateZ * scale, the same Euler order TransformSystem always used, and
+// world = parentWorld * local. Every transform goes through the vector path, a partial group is padded instead of
+// falling back to scalar code, so a transform's result doesn't depend on how the batch was split.
+struct TransformBatch {
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> rotationX, rotationY, rotationZ;	 // in radians
+	std::vector<float> scaleX, scaleY, scaleZ;
+
+	std::vector<const Matrix4 *> parentWorld;  // IdentityMatrix() for roots
+	std::vector<Matrix4 *>		 local;
+	std::vector<Matrix4 *>		 world;
+
+	void Clear();
+	void Reserve(size_t count);
+	void Push(const Vector3 &position, const Vector3 &rotation, const Vector3 &scale, const Matrix4 *parentWorldMatrix,
+			  Matrix4 *localMatrix, Matrix4 *worldMatrix);
+	// Resize then Set lets several threads fill disjoint slots of the batch.
+	void Resize(size_t count);
+	void Set(size_t index, const Vector3 &position, const Vector3 &rotation, const Vector3 &scale,
+			 const Matrix4 *parentWorldMatrix, Matrix4 *localMatrix, Matrix4 *worldMatrix);
+	[[nodiscard]] size_t Size() const { return positionX.size(); }
+};
+
+// Lanes per SIMD group in this build.
+[[nodiscard]] size_t GetTransformBatchWidth();
+// Stable address of an identity matrix to use as the parent of roots.
+[[nodiscard]] const Matrix4 *IdentityMatrix();
+
+// Computes the transforms in [begin, end). Disjoint ranges of one batch can run on different threads.
+void ComputeTransformMatrices(const TransformBatch &batch, size_t begin, size_t end);
+}  // namespace PE::Math
\ No newline at end of file
@@ -31,6 +31,8 @@ public:
 private:
 	friend class GLFWCallbacks;
 
+	// Renders headlessFrameCount frames with a fixed time step, captures the requested ones and logs frame times.
+	void RunHeadless();
 	void CalculateFrameStats() const;
 	void OnWindowResize(int width, int height);
 	void OnWindowFocus(int focused);
@@ -12,8 +12,7 @@ struct Transform {
 	Math::Matrix4 localMatrix{Math::Matrix4Identity()};
 	Math::Matrix4 worldMatrix{Math::Matrix4Identity()};
 
-	uint32_t parentEntityID	   = UINT32_MAX;
-	uint32_t parentPackedIndex = UINT32_MAX;
+	uint32_t parentEntityID = UINT32_MAX;
 
 	TransformState state = TransformState::Clean;
 };
@@ -2,6 +2,7 @@
 #include "ECS/EntityManager.h"
 #include "ECS/ISystem.h"
 #include "Scene/Components/DayNightCycle.h"
+#include "TransformSystem.h"
 
 namespace PE::Scene::Systems {
 class DayNightSystem : public ECS::ISystem {
@@ -9,7 +10,7 @@ public:
 	DayNightSystem()		   = default;
 	~DayNightSystem() override = default;
 
-	ERROR_CODE Initialize(ECS::ESystemStage stage, ECS::EntityManager *entityManager);
+	ERROR_CODE Initialize(ECS::ESystemStage stage, ECS::EntityManager *entityManager, TransformSystem *transformSystem);
 	ERROR_CODE Shutdown() override;
 	void	   OnUpdate(float dt) override;
 	void	   IncreaseCycleDayDuration() const;
@@ -21,7 +22,8 @@ private:
 	void		  UpdateEnvironmentalEffects(Components::DayNightCycle &cycle, float dt);
 	Math::Vector4 CalculateLightColor(float sunHeight, const Components::DayNightCycle &cycle);
 
-	ECS::EntityManager *ref_eM = nullptr;
+	ECS::EntityManager *ref_eM				= nullptr;
+	TransformSystem	   *ref_transformSystem = nullptr;
 
 	static constexpr float MaxDayDuration = 60.0f;
 	static constexpr float MinDayDuration = 1.0f;
@@ -7,6 +7,7 @@
 #include "Graphics/Systems/CameraSystem.h"
 #include "Input/InputSystem.h"
 #include "Math/Math.h"
+#include "Math/TransformBatch.h"
 
 namespace PE::Scene::Systems {
 class TransformSystem : public ECS::ISystem {
@@ -24,35 +25,65 @@ public:
 
 	void OnUpdate(float dt) override;
 
-	void						SetPosition(uint32_t entityID, float x, float y, float z) const;
-	void						SetPosition(uint32_t entityID, Math::Vector3 pos) const;
+	void						SetPosition(uint32_t entityID, float x, float y, float z);
+	void						SetPosition(uint32_t entityID, Math::Vector3 pos);
 	[[nodiscard]] Math::Vector3 GetPosition(uint32_t entityID) const;
 
-	void						SetRotation(uint32_t entityID, float pitch, float yaw, float roll) const;  // in radians
-	void						SetRotation(uint32_t entityID, Math::Vector3 rot) const;				   // in radians
+	void						SetRotation(uint32_t entityID, float pitch, float yaw, float roll);	 // in radians
+	void						SetRotation(uint32_t entityID, Math::Vector3 rot);					 // in radians
 	[[nodiscard]] Math::Vector3 GetRotation(uint32_t entityID) const;
 
-	void						SetScale(uint32_t entityID, float x, float y, float z) const;
-	void						SetScale(uint32_t entityID, Math::Vector3 scale) const;
+	void						SetScale(uint32_t entityID, float x, float y, float z);
+	void						SetScale(uint32_t entityID, Math::Vector3 scale);
 	[[nodiscard]] Math::Vector3 GetScale(uint32_t entityID) const;
 
-	void UpdateWorldMatrix(Components::Transform &transform);
-	void UpdateWorldMatrix(Components::Transform &transform, const Components::Transform &parentTransform);
-
+	// Parent changes are applied on the next update and only touch the moved subtree. Attaching an entity below one
+	// of its own descendants is refused.
 	void AttachEntity(uint32_t childEntityID, uint32_t parentEntityID);
 	void DetachEntity(uint32_t entityID);
 
-	void MarkDirty() { m_isHierarchyDirty = true; }
+	// Queues the entity's subtree for the next update. Code that edits a Transform directly has to call this, only
+	// setting its state to Dirty is not picked up.
+	void MarkDirty(ECS::EntityID entityID);
+	// Entities whose world matrix the last update recomputed, for systems that mirror transforms elsewhere. Valid until
+	// the next update.
+	[[nodiscard]] const std::vector<ECS::EntityID> &GetUpdatedEntities() const { return m_updatedEntities; }
 
 private:
-	void RebuildTransformArray();
-	void DFSRebuild(uint32_t entityID, uint32_t currentParentPackedIndex, const std::vector<std::vector<uint32_t>> &adj,
-					std::vector<Components::Transform> &sortedData, std::vector<uint32_t> &sortedEntities);
+	// Hierarchy links of one transform, stored by entity index. Children form an intrusive doubly linked list, so
+	// linking and unlinking only touches the direct neighbours.
+	struct HierarchyNode {
+		ECS::EntityID entityID	  = ECS::INVALID_ENTITY_ID;	 // INVALID_ENTITY_ID if the slot has no transform
+		ECS::EntityID parent	  = ECS::INVALID_ENTITY_ID;
+		ECS::EntityID firstChild  = ECS::INVALID_ENTITY_ID;
+		ECS::EntityID nextSibling = ECS::INVALID_ENTITY_ID;
+		ECS::EntityID prevSibling = ECS::INVALID_ENTITY_ID;
+		uint32_t	  depth		  = 0;
+		uint32_t	  visitStamp  = 0;
+	};
+
+	void SyncHierarchy(ECS::ComponentArray<Components::Transform> &array);
+	void InsertNode(ECS::EntityID entityID);
+	void RemoveNode(ECS::EntityID entityID);
+	void ApplyParent(ECS::EntityID entityID, Components::Transform &transform,
+					 const ECS::ComponentArray<Components::Transform> &array);
+	void Link(ECS::EntityID entityID, ECS::EntityID parentID);
+	void Unlink(ECS::EntityID entityID);
+	void SetSubtreeDepth(ECS::EntityID entityID, uint32_t depth);
+	void CollectSubtree(ECS::EntityID entityID);
+
+	[[nodiscard]] HierarchyNode *FindNode(ECS::EntityID entityID);
+	[[nodiscard]] bool			 IsDescendant(ECS::EntityID entityID, ECS::EntityID ancestorID);
 
 	ECS::EntityManager		 *ref_eM	 = nullptr;
 	const Core::EngineConfig *ref_config = nullptr;
 
-	bool	 m_isHierarchyDirty	  = true;
-	uint32_t m_lastComponentCount = 0;
+	ECS::PagedSparseArray<HierarchyNode>	m_nodes;
+	std::vector<ECS::EntityID>				m_dirtyEntities;	// marked since the last update, may repeat
+	std::vector<ECS::EntityID>				m_updatedEntities;	// set to Updated last update, Clean again on the next
+	std::vector<std::vector<ECS::EntityID>> m_dirtyLevels;		// dirty subtrees bucketed by depth
+	std::vector<ECS::EntityID>				m_stack;
+	Math::TransformBatch					m_batch;  // SoA TRS of the level being propagated
+	uint32_t								m_visitStamp = 0;
 };
 }  // namespace PE::Scene::Systems
\ No newline at end of file
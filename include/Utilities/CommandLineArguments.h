@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+
 #include "Graphics/RenderConfig.h"
 #include "Logger.h"
 
@@ -13,5 +15,16 @@ struct CommandLineArguments {
 	bool						  enableVSync  = false;
 	uint16_t					  clientWidth  = 800;
 	uint16_t					  clientHeight = 600;
+	bool						  singleThreaded	= false;
+	uint16_t					  workerThreadCount = 0;
+	bool						  compressTextures	= true;
+	bool						  gpuDrivenCulling	= false;
+
+	// -headless [-frames N] [-capture 1,60,300] [-capturedir path] [-captureformat png|ppm]
+	bool				  headless			 = false;
+	uint32_t			  headlessFrameCount = 600;
+	std::vector<uint32_t> captureFrames;
+	std::string			  captureDirectory	 = "Captures";
+	std::string			  captureFormat		 = "png";
 };
 }  // namespace PE::Utilities
\ No newline at end of file
@@ -57,6 +57,15 @@ public:
 				if (currentSection == "Engine") {
 					if (key == "developerMode") {
 						args.developerMode = String::ParseBool(value);
+					} else if (key == "singleThreaded") {
+						args.singleThreaded = String::ParseBool(value);
+					} else if (key == "workerThreads") {
+						if (auto val = ParseNumber<uint16_t>(value); val.has_value())
+							args.workerThreadCount = *val;
+						else {
+							std::string logMessage = "Invalid value for 'workerThreads' in INI file: " + value;
+							PE_LOG_ERROR(logMessage);
+						}
 					}
 				} else if (currentSection == "Graphics") {
 					if (key == "api") {
@@ -73,6 +82,10 @@ public:
 							std::string logMessage = "Invalid value for 'width' in INI file: " + value;
 							PE_LOG_ERROR(logMessage);
 						}
+					} else if (key == "textureCompression") {
+						args.compressTextures = String::ParseBool(value);
+					} else if (key == "gpuCulling") {
+						args.gpuDrivenCulling = String::ParseBool(value);
 					}
 				} else if (key == "height") {
 					if (auto val = ParseNumber<uint16_t>(value); val.has_value())
@@ -144,6 +157,48 @@ public:
 				}
 			} else if (arg == "-vsync") {
 				args.enableVSync = true;
+			} else if (arg == "-headless") {
+				args.headless = true;
+			} else if (arg == "-frames") {
+				if (auto val = ParseNumber<uint32_t>(getNextArg())) {
+					args.headlessFrameCount = *val;
+				} else {
+					PE_LOG_ERROR("Invalid number format for: " + std::string(arg));
+				}
+			} else if (arg == "-capture") {
+				// Comma separated frame indices, counted from 0.
+				std::string_view frames = getNextArg();
+				while (!frames.empty()) {
+					const size_t		   comma = frames.find(',');
+					const std::string_view frame = frames.substr(0, comma);
+					if (auto val = ParseNumber<uint32_t>(frame)) {
+						args.captureFrames.push_back(*val);
+					} else {
+						PE_LOG_ERROR("Invalid frame index for " + std::string(arg) + ": " + std::string(frame));
+					}
+					frames = comma == std::string_view::npos ? std::string_view() : frames.substr(comma + 1);
+				}
+			} else if (arg == "-capturedir") {
+				args.captureDirectory = getNextArg();
+			} else if (arg == "-captureformat") {
+				const std::string_view format = getNextArg();
+				if (format == "png" || format == "ppm") {
+					args.captureFormat = format;
+				} else if (!format.empty()) {
+					PE_LOG_ERROR("Unknown capture format: " + std::string(format));
+				}
+			} else if (arg == "-notexcompress") {
+				args.compressTextures = false;
+			} else if (arg == "-gpuculling") {
+				args.gpuDrivenCulling = true;
+			} else if (arg == "-singlethread") {
+				args.singleThreaded = true;
+			} else if (arg == "-threads") {
+				if (auto val = ParseNumber<uint16_t>(getNextArg())) {
+					args.workerThreadCount = *val;
+				} else {
+					PE_LOG_ERROR("Invalid number format for: " + std::string(arg));
+				}
 			} else if (arg == "-width") {
 				if (auto val = ParseNumber<uint16_t>(getNextArg())) {
 					args.clientWidth = *val;
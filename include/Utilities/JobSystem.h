@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Common/Common.h"
+
+namespace PE::Utilities {
+// Fork/join counter. Incremented for every job submitted with it, decremented when that job finished.
+struct JobCounter {
+	std::atomic<uint32_t> pending{0};
+
+	[[nodiscard]] bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+using JobFunction = std::function<void()>;
+
+// Work-stealing job system. Every worker owns a deque, pushes and pops its own jobs LIFO at the back and steals
+// FIFO from the front of the other workers' deques. The thread that called Initialize is worker 0 and only runs
+// jobs while it waits on a counter.
+class JobSystem {
+public:
+	JobSystem() = delete;
+
+	// workerCount includes the calling thread. 0 picks std::thread::hardware_concurrency().
+	static ERROR_CODE Initialize(uint32_t workerCount = 0);
+	static ERROR_CODE Shutdown();
+
+	static void Run(JobFunction job, JobCounter *counter = nullptr);
+	static void Wait(const JobCounter &counter);
+	static bool TryExecuteJob();
+
+	// Splits [0, count) into chunks of at least grainSize and calls fn(begin, end) for each one. The caller runs the
+	// first chunk itself and helps with the rest until all of them are done, so nesting is fine.
+	template <typename TFunc>
+	static void ParallelForRange(size_t count, size_t grainSize, TFunc &&fn);
+
+	// Calls fn(element, index) for every element of data, chunked like ParallelForRange.
+	template <typename T, typename TFunc>
+	static void ParallelFor(std::span<T> data, size_t grainSize, TFunc &&fn);
+
+	[[nodiscard]] static uint32_t GetWorkerCount() { return static_cast<uint32_t>(s_queues.size()); }
+	[[nodiscard]] static uint32_t GetCurrentWorkerIndex();
+	[[nodiscard]] static bool	  IsRunning() { return s_state == SystemState::Running; }
+
+private:
+	struct Job {
+		JobFunction function;
+		JobCounter *counter = nullptr;
+	};
+
+	struct WorkerQueue {
+		std::mutex		mutex;
+		std::deque<Job> jobs;
+	};
+
+	static void WorkerLoop(uint32_t workerIndex);
+	static bool PopJob(Job &outJob);
+	static void Execute(Job &job);
+
+	static inline SystemState							s_state = SystemState::Uninitialized;
+	static inline std::vector<std::unique_ptr<WorkerQueue>> s_queues;
+	static inline std::vector<std::thread>				s_threads;
+	static inline std::atomic<uint32_t>					s_queuedJobs{0};
+	static inline std::atomic<bool>						s_shutdownRequested{false};
+	static inline std::mutex							s_wakeMutex;
+	static inline std::condition_variable				s_wakeCondition;
+
+	// Upper bound on chunks per worker. Small grains on huge ranges would otherwise flood the deques.
+	static constexpr size_t MAX_CHUNKS_PER_WORKER = 8;
+};
+
+template <typename TFunc>
+void JobSystem::ParallelForRange(const size_t count, size_t grainSize, TFunc &&fn) {
+	if (count == 0) return;
+
+	const size_t workerCount = IsRunning() ? GetWorkerCount() : 1;
+	const size_t maxChunks	 = workerCount * MAX_CHUNKS_PER_WORKER;
+	grainSize				 = std::max({grainSize, size_t{1}, (count + maxChunks - 1) / maxChunks});
+
+	if (workerCount <= 1 || count <= grainSize) {
+		fn(size_t{0}, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t begin = grainSize; begin < count; begin += grainSize) {
+		const size_t end = std::min(begin + grainSize, count);
+		Run([&fn, begin, end] { fn(begin, end); }, &counter);
+	}
+
+	fn(size_t{0}, grainSize);
+	Wait(counter);
+}
+
+template <typename T, typename TFunc>
+void JobSystem::ParallelFor(std::span<T> data, const size_t grainSize, TFunc &&fn) {
+	ParallelForRange(data.size(), grainSize, [data, &fn](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; ++i) fn(data[i], i);
+	});
+}
+}  // namespace PE::Utilities
\ No newline at end of file
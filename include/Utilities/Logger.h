@@ -2,6 +2,7 @@
 #include <cassert>
 #include <cstdint>
 #include <fstream>
+#include <mutex>
 #include <string>
 
 #include "Common/Common.h"
@@ -161,6 +162,8 @@ private:
 	static std::string	 s_logFilePath;
 	static size_t		 s_maxFiles;
 	static uint64_t		 s_maxFileSizeBytes;
+	// Recursive because the rotation helpers may log themselves. Systems log from job system workers.
+	static std::recursive_mutex s_mutex;
 
 	static std::string FormatMessage(LogLevel level, const std::string &msg, const char *file, const int line);
 	static std::string CurrentTimestampString();  // YYYYMMDD_HHMMSS
@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace PE::Utilities {
+// Two-level segregated fit allocator over an abstract [0, size) range. It never touches memory, it only hands out
+// offsets, so the same code manages GPU memory blocks or anything else addressed by offset. Free ranges sit in
+// size-class lists found through two bitmaps, allocation and free are O(1) and neighbouring free ranges are merged
+// right away.
+class TLSFAllocator {
+public:
+	static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+	struct Allocation {
+		uint64_t offset = 0;
+		uint64_t size	= 0;
+		uint32_t node	= INVALID_NODE;	 // pass to Free
+
+		[[nodiscard]] bool IsValid() const { return node != INVALID_NODE; }
+	};
+
+	explicit TLSFAllocator(uint64_t size);
+
+	// alignment has to be a power of two. Returns an invalid allocation when no free range fits.
+	[[nodiscard]] Allocation Allocate(uint64_t size, uint64_t alignment);
+	void					 Free(uint32_t node);
+	[[nodiscard]] Allocation Get(uint32_t node) const { return {m_nodes[node].offset, m_nodes[node].size, node}; }
+
+	[[nodiscard]] uint64_t GetSize() const { return m_size; }
+	[[nodiscard]] uint64_t GetUsedSize() const { return m_usedSize; }
+	[[nodiscard]] uint64_t GetFreeSize() const { return m_size - m_usedSize; }
+	[[nodiscard]] uint32_t GetAllocationCount() const { return m_allocationCount; }
+	[[nodiscard]] bool	   IsEmpty() const { return m_allocationCount == 0; }
+	// Free bytes outside the largest free range, the part of GetFreeSize a big allocation can't use.
+	[[nodiscard]] uint64_t GetFragmentedSize() const { return GetFreeSize() - GetLargestFreeRange(); }
+	[[nodiscard]] uint64_t GetLargestFreeRange() const;
+
+private:
+	static constexpr uint32_t SL_COUNT_LOG2 = 5;
+	static constexpr uint32_t SL_COUNT		= 1u << SL_COUNT_LOG2;
+	static constexpr uint32_t FL_COUNT		= 64 - SL_COUNT_LOG2 + 1;
+
+	struct Node {
+		uint64_t offset		  = 0;
+		uint64_t size		  = 0;
+		uint32_t prevPhysical = INVALID_NODE;
+		uint32_t nextPhysical = INVALID_NODE;
+		uint32_t prevFree	  = INVALID_NODE;
+		uint32_t nextFree	  = INVALID_NODE;
+		bool	 free		  = false;
+	};
+
+	static void Mapping(uint64_t size, uint32_t &fl, uint32_t &sl);
+
+	uint32_t CreateNode(uint64_t offset, uint64_t size);
+	void	 ReleaseNode(uint32_t node);
+	void	 InsertFree(uint32_t node);
+	void	 RemoveFree(uint32_t node);
+	// Splits the tail of node past size off into a new free node.
+	void	 SplitTail(uint32_t node, uint64_t size);
+	uint32_t FindFree(uint64_t size) const;
+
+	uint64_t								  m_size;
+	uint64_t								  m_usedSize		= 0;
+	uint32_t								  m_allocationCount	= 0;
+	uint64_t								  m_flBitmap		= 0;
+	std::array<uint32_t, FL_COUNT>			  m_slBitmaps{};
+	std::array<uint32_t, FL_COUNT * SL_COUNT> m_freeHeads;
+	std::vector<Node>						  m_nodes;
+	std::vector<uint32_t>					  m_unusedNodes;
+};
+}  // namespace PE::Utilities
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "Assets/AssetManager.h"
 
+#include <cmath>
 #include <format>
 
 #include "Assets/AssetInfo.h"
+#include "Assets/MeshProcessing.h"
 #include "Assets/Model.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureProcessing.h"
 #include "Common/Common.h"
 #include "Core/EngineConfig.h"
 #include "Graphics/GeometryGenerator.h"
@@ -51,8 +54,9 @@ static inline const std::filesystem::path DefaultShadowShaderPSPath =
 
 ERROR_CODE AssetManager::Initialize(Graphics::IRenderer *renderer, const Core::EngineConfig &engineConfig) {
 	PE_CHECK_STATE_INIT(s_state, "AssetManager is already initialized.");
-	s_state		 = SystemState::Initializing;
-	ref_renderer = renderer;
+	s_state			   = SystemState::Initializing;
+	ref_renderer	   = renderer;
+	s_compressTextures = engineConfig.renderConfig.compressTextures && renderer->SupportsBlockCompression();
 
 	const size_t defaultAmount = engineConfig.maxComponentTypeCount;
 	ReserveMemory(defaultAmount, defaultAmount, defaultAmount, defaultAmount, defaultAmount);
@@ -169,6 +173,15 @@ Graphics::TextureID AssetManager::RequestTexture(const std::string						  &name,
 		}
 	}
 
+	const size_t sourceSize = tempTex.GetTextureData().size();
+	Texture::Processing::GenerateMips(tempTex);
+	if (s_compressTextures) {
+		const Graphics::TextureCompression compression = Texture::Processing::GetCompression(params.type);
+		if (compression != Graphics::TextureCompression::None && Texture::Processing::Compress(tempTex, compression))
+			PE_LOG_INFO(std::format("Compressed texture {}: {} KB source, {} KB with mips.", texName,
+									sourceSize / 1024, tempTex.GetTextureData().size() / 1024));
+	}
+
 	const Graphics::TextureID id =
 		ref_renderer->CreateTexture(texName, tempTex.GetTextureData().data(), tempTex.GetTextureParameters());
 
@@ -197,14 +210,29 @@ Graphics::MeshID AssetManager::RequestMesh(const std::string &name) {
 Graphics::MeshID AssetManager::RequestMesh(const std::string &name, const Graphics::MeshData &meshData) {
 	if (const uint32_t handle = GetMeshHandle(name); Graphics::INVALID_HANDLE != handle) return handle;
 
-	const Graphics::MeshID id = ref_renderer->CreateMesh(name, meshData);
+	// Triangles are reordered for the post-transform cache and overdraw, then vertices for fetch locality.
+	Graphics::MeshData optimized = meshData;
+	Mesh::Processing::OptimizeMesh(optimized);
+
+	const Graphics::MeshID id = ref_renderer->CreateMesh(name, optimized);
 	if (id != Graphics::INVALID_HANDLE) {
 		MeshAssetInfo *newInfo = AllocateAsset(s_meshStore);
 		newInfo->name		   = name;
 		newInfo->type		   = AssetType::Mesh;
 		newInfo->ref_handle	   = id;
-		newInfo->vertexCount   = static_cast<uint32_t>(meshData.Vertices.size());
-		newInfo->indexCount	   = static_cast<uint32_t>(meshData.Indices.size());
+		newInfo->vertexCount   = static_cast<uint32_t>(optimized.Vertices.size());
+		newInfo->indexCount	   = static_cast<uint32_t>(optimized.Indices.size());
+
+		// Bounds for culling. The sphere shares the box center and reaches the farthest vertex, which is tighter
+		// than the box's half diagonal for most meshes.
+		for (const Graphics::Vertex &vertex : optimized.Vertices) newInfo->bounds.Grow(vertex.Position);
+		if (newInfo->bounds.IsValid()) {
+			newInfo->boundingSphere.center = newInfo->bounds.GetCenter();
+			float radiusSq				   = 0.0f;
+			for (const Graphics::Vertex &vertex : optimized.Vertices)
+				radiusSq = Math::Max(radiusSq, Math::LengthSq(vertex.Position - newInfo->boundingSphere.center));
+			newInfo->boundingSphere.radius = std::sqrt(radiusSq);
+		}
 
 		s_meshAssetRegistry[name] = newInfo;
 		s_meshesById[id]		  = newInfo;
@@ -387,12 +415,14 @@ ModelAssetInfo *AssetManager::RequestModel(std::string &modelName, const std::fi
 				PE_LOG_WARN("Can't load material of model at" + path.string());
 	} else {
 		RequestMaterial(DefaultMaterialName.data(), shaderName);
-		for (auto &[meshAssetName, materialAssetName] : result.modelAssetInfo.subMeshes)
-			materialAssetName = DefaultMaterialName;
+		for (ModelAssetInfo::SubMeshEntry &entry : result.modelAssetInfo.subMeshes)
+			entry.materialAssetName = DefaultMaterialName;
 	}
 	for (auto const &[assetInfo, meshData] : result.meshes) {
 		if (RequestMesh(assetInfo.name, meshData) == Graphics::INVALID_HANDLE)
 			PE_LOG_WARN("Can't load material of model at" + path.string());
+		else
+			s_meshAssetRegistry[assetInfo.name]->lodError = assetInfo.lodError;
 	}
 
 	ModelAssetInfo *newInfo = AllocateAsset(s_modelStore);
@@ -441,6 +471,13 @@ ModelAssetInfo *AssetManager::GetModelAssetInfo(const std::string &fileName) {
 	return nullptr;
 }
 
+const MeshAssetInfo *AssetManager::GetMeshAssetInfo(const Graphics::MeshID id) {
+	if (const auto it = s_meshesById.find(id); it != s_meshesById.end()) {
+		return static_cast<const MeshAssetInfo *>(it->second);
+	}
+	return nullptr;
+}
+
 void AssetManager::ReserveMemory(size_t textureCount, size_t meshCount, size_t materialCount, size_t modelCount,
 								 size_t shaderCount) {
 	s_textureStore.reserve(textureCount);
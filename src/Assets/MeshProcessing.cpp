@@ -0,0 +1,730 @@
+#include "Assets/MeshProcessing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+#include "Math/Bounds.h"
+
+namespace PE::Assets::Mesh::Processing {
+namespace {
+constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
+// Squared attribute distances are added to the squared geometric error of positions scaled into a unit cube.
+constexpr float NORMAL_WEIGHT = 0.01f;
+constexpr float UV_WEIGHT	  = 0.01f;
+// Border planes weigh their edge length squared times this, which holds the outline of open meshes in place.
+constexpr double BORDER_WEIGHT = 10.0;
+// A collapse that turns any triangle by more than about 75 degrees is rejected.
+constexpr float MIN_TURN_COS = 0.25f;
+
+// LOD levels stray at most this far from the full detail mesh, relative to its largest extent.
+constexpr float	 MAX_LOD_ERROR		= 0.1f;
+constexpr float	 MAX_LOD_KEEP_RATIO = 0.75f;
+constexpr size_t MIN_LOD_TRIANGLES	= 32;
+
+// A run of the cache optimized order is split for overdraw sorting where its ACMR stays within this factor.
+constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+enum class VertexKind : uint8_t {
+	Manifold,
+	Border,	 // on one open edge loop, only slides along it
+	Locked	 // non-manifold or where border loops touch, never moves
+};
+
+// Weighted sum of squared plane distances, x^T A x + 2 b.x + c, in double as the terms of large planes cancel out.
+struct Quadric {
+	double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+	double b0  = 0.0, b1 = 0.0, b2 = 0.0, c = 0.0;
+
+	// Summed plane weights, errors are divided by it.
+	double weight = 0.0;
+
+	// n is the unit normal of the plane dot(n, x) + d = 0.
+	void AddPlane(const Math::Vector3 &n, const double d, const double w) {
+		a00 += w * n.x * n.x;
+		a11 += w * n.y * n.y;
+		a22 += w * n.z * n.z;
+		a01 += w * n.x * n.y;
+		a02 += w * n.x * n.z;
+		a12 += w * n.y * n.z;
+		b0 += w * n.x * d;
+		b1 += w * n.y * d;
+		b2 += w * n.z * d;
+		c += w * d * d;
+		weight += w;
+	}
+
+	void Add(const Quadric &o) {
+		a00 += o.a00;
+		a11 += o.a11;
+		a22 += o.a22;
+		a01 += o.a01;
+		a02 += o.a02;
+		a12 += o.a12;
+		b0 += o.b0;
+		b1 += o.b1;
+		b2 += o.b2;
+		c += o.c;
+		weight += o.weight;
+	}
+
+	// Mean squared distance of p to the planes.
+	[[nodiscard]] double Error(const Math::Vector3 &p) const {
+		if (weight <= 0.0) return 0.0;
+		const double x	 = p.x, y = p.y, z = p.z;
+		const double sum = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+						   2.0 * (b0 * x + b1 * y + b2 * z) + c;
+		return std::max(sum, 0.0) / weight;
+	}
+};
+
+// Positions are welded bit for bit, the loader already split vertices by attributes only.
+struct PositionKey {
+	uint32_t bits[3];
+	bool	 operator==(const PositionKey &o) const { return std::memcmp(bits, o.bits, sizeof(bits)) == 0; }
+};
+
+struct PositionKeyHash {
+	size_t operator()(const PositionKey &k) const {
+		return (k.bits[0] * 73856093u) ^ (k.bits[1] * 19349663u) ^ (k.bits[2] * 83492791u);
+	}
+};
+
+uint64_t EdgeKey(const uint32_t from, const uint32_t to) { return (static_cast<uint64_t>(from) << 32) | to; }
+
+// Half edge collapses over welded positions. A vertex of the mesh is a wedge of its position, a position collapses
+// onto a neighbor by moving each of its wedges to the neighbor's wedge with the closest attributes, so no new vertex
+// is ever made and LOD levels share the source vertices. Collapses run in passes: the cheapest collapse of every
+// position is picked, they are applied cheapest first, and a collapse locks the triangles around it until the next
+// pass so all of a pass can be checked against the same triangles.
+class Simplifier {
+public:
+	explicit Simplifier(const Graphics::MeshData &meshData);
+
+	// Collapses until targetIndexCount or maxError is reached and returns the error so far. Calls go on from where
+	// the one before stopped.
+	float Run(size_t targetIndexCount, float maxError);
+	void  Extract(Graphics::MeshData &outMeshData) const;
+
+	[[nodiscard]] size_t GetIndexCount() const { return m_indices.size(); }
+	[[nodiscard]] float	 GetExtent() const { return m_extent; }
+
+private:
+	struct Collapse {
+		uint32_t from  = NO_VERTEX;
+		uint32_t to	   = NO_VERTEX;
+		double	 error = 0.0;  // squared geometric error
+		double	 cost  = 0.0;  // error plus attribute distance, collapses are applied in its order
+	};
+
+	[[nodiscard]] uint32_t GetPosition(const uint32_t vertex) const { return m_positionOf[vertex]; }
+
+	void			   ComputeQuadrics();
+	void			   BuildAdjacency();
+	void			   PickCollapses(double maxErrorSq);
+	void			   TryCollapse(uint32_t from, uint32_t to, double maxErrorSq);
+	[[nodiscard]] bool CanCollapse(uint32_t from, uint32_t to) const;
+	[[nodiscard]] bool TurnsTriangles(uint32_t from, uint32_t to) const;
+	uint32_t		   FindClosestWedge(uint32_t wedge, uint32_t position, float &outDistance) const;
+	size_t			   ApplyCollapse(const Collapse &collapse);
+	void			   RemapIndices();
+
+	const Graphics::MeshData &m_source;
+	float					  m_extent = 1.0f;
+	double					  m_error  = 0.0;  // largest squared error of an applied collapse
+
+	// Per vertex. A position is named by its first vertex, m_nextWedge links the vertices of a position in a ring.
+	std::vector<Math::Vector3> m_positions;	 // scaled into a unit cube
+	std::vector<uint32_t>	   m_positionOf;
+	std::vector<uint32_t>	   m_nextWedge;
+	std::vector<uint32_t>	   m_remap;	 // vertex a collapse in this pass moved a vertex to, itself otherwise
+
+	// Per position.
+	std::vector<Quadric>	m_quadrics;
+	std::vector<VertexKind> m_kinds;
+	std::vector<uint32_t>	m_borderNext;
+	std::vector<uint32_t>	m_borderPrev;
+	std::vector<Collapse>	m_bestCollapse;
+	std::vector<uint8_t>	m_locked;
+
+	// Triangles around every position, the ones of position p are m_adjacency[m_adjacencyOffsets[p]] up to the next.
+	std::vector<uint32_t> m_adjacencyOffsets;
+	std::vector<uint32_t> m_adjacency;
+
+	std::vector<uint32_t> m_indices;
+	std::vector<Collapse> m_collapses;
+};
+
+Simplifier::Simplifier(const Graphics::MeshData &meshData) : m_source(meshData) {
+	const size_t vertexCount = meshData.Vertices.size();
+
+	Math::BoundingBox box;
+	for (const Graphics::Vertex &vertex : meshData.Vertices) box.Grow(vertex.Position);
+	if (box.IsValid()) {
+		const Math::Vector3 size = box.max - box.min;
+		m_extent				 = Math::Max(size.x, Math::Max(size.y, size.z));
+		if (m_extent <= 0.0f) m_extent = 1.0f;
+	}
+
+	m_positions.resize(vertexCount);
+	m_positionOf.resize(vertexCount);
+	m_nextWedge.resize(vertexCount);
+	m_remap.resize(vertexCount);
+
+	std::unordered_map<PositionKey, uint32_t, PositionKeyHash> welded;
+	welded.reserve(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; ++v) {
+		const Math::Vector3 &position = meshData.Vertices[v].Position;
+		m_positions[v]				  = (position - box.min) / m_extent;
+		m_remap[v]					  = v;
+
+		PositionKey key;
+		std::memcpy(key.bits, &position.x, sizeof(key.bits));
+		const uint32_t first = welded.try_emplace(key, v).first->second;
+		m_positionOf[v]		 = first;
+		m_nextWedge[v]		 = v;
+		if (first != v) {
+			m_nextWedge[v]	   = m_nextWedge[first];
+			m_nextWedge[first] = v;
+		}
+	}
+
+	// Triangles that are already degenerate over welded positions can't be collapsed sensibly, they go right away.
+	m_indices.reserve(meshData.Indices.size());
+	for (size_t i = 0; i + 2 < meshData.Indices.size(); i += 3) {
+		const uint32_t a = meshData.Indices[i], b = meshData.Indices[i + 1], c = meshData.Indices[i + 2];
+		if (a >= vertexCount || b >= vertexCount || c >= vertexCount) continue;
+		if (GetPosition(a) == GetPosition(b) || GetPosition(b) == GetPosition(c) || GetPosition(c) == GetPosition(a))
+			continue;
+		m_indices.insert(m_indices.end(), {a, b, c});
+	}
+
+	m_quadrics.resize(vertexCount);
+	m_kinds.assign(vertexCount, VertexKind::Manifold);
+	m_borderNext.assign(vertexCount, NO_VERTEX);
+	m_borderPrev.assign(vertexCount, NO_VERTEX);
+	m_bestCollapse.resize(vertexCount);
+	m_locked.resize(vertexCount);
+	ComputeQuadrics();
+}
+
+void Simplifier::ComputeQuadrics() {
+	// Directed edges over positions. An edge without its twin is open, one that shows up twice is non-manifold.
+	std::unordered_map<uint64_t, uint32_t> edges;
+	edges.reserve(m_indices.size());
+	for (size_t i = 0; i < m_indices.size(); ++i) {
+		const size_t next = i % 3 == 2 ? i - 2 : i + 1;
+		edges[EdgeKey(GetPosition(m_indices[i]), GetPosition(m_indices[next]))]++;
+	}
+
+	std::vector<uint8_t> openOut(m_quadrics.size()), openIn(m_quadrics.size());
+	for (size_t t = 0; t < m_indices.size(); t += 3) {
+		const uint32_t p[3] = {GetPosition(m_indices[t]), GetPosition(m_indices[t + 1]), GetPosition(m_indices[t + 2])};
+
+		const Math::Vector3 &p0			= m_positions[p[0]];
+		const Math::Vector3	 cross		= Math::Cross(m_positions[p[1]] - p0, m_positions[p[2]] - p0);
+		const float			 doubleArea = Math::Length(cross);
+		if (doubleArea <= 0.0f) continue;
+
+		// Area weighted, so large triangles hold the surface more than slivers do.
+		const Math::Vector3 normal = cross / doubleArea;
+		const double		d	   = -Math::Dot(normal, p0);
+		for (const uint32_t position : p) m_quadrics[position].AddPlane(normal, d, 0.5 * doubleArea);
+
+		for (int e = 0; e < 3; ++e) {
+			const uint32_t from = p[e], to = p[(e + 1) % 3];
+			if (edges[EdgeKey(from, to)] > 1) {
+				m_kinds[from] = m_kinds[to] = VertexKind::Locked;
+				continue;
+			}
+			if (edges.contains(EdgeKey(to, from))) continue;
+
+			openOut[from]++;
+			openIn[to]++;
+			m_borderNext[from] = to;
+			m_borderPrev[to]   = from;
+
+			// A plane through the open edge, standing upright on the triangle.
+			const Math::Vector3 edge		 = m_positions[to] - m_positions[from];
+			const Math::Vector3 borderNormal = Math::Cross(edge, normal);
+			const float			length		 = Math::Length(borderNormal);
+			if (length <= 0.0f) continue;
+
+			const Math::Vector3 n = borderNormal / length;
+			const double		w = BORDER_WEIGHT * Math::LengthSq(edge);
+			m_quadrics[from].AddPlane(n, -Math::Dot(n, m_positions[from]), w);
+			m_quadrics[to].AddPlane(n, -Math::Dot(n, m_positions[from]), w);
+		}
+	}
+
+	for (size_t p = 0; p < m_kinds.size(); ++p) {
+		if (m_kinds[p] == VertexKind::Locked || (openOut[p] == 0 && openIn[p] == 0)) continue;
+		m_kinds[p] = openOut[p] == 1 && openIn[p] == 1 ? VertexKind::Border : VertexKind::Locked;
+	}
+}
+
+float Simplifier::Run(const size_t targetIndexCount, const float maxError) {
+	const double maxErrorSq = static_cast<double>(maxError / m_extent) * (maxError / m_extent);
+
+	while (m_indices.size() > targetIndexCount) {
+		BuildAdjacency();
+		PickCollapses(maxErrorSq);
+		if (m_collapses.empty()) break;
+
+		std::sort(m_collapses.begin(), m_collapses.end(),
+				  [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+		// A pass takes at most half of what is left to do, so the later collapses get picked on fresh costs.
+		const size_t triangleCount	 = m_indices.size() / 3;
+		const size_t targetTriangles = targetIndexCount / 3;
+		const size_t passGoal		 = triangleCount - (triangleCount - targetTriangles + 1) / 2;
+
+		std::fill(m_locked.begin(), m_locked.end(), 0);
+		size_t removed = 0;
+		for (const Collapse &collapse : m_collapses) {
+			if (triangleCount - removed <= passGoal) break;
+			if (m_locked[collapse.from] || m_locked[collapse.to]) continue;
+			if (TurnsTriangles(collapse.from, collapse.to)) continue;
+
+			removed += ApplyCollapse(collapse);
+			m_error = std::max(m_error, collapse.error);
+		}
+		if (removed == 0) break;
+
+		RemapIndices();
+	}
+
+	return static_cast<float>(std::sqrt(m_error)) * m_extent;
+}
+
+void Simplifier::BuildAdjacency() {
+	m_adjacencyOffsets.assign(m_positions.size() + 1, 0);
+	for (const uint32_t vertex : m_indices) m_adjacencyOffsets[GetPosition(vertex) + 1]++;
+	for (size_t p = 1; p < m_adjacencyOffsets.size(); ++p) m_adjacencyOffsets[p] += m_adjacencyOffsets[p - 1];
+
+	m_adjacency.resize(m_indices.size());
+	std::vector<uint32_t> cursor(m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < m_indices.size(); ++i)
+		m_adjacency[cursor[GetPosition(m_indices[i])]++] = static_cast<uint32_t>(i / 3);
+}
+
+void Simplifier::PickCollapses(const double maxErrorSq) {
+	for (Collapse &best : m_bestCollapse) best.to = NO_VERTEX;
+
+	for (size_t t = 0; t < m_indices.size(); t += 3) {
+		for (size_t e = 0; e < 3; ++e) {
+			const uint32_t a = GetPosition(m_indices[t + e]);
+			const uint32_t b = GetPosition(m_indices[t + (e + 1) % 3]);
+			TryCollapse(a, b, maxErrorSq);
+			TryCollapse(b, a, maxErrorSq);
+		}
+	}
+
+	m_collapses.clear();
+	for (const Collapse &best : m_bestCollapse)
+		if (best.to != NO_VERTEX) m_collapses.push_back(best);
+}
+
+void Simplifier::TryCollapse(const uint32_t from, const uint32_t to, const double maxErrorSq) {
+	if (!CanCollapse(from, to)) return;
+
+	// The error is the one the merged quadric leaves at the kept position.
+	Quadric merged = m_quadrics[from];
+	merged.Add(m_quadrics[to]);
+	const double error = merged.Error(m_positions[to]);
+	if (error > maxErrorSq) return;
+
+	// Attribute cost is the worst match any wedge of from gets.
+	float	 attributeCost = 0.0f;
+	uint32_t wedge		   = from;
+	do {
+		float distance;
+		FindClosestWedge(wedge, to, distance);
+		attributeCost = Math::Max(attributeCost, distance);
+		wedge		  = m_nextWedge[wedge];
+	} while (wedge != from);
+
+	Collapse	&best = m_bestCollapse[from];
+	const double cost = error + attributeCost;
+	if (best.to == NO_VERTEX || cost < best.cost) best = {from, to, error, cost};
+}
+
+bool Simplifier::CanCollapse(const uint32_t from, const uint32_t to) const {
+	switch (m_kinds[from]) {
+		case VertexKind::Manifold: return true;
+		case VertexKind::Border:
+			// Along the loop only, and never down to a loop of two edges.
+			return (to == m_borderNext[from] || to == m_borderPrev[from]) &&
+				   m_borderNext[m_borderNext[from]] != m_borderPrev[from];
+		default: return false;
+	}
+}
+
+bool Simplifier::TurnsTriangles(const uint32_t from, const uint32_t to) const {
+	const Math::Vector3 &target = m_positions[to];
+	for (uint32_t a = m_adjacencyOffsets[from]; a < m_adjacencyOffsets[from + 1]; ++a) {
+		const size_t   t	= 3 * static_cast<size_t>(m_adjacency[a]);
+		const uint32_t p[3] = {GetPosition(m_indices[t]), GetPosition(m_indices[t + 1]), GetPosition(m_indices[t + 2])};
+		if (p[0] == to || p[1] == to || p[2] == to) continue;  // collapses away
+
+		const int			 k	= p[0] == from ? 0 : (p[1] == from ? 1 : 2);
+		const Math::Vector3 &p1 = m_positions[p[(k + 1) % 3]];
+		const Math::Vector3 &p2 = m_positions[p[(k + 2) % 3]];
+
+		const Math::Vector3 before = Math::Cross(p1 - m_positions[from], p2 - m_positions[from]);
+		const Math::Vector3 after  = Math::Cross(p1 - target, p2 - target);
+		if (Math::Dot(before, after) <= MIN_TURN_COS * std::sqrt(Math::LengthSq(before) * Math::LengthSq(after)))
+			return true;
+	}
+	return false;
+}
+
+uint32_t Simplifier::FindClosestWedge(const uint32_t wedge, const uint32_t position, float &outDistance) const {
+	const Graphics::Vertex &vertex = m_source.Vertices[wedge];
+
+	uint32_t closest = position;
+	outDistance		 = Math::Infinity;
+	uint32_t other	 = position;
+	do {
+		const Graphics::Vertex &candidate = m_source.Vertices[other];
+		const Math::Vector2		uv		  = vertex.TexC - candidate.TexC;
+		const float				distance  = NORMAL_WEIGHT * Math::LengthSq(vertex.Normal - candidate.Normal) +
+											UV_WEIGHT * (uv.x * uv.x + uv.y * uv.y);
+		if (distance < outDistance) {
+			outDistance = distance;
+			closest		= other;
+		}
+		other = m_nextWedge[other];
+	} while (other != position);
+	return closest;
+}
+
+size_t Simplifier::ApplyCollapse(const Collapse &collapse) {
+	const uint32_t from = collapse.from, to = collapse.to;
+
+	uint32_t wedge = from;
+	do {
+		float distance;
+		m_remap[wedge] = FindClosestWedge(wedge, to, distance);
+		wedge		   = m_nextWedge[wedge];
+	} while (wedge != from);
+
+	m_quadrics[to].Add(m_quadrics[from]);
+
+	if (m_kinds[from] == VertexKind::Border) {
+		if (to == m_borderNext[from]) {
+			m_borderNext[m_borderPrev[from]] = to;
+			m_borderPrev[to]				 = m_borderPrev[from];
+		} else {
+			m_borderPrev[m_borderNext[from]] = to;
+			m_borderNext[to]				 = m_borderNext[from];
+		}
+	}
+
+	// Every position around from sees its triangles change, they wait for the next pass.
+	size_t removed = 0;
+	for (uint32_t a = m_adjacencyOffsets[from]; a < m_adjacencyOffsets[from + 1]; ++a) {
+		const size_t t	   = 3 * static_cast<size_t>(m_adjacency[a]);
+		bool		 hasTo = false;
+		for (size_t k = 0; k < 3; ++k) {
+			const uint32_t position = GetPosition(m_indices[t + k]);
+			m_locked[position]		= 1;
+			hasTo |= position == to;
+		}
+		if (hasTo) removed++;
+	}
+	m_locked[to] = 1;
+	return removed;
+}
+
+void Simplifier::RemapIndices() {
+	size_t write = 0;
+	for (size_t t = 0; t < m_indices.size(); t += 3) {
+		const uint32_t a = m_remap[m_indices[t]], b = m_remap[m_indices[t + 1]], c = m_remap[m_indices[t + 2]];
+		if (GetPosition(a) == GetPosition(b) || GetPosition(b) == GetPosition(c) || GetPosition(c) == GetPosition(a))
+			continue;
+		m_indices[write++] = a;
+		m_indices[write++] = b;
+		m_indices[write++] = c;
+	}
+	m_indices.resize(write);
+
+	for (uint32_t v = 0; v < m_remap.size(); ++v) m_remap[v] = v;
+}
+
+void Simplifier::Extract(Graphics::MeshData &outMeshData) const {
+	// Vertices are kept in the order the triangles first use them.
+	std::vector<uint32_t> newIndex(m_source.Vertices.size(), NO_VERTEX);
+	outMeshData.Vertices.clear();
+	outMeshData.Indices.resize(m_indices.size());
+	for (size_t i = 0; i < m_indices.size(); ++i) {
+		uint32_t &index = newIndex[m_indices[i]];
+		if (index == NO_VERTEX) {
+			index = static_cast<uint32_t>(outMeshData.Vertices.size());
+			outMeshData.Vertices.push_back(m_source.Vertices[m_indices[i]]);
+		}
+		outMeshData.Indices[i] = index;
+	}
+}
+
+// FIFO post-transform cache. A vertex stays cached until cacheSize other vertices were shaded after it.
+class VertexCache {
+public:
+	VertexCache(const size_t vertexCount, const uint32_t cacheSize)
+		: m_shadedAt(vertexCount, 0), m_cacheSize(cacheSize), m_time(cacheSize + 1) {}
+
+	// Shaded vertices since vertex was, more than the cache size once it is evicted.
+	[[nodiscard]] uint32_t GetAge(const uint32_t vertex) const { return m_time - m_shadedAt[vertex]; }
+
+	// Returns whether the vertex had to be shaded.
+	bool Access(const uint32_t vertex) {
+		if (GetAge(vertex) <= m_cacheSize) return false;
+		m_shadedAt[vertex] = m_time++;
+		return true;
+	}
+
+	void Flush() { m_time += m_cacheSize + 1; }
+
+private:
+	std::vector<uint32_t> m_shadedAt;
+	uint32_t			  m_cacheSize;
+	uint32_t			  m_time;
+};
+
+size_t CountCacheMisses(const std::span<const uint32_t> triangles, VertexCache &cache) {
+	size_t misses = 0;
+	for (const uint32_t vertex : triangles) misses += cache.Access(vertex);
+	return misses;
+}
+}  // namespace
+
+float Simplify(const Graphics::MeshData &meshData, const size_t targetIndexCount, const float maxError,
+			   Graphics::MeshData &outMeshData) {
+	Simplifier	simplifier(meshData);
+	const float error = simplifier.Run(targetIndexCount, maxError);
+	simplifier.Extract(outMeshData);
+	return error;
+}
+
+std::vector<LODLevel> GenerateLODs(const Graphics::MeshData &meshData, const std::span<const float> triangleRatios) {
+	std::vector<LODLevel> levels;
+	const size_t		  triangleCount = meshData.Indices.size() / 3;
+	if (triangleCount < MIN_LOD_TRIANGLES) return levels;
+
+	Simplifier	simplifier(meshData);
+	const float maxError	  = MAX_LOD_ERROR * simplifier.GetExtent();
+	size_t		previousCount = simplifier.GetIndexCount();
+	for (const float ratio : triangleRatios) {
+		const auto	targetIndexCount = 3 * static_cast<size_t>(static_cast<float>(triangleCount) * ratio);
+		const float error			 = simplifier.Run(targetIndexCount, maxError);
+
+		const size_t indexCount = simplifier.GetIndexCount();
+		if (indexCount == 0 || static_cast<float>(indexCount) > MAX_LOD_KEEP_RATIO * static_cast<float>(previousCount))
+			break;
+		previousCount = indexCount;
+
+		LODLevel &level = levels.emplace_back();
+		simplifier.Extract(level.meshData);
+		level.error = error;
+	}
+	return levels;
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const std::span<const uint32_t> indices, const size_t vertexCount,
+										 const uint32_t cacheSize) {
+	VertexCacheStatistics statistics;
+	if (indices.empty() || vertexCount == 0) return statistics;
+
+	VertexCache	 cache(vertexCount, cacheSize);
+	const auto	 misses		   = static_cast<float>(CountCacheMisses(indices, cache));
+	const size_t triangleCount = indices.size() / 3;
+	statistics.acmr			   = misses / static_cast<float>(triangleCount);
+	statistics.atvr			   = misses / static_cast<float>(vertexCount);
+	return statistics;
+}
+
+void OptimizeVertexCache(const std::span<uint32_t> indices, const size_t vertexCount,
+						 std::vector<uint32_t> *outClusters) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// Triangles around each vertex, and how many of them are still to be emitted.
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (const uint32_t vertex : indices) adjacencyOffsets[vertex + 1]++;
+	for (size_t v = 1; v <= vertexCount; ++v) adjacencyOffsets[v] += adjacencyOffsets[v - 1];
+
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; ++i) {
+		adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		liveTriangles[indices[i]]++;
+	}
+
+	VertexCache			  cache(vertexCount, VERTEX_CACHE_SIZE);
+	std::vector<uint8_t>  emitted(triangleCount, 0);
+	std::vector<uint32_t> deadEnds;	 // recently used vertices, where the walk resumes after a dead end
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+
+	uint32_t fan		  = indices[0];
+	uint32_t nextFallback = 0;	// vertices before it have no live triangles left
+	if (outClusters) outClusters->push_back(0);
+	while (fan != NO_VERTEX) {
+		candidates.clear();
+		for (uint32_t a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; ++a) {
+			const uint32_t triangle = adjacency[a];
+			if (emitted[triangle]) continue;
+			emitted[triangle] = 1;
+
+			for (size_t corner = 0; corner < 3; ++corner) {
+				const uint32_t vertex = indices[triangle * 3 + corner];
+				output.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+				cache.Access(vertex);
+			}
+		}
+
+		// The candidate whose fan would still be cached once emitted and that entered the cache first, or any that has
+		// triangles left.
+		uint32_t next		  = NO_VERTEX;
+		int64_t	 bestPriority = -1;
+		for (const uint32_t vertex : candidates) {
+			if (liveTriangles[vertex] == 0) continue;
+
+			int64_t priority = 0;
+			if (cache.GetAge(vertex) + 2 * liveTriangles[vertex] <= VERTEX_CACHE_SIZE) priority = cache.GetAge(vertex);
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				next		 = vertex;
+			}
+		}
+
+		if (next == NO_VERTEX) {
+			while (!deadEnds.empty() && next == NO_VERTEX) {
+				if (liveTriangles[deadEnds.back()] > 0) next = deadEnds.back();
+				deadEnds.pop_back();
+			}
+			while (next == NO_VERTEX && nextFallback < vertexCount) {
+				if (liveTriangles[nextFallback] > 0) next = nextFallback;
+				nextFallback++;
+			}
+			if (next != NO_VERTEX && outClusters) outClusters->push_back(static_cast<uint32_t>(output.size() / 3));
+		}
+		fan = next;
+	}
+	std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeOverdraw(const std::span<uint32_t> indices, const std::span<const Graphics::Vertex> vertices,
+					  const std::span<const uint32_t> clusters, const float threshold) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// Splits every cluster where the triangles since the last split were drawn at most threshold times worse than the
+	// whole cluster from a cold cache, which is how a reordered cluster starts.
+	std::vector<uint32_t> starts;
+	VertexCache			  cache(vertices.size(), VERTEX_CACHE_SIZE);
+	for (size_t c = 0; c < std::max<size_t>(clusters.size(), 1); ++c) {
+		const size_t begin = clusters.empty() ? 0 : clusters[c];
+		const size_t end   = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+		cache.Flush();
+		const auto	clusterMisses = CountCacheMisses(indices.subspan(begin * 3, (end - begin) * 3), cache);
+		const float maxACMR		  = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+		cache.Flush();
+		size_t splitStart = begin;
+		size_t misses	  = 0;
+		starts.push_back(static_cast<uint32_t>(begin));
+		for (size_t t = begin; t + 1 < end; ++t) {
+			misses += CountCacheMisses(indices.subspan(t * 3, 3), cache);
+			if (static_cast<float>(misses) <= maxACMR * static_cast<float>(t + 1 - splitStart)) {
+				starts.push_back(static_cast<uint32_t>(t + 1));
+				splitStart = t + 1;
+				misses	   = 0;
+				cache.Flush();
+			}
+		}
+	}
+
+	// Clusters facing away from the area weighted center of the mesh go first.
+	struct Cluster {
+		uint32_t	  first = 0;
+		uint32_t	  count = 0;
+		Math::Vector3 centroid{0.0f};
+		Math::Vector3 normal{0.0f};	 // area weighted
+		float		  area	= 0.0f;
+		float		  order = 0.0f;
+	};
+	std::vector<Cluster> sorted(starts.size());
+	Math::Vector3		 meshCentroid(0.0f);
+	float				 meshArea = 0.0f;
+	for (size_t c = 0; c < starts.size(); ++c) {
+		Cluster &cluster = sorted[c];
+		cluster.first	 = starts[c];
+		cluster.count	 = (c + 1 < starts.size() ? starts[c + 1] : static_cast<uint32_t>(triangleCount)) - starts[c];
+		for (uint32_t t = cluster.first; t < cluster.first + cluster.count; ++t) {
+			const Math::Vector3 &p0		= vertices[indices[t * 3]].Position;
+			const Math::Vector3 &p1		= vertices[indices[t * 3 + 1]].Position;
+			const Math::Vector3 &p2		= vertices[indices[t * 3 + 2]].Position;
+			const Math::Vector3	 normal = Math::Cross(p1 - p0, p2 - p0);
+			const float			 area	= Math::Length(normal);
+			cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+			cluster.normal += normal;
+			cluster.area += area;
+		}
+		meshCentroid += cluster.centroid;
+		meshArea += cluster.area;
+	}
+	if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+	for (Cluster &cluster : sorted) {
+		if (cluster.area <= 0.0f) continue;
+		const float normalLength = Math::Length(cluster.normal);
+		if (normalLength > 0.0f)
+			cluster.order = Math::Dot(cluster.centroid / cluster.area - meshCentroid, cluster.normal / normalLength);
+	}
+	std::ranges::stable_sort(sorted, std::ranges::greater{}, &Cluster::order);
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	for (const Cluster &cluster : sorted)
+		output.insert(output.end(), indices.begin() + cluster.first * 3,
+					  indices.begin() + (cluster.first + cluster.count) * 3);
+	std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeVertexFetch(Graphics::MeshData &meshData) {
+	std::vector<uint32_t>		  newIndex(meshData.Vertices.size(), NO_VERTEX);
+	std::vector<Graphics::Vertex> vertices;
+	vertices.reserve(meshData.Vertices.size());
+	for (uint32_t &vertex : meshData.Indices) {
+		uint32_t &index = newIndex[vertex];
+		if (index == NO_VERTEX) {
+			index = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(meshData.Vertices[vertex]);
+		}
+		vertex = index;
+	}
+	meshData.Vertices = std::move(vertices);
+}
+
+void OptimizeMesh(Graphics::MeshData &meshData) {
+	const size_t vertexCount = meshData.Vertices.size();
+	if (meshData.Indices.size() % 3 != 0 ||
+		std::ranges::any_of(meshData.Indices, [&](const uint32_t index) { return index >= vertexCount; }))
+		return;
+
+	std::vector<uint32_t> clusters;
+	OptimizeVertexCache(meshData.Indices, vertexCount, &clusters);
+	OptimizeOverdraw(meshData.Indices, meshData.Vertices, clusters, OVERDRAW_THRESHOLD);
+	OptimizeVertexFetch(meshData);
+}
+}  // namespace PE::Assets::Mesh::Processing
\ No newline at end of file
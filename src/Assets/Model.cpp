@@ -1,12 +1,15 @@
 #include "Assets/Model.h"
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <sstream>
 #include <vector>
 
 #include "Assets/AssetManager.h"
+#include "Assets/MeshProcessing.h"
 #include "Assets/Texture.h"
+#include "Utilities/JobSystem.h"
 #include "Utilities/Logger.h"
 
 namespace PE::Assets::Model::Loader {
@@ -89,6 +92,36 @@ void CalculateTangents(std::vector<Graphics::Vertex> &vertices, const std::vecto
 	}
 }
 
+// Triangle counts of the LOD levels relative to the full detail mesh, the last one is what distant props draw.
+constexpr std::array<float, Graphics::MAX_MESH_LODS> LOD_TRIANGLE_RATIOS = {0.5f, 0.25f, 0.1f};
+
+// Simplifies every submesh into its LOD chain, one job per submesh. The levels are appended to the meshes after all
+// full detail ones and named after their submesh.
+void GenerateSubMeshLODs(ModelLoadResult &result) {
+	const size_t										 subMeshCount = result.meshes.size();
+	std::vector<std::vector<Mesh::Processing::LODLevel>> levels(subMeshCount);
+	Utilities::JobSystem::ParallelForRange(subMeshCount, 1, [&](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			levels[i] = Mesh::Processing::GenerateLODs(result.meshes[i].meshData, LOD_TRIANGLE_RATIOS);
+	});
+
+	for (size_t i = 0; i < subMeshCount; ++i) {
+		const std::string baseName = result.meshes[i].assetInfo.name;
+		for (size_t l = 0; l < levels[i].size(); ++l) {
+			ProcessedMesh pm;
+			pm.meshData = std::move(levels[i][l].meshData);
+
+			pm.assetInfo.name		 = baseName + "_LOD" + std::to_string(l + 1);
+			pm.assetInfo.vertexCount = static_cast<uint32_t>(pm.meshData.Vertices.size());
+			pm.assetInfo.indexCount	 = static_cast<uint32_t>(pm.meshData.Indices.size());
+			pm.assetInfo.lodError	 = levels[i][l].error;
+
+			result.modelAssetInfo.subMeshes[i].lodMeshAssetNames.push_back(pm.assetInfo.name);
+			result.meshes.push_back(std::move(pm));
+		}
+	}
+}
+
 ModelLoadResult LoadOBJ(const std::filesystem::path &path) {
 	ModelLoadResult result;
 	std::ifstream	file(path);
@@ -217,6 +250,7 @@ ModelLoadResult LoadOBJ(const std::filesystem::path &path) {
 	}
 
 	FlushSubmesh("");
+	GenerateSubMeshLODs(result);
 	result.success = true;
 	return result;
 }
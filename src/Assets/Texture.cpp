@@ -1,7 +1,11 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <vector>
 
 #ifdef PE_D3D11
@@ -154,4 +158,105 @@ bool LoadCubemap(const std::vector<std::filesystem::path> &paths, Graphics::Text
 
 	return true;
 }
-}  // namespace PE::Assets::Texture::Loader
\ No newline at end of file
+}  // namespace PE::Assets::Texture::Loader
+
+namespace PE::Assets::Texture::Writer {
+namespace {
+void AppendBigEndian(std::vector<unsigned char> &out, const uint32_t value) {
+	out.push_back(static_cast<unsigned char>(value >> 24));
+	out.push_back(static_cast<unsigned char>(value >> 16));
+	out.push_back(static_cast<unsigned char>(value >> 8));
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+uint32_t Crc32(const unsigned char *data, const size_t size, uint32_t crc = 0xFFFFFFFFu) {
+	static const std::array<uint32_t, 256> table = [] {
+		std::array<uint32_t, 256> t{};
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			t[i] = c;
+		}
+		return t;
+	}();
+	for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+void AppendChunk(std::vector<unsigned char> &out, const char *type, const std::vector<unsigned char> &data) {
+	AppendBigEndian(out, static_cast<uint32_t>(data.size()));
+	const size_t typeOffset = out.size();
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), data.begin(), data.end());
+	AppendBigEndian(out, Crc32(out.data() + typeOffset, data.size() + 4) ^ 0xFFFFFFFFu);
+}
+
+bool WritePng(std::ofstream &file, const uint32_t width, const uint32_t height, const unsigned char *rgba) {
+	// Filter type 0 per row followed by the RGB pixels.
+	const size_t			   rowSize = static_cast<size_t>(width) * 3 + 1;
+	std::vector<unsigned char> raw(rowSize * height);
+	for (uint32_t y = 0; y < height; ++y) {
+		unsigned char *row = raw.data() + y * rowSize;
+		row[0]			   = 0;
+		for (uint32_t x = 0; x < width; ++x) std::memcpy(row + 1 + x * 3, rgba + (y * width + x) * 4, 3);
+	}
+
+	// zlib stream of stored deflate blocks, each holds at most 65535 bytes.
+	std::vector<unsigned char> zlib	  = {0x78, 0x01};
+	uint32_t				   a	  = 1;
+	uint32_t				   b	  = 0;
+	size_t					   offset = 0;
+	do {
+		const uint16_t blockSize = static_cast<uint16_t>(std::min<size_t>(raw.size() - offset, 65535));
+		const uint16_t inverse	 = ~blockSize;
+		zlib.push_back(offset + blockSize == raw.size() ? 1 : 0);
+		zlib.push_back(static_cast<unsigned char>(blockSize));
+		zlib.push_back(static_cast<unsigned char>(blockSize >> 8));
+		zlib.push_back(static_cast<unsigned char>(inverse));
+		zlib.push_back(static_cast<unsigned char>(inverse >> 8));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+		for (size_t i = offset; i < offset + blockSize; ++i) {
+			a = (a + raw[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		offset += blockSize;
+	} while (offset < raw.size());
+	AppendBigEndian(zlib, (b << 16) | a);
+
+	std::vector<unsigned char> header;
+	AppendBigEndian(header, width);
+	AppendBigEndian(header, height);
+	header.insert(header.end(), {8, 2, 0, 0, 0});  // 8-bit RGB, no interlace
+
+	std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	AppendChunk(png, "IHDR", header);
+	AppendChunk(png, "IDAT", zlib);
+	AppendChunk(png, "IEND", {});
+	file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+	return file.good();
+}
+
+bool WritePpm(std::ofstream &file, const uint32_t width, const uint32_t height, const unsigned char *rgba) {
+	file << "P6\n" << width << " " << height << "\n255\n";
+	std::vector<unsigned char> rgb(static_cast<size_t>(width) * height * 3);
+	for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) std::memcpy(&rgb[i * 3], rgba + i * 4, 3);
+	file.write(reinterpret_cast<const char *>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+	return file.good();
+}
+}  // namespace
+
+bool Write(const std::filesystem::path &path, const uint32_t width, const uint32_t height, const unsigned char *rgba) {
+	const bool isPng = path.extension() == ".png";
+	if (!isPng && path.extension() != ".ppm") {
+		PE_LOG_ERROR("Unsupported image format: " + path.string());
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		PE_LOG_ERROR("Failed to open " + path.string() + " for writing");
+		return false;
+	}
+	return isPng ? WritePng(file, width, height, rgba) : WritePpm(file, width, height, rgba);
+}
+}  // namespace PE::Assets::Texture::Writer
\ No newline at end of file
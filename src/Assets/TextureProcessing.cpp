@@ -0,0 +1,649 @@
+#include "Assets/TextureProcessing.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include "Utilities/JobSystem.h"
+#include "Utilities/Logger.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PE_TEXTURE_SSE2
+#endif
+
+namespace PE::Assets::Texture::Processing {
+namespace {
+enum class MipFilter { Linear, SRGB, Normal };
+
+constexpr size_t MIP_ROWS_PER_JOB = 32;
+
+// Interpolation weights of BC7 4-bit indices, out of 64.
+constexpr std::array<int, 16> BC7_WEIGHTS = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+// Weight of the second endpoint for each BC1 index in four color mode.
+constexpr std::array<float, 4> BC1_WEIGHTS = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+using BlockPixels = float[16][4];
+
+bool IsSRGB(const Graphics::TextureParameters &params) {
+#ifdef PE_D3D11
+	return params.format.dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+#else
+	return params.format.vulkanFormat == VK_FORMAT_R8G8B8A8_SRGB;
+#endif
+}
+
+void SetFormat(Graphics::TextureParameters &params, const bool srgb) {
+#ifdef PE_D3D11
+	DXGI_FORMAT &format = params.format.dxgiFormat;
+	switch (params.compression) {
+		case Graphics::TextureCompression::BC1:
+			format = srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+			break;
+		case Graphics::TextureCompression::BC3:
+			format = srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+			break;
+		case Graphics::TextureCompression::BC4: format = DXGI_FORMAT_BC4_UNORM; break;
+		case Graphics::TextureCompression::BC5: format = DXGI_FORMAT_BC5_UNORM; break;
+		case Graphics::TextureCompression::BC7:
+			format = srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+			break;
+		default: format = srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM; break;
+	}
+#else
+	VkFormat &format = params.format.vulkanFormat;
+	switch (params.compression) {
+		case Graphics::TextureCompression::BC1:
+			format = srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+			break;
+		case Graphics::TextureCompression::BC3:
+			format = srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+			break;
+		case Graphics::TextureCompression::BC4: format = VK_FORMAT_BC4_UNORM_BLOCK; break;
+		case Graphics::TextureCompression::BC5: format = VK_FORMAT_BC5_UNORM_BLOCK; break;
+		case Graphics::TextureCompression::BC7:
+			format = srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			break;
+		default: format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM; break;
+	}
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Mip generation
+// ---------------------------------------------------------------------------------------------------------------------
+const std::array<float, 256> &SRGBToLinearTable() {
+	static const std::array<float, 256> table = [] {
+		std::array<float, 256> values{};
+		for (int i = 0; i < 256; ++i) {
+			const float c = static_cast<float>(i) / 255.0f;
+			values[i]	  = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return values;
+	}();
+	return table;
+}
+
+uint8_t LinearToSRGB(const float value) {
+	static const std::array<uint8_t, 4096> table = [] {
+		std::array<uint8_t, 4096> values{};
+		for (int i = 0; i < 4096; ++i) {
+			const float c = static_cast<float>(i) / 4095.0f;
+			const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+			values[i]	  = static_cast<uint8_t>(std::lround(std::clamp(s, 0.0f, 1.0f) * 255.0f));
+		}
+		return values;
+	}();
+	return table[std::clamp(static_cast<int>(value * 4095.0f + 0.5f), 0, 4095)];
+}
+
+void AveragePixel(const uint8_t *a, const uint8_t *b, const uint8_t *c, const uint8_t *d, uint8_t *out,
+				  const MipFilter filter) {
+	switch (filter) {
+		case MipFilter::Linear:
+			for (int ch = 0; ch < 4; ++ch) out[ch] = static_cast<uint8_t>((a[ch] + b[ch] + c[ch] + d[ch] + 2) >> 2);
+			break;
+		case MipFilter::SRGB: {
+			const auto &toLinear = SRGBToLinearTable();
+			for (int ch = 0; ch < 3; ++ch)
+				out[ch] = LinearToSRGB((toLinear[a[ch]] + toLinear[b[ch]] + toLinear[c[ch]] + toLinear[d[ch]]) * 0.25f);
+			out[3] = static_cast<uint8_t>((a[3] + b[3] + c[3] + d[3] + 2) >> 2);
+			break;
+		}
+		case MipFilter::Normal: {
+			float n[3];
+			for (int ch = 0; ch < 3; ++ch) n[ch] = (a[ch] + b[ch] + c[ch] + d[ch]) / 510.0f - 2.0f;
+			const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length < 1e-6f) {
+				n[0] = 0.0f;
+				n[1] = 0.0f;
+				n[2] = 1.0f;
+			} else {
+				for (float &v : n) v /= length;
+			}
+			for (int ch = 0; ch < 3; ++ch) out[ch] = static_cast<uint8_t>(std::lround((n[ch] * 0.5f + 0.5f) * 255.0f));
+			out[3] = static_cast<uint8_t>((a[3] + b[3] + c[3] + d[3] + 2) >> 2);
+			break;
+		}
+	}
+}
+
+#ifdef PE_TEXTURE_SSE2
+// Box filters four destination pixels per iteration, exactly like the scalar Linear path. Returns how many pixels of
+// the row it wrote.
+uint32_t AverageRowSSE2(const uint8_t *row0, const uint8_t *row1, uint8_t *out, const uint32_t dstWidth) {
+	const __m128i zero	= _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(2);
+
+	uint32_t x = 0;
+	for (; x + 4 <= dstWidth; x += 4) {
+		const auto	 *a	 = reinterpret_cast<const __m128i *>(row0 + x * 8);
+		const auto	 *b	 = reinterpret_cast<const __m128i *>(row1 + x * 8);
+		const __m128i a0 = _mm_loadu_si128(a);
+		const __m128i a1 = _mm_loadu_si128(a + 1);
+		const __m128i b0 = _mm_loadu_si128(b);
+		const __m128i b1 = _mm_loadu_si128(b + 1);
+
+		// Vertical sums in 16 bits, two source pixels per register.
+		const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+		const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+		const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+		const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+		// Adding the upper pixel onto the lower one leaves each destination pixel in the low half.
+		const __m128i h0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+		const __m128i h1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+		const __m128i h2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+		const __m128i h3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+
+		const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1), round), 2);
+		const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h2, h3), round), 2);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + x * 4), _mm_packus_epi16(lo, hi));
+	}
+	return x;
+}
+#endif
+
+// Halves a level. An odd last row or column of the source is dropped, a source extent of 1 is repeated.
+void Downsample(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, uint8_t *dst,
+				const MipFilter filter) {
+	const uint32_t dstWidth	 = std::max(srcWidth / 2, 1u);
+	const uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+
+	Utilities::JobSystem::ParallelForRange(dstHeight, MIP_ROWS_PER_JOB, [&](const size_t begin, const size_t end) {
+		for (size_t y = begin; y < end; ++y) {
+			const uint8_t *row0 = src + std::min<size_t>(y * 2, srcHeight - 1) * srcWidth * 4;
+			const uint8_t *row1 = src + std::min<size_t>(y * 2 + 1, srcHeight - 1) * srcWidth * 4;
+			uint8_t		  *out	= dst + y * dstWidth * 4;
+
+			uint32_t x = 0;
+#ifdef PE_TEXTURE_SSE2
+			if (filter == MipFilter::Linear && srcWidth >= 2) x = AverageRowSSE2(row0, row1, out, dstWidth);
+#endif
+			for (; x < dstWidth; ++x) {
+				const size_t x0 = std::min(x * 2, srcWidth - 1) * 4;
+				const size_t x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+				AveragePixel(row0 + x0, row0 + x1, row1 + x0, row1 + x1, out + x * 4, filter);
+			}
+		}
+	});
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Block encoders. Every encoder fits a line through the block's colors, picks indices along it, then refits the
+// endpoints to those indices with least squares once and keeps whichever pair has the lower error.
+// ---------------------------------------------------------------------------------------------------------------------
+template <int N>
+void FitLine(const BlockPixels &pixels, float (&e0)[4], float (&e1)[4]) {
+	float mean[4]{}, low[4], high[4];
+	for (int ch = 0; ch < N; ++ch) {
+		low[ch]	 = 255.0f;
+		high[ch] = 0.0f;
+	}
+	for (const auto &pixel : pixels) {
+		for (int ch = 0; ch < N; ++ch) {
+			mean[ch] += pixel[ch] / 16.0f;
+			low[ch]	 = std::min(low[ch], pixel[ch]);
+			high[ch] = std::max(high[ch], pixel[ch]);
+		}
+	}
+
+	float covariance[N][N]{};
+	for (const auto &pixel : pixels) {
+		for (int i = 0; i < N; ++i)
+			for (int j = 0; j < N; ++j) covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+	}
+
+	// Power iteration from the bounding box diagonal converges to the principal axis in a few steps.
+	float axis[4]{};
+	for (int ch = 0; ch < N; ++ch) axis[ch] = high[ch] - low[ch];
+	for (int iteration = 0; iteration < 4; ++iteration) {
+		float next[4]{}, length = 0.0f;
+		for (int i = 0; i < N; ++i) {
+			for (int j = 0; j < N; ++j) next[i] += covariance[i][j] * axis[j];
+			length = std::max(length, std::abs(next[i]));
+		}
+		if (length < 1e-6f) break;
+		for (int ch = 0; ch < N; ++ch) axis[ch] = next[ch] / length;
+	}
+
+	float axisLengthSq = 0.0f;
+	for (int ch = 0; ch < N; ++ch) axisLengthSq += axis[ch] * axis[ch];
+	if (axisLengthSq < 1e-12f) {
+		for (int ch = 0; ch < N; ++ch) e0[ch] = e1[ch] = mean[ch];
+		return;
+	}
+
+	float tMin = 0.0f, tMax = 0.0f;
+	for (const auto &pixel : pixels) {
+		float t = 0.0f;
+		for (int ch = 0; ch < N; ++ch) t += (pixel[ch] - mean[ch]) * axis[ch];
+		tMin = std::min(tMin, t);
+		tMax = std::max(tMax, t);
+	}
+	for (int ch = 0; ch < N; ++ch) {
+		e0[ch] = std::clamp(mean[ch] + axis[ch] * tMin / axisLengthSq, 0.0f, 255.0f);
+		e1[ch] = std::clamp(mean[ch] + axis[ch] * tMax / axisLengthSq, 0.0f, 255.0f);
+	}
+}
+
+// Endpoints with the least squared error for fixed per pixel weights of e1.
+template <int N>
+bool SolveEndpoints(const BlockPixels &pixels, const float (&weights)[16], float (&e0)[4], float (&e1)[4]) {
+	float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[4]{}, bx[4]{};
+	for (int i = 0; i < 16; ++i) {
+		const float b = weights[i];
+		const float a = 1.0f - b;
+		aa += a * a;
+		bb += b * b;
+		ab += a * b;
+		for (int ch = 0; ch < N; ++ch) {
+			ax[ch] += a * pixels[i][ch];
+			bx[ch] += b * pixels[i][ch];
+		}
+	}
+
+	const float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f) return false;
+
+	for (int ch = 0; ch < N; ++ch) {
+		e0[ch] = std::clamp((bb * ax[ch] - ab * bx[ch]) / determinant, 0.0f, 255.0f);
+		e1[ch] = std::clamp((aa * bx[ch] - ab * ax[ch]) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+void LoadBlock(const uint8_t *block, BlockPixels &pixels) {
+	for (int i = 0; i < 16; ++i)
+		for (int ch = 0; ch < 4; ++ch) pixels[i][ch] = block[i * 4 + ch];
+}
+
+// --- BC1 ---
+uint16_t To565(const float (&color)[4]) {
+	const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+	const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+	const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void From565(const uint16_t value, int (&color)[3]) {
+	const int r = value >> 11, g = (value >> 5) & 63, b = value & 31;
+	color[0]	= (r << 3) | (r >> 2);
+	color[1]	= (g << 2) | (g >> 4);
+	color[2]	= (b << 3) | (b >> 2);
+}
+
+// Orders the endpoints for four color mode and picks the nearest palette entry per pixel. Returns the squared error.
+uint32_t FitBC1(const uint8_t *block, uint16_t &c0, uint16_t &c1, uint32_t &outIndices) {
+	if (c0 < c1) std::swap(c0, c1);
+
+	int palette[4][3];
+	From565(c0, palette[0]);
+	From565(c1, palette[1]);
+	for (int ch = 0; ch < 3; ++ch) {
+		palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+		palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+	}
+	// Equal endpoints decode in three color mode, where only index 0 still means c0.
+	const int entries = c0 == c1 ? 1 : 4;
+
+	uint32_t error = 0;
+	outIndices	   = 0;
+	for (int i = 0; i < 16; ++i) {
+		uint32_t bestError = UINT32_MAX, bestIndex = 0;
+		for (int entry = 0; entry < entries; ++entry) {
+			uint32_t entryError = 0;
+			for (int ch = 0; ch < 3; ++ch) {
+				const int diff = block[i * 4 + ch] - palette[entry][ch];
+				entryError += diff * diff;
+			}
+			if (entryError < bestError) {
+				bestError = entryError;
+				bestIndex = entry;
+			}
+		}
+		outIndices |= bestIndex << (i * 2);
+		error += bestError;
+	}
+	return error;
+}
+
+void EncodeBC1(const uint8_t *block, uint8_t *out) {
+	BlockPixels pixels;
+	LoadBlock(block, pixels);
+
+	float e0[4], e1[4];
+	FitLine<3>(pixels, e0, e1);
+	uint16_t c0 = To565(e1), c1 = To565(e0);
+	uint32_t indices;
+	uint32_t error = FitBC1(block, c0, c1, indices);
+
+	float weights[16];
+	for (int i = 0; i < 16; ++i) weights[i] = BC1_WEIGHTS[(indices >> (i * 2)) & 3];
+	if (error > 0 && SolveEndpoints<3>(pixels, weights, e0, e1)) {
+		uint16_t refined0 = To565(e0), refined1 = To565(e1);
+		uint32_t refinedIndices;
+		if (const uint32_t refinedError = FitBC1(block, refined0, refined1, refinedIndices); refinedError < error) {
+			c0		= refined0;
+			c1		= refined1;
+			indices = refinedIndices;
+		}
+	}
+
+	std::memcpy(out, &c0, 2);
+	std::memcpy(out + 2, &c1, 2);
+	std::memcpy(out + 4, &indices, 4);
+}
+
+// --- BC4, one channel of the block ---
+void EncodeBC4(const uint8_t *block, const int channel, uint8_t *out) {
+	int low = 255, high = 0;
+	for (int i = 0; i < 16; ++i) {
+		low	 = std::min<int>(low, block[i * 4 + channel]);
+		high = std::max<int>(high, block[i * 4 + channel]);
+	}
+
+	// high > low selects the eight value mode, index 0 is high, 1 is low and 2-7 step from high to low.
+	uint64_t bits = 0;
+	if (high > low) {
+		const int range = high - low;
+		for (int i = 0; i < 16; ++i) {
+			const int	   step	 = ((high - block[i * 4 + channel]) * 14 + range) / (2 * range);
+			const uint64_t index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+			bits |= index << (i * 3);
+		}
+	}
+
+	out[0] = static_cast<uint8_t>(high);
+	out[1] = static_cast<uint8_t>(low);
+	for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+// --- BC7, mode 6 only: one subset, RGBA endpoints of 7 bits plus a p-bit each and 4-bit indices ---
+struct Mode6Endpoints {
+	int color[2][4];  // 7 bits per channel
+	int pBit[2];
+
+	// The 8-bit value an endpoint channel decodes to.
+	[[nodiscard]] int Get(const int endpoint, const int ch) const {
+		return (color[endpoint][ch] << 1) | pBit[endpoint];
+	}
+};
+
+void QuantizeMode6(const float (&value)[4], const int endpoint, Mode6Endpoints &outEndpoints) {
+	float bestError = -1.0f;
+	for (int pBit = 0; pBit < 2; ++pBit) {
+		int	  color[4];
+		float error = 0.0f;
+		for (int ch = 0; ch < 4; ++ch) {
+			color[ch]		 = std::clamp(static_cast<int>(std::lround((value[ch] - pBit) / 2.0f)), 0, 127);
+			const float diff = static_cast<float>((color[ch] << 1) | pBit) - value[ch];
+			error += diff * diff;
+		}
+		if (bestError < 0.0f || error < bestError) {
+			bestError = error;
+			std::copy_n(color, 4, outEndpoints.color[endpoint]);
+			outEndpoints.pBit[endpoint] = pBit;
+		}
+	}
+}
+
+float FitMode6(const BlockPixels &pixels, const Mode6Endpoints &endpoints, uint8_t (&outIndices)[16]) {
+	int palette[16][4];
+	for (int entry = 0; entry < 16; ++entry) {
+		for (int ch = 0; ch < 4; ++ch) {
+			palette[entry][ch] = ((64 - BC7_WEIGHTS[entry]) * endpoints.Get(0, ch) +
+								  BC7_WEIGHTS[entry] * endpoints.Get(1, ch) + 32) >>
+								 6;
+		}
+	}
+
+	float direction[4], lengthSq = 0.0f;
+	for (int ch = 0; ch < 4; ++ch) {
+		direction[ch] = static_cast<float>(endpoints.Get(1, ch) - endpoints.Get(0, ch));
+		lengthSq += direction[ch] * direction[ch];
+	}
+
+	// Projecting onto the endpoint line finds the closest index up to rounding, its neighbours settle the rest.
+	float error = 0.0f;
+	for (int i = 0; i < 16; ++i) {
+		int guess = 0;
+		if (lengthSq > 0.0f) {
+			float t = 0.0f;
+			for (int ch = 0; ch < 4; ++ch) t += (pixels[i][ch] - endpoints.Get(0, ch)) * direction[ch];
+			guess = std::clamp(static_cast<int>(std::lround(t / lengthSq * 15.0f)), 0, 15);
+		}
+
+		float bestError = -1.0f;
+		for (int entry = std::max(guess - 1, 0); entry <= std::min(guess + 1, 15); ++entry) {
+			float entryError = 0.0f;
+			for (int ch = 0; ch < 4; ++ch) {
+				const float diff = pixels[i][ch] - palette[entry][ch];
+				entryError += diff * diff;
+			}
+			if (bestError < 0.0f || entryError < bestError) {
+				bestError	  = entryError;
+				outIndices[i] = static_cast<uint8_t>(entry);
+			}
+		}
+		error += bestError;
+	}
+	return error;
+}
+
+class BitWriter {
+public:
+	explicit BitWriter(uint8_t *out) : m_out(out) {}
+
+	void Write(const uint32_t value, const uint32_t bitCount) {
+		for (uint32_t bit = 0; bit < bitCount; ++bit, ++m_position)
+			if ((value >> bit) & 1) m_out[m_position >> 3] |= static_cast<uint8_t>(1u << (m_position & 7));
+	}
+
+private:
+	uint8_t *m_out;
+	uint32_t m_position = 0;
+};
+
+void EncodeBC7(const uint8_t *block, uint8_t *out) {
+	BlockPixels pixels;
+	LoadBlock(block, pixels);
+
+	float e0[4], e1[4];
+	FitLine<4>(pixels, e0, e1);
+	Mode6Endpoints endpoints{};
+	QuantizeMode6(e0, 0, endpoints);
+	QuantizeMode6(e1, 1, endpoints);
+	uint8_t indices[16];
+	float	error = FitMode6(pixels, endpoints, indices);
+
+	float weights[16];
+	for (int i = 0; i < 16; ++i) weights[i] = static_cast<float>(BC7_WEIGHTS[indices[i]]) / 64.0f;
+	if (error > 0.0f && SolveEndpoints<4>(pixels, weights, e0, e1)) {
+		Mode6Endpoints refined{};
+		QuantizeMode6(e0, 0, refined);
+		QuantizeMode6(e1, 1, refined);
+		uint8_t refinedIndices[16];
+		if (const float refinedError = FitMode6(pixels, refined, refinedIndices); refinedError < error) {
+			endpoints = refined;
+			std::copy_n(refinedIndices, 16, indices);
+		}
+	}
+
+	// The first index is stored without its top bit, so it has to be below 8. Swapping the endpoints mirrors them all.
+	if (indices[0] >= 8) {
+		std::swap(endpoints.color[0], endpoints.color[1]);
+		std::swap(endpoints.pBit[0], endpoints.pBit[1]);
+		for (uint8_t &index : indices) index = static_cast<uint8_t>(15 - index);
+	}
+
+	std::memset(out, 0, 16);
+	BitWriter writer(out);
+	writer.Write(1u << 6, 7);
+	for (int ch = 0; ch < 4; ++ch) {
+		writer.Write(endpoints.color[0][ch], 7);
+		writer.Write(endpoints.color[1][ch], 7);
+	}
+	writer.Write(endpoints.pBit[0], 1);
+	writer.Write(endpoints.pBit[1], 1);
+	writer.Write(indices[0], 3);
+	for (int i = 1; i < 16; ++i) writer.Write(indices[i], 4);
+}
+
+void EncodeBlock(const uint8_t *block, uint8_t *out, const Graphics::TextureCompression compression) {
+	switch (compression) {
+		case Graphics::TextureCompression::BC1: EncodeBC1(block, out); break;
+		case Graphics::TextureCompression::BC3:
+			EncodeBC4(block, 3, out);
+			EncodeBC1(block, out + 8);
+			break;
+		case Graphics::TextureCompression::BC4: EncodeBC4(block, 0, out); break;
+		case Graphics::TextureCompression::BC5:
+			EncodeBC4(block, 0, out);
+			EncodeBC4(block, 1, out + 8);
+			break;
+		case Graphics::TextureCompression::BC7: EncodeBC7(block, out); break;
+		default: break;
+	}
+}
+
+// Encodes one layer of one level. Blocks hanging over the edge repeat the last row and column.
+void EncodeLevel(const uint8_t *src, const uint32_t width, const uint32_t height, uint8_t *dst,
+				 const Graphics::TextureCompression compression) {
+	const uint32_t blocksX	 = (width + 3) / 4;
+	const uint32_t blocksY	 = (height + 3) / 4;
+	const uint32_t blockSize = Graphics::GetBlockSize(compression);
+
+	Utilities::JobSystem::ParallelForRange(blocksY, 1, [&](const size_t begin, const size_t end) {
+		uint8_t block[64];
+		for (size_t by = begin; by < end; ++by) {
+			for (uint32_t bx = 0; bx < blocksX; ++bx) {
+				for (uint32_t y = 0; y < 4; ++y) {
+					const size_t row = std::min<size_t>(by * 4 + y, height - 1);
+					for (uint32_t x = 0; x < 4; ++x) {
+						const size_t column = std::min(bx * 4 + x, width - 1);
+						std::memcpy(block + (y * 4 + x) * 4, src + (row * width + column) * 4, 4);
+					}
+				}
+				EncodeBlock(block, dst + (by * blocksX + bx) * blockSize, compression);
+			}
+		}
+	});
+}
+}  // namespace
+
+Graphics::TextureCompression GetCompression(const Graphics::TextureType type) {
+	switch (type) {
+		case Graphics::TextureType::Albedo:
+		case Graphics::TextureType::Emissive:
+		case Graphics::TextureType::Terrain_Layer_0:
+		case Graphics::TextureType::Terrain_Layer_1:
+		case Graphics::TextureType::Terrain_Layer_2:
+		case Graphics::TextureType::Terrain_Layer_3: return Graphics::TextureCompression::BC7;
+		case Graphics::TextureType::Normal: return Graphics::TextureCompression::BC5;
+		case Graphics::TextureType::Mask: return Graphics::TextureCompression::BC1;
+		case Graphics::TextureType::Terrain_Splat: return Graphics::TextureCompression::BC3;
+		case Graphics::TextureType::Displacement: return Graphics::TextureCompression::BC4;
+		// Nothing is known about what generic textures hold, so they stay exact.
+		case Graphics::TextureType::Generic_0:
+		case Graphics::TextureType::Generic_1:
+		default: return Graphics::TextureCompression::None;
+	}
+}
+
+uint8_t GetFullMipCount(const uint32_t width, const uint32_t height) {
+	return static_cast<uint8_t>(std::bit_width(std::max({width, height, 1u})));
+}
+
+void GenerateMips(Graphics::Texture &texture) {
+	auto &params = texture.GetTextureParameters();
+	if (params.compression != Graphics::TextureCompression::None || params.mipLevels != 1) {
+		PE_LOG_WARN("Mips can only be generated from a single level of uncompressed data.");
+		return;
+	}
+
+	const uint8_t levelCount = GetFullMipCount(params.width, params.height);
+	if (levelCount <= 1) return;
+
+	MipFilter filter = IsSRGB(params) ? MipFilter::SRGB : MipFilter::Linear;
+	if (params.type == Graphics::TextureType::Normal) filter = MipFilter::Normal;
+
+	auto		&source	   = texture.GetTextureData();
+	const size_t baseSize  = source.size();
+	params.mipLevels	   = levelCount;
+	source.resize(Graphics::GetTextureDataSize(params));
+
+	size_t srcOffset = 0;
+	size_t dstOffset = baseSize;
+	for (uint32_t level = 1; level < levelCount; ++level) {
+		const uint32_t srcWidth		= Graphics::GetMipExtent(params.width, level - 1);
+		const uint32_t srcHeight	= Graphics::GetMipExtent(params.height, level - 1);
+		const size_t   srcLevelSize = Graphics::GetMipLevelSize(params, level - 1);
+		const size_t   dstLevelSize = Graphics::GetMipLevelSize(params, level);
+		for (uint32_t layer = 0; layer < params.arrayLayers; ++layer) {
+			Downsample(source.data() + srcOffset + layer * srcLevelSize, srcWidth, srcHeight,
+					   source.data() + dstOffset + layer * dstLevelSize, filter);
+		}
+		srcOffset = dstOffset;
+		dstOffset += dstLevelSize * params.arrayLayers;
+	}
+}
+
+bool Compress(Graphics::Texture &texture, const Graphics::TextureCompression compression) {
+	auto &params = texture.GetTextureParameters();
+	if (compression == Graphics::TextureCompression::None) return true;
+	if (params.compression != Graphics::TextureCompression::None) {
+		PE_LOG_ERROR("Texture is already block compressed.");
+		return false;
+	}
+
+	const auto &source = texture.GetTextureData();
+	if (source.size() != Graphics::GetTextureDataSize(params)) {
+		PE_LOG_ERROR("Texture data doesn't match its parameters, can't compress it.");
+		return false;
+	}
+
+	Graphics::TextureParameters compressed = params;
+	compressed.compression				   = compression;
+	std::vector<unsigned char> data(Graphics::GetTextureDataSize(compressed));
+
+	size_t srcOffset = 0;
+	size_t dstOffset = 0;
+	for (uint32_t level = 0; level < params.mipLevels; ++level) {
+		const uint32_t width  = Graphics::GetMipExtent(params.width, level);
+		const uint32_t height = Graphics::GetMipExtent(params.height, level);
+		for (uint32_t layer = 0; layer < params.arrayLayers; ++layer) {
+			EncodeLevel(source.data() + srcOffset, width, height, data.data() + dstOffset, compression);
+			srcOffset += Graphics::GetMipLevelSize(params, level);
+			dstOffset += Graphics::GetMipLevelSize(compressed, level);
+		}
+	}
+
+	SetFormat(compressed, IsSRGB(params));
+	params						= compressed;
+	texture.GetTextureData()	= std::move(data);
+	return true;
+}
+}  // namespace PE::Assets::Texture::Processing
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "Scene/SceneLoader.h"
 #include "Scene/Systems/DayNightSystem.h"
 #include "Utilities/IOUtilities.h"
+#include "Utilities/JobSystem.h"
 #include "Utilities/MemoryUtilities.h"
 
 namespace PE::Core {
@@ -25,7 +26,9 @@ ERROR_CODE Engine::Initialize(Platform::PlatformSystem *platformSystem, EngineCo
 	m_sceneLoader	= new Scene::SceneLoader();
 
 	// Initialize Internal
+	PE_ENSURE_INIT_SILENT(result, Utilities::JobSystem::Initialize(config.parallelSystemUpdate ? config.workerThreadCount : 1));
 	PE_ENSURE_INIT_SILENT(result, m_entityManager->Initialize(config.maxEntityCount, config.maxComponentTypeCount));
+	m_entityManager->SetParallelUpdate(config.parallelSystemUpdate);
 	PE_ENSURE_INIT_SILENT(result, InitializeComponents(config));
 	PE_ENSURE_INIT_SILENT(result, InitializeSystems(config, window));
 
@@ -59,21 +62,26 @@ ERROR_CODE Engine::InitializeSystems(EngineConfig &config, GLFWwindow *window) {
 		m_cameraSystem->Initialize(ECS::ESystemStage::Camera, m_entityManager, ref_inputSystem, config.renderConfig),
 		"Camera system can't initialized.");
 	m_renderSystem = new Graphics::Systems::RenderSystem();
-	PE_ENSURE_INIT(
-		result, m_renderSystem->Initialize(ECS::ESystemStage::Render, m_entityManager, m_cameraSystem, window, config),
-		"Render system can't initialized.");
+	PE_ENSURE_INIT(result,
+				   m_renderSystem->Initialize(ECS::ESystemStage::Render, m_entityManager, m_cameraSystem,
+											  m_transformSystem, window, config),
+				   "Render system can't initialized.");
 	m_particleSystem = new Graphics::Systems::ParticleSystem();
 	PE_ENSURE_INIT(
 		result,
 		m_particleSystem->Initialize(ECS::ESystemStage::Particle, m_entityManager, m_renderSystem->GetRenderer()),
 		"Render system can't initialized.");
-	m_guiSystem = new Graphics::Systems::GUISystem();
-	PE_ENSURE_INIT(result,
-				   m_guiSystem->Initialize(ECS::ESystemStage::GUI, m_entityManager, m_sceneControlSystem,
-										   m_renderSystem->GetRenderer()),
-				   "GUI System failed to initialize.");
+	// ImGui needs a window for its input backend, and captured frames are cleaner without the overlay anyway.
+	if (!config.headless) {
+		m_guiSystem = new Graphics::Systems::GUISystem();
+		PE_ENSURE_INIT(result,
+					   m_guiSystem->Initialize(ECS::ESystemStage::GUI, m_entityManager, m_sceneControlSystem,
+											   m_transformSystem, m_renderSystem->GetRenderer()),
+					   "GUI System failed to initialize.");
+	}
 	m_dayNightSystem = new Scene::Systems::DayNightSystem();
-	PE_ENSURE_INIT(result, m_dayNightSystem->Initialize(ECS::ESystemStage::GameLogic, m_entityManager),
+	PE_ENSURE_INIT(result,
+				   m_dayNightSystem->Initialize(ECS::ESystemStage::GameLogic, m_entityManager, m_transformSystem),
 				   "Scene control system can't initialized.");
 	m_sceneControlSystem = new Scene::Systems::SceneControlSystem();
 	PE_ENSURE_INIT(result,
@@ -101,13 +109,7 @@ ERROR_CODE Engine::InitializeComponents(const EngineConfig &config) const {
 void Engine::UpdateApplication(const float dt) {
 	static float totalTime = 0.0f;
 
-	m_sceneControlSystem->OnUpdate(dt);
-	m_dayNightSystem->OnUpdate(dt);
-	m_transformSystem->OnUpdate(dt);
-	m_cameraSystem->OnUpdate(dt);
-	m_guiSystem->OnUpdate(dt);
-	m_particleSystem->OnUpdate(dt);
-	m_renderSystem->OnUpdate(dt);
+	m_entityManager->Update(dt);
 
 	totalTime += dt;
 }
@@ -139,6 +141,7 @@ ERROR_CODE Engine::Shutdown() {
 	ShutdownComponents();
 	Utilities::SafeShutdown(m_entityManager);
 	Assets::AssetManager::Shutdown();
+	Utilities::JobSystem::Shutdown();
 	m_state = SystemState::Uninitialized;
 
 	return ERROR_CODE::OK;
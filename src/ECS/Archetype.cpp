@@ -0,0 +1,134 @@
+#include "ECS/Archetype.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Utilities/Logger.h"
+
+namespace PE::ECS {
+namespace {
+uint32_t AlignUp(const uint32_t value, const uint32_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+}  // namespace
+
+Archetype::Archetype(const ComponentSignature &signature, const std::vector<const ComponentInfo *> &components)
+	: m_signature(signature), m_components(components) {
+	std::sort(m_components.begin(), m_components.end(),
+			  [](const ComponentInfo *a, const ComponentInfo *b) { return a->typeID < b->typeID; });
+
+	uint32_t rowSize		= sizeof(EntityID);
+	uint32_t paddingBudget	= 0;
+	uint32_t highestTypeID	= 0;
+	for (const ComponentInfo *info : m_components) {
+		rowSize += info->size;
+		paddingBudget += info->alignment;
+		highestTypeID = std::max(highestTypeID, info->typeID);
+	}
+
+	m_chunkCapacity = ARCHETYPE_CHUNK_SIZE > paddingBudget ? (ARCHETYPE_CHUNK_SIZE - paddingBudget) / rowSize : 0;
+	if (m_chunkCapacity == 0) {
+		// Component set is bigger than a chunk, fall back to one row per (oversized) chunk.
+		m_chunkCapacity = 1;
+		m_chunkBytes	= AlignUp(rowSize + paddingBudget, ARCHETYPE_CHUNK_ALIGNMENT);
+	}
+
+	m_columnOf.assign(m_components.empty() ? 0 : highestTypeID + 1, -1);
+	m_columnOffsets.resize(m_components.size());
+
+	uint32_t offset = m_chunkCapacity * sizeof(EntityID);
+	for (size_t column = 0; column < m_components.size(); ++column) {
+		const ComponentInfo *info = m_components[column];
+		offset					  = AlignUp(offset, info->alignment);
+		m_columnOffsets[column]	  = offset;
+		m_columnOf[info->typeID]  = static_cast<int16_t>(column);
+		offset += m_chunkCapacity * info->size;
+	}
+	assert(offset <= m_chunkBytes);
+}
+
+Archetype::~Archetype() {
+	Clear();
+	for (const ArchetypeChunk &chunk : m_chunks)
+		::operator delete(chunk.data, std::align_val_t{ARCHETYPE_CHUNK_ALIGNMENT});
+	m_chunks.clear();
+}
+
+EntityLocation Archetype::AllocateRow(const EntityID entityID, const uint32_t archetypeIndex) {
+	if (m_activeChunks == 0 || m_chunks[m_activeChunks - 1].count == m_chunkCapacity) {
+		if (m_activeChunks == m_chunks.size()) {
+			ArchetypeChunk chunk;
+			chunk.data =
+				static_cast<std::byte *>(::operator new(m_chunkBytes, std::align_val_t{ARCHETYPE_CHUNK_ALIGNMENT}));
+			m_chunks.push_back(chunk);
+		}
+		m_chunks[m_activeChunks].count = 0;
+		m_activeChunks++;
+	}
+
+	const uint32_t	chunkIndex = m_activeChunks - 1;
+	ArchetypeChunk &chunk	   = m_chunks[chunkIndex];
+	const uint32_t	row		   = chunk.count++;
+
+	reinterpret_cast<EntityID *>(chunk.data)[row] = entityID;
+	m_entityCount++;
+
+	return {archetypeIndex, chunkIndex, row};
+}
+
+EntityID Archetype::RemoveRow(const uint32_t chunkIndex, const uint32_t row, const bool destructRow) {
+	assert(chunkIndex < m_activeChunks && row < m_chunks[chunkIndex].count);
+
+	if (destructRow) {
+		for (uint32_t column = 0; column < m_components.size(); ++column)
+			m_components[column]->destruct(RowPtr(chunkIndex, column, row));
+	}
+
+	const uint32_t	lastChunkIndex = m_activeChunks - 1;
+	ArchetypeChunk &lastChunk	   = m_chunks[lastChunkIndex];
+	const uint32_t	lastRow		   = lastChunk.count - 1;
+	EntityID		movedEntity	   = INVALID_ENTITY_ID;
+
+	if (chunkIndex != lastChunkIndex || row != lastRow) {
+		for (uint32_t column = 0; column < m_components.size(); ++column) {
+			void *src = RowPtr(lastChunkIndex, column, lastRow);
+			m_components[column]->moveConstruct(RowPtr(chunkIndex, column, row), src);
+			m_components[column]->destruct(src);
+		}
+		movedEntity = reinterpret_cast<EntityID *>(lastChunk.data)[lastRow];
+		reinterpret_cast<EntityID *>(m_chunks[chunkIndex].data)[row] = movedEntity;
+	}
+
+	lastChunk.count--;
+	if (lastChunk.count == 0) m_activeChunks--;
+	m_entityCount--;
+
+	return movedEntity;
+}
+
+void Archetype::Clear() {
+	for (uint32_t chunkIndex = 0; chunkIndex < m_activeChunks; ++chunkIndex) {
+		ArchetypeChunk &chunk = m_chunks[chunkIndex];
+		for (uint32_t column = 0; column < m_components.size(); ++column)
+			for (uint32_t row = 0; row < chunk.count; ++row) m_components[column]->destruct(RowPtr(chunkIndex, column, row));
+		chunk.count = 0;
+	}
+	m_activeChunks = 0;
+	m_entityCount  = 0;
+}
+
+void *Archetype::GetComponent(const uint32_t chunkIndex, const uint32_t row, const uint32_t typeID) const {
+	if (typeID >= m_columnOf.size() || m_columnOf[typeID] < 0) {
+		PE_LOG_FATAL("Archetype doesn't contain the component.");
+		return nullptr;
+	}
+	return RowPtr(chunkIndex, static_cast<uint32_t>(m_columnOf[typeID]), row);
+}
+
+void *Archetype::GetColumn(const uint32_t chunkIndex, const uint32_t typeID) const {
+	if (typeID >= m_columnOf.size() || m_columnOf[typeID] < 0) {
+		PE_LOG_FATAL("Archetype doesn't contain the component.");
+		return nullptr;
+	}
+	return m_chunks[chunkIndex].data + m_columnOffsets[m_columnOf[typeID]];
+}
+}  // namespace PE::ECS
\ No newline at end of file
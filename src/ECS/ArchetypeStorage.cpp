@@ -0,0 +1,152 @@
+#include "ECS/ArchetypeStorage.h"
+
+#include <algorithm>
+
+namespace PE::ECS {
+ArchetypeStorage::~ArchetypeStorage() { ArchetypeStorage::Shutdown(); }
+
+ERROR_CODE ArchetypeStorage::Initialize(const uint32_t maxEntities) {
+	PE_CHECK_STATE_INIT(m_state, "ArchetypeStorage is already initialized.");
+	m_state = SystemState::Initializing;
+
+	m_componentInfos.assign(MAX_ARCHETYPE_COMPONENT_TYPES, ComponentInfo{});
+	m_locations.Clear();
+	m_locations.Reserve(maxEntities);
+	m_archetypes.clear();
+	m_archetypeLookup.clear();
+	FindOrCreateArchetype(ComponentSignature{});  // root archetype for entities without components
+
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE ArchetypeStorage::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
+	m_state = SystemState::ShuttingDown;
+
+	m_archetypes.clear();
+	m_archetypeLookup.clear();
+	m_locations.Clear();
+	m_componentInfos.clear();
+
+	m_state = SystemState::Uninitialized;
+	return ERROR_CODE::OK;
+}
+
+void ArchetypeStorage::DestroyEntity(const EntityID entityID) {
+	EntityLocation *slot = m_locations.Find(GetEntityIndex(entityID));
+	if (!slot || slot->archetype == UINT32_MAX) return;
+
+	const EntityLocation location = *slot;
+	const EntityID moved = m_archetypes[location.archetype]->RemoveRow(location.chunk, location.row, true);
+	PatchMovedEntity(moved, location);
+	*slot = EntityLocation{};
+}
+
+void ArchetypeStorage::Clear() {
+	for (const auto &archetype : m_archetypes) archetype->Clear();
+	m_locations.Clear();
+}
+
+bool ArchetypeStorage::IsRegistered(const uint32_t typeID) const {
+	return typeID < m_componentInfos.size() && m_componentInfos[typeID].IsValid();
+}
+
+const EntityLocation &ArchetypeStorage::GetLocation(const EntityID entityID) const {
+	static constexpr EntityLocation invalidLocation{};
+	const EntityLocation		   *location = m_locations.Find(GetEntityIndex(entityID));
+	return location ? *location : invalidLocation;
+}
+
+uint32_t ArchetypeStorage::GetArchetypeCount() const { return static_cast<uint32_t>(m_archetypes.size()); }
+
+ERROR_CODE ArchetypeStorage::RegisterComponentInfo(const ComponentInfo &info) {
+	if (info.typeID >= MAX_ARCHETYPE_COMPONENT_TYPES) {
+		PE_LOG_ERROR("Too many component types for archetype signature.");
+		return ERROR_CODE::MAX_COMPONENT_TYPES_REACHED;
+	}
+
+	if (m_componentInfos[info.typeID].IsValid()) {
+		PE_LOG_FATAL("Component is already registered!");
+		return ERROR_CODE::COMPONENT_ALREADY_REGISTERED;
+	}
+
+	m_componentInfos[info.typeID] = info;
+	return ERROR_CODE::OK;
+}
+
+uint32_t ArchetypeStorage::FindOrCreateArchetype(const ComponentSignature &signature) {
+	if (const auto it = m_archetypeLookup.find(signature); it != m_archetypeLookup.end()) return it->second;
+
+	std::vector<const ComponentInfo *> components;
+	for (uint32_t typeID = 0; typeID < MAX_ARCHETYPE_COMPONENT_TYPES; ++typeID)
+		if (signature.test(typeID)) components.push_back(&m_componentInfos[typeID]);
+
+	const auto index = static_cast<uint32_t>(m_archetypes.size());
+	m_archetypes.push_back(std::make_unique<Archetype>(signature, components));
+	m_archetypeLookup[signature] = index;
+	return index;
+}
+
+uint32_t ArchetypeStorage::GetAddTarget(const uint32_t archetypeIndex, const uint32_t typeID) {
+	if (typeID >= MAX_ARCHETYPE_COMPONENT_TYPES) {
+		PE_LOG_ERROR("Component type ID doesn't fit in an archetype signature.");
+		return UINT32_MAX;
+	}
+
+	if (const auto it = m_archetypes[archetypeIndex]->addEdges.find(typeID);
+		it != m_archetypes[archetypeIndex]->addEdges.end())
+		return it->second;
+
+	ComponentSignature signature = m_archetypes[archetypeIndex]->GetSignature();
+	signature.set(typeID);
+	const uint32_t target = FindOrCreateArchetype(signature);
+
+	m_archetypes[archetypeIndex]->addEdges[typeID] = target;
+	m_archetypes[target]->removeEdges[typeID]	   = archetypeIndex;
+	return target;
+}
+
+uint32_t ArchetypeStorage::GetRemoveTarget(const uint32_t archetypeIndex, const uint32_t typeID) {
+	if (const auto it = m_archetypes[archetypeIndex]->removeEdges.find(typeID);
+		it != m_archetypes[archetypeIndex]->removeEdges.end())
+		return it->second;
+
+	ComponentSignature signature = m_archetypes[archetypeIndex]->GetSignature();
+	signature.reset(typeID);
+	const uint32_t target = FindOrCreateArchetype(signature);
+
+	m_archetypes[archetypeIndex]->removeEdges[typeID] = target;
+	m_archetypes[target]->addEdges[typeID]			  = archetypeIndex;
+	return target;
+}
+
+EntityLocation ArchetypeStorage::MoveEntity(const EntityID entityID, const uint32_t targetArchetype) {
+	const EntityLocation oldLocation = AssureLocation(entityID);
+	Archetype			&source		 = *m_archetypes[oldLocation.archetype];
+	Archetype			&target		 = *m_archetypes[targetArchetype];
+
+	const EntityLocation newLocation = target.AllocateRow(entityID, targetArchetype);
+	for (const ComponentInfo *info : source.GetComponents()) {
+		// Columns missing in the target were already destroyed by the caller.
+		if (!target.HasComponent(info->typeID)) continue;
+
+		void *src = source.GetComponent(oldLocation.chunk, oldLocation.row, info->typeID);
+		info->moveConstruct(target.GetComponent(newLocation.chunk, newLocation.row, info->typeID), src);
+		info->destruct(src);
+	}
+
+	const EntityID moved = source.RemoveRow(oldLocation.chunk, oldLocation.row, false);
+	PatchMovedEntity(moved, oldLocation);
+
+	AssureLocation(entityID) = newLocation;
+	return newLocation;
+}
+
+void ArchetypeStorage::PatchMovedEntity(const EntityID movedEntity, const EntityLocation &location) {
+	if (movedEntity == INVALID_ENTITY_ID) return;
+	EntityLocation &movedLocation = AssureLocation(movedEntity);
+	movedLocation.chunk			  = location.chunk;
+	movedLocation.row			  = location.row;
+}
+}  // namespace PE::ECS
\ No newline at end of file
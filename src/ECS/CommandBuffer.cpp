@@ -0,0 +1,54 @@
+#include "ECS/CommandBuffer.h"
+
+#include <algorithm>
+
+#include "ECS/EntityManager.h"
+
+namespace PE::ECS {
+CommandBuffer::~CommandBuffer() { Reset(); }
+
+EntityID CommandBuffer::CreateEntity() {
+	const EntityID entityID = ref_eM->ReserveEntity();
+	if (entityID != INVALID_ENTITY_ID) Record(CommandType::CreateEntity, UINT32_MAX, entityID, nullptr, nullptr);
+	return entityID;
+}
+
+void CommandBuffer::DestroyEntity(const EntityID entityID) {
+	Record(CommandType::DestroyEntity, UINT32_MAX, entityID, nullptr, nullptr);
+}
+
+void CommandBuffer::Reset() {
+	for (const Command &command : m_commands)
+		if (command.component) command.table->destruct(command.component);
+
+	m_commands.clear();
+	m_blockIndex  = 0;
+	m_blockOffset = 0;
+}
+
+void *CommandBuffer::Allocate(const size_t size, const size_t alignment) {
+	// Blocks are never moved or freed until the buffer dies, so recorded pointers stay valid across growth.
+	while (m_blockIndex < m_blocks.size()) {
+		const ArenaBlock &block	 = m_blocks[m_blockIndex];
+		const size_t	  offset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+		if (offset + size <= block.size) {
+			m_blockOffset = offset + size;
+			return block.data.get() + offset;
+		}
+
+		m_blockIndex++;
+		m_blockOffset = 0;
+	}
+
+	const size_t blockSize = std::max(ARENA_BLOCK_SIZE, size);
+	m_blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+	m_blockIndex  = m_blocks.size() - 1;
+	m_blockOffset = size;
+	return m_blocks.back().data.get();
+}
+
+void CommandBuffer::Record(const CommandType type, const uint32_t typeID, const EntityID entityID, void *component,
+						   const ComponentCommandTable *table) {
+	m_commands.push_back({type, typeID, entityID, static_cast<uint32_t>(m_commands.size()), component, table});
+}
+}  // namespace PE::ECS
\ No newline at end of file
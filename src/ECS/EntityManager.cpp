@@ -1,24 +1,49 @@
 #include "ECS/EntityManager.h"
 
+#include <algorithm>
+#include <tuple>
+
 #include "Scene/EntityFactory.h"
+#include "Utilities/JobSystem.h"
 #include "Utilities/MemoryUtilities.h"
 
 namespace PE::ECS {
-ERROR_CODE EntityManager::Initialize(uint32_t maxEntities, uint32_t maxComponentTypes) {
+namespace {
+uint32_t GetPlaybackPhase(const CommandBuffer::CommandType type) {
+	switch (type) {
+		case CommandBuffer::CommandType::CreateEntity: return 0;
+		case CommandBuffer::CommandType::DestroyEntity: return 2;
+		default: return 1;
+	}
+}
+}  // namespace
+
+ERROR_CODE EntityManager::Initialize(uint32_t maxEntities, uint32_t maxComponentTypes, StorageMode storageMode) {
 	PE_CHECK_STATE_INIT(m_state, "Entity manager is already initialized");
 	m_state = SystemState::Initializing;
 
+	if (maxEntities > MAX_ENTITY_COUNT) {
+		PE_LOG_FATAL("Max entity count doesn't fit into the entity ID index bits.");
+		return ERROR_CODE::INVALID_ARGUMENT;
+	}
+
+	// Component masks are fixed size, anything above MAX_COMPONENT_TYPES could never be attached anyway.
 	ref_maxEntities		  = maxEntities;
-	ref_maxComponentTypes = maxComponentTypes;
+	ref_maxComponentTypes = std::min(maxComponentTypes, MAX_COMPONENT_TYPES);
+	m_storageMode		  = storageMode;
 
-	m_allComponentIndices.assign(maxEntities * maxComponentTypes, UINT32_MAX);
 	m_componentArrays.clear();
-	m_componentArrays.resize(maxComponentTypes);
+	m_componentArrays.resize(ref_maxComponentTypes);
 
-	while (!m_freeEntities.empty()) m_freeEntities.pop();
-	for (EntityID i = 0; i < maxEntities; ++i) m_freeEntities.push(maxEntities - 1 - i);
+	m_entities.clear();
+	m_componentMasks.clear();
+	m_freeHead	 = ENTITY_INDEX_MASK;
+	m_aliveCount = 0;
+	m_nextEntityIndex.store(0, std::memory_order_relaxed);
+	SyncCommandBufferCount();
 
 	ERROR_CODE result = ERROR_CODE::OK;
+	if (m_storageMode == StorageMode::Archetype) PE_CHECK(result, m_archetypeStorage.Initialize(maxEntities));
 	PE_CHECK(result, Scene::EntityFactory::Initialize(this));
 
 	m_state = SystemState::Running;
@@ -26,79 +51,266 @@ ERROR_CODE EntityManager::Initialize(uint32_t maxEntities, uint32_t maxComponent
 }
 
 void EntityManager::Update(const float dt) {
-	// TODO: Currently not used, but will use.
-	//     for (auto const &stageVec : m_systems)
-	//         for (auto &sys : stageVec)
-	//             sys->OnUpdate(dt);
+	if (m_isScheduleDirty) {
+		m_scheduler.Build(m_systems);
+		m_isScheduleDirty = false;
+	}
+
+	SyncCommandBufferCount();
+	m_scheduler.Run(dt, m_parallelUpdate);
+	FlushCommandBuffers();
 }
 
 ERROR_CODE EntityManager::Shutdown() {
 	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
 	m_state = SystemState::ShuttingDown;
 
-	for (auto const &stageVec : m_systems)
-		for (const auto &sys : stageVec) sys->Shutdown();
+	// Systems unregister themselves on shutdown, so walk a copy of each stage.
+	for (auto &stageVec : m_systems) {
+		const std::vector<ISystem *> systems = stageVec;
+		for (ISystem *sys : systems) sys->Shutdown();
+		stageVec.clear();
+	}
+
+	m_scheduler.Clear();
+	m_isScheduleDirty = true;
 
-	m_allComponentIndices.clear();
+	m_commandBuffers.clear();
+	m_entities.clear();
+	m_componentMasks.clear();
+	m_freeHead	 = ENTITY_INDEX_MASK;
+	m_aliveCount = 0;
+	m_nextEntityIndex.store(0, std::memory_order_relaxed);
 	m_componentArrays.clear();
+	m_archetypeStorage.Shutdown();
 	Scene::EntityFactory::Shutdown();
 	m_state = SystemState::Uninitialized;
 	return ERROR_CODE::OK;
 }
 
 EntityID EntityManager::CreateEntity() {
-	if (m_freeEntities.empty()) {
-		PE_LOG_ERROR("There isn't any free entity.");
-		return UINT32_MAX;
+	if (m_freeHead == ENTITY_INDEX_MASK) {
+		const EntityID id = ReserveEntity();
+		if (id != INVALID_ENTITY_ID) ActivateEntity(id);
+		return id;
 	}
 
-	const auto id = m_freeEntities.top();
-	m_freeEntities.pop();
-
-	for (uint32_t typeID = 0; typeID < ref_maxComponentTypes; ++typeID)
-		m_allComponentIndices[typeID * ref_maxEntities + id] = UINT32_MAX;
-
-	return id;
+	// The free slot already carries the bumped generation.
+	const uint32_t index = m_freeHead;
+	m_freeHead			 = GetEntityIndex(m_entities[index]);
+	m_entities[index]	 = MakeEntityID(index, GetEntityGeneration(m_entities[index]));
+	m_aliveCount++;
+	return m_entities[index];
 }
 
 ERROR_CODE EntityManager::DestroyEntity(EntityID id) {
-	if (id >= ref_maxEntities) {
-		PE_LOG_FATAL("Entity ID isn't correct.");
+	if (!IsAlive(id)) {
+		PE_LOG_FATAL("Entity ID isn't correct or the entity is already destroyed.");
 		return ERROR_CODE::WRONG_ENTITY_ID;
 	}
 
-	for (uint32_t typeID = 0; typeID < ref_maxComponentTypes; ++typeID) {
-		if (const uint32_t idx = m_allComponentIndices[typeID * ref_maxEntities + id];
-			idx != UINT32_MAX && m_componentArrays[typeID]->Has(idx)) {
-			m_componentArrays[typeID]->Remove(idx);
-			m_allComponentIndices[typeID * ref_maxEntities + id] = UINT32_MAX;
+	if (m_storageMode == StorageMode::Archetype)
+		m_archetypeStorage.DestroyEntity(id);
+	else
+		m_componentMasks[GetEntityIndex(id)].ForEach(
+			[this, id](const uint32_t typeID) { m_componentArrays[typeID]->Remove(id); });
+
+	ReleaseEntity(id);
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE EntityManager::DestroyEntities(const std::span<const EntityID> ids) {
+	ERROR_CODE result = ERROR_CODE::OK;
+
+	// Archetype rows move one entity at a time anyway.
+	if (m_storageMode == StorageMode::Archetype) {
+		for (const EntityID id : ids)
+			if (const ERROR_CODE destroyResult = DestroyEntity(id); destroyResult < ERROR_CODE::WARN_START)
+				result = destroyResult;
+		return result;
+	}
+
+	m_typeRemoveScratch.resize(ref_maxComponentTypes);
+	for (const EntityID id : ids) {
+		if (!IsAlive(id)) {
+			PE_LOG_FATAL("Entity ID isn't correct or the entity is already destroyed.");
+			result = ERROR_CODE::WRONG_ENTITY_ID;
+			continue;
 		}
+
+		m_componentMasks[GetEntityIndex(id)].ForEach(
+			[this, id](const uint32_t typeID) { m_typeRemoveScratch[typeID].push_back(id); });
+		ReleaseEntity(id);
 	}
 
-	m_freeEntities.push(id);
-	return ERROR_CODE::OK;
+	for (uint32_t typeID = 0; typeID < ref_maxComponentTypes; ++typeID) {
+		std::vector<EntityID> &removals = m_typeRemoveScratch[typeID];
+		if (removals.empty()) continue;
+
+		m_componentArrays[typeID]->RemoveBatch(removals);
+		removals.clear();
+	}
+
+	return result;
 }
 
 void EntityManager::ClearAllEntities() {
 	PE_LOG_INFO("EntityManager: Clearing all entities and components...");
 
+	// Pending commands refer to entities that are about to go away.
+	for (const auto &buffer : m_commandBuffers) buffer->Reset();
+
 	for (uint32_t typeID = 0; typeID < ref_maxComponentTypes; ++typeID) {
 		if (m_componentArrays[typeID]) {
 			m_componentArrays[typeID]->Clear();
 		}
 	}
 
-	std::fill(m_allComponentIndices.begin(), m_allComponentIndices.end(), UINT32_MAX);
+	if (m_storageMode == StorageMode::Archetype) m_archetypeStorage.Clear();
 
-	while (!m_freeEntities.empty()) m_freeEntities.pop();
+	// Every live slot goes back to the free list with a new generation so handles from before the clear stay stale.
+	// Linking from the back hands out the lowest indices first again.
+	m_freeHead = ENTITY_INDEX_MASK;
+	for (uint32_t index = static_cast<uint32_t>(m_entities.size()); index-- > 0;) {
+		// Slots of discarded reservations were never alive and start over at generation 0.
+		const EntityID slot		  = m_entities[index];
+		const bool	   isAlive	  = GetEntityIndex(slot) == index;
+		const uint32_t generation = slot == INVALID_ENTITY_ID ? 0 : GetEntityGeneration(slot) + (isAlive ? 1 : 0);
 
-	for (EntityID i = 0; i < ref_maxEntities; ++i) {
-		m_freeEntities.push(ref_maxEntities - 1 - i);
+		m_entities[index] = MakeEntityID(m_freeHead, generation);
+		m_componentMasks[index].Clear();
+		m_freeHead = index;
 	}
+	m_aliveCount = 0;
+	m_nextEntityIndex.store(static_cast<uint32_t>(m_entities.size()), std::memory_order_relaxed);
 
 	PE_LOG_INFO("EntityManager: All entities cleared.");
 }
 
+EntityID EntityManager::ReserveEntity() {
+	// Only fresh indices are reserved, recycling through the free list stays with CreateEntity on the main thread.
+	const uint32_t index = m_nextEntityIndex.fetch_add(1, std::memory_order_relaxed);
+	if (index >= MAX_ENTITY_COUNT) {
+		PE_LOG_ERROR("There isn't any free entity.");
+		return INVALID_ENTITY_ID;
+	}
+
+	return MakeEntityID(index, 0);
+}
+
+CommandBuffer &EntityManager::GetCommandBuffer() {
+	const uint32_t worker = Utilities::JobSystem::GetCurrentWorkerIndex();
+	if (worker < m_commandBuffers.size()) return *m_commandBuffers[worker];
+
+	if (Utilities::JobSystem::IsRunning()) PE_LOG_FATAL("Command buffers can only be recorded from job workers.");
+	return *m_commandBuffers.front();
+}
+
+void EntityManager::FlushCommandBuffers() {
+	m_playbackScratch.clear();
+	for (uint32_t bufferIndex = 0; bufferIndex < m_commandBuffers.size(); ++bufferIndex)
+		for (const CommandBuffer::Command &command : m_commandBuffers[bufferIndex]->GetCommands())
+			m_playbackScratch.push_back({&command, bufferIndex});
+
+	if (m_playbackScratch.empty()) return;
+
+	// Creates first so later commands find their entities, then component commands grouped by type so each array is
+	// touched in one run, destroys last. Inside a group, commands on one entity keep the order they were recorded in
+	// and buffers are ordered by worker index, so the result doesn't depend on how jobs got scheduled.
+	const auto sortKey = [](const PlaybackEntry &entry) {
+		const CommandBuffer::Command &command = *entry.command;
+		return std::tuple(GetPlaybackPhase(command.type), command.typeID, GetEntityIndex(command.entityID),
+						  entry.bufferIndex, command.sequence);
+	};
+	std::sort(m_playbackScratch.begin(), m_playbackScratch.end(),
+			  [&sortKey](const PlaybackEntry &a, const PlaybackEntry &b) { return sortKey(a) < sortKey(b); });
+
+	// Entities that die in this batch skip their component commands.
+	m_destroyScratch.clear();
+	for (const PlaybackEntry &entry : m_playbackScratch)
+		if (entry.command->type == CommandBuffer::CommandType::DestroyEntity)
+			m_destroyScratch.push_back(entry.command->entityID);
+	std::sort(m_destroyScratch.begin(), m_destroyScratch.end());
+	m_destroyScratch.erase(std::unique(m_destroyScratch.begin(), m_destroyScratch.end()), m_destroyScratch.end());
+
+	uint32_t pendingRemovalType = UINT32_MAX;
+	for (const PlaybackEntry &entry : m_playbackScratch) {
+		const CommandBuffer::Command &command = *entry.command;
+		if (command.type == CommandBuffer::CommandType::DestroyEntity) break;
+
+		if (command.type == CommandBuffer::CommandType::CreateEntity) {
+			ActivateEntity(command.entityID);
+			continue;
+		}
+
+		if (std::binary_search(m_destroyScratch.begin(), m_destroyScratch.end(), command.entityID)) continue;
+
+		if (pendingRemovalType != command.typeID || command.type == CommandBuffer::CommandType::AddComponent) {
+			FlushPendingRemovals(pendingRemovalType);
+			pendingRemovalType = UINT32_MAX;
+		}
+
+		if (command.type == CommandBuffer::CommandType::AddComponent) {
+			command.table->add(*this, command.entityID, command.component);
+			continue;
+		}
+
+		// Removes from sparse arrays are collected and swap-removed together, archetype rows move one at a time.
+		if (m_storageMode == StorageMode::Archetype || !IsAlive(command.entityID) ||
+			!m_componentMasks[GetEntityIndex(command.entityID)].Test(command.typeID)) {
+			command.table->remove(*this, command.entityID);
+			continue;
+		}
+
+		m_componentMasks[GetEntityIndex(command.entityID)].Reset(command.typeID);
+		m_removeScratch.push_back(command.entityID);
+		pendingRemovalType = command.typeID;
+	}
+	FlushPendingRemovals(pendingRemovalType);
+
+	DestroyEntities(m_destroyScratch);
+
+	for (const auto &buffer : m_commandBuffers) buffer->Reset();
+	m_playbackScratch.clear();
+}
+
+void EntityManager::ActivateEntity(const EntityID id) {
+	// The configured maximum is only a sizing hint, storage pages grow with the live entities.
+	const uint32_t index = GetEntityIndex(id);
+	if (index == ref_maxEntities)
+		PE_LOG_WARN("Entity count exceeded the configured maximum of " + std::to_string(ref_maxEntities) + ".");
+
+	// Reservations can be activated out of order, the slots in between stay dead until their turn.
+	if (index >= m_entities.size()) {
+		m_entities.resize(index + 1, INVALID_ENTITY_ID);
+		m_componentMasks.resize(index + 1);
+	}
+
+	m_entities[index] = id;
+	m_aliveCount++;
+}
+
+void EntityManager::ReleaseEntity(const EntityID id) {
+	const uint32_t index = GetEntityIndex(id);
+	m_componentMasks[index].Clear();
+	m_entities[index] = MakeEntityID(m_freeHead, GetEntityGeneration(id) + 1);
+	m_freeHead		  = index;
+	m_aliveCount--;
+}
+
+void EntityManager::SyncCommandBufferCount() {
+	// Buffers are only ever added, a shrinking job system must not drop commands that are still pending.
+	const uint32_t count = std::max(1u, Utilities::JobSystem::GetWorkerCount());
+	while (m_commandBuffers.size() < count) m_commandBuffers.push_back(std::make_unique<CommandBuffer>(this));
+}
+
+void EntityManager::FlushPendingRemovals(const uint32_t typeID) {
+	if (m_removeScratch.empty()) return;
+
+	m_componentArrays[typeID]->RemoveBatch(m_removeScratch);
+	m_removeScratch.clear();
+}
+
 ERROR_CODE EntityManager::RegisterSystem(ISystem *system) {
 	ESystemStage stage = system->GetStage();
 
@@ -114,6 +326,7 @@ ERROR_CODE EntityManager::RegisterSystem(ISystem *system) {
 		}
 	}
 	m_systems[static_cast<size_t>(stage)].emplace_back(system);
+	m_isScheduleDirty = true;
 
 	return ERROR_CODE::OK;
 }
@@ -130,6 +343,7 @@ ERROR_CODE EntityManager::UnregisterSystem(const ISystem *system) {
 		 ++it) {
 		if ((*it)->GetID() == system->GetID()) {
 			m_systems[static_cast<size_t>(stage)].erase(it);
+			m_isScheduleDirty = true;
 			return ERROR_CODE::OK;
 		}
 	}
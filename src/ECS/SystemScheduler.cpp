@@ -0,0 +1,105 @@
+#include "ECS/SystemScheduler.h"
+
+#include <thread>
+
+namespace PE::ECS {
+void SystemScheduler::Build(const StageList &stages) {
+	m_nodes.clear();
+	m_edgeCount = 0;
+
+	for (const auto &stageSystems : stages)
+		for (ISystem *system : stageSystems) m_nodes.push_back({system, {}, 0, system->GetAccess().mainThread});
+
+	const auto count = static_cast<uint32_t>(m_nodes.size());
+	for (uint32_t i = 0; i < count; ++i) {
+		const SystemAccess &earlier = m_nodes[i].system->GetAccess();
+		for (uint32_t j = i + 1; j < count; ++j) {
+			const SystemAccess &later = m_nodes[j].system->GetAccess();
+			// Main thread systems share one thread anyway, keep them in stage order.
+			if (!Conflicts(earlier, later) && !(earlier.mainThread && later.mainThread)) continue;
+
+			m_nodes[i].successors.push_back(j);
+			m_nodes[j].dependencyCount++;
+			m_edgeCount++;
+		}
+	}
+
+	m_pendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(count);
+	m_mainThreadReady.reserve(count);
+}
+
+void SystemScheduler::Run(const float dt, const bool parallel) {
+	if (m_nodes.empty()) return;
+
+	if (!parallel || Utilities::JobSystem::GetWorkerCount() <= 1)
+		RunSerial(dt);
+	else
+		RunParallel(dt);
+}
+
+void SystemScheduler::Clear() {
+	m_nodes.clear();
+	m_pendingDependencies.reset();
+	m_mainThreadReady.clear();
+	m_edgeCount = 0;
+}
+
+bool SystemScheduler::Conflicts(const SystemAccess &a, const SystemAccess &b) {
+	if (a.exclusive || b.exclusive) return true;
+	return (a.writes & (b.reads | b.writes)).any() || (b.writes & a.reads).any();
+}
+
+void SystemScheduler::RunSerial(const float dt) {
+	for (const Node &node : m_nodes) node.system->OnUpdate(dt);
+}
+
+void SystemScheduler::RunParallel(const float dt) {
+	const auto count = static_cast<uint32_t>(m_nodes.size());
+	for (uint32_t i = 0; i < count; ++i)
+		m_pendingDependencies[i].store(m_nodes[i].dependencyCount, std::memory_order_relaxed);
+	m_remainingSystems.store(count, std::memory_order_release);
+
+	Utilities::JobCounter counter;
+	for (uint32_t i = 0; i < count; ++i)
+		if (m_nodes[i].dependencyCount == 0) Dispatch(i, dt, counter);
+
+	while (m_remainingSystems.load(std::memory_order_acquire) > 0) {
+		uint32_t nodeIndex = UINT32_MAX;
+		{
+			std::lock_guard lock(m_mainThreadMutex);
+			if (!m_mainThreadReady.empty()) {
+				nodeIndex = m_mainThreadReady.front();
+				m_mainThreadReady.erase(m_mainThreadReady.begin());
+			}
+		}
+
+		if (nodeIndex != UINT32_MAX)
+			Execute(nodeIndex, dt, counter);
+		else if (!Utilities::JobSystem::TryExecuteJob())
+			std::this_thread::yield();
+	}
+
+	Utilities::JobSystem::Wait(counter);
+}
+
+void SystemScheduler::Dispatch(const uint32_t nodeIndex, const float dt, Utilities::JobCounter &counter) {
+	if (m_nodes[nodeIndex].mainThread) {
+		std::lock_guard lock(m_mainThreadMutex);
+		m_mainThreadReady.push_back(nodeIndex);
+		return;
+	}
+
+	Utilities::JobSystem::Run([this, nodeIndex, dt, &counter] { Execute(nodeIndex, dt, counter); }, &counter);
+}
+
+void SystemScheduler::Execute(const uint32_t nodeIndex, const float dt, Utilities::JobCounter &counter) {
+	const Node &node = m_nodes[nodeIndex];
+	node.system->OnUpdate(dt);
+
+	for (const uint32_t successor : node.successors)
+		if (m_pendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Dispatch(successor, dt, counter);
+
+	m_remainingSystems.fetch_sub(1, std::memory_order_acq_rel);
+}
+}  // namespace PE::ECS
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "Graphics/GPUProfile.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace PE::Graphics {
+const char *GetGPUPassName(const GPUPass pass) {
+	switch (pass) {
+		case GPUPass::Culling: return "Culling";
+		case GPUPass::Shadow: return "Shadow";
+		case GPUPass::Forward: return "Forward";
+		case GPUPass::Particles: return "Particles";
+		case GPUPass::GUI: return "GUI";
+		default: return "Frame";
+	}
+}
+
+void GPUProfile::AddFrame(const GPUFrameTimings &frame) {
+	if (m_frames.size() < HISTORY_SIZE) {
+		m_frames.push_back(frame);
+		return;
+	}
+	m_frames[m_next] = frame;
+	m_next			 = (m_next + 1) % HISTORY_SIZE;
+}
+
+const GPUFrameTimings &GPUProfile::GetLatest() const {
+	return m_frames.size() < HISTORY_SIZE ? m_frames.back() : m_frames[(m_next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+double GPUProfile::GetPercentileMs(const GPUPass pass, const double percentile) const {
+	if (m_frames.empty()) return 0.0;
+
+	std::vector<double> samples;
+	samples.reserve(m_frames.size());
+	for (const GPUFrameTimings &frame : m_frames)
+		samples.push_back(pass == GPUPass::Count ? frame.frameMs : frame.passMs[static_cast<size_t>(pass)]);
+
+	const auto rank = std::min(samples.size() - 1, static_cast<size_t>(samples.size() * percentile / 100.0));
+	std::ranges::nth_element(samples, samples.begin() + static_cast<std::ptrdiff_t>(rank));
+	return samples[rank];
+}
+
+ERROR_CODE GPUProfile::WriteCSV(const std::filesystem::path &path) const {
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) return ERROR_CODE::IO_ERROR_OCCURRED;
+
+	file << "frame,frame_ms";
+	for (size_t p = 0; p < GPU_PASS_COUNT; ++p) file << ',' << GetGPUPassName(static_cast<GPUPass>(p)) << "_ms";
+	if (m_hasStatistics) {
+		for (size_t p = 0; p < GPU_PASS_COUNT; ++p) {
+			const char *name = GetGPUPassName(static_cast<GPUPass>(p));
+			file << std::format(",{0}_primitives,{0}_vertex_invocations,{0}_clipped_primitives", name)
+				 << std::format(",{}_fragment_invocations", name);
+		}
+	}
+	file << '\n';
+
+	// Oldest first, the ring starts at m_next once it has wrapped.
+	for (size_t i = 0; i < m_frames.size(); ++i) {
+		const GPUFrameTimings &frame = m_frames[(m_next + i) % m_frames.size()];
+		file << std::format("{},{:.4f}", frame.frameIndex, frame.frameMs);
+		for (const double ms : frame.passMs) file << std::format(",{:.4f}", ms);
+		if (m_hasStatistics) {
+			for (const GPUPassStatistics &stats : frame.statistics)
+				file << std::format(",{},{},{},{}", stats.inputPrimitives, stats.vertexInvocations,
+									stats.clippingPrimitives, stats.fragmentInvocations);
+		}
+		file << '\n';
+	}
+
+	return file ? ERROR_CODE::OK : ERROR_CODE::IO_ERROR_OCCURRED;
+}
+}  // namespace PE::Graphics
\ No newline at end of file
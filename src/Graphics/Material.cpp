@@ -61,7 +61,7 @@ ERROR_CODE Material::Initialize(
 
 	uint64_t layer = 1;
 	m_sortKeyMask = RenderKey::Create(static_cast<uint8_t>(static_cast<RenderPass>(0)), static_cast<uint16_t>(shaderID),
-									  static_cast<uint16_t>(id), 0);
+									  static_cast<uint16_t>(id), 0, 0);
 
 	return ERROR_CODE::OK;
 }
@@ -0,0 +1,120 @@
+#include "Graphics/RenderQueue.h"
+
+#include <algorithm>
+
+#include "Utilities/JobSystem.h"
+
+namespace PE::Graphics {
+constexpr uint32_t RADIX_BITS			 = 11;
+constexpr uint32_t RADIX_SIZE			 = 1u << RADIX_BITS;
+constexpr uint64_t RADIX_MASK			 = RADIX_SIZE - 1;
+constexpr uint32_t RADIX_PASSES			 = (64 + RADIX_BITS - 1) / RADIX_BITS;
+constexpr size_t   RADIX_SORT_THRESHOLD	 = 256;  // below this a comparison sort is faster than clearing histograms
+constexpr size_t   MIN_ENTRIES_PER_CHUNK = 16 * 1024;
+
+namespace {
+// Layer stays on top so passes don't interleave, the inverted depth makes far surfaces sort first. Shader, material
+// and mesh only break depth ties, so equal surfaces at the same depth can still be batched.
+uint64_t MakeTransparentKey(const uint64_t key) {
+	const uint64_t layer	= RenderKey::GetLayer(key);
+	const uint64_t farFirst = UINT16_MAX - RenderKey::GetDepth(key);
+	return (layer << 60) | (farFirst << 44) | ((key >> 16) & 0xFFFFFFFFFFF);
+}
+}  // namespace
+
+void RenderQueue::Submit(const RenderCommand &command) {
+	const auto index = static_cast<uint32_t>(m_commands.size());
+	m_commands.push_back(command);
+
+	if (command.flags & RenderFlag_ForceTransparent) m_transparent.push_back({MakeTransparentKey(command.key), index});
+	else m_opaque.push_back({command.key, index});
+}
+
+void RenderQueue::Sort() {
+	RadixSort(m_opaque);
+	RadixSort(m_transparent);
+
+	m_sorted.clear();
+	m_sorted.insert(m_sorted.end(), m_opaque.begin(), m_opaque.end());
+	m_sorted.insert(m_sorted.end(), m_transparent.begin(), m_transparent.end());
+}
+
+void RenderQueue::Clear() {
+	m_commands.clear();
+	m_opaque.clear();
+	m_transparent.clear();
+	m_sorted.clear();
+}
+
+void RenderQueue::RadixSort(std::vector<SortEntry> &entries) {
+	const size_t count = entries.size();
+
+	// Entries are submitted in index order and every pass is stable, so equal keys keep submission order. The
+	// comparison sort for small queues breaks ties the same way.
+	if (count < RADIX_SORT_THRESHOLD) {
+		std::sort(entries.begin(), entries.end(), [](const SortEntry &a, const SortEntry &b) {
+			return a.key != b.key ? a.key < b.key : a.index < b.index;
+		});
+		return;
+	}
+
+	const size_t workerCount = Utilities::JobSystem::IsRunning() ? Utilities::JobSystem::GetWorkerCount() : 1;
+	const size_t chunkCount	 = std::clamp(count / MIN_ENTRIES_PER_CHUNK, size_t{1}, workerCount);
+
+	m_scratch.resize(count);
+	m_histograms.resize(chunkCount * RADIX_SIZE);
+
+	SortEntry *source	   = entries.data();
+	SortEntry *destination = m_scratch.data();
+
+	// Chunk c always covers the same slice of the source array, so scattering chunk by chunk keeps the pass stable.
+	const auto forEachChunk = [chunkCount](auto &&fn) {
+		if (chunkCount == 1) {
+			fn(size_t{0});
+			return;
+		}
+		Utilities::JobSystem::ParallelForRange(chunkCount, 1, [&fn](const size_t begin, const size_t end) {
+			for (size_t chunk = begin; chunk < end; ++chunk) fn(chunk);
+		});
+	};
+	const auto chunkBegin = [count, chunkCount](const size_t chunk) { return count * chunk / chunkCount; };
+
+	for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+		const uint32_t shift = pass * RADIX_BITS;
+
+		forEachChunk([&](const size_t chunk) {
+			uint32_t *histogram = &m_histograms[chunk * RADIX_SIZE];
+			std::fill_n(histogram, RADIX_SIZE, 0u);
+			for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i)
+				histogram[(source[i].key >> shift) & RADIX_MASK]++;
+		});
+
+		// A digit every key shares (the layer bits, mostly) would only copy the array.
+		const uint64_t firstDigit = (source[0].key >> shift) & RADIX_MASK;
+		size_t		   firstCount = 0;
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk) firstCount += m_histograms[chunk * RADIX_SIZE + firstDigit];
+		if (firstCount == count) continue;
+
+		// Exclusive prefix sum, digit major and chunk minor, turns the counts into each chunk's write offsets.
+		uint32_t offset = 0;
+		for (uint32_t digit = 0; digit < RADIX_SIZE; ++digit) {
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+				uint32_t	  &bucket	   = m_histograms[chunk * RADIX_SIZE + digit];
+				const uint32_t bucketCount = bucket;
+				bucket					   = offset;
+				offset += bucketCount;
+			}
+		}
+
+		forEachChunk([&](const size_t chunk) {
+			uint32_t *histogram = &m_histograms[chunk * RADIX_SIZE];
+			for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i)
+				destination[histogram[(source[i].key >> shift) & RADIX_MASK]++] = source[i];
+		});
+
+		std::swap(source, destination);
+	}
+
+	if (source != entries.data()) entries.swap(m_scratch);
+}
+}  // namespace PE::Graphics
\ No newline at end of file
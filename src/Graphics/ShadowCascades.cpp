@@ -0,0 +1,123 @@
+#include "Graphics/ShadowCascades.h"
+
+#include <array>
+#include <cmath>
+
+namespace PE::Graphics {
+namespace {
+// Cascade radii are rounded up to this step, float noise in the corner math would otherwise resize them every frame.
+constexpr float RADIUS_STEP = 1.0f / 16.0f;
+// Clip space x and y of the four corner rays of a view frustum.
+constexpr float NDC_CORNERS[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+Math::Matrix4 MakeCascadeProjection(const ShadowCascade &cascade, const float nearDepth) {
+	const Math::Vector3 &c = cascade.center;
+	const float			 r = cascade.radius;
+	return Math::Mat4Ortho(c.x - r, c.x + r, c.y - r, c.y + r, nearDepth, c.z + r);
+}
+
+Math::Frustum MakeCasterFrustum(const ShadowCascade &cascade, const float sphereNear) {
+	Math::Frustum frustum = Math::ExtractFrustum(MakeCascadeProjection(cascade, sphereNear) * cascade.lightView);
+
+	// Without a near plane the test volume reaches all the way back to the light.
+	frustum.planes[Math::Frustum::Near] = Math::Vector4(0.0f, 0.0f, 0.0f, Math::Infinity);
+	return frustum;
+}
+}  // namespace
+
+uint32_t FitShadowCascades(const Math::Matrix4 &view, const Math::Matrix4 &projection,
+						   const Math::Vector3 &lightDirection, const RenderConfig &config,
+						   const std::span<ShadowCascade, MAX_SHADOW_CASCADES> outCascades) {
+	// Corner rays of the view frustum in view space, from the near to the far plane.
+	const Math::Matrix4			 inverseProjection = Math::Inverse(projection);
+	std::array<Math::Vector3, 4> nearCorners;
+	std::array<Math::Vector3, 4> farCorners;
+	for (size_t i = 0; i < 4; ++i) {
+		const Math::Vector4 nearCorner = inverseProjection * Math::Vector4(NDC_CORNERS[i][0], NDC_CORNERS[i][1], 0, 1);
+		const Math::Vector4 farCorner  = inverseProjection * Math::Vector4(NDC_CORNERS[i][0], NDC_CORNERS[i][1], 1, 1);
+		nearCorners[i]				   = Math::Vector3(nearCorner) / nearCorner.w;
+		farCorners[i]				   = Math::Vector3(farCorner) / farCorner.w;
+	}
+
+	const float	   nearZ	  = nearCorners[0].z;
+	const float	   farZ		  = farCorners[0].z;
+	const float	   shadowFar  = Math::Clamp(config.shadowDistance, nearZ, farZ);
+	const uint32_t count	  = Math::Clamp<uint32_t>(config.shadowCascadeCount, 1, MAX_SHADOW_CASCADES);
+	const float	   resolution = static_cast<float>(config.shadowMapResolution);
+
+	// Rotation only, so light space doesn't move with the camera and snapped centers land on the same texel grid
+	// every frame.
+	const Math::Vector3	up			= Math::Abs(lightDirection.y) > 0.99f ? Math::Vector3Forward : Math::Vector3Up;
+	const Math::Matrix4	lightView	= Math::Mat4LookAt(Math::Vector3Zero, Math::Normalize(lightDirection), up);
+	const Math::Matrix4	inverseView	= Math::Inverse(view);
+
+	float splitNear = nearZ;
+	for (uint32_t c = 0; c < count; ++c) {
+		const float t			 = static_cast<float>(c + 1) / static_cast<float>(count);
+		const float uniformSplit = nearZ + (shadowFar - nearZ) * t;
+		const float logSplit	 = nearZ * std::pow(shadowFar / nearZ, t);
+		const float splitFar	 = Math::Lerp(uniformSplit, logSplit, config.shadowSplitLambda);
+
+		// View depth is linear along each corner ray, so the slice corners are a lerp between both planes.
+		std::array<Math::Vector3, 8> corners;
+		Math::Vector3				 center = Math::Vector3Zero;
+		for (size_t i = 0; i < 4; ++i) {
+			const Math::Vector3 ray = farCorners[i] - nearCorners[i];
+			corners[i]				= nearCorners[i] + ray * ((splitNear - nearZ) / (farZ - nearZ));
+			corners[i + 4]			= nearCorners[i] + ray * ((splitFar - nearZ) / (farZ - nearZ));
+		}
+		for (Math::Vector3 &corner : corners) {
+			corner = Math::Vector3(inverseView * Math::Vector4(corner, 1.0f));
+			center += corner;
+		}
+		center = center / 8.0f;
+
+		float radius = 0.0f;
+		for (const Math::Vector3 &corner : corners) radius = Math::Max(radius, Math::Vector3Distance(corner, center));
+		radius = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
+
+		// Moving the cascade by whole texels only keeps its shadow edges from crawling while the camera moves.
+		const float	  texelSize	  = 2.0f * radius / resolution;
+		Math::Vector3 lightCenter = Math::Vector3(lightView * Math::Vector4(center, 1.0f));
+		lightCenter.x			  = std::floor(lightCenter.x / texelSize) * texelSize;
+		lightCenter.y			  = std::floor(lightCenter.y / texelSize) * texelSize;
+
+		ShadowCascade &cascade = outCascades[c];
+		cascade.lightView	   = lightView;
+		cascade.center		   = lightCenter;
+		cascade.radius		   = radius;
+		cascade.splitDepth	   = splitFar;
+		cascade.viewProjection = MakeCascadeProjection(cascade, lightCenter.z - radius) * lightView;
+
+		splitNear = splitFar;
+	}
+	return count;
+}
+
+size_t CullShadowCasters(ShadowCascade &cascade, const float *centerX, const float *centerY, const float *centerZ,
+						 const float *radius, const size_t count, const float maxCasterDistance, uint8_t *visible) {
+	const float			sphereNear = cascade.center.z - cascade.radius;
+	const Math::Frustum frustum	   = MakeCasterFrustum(cascade, sphereNear);
+
+	const size_t visibleCount = Math::CullSpheres(frustum, centerX, centerY, centerZ, radius, count, visible);
+
+	// Unbounded casters would drag the near plane along to the limit, they get clipped instead.
+	float nearDepth = sphereNear;
+	for (size_t i = 0; i < count; ++i) {
+		if (!visible[i] || radius[i] >= Math::Infinity) continue;
+
+		const Math::Vector4 center(centerX[i], centerY[i], centerZ[i], 1.0f);
+		nearDepth = Math::Min(nearDepth, (cascade.lightView * center).z - radius[i]);
+	}
+	nearDepth = Math::Max(nearDepth, sphereNear - maxCasterDistance);
+
+	cascade.viewProjection = MakeCascadeProjection(cascade, nearDepth) * cascade.lightView;
+	return visibleCount;
+}
+
+Math::Frustum GetShadowCasterFrustum(ShadowCascade &cascade, const float maxCasterDistance) {
+	const float sphereNear = cascade.center.z - cascade.radius;
+	cascade.viewProjection = MakeCascadeProjection(cascade, sphereNear - maxCasterDistance) * cascade.lightView;
+	return MakeCasterFrustum(cascade, sphereNear);
+}
+}  // namespace PE::Graphics
\ No newline at end of file
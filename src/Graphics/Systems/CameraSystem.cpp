@@ -2,8 +2,11 @@
 
 #include "Assets/AssetInfo.h"
 #include "Graphics/Components/Camera.h"
+#include "Utilities/JobSystem.h"
 
 namespace PE::Graphics::Systems {
+constexpr size_t CAMERA_GRAIN_SIZE = 16;
+
 ERROR_CODE CameraSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager,
 									Input::InputSystem *inputSystem, const RenderConfig &renderConfig) {
 	PE_CHECK_STATE_INIT(m_state, "Render system is already initialized!");
@@ -13,41 +16,49 @@ ERROR_CODE CameraSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityMa
 	m_stage			= stage;
 	ref_eM			= entityManager;
 	ref_inputSystem = inputSystem;
+	DeclareReads<Scene::Components::Transform>();
+	DeclareWrites<Components::Camera>();
+
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->RegisterSystem(this));
 
 	m_state = SystemState::Running;
-	return ERROR_CODE::OK;
+	return result;
 }
 
 ERROR_CODE CameraSystem::Shutdown() {
 	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
 	m_state = SystemState::ShuttingDown;
 
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->UnregisterSystem(this));
+	m_stage	 = ECS::ESystemStage::Count;
+	m_typeID = UINT32_MAX;
+
 	m_state = SystemState::Uninitialized;
-	return ERROR_CODE::OK;
+	return result;
 }
 
 void CameraSystem::OnUpdate(float dt) {
-	auto		&cameras	   = ref_eM->GetCompArr<Components::Camera>();
-	auto		&cameraData	   = cameras.Data();
-	const auto	&entityIndices = cameras.Index();
-	const size_t count		   = cameras.GetCount();
+	auto	   &cameras		  = ref_eM->GetCompArr<Components::Camera>();
+	const auto &entityIndices = cameras.Index();
 
-	for (size_t i = 0; i < count; ++i) {
-		auto &cam = cameraData[i];
+	// Each camera only reads its own transform, so the packed array can be split across workers.
+	Utilities::JobSystem::ParallelFor(
+		std::span(cameras.Data()), CAMERA_GRAIN_SIZE, [this, &entityIndices](Components::Camera &cam, const size_t i) {
+			const uint32_t entityID = entityIndices[i];
 
-		const uint32_t entityID = entityIndices[i];
-
-		if (cam.isDirty) {
-			cam.projectionMatrix = Math::Perspective(Math::Radians(cam.fovY), cam.aspectRatio, cam.nearZ, cam.farZ);
-			cam.isDirty			 = false;
-		}
+			if (cam.isDirty) {
+				cam.projectionMatrix = Math::Perspective(Math::Radians(cam.fovY), cam.aspectRatio, cam.nearZ, cam.farZ);
+				cam.isDirty			 = false;
+			}
 
-		if (const auto *tfComp = ref_eM->TryGetTIComponent<Scene::Components::Transform>(entityID)) {
-			if (tfComp->state == Scene::Components::Transform::TransformState::Updated) {
-				cam.viewMatrix = UpdateViewMatrix(*tfComp);
+			if (const auto *tfComp = ref_eM->TryGetTIComponent<Scene::Components::Transform>(entityID)) {
+				if (tfComp->state == Scene::Components::Transform::TransformState::Updated) {
+					cam.viewMatrix = UpdateViewMatrix(*tfComp);
+				}
 			}
-		}
-	}
+		});
 }
 
 void CameraSystem::SelectActiveCamera(const ECS::EntityID activeCamID) { m_activeCamera = activeCamID; }
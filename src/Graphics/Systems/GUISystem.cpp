@@ -28,19 +28,28 @@ struct DirectionalLight;
 
 namespace PE::Graphics::Systems {
 ERROR_CODE GUISystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager,
-								 Scene::Systems::SceneControlSystem *sceneControlSystem, IRenderer *renderer) {
+								 Scene::Systems::SceneControlSystem *sceneControlSystem,
+								 Scene::Systems::TransformSystem *transformSystem, IRenderer *renderer) {
 	PE_CHECK_STATE_INIT(m_state, "GUI system is already initialized!");
 	m_state = SystemState::Initializing;
 
-	m_typeID	 = GetUniqueISystemTypeID<GUISystem>();
-	m_stage		 = stage;
-	ref_eM		 = entityManager;
-	ref_renderer = renderer;
+	m_typeID			= GetUniqueISystemTypeID<GUISystem>();
+	m_stage				= stage;
+	ref_eM				= entityManager;
+	ref_transformSystem = transformSystem;
+	ref_renderer		= renderer;
+
+	// The inspector can edit any component of the selected entity and ImGui has to stay on the main thread.
+	m_access.mainThread = true;
+	DeclareWrites<Scene::Components::Tag, Scene::Components::Transform, Components::Camera, Components::MeshRenderer,
+				  Components::DirectionalLight, Components::ParticleEmitter, Scene::Components::DayNightCycle,
+				  IRenderer>();
 
 	m_fpsTimer = new Utilities::Timer();
 	ERROR_CODE result;
 
 	PE_CHECK(result, ref_renderer->InitGUI());
+	PE_CHECK(result, ref_eM->RegisterSystem(this));
 
 	PE_LOG_INFO("GUI System Initialized.");
 	m_state = SystemState::Running;
@@ -53,8 +62,13 @@ ERROR_CODE GUISystem::Shutdown() {
 
 	Utilities::SafeDelete(m_fpsTimer);
 
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->UnregisterSystem(this));
+	m_stage	 = ECS::ESystemStage::Count;
+	m_typeID = UINT32_MAX;
+
 	m_state = SystemState::Uninitialized;
-	return ERROR_CODE::OK;
+	return result;
 }
 
 void GUISystem::OnUpdate(float dt) {
@@ -169,7 +183,7 @@ void GUISystem::DrawInspector() {
 
 				changed |= ImGui::DragFloat3("Scale", &tf->scale.x, 0.05f);
 
-				if (changed) tf->state = PE::Scene::Components::Transform::TransformState::Dirty;
+				if (changed) ref_transformSystem->MarkDirty(m_selectedEntity);
 			}
 		}
 
@@ -212,6 +226,7 @@ void GUISystem::DrawInspector() {
 					if (ImGui::TreeNode((void *)(intptr_t)i, "SubMesh %d", i)) {
 						ImGui::Text("Mesh ID: %d", (int)submesh.meshID);
 						ImGui::Text("Material ID: %d", (int)submesh.materialID);
+						ImGui::Text("LODs: %d", (int)submesh.lodCount);
 						ImGui::TreePop();
 					}
 					ImGui::PopID();
@@ -429,6 +444,62 @@ void GUISystem::DrawAssetBrowser() {
 	ImGui::End();
 }
 
+void GUISystem::DrawGPUProfile() {
+	const GPUProfile *profile = ref_renderer->GetGPUProfile();
+	if (!profile || profile->IsEmpty()) {
+		ImGui::TextDisabled("GPU profiling unavailable");
+		return;
+	}
+
+	// Latest frame next to percentiles over the profile's window, the last row is the whole frame.
+	const GPUFrameTimings &latest = profile->GetLatest();
+	if (ImGui::BeginTable("GPUTable", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+		ImGui::TableSetupColumn("GPU ms");
+		ImGui::TableSetupColumn("Last");
+		ImGui::TableSetupColumn("p50");
+		ImGui::TableSetupColumn("p95");
+		ImGui::TableSetupColumn("p99");
+		ImGui::TableHeadersRow();
+
+		for (size_t p = 0; p <= GPU_PASS_COUNT; ++p) {
+			const auto pass = static_cast<GPUPass>(p);
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0);
+			ImGui::TextUnformatted(GetGPUPassName(pass));
+
+			ImGui::TableSetColumnIndex(1);
+			ImGui::Text("%.3f", p < GPU_PASS_COUNT ? latest.passMs[p] : latest.frameMs);
+
+			ImGui::TableSetColumnIndex(2);
+			ImGui::Text("%.3f", profile->GetPercentileMs(pass, 50.0));
+			ImGui::TableSetColumnIndex(3);
+			ImGui::Text("%.3f", profile->GetPercentileMs(pass, 95.0));
+			ImGui::TableSetColumnIndex(4);
+			ImGui::Text("%.3f", profile->GetPercentileMs(pass, 99.0));
+		}
+		ImGui::EndTable();
+	}
+
+	if (profile->HasStatistics()) {
+		const GPUPassStatistics &forward = latest.statistics[static_cast<size_t>(GPUPass::Forward)];
+		const GPUPassStatistics &shadow	 = latest.statistics[static_cast<size_t>(GPUPass::Shadow)];
+		ImGui::Text("Forward:       %.2f M prims, %.2f M frags", forward.clippingPrimitives / 1000000.0f,
+					forward.fragmentInvocations / 1000000.0f);
+		ImGui::Text("Shadow:        %.2f M verts, %.2f M prims", shadow.vertexInvocations / 1000000.0f,
+					shadow.clippingPrimitives / 1000000.0f);
+	}
+
+	if (ImGui::Button("Export GPU CSV")) {
+		const std::filesystem::path path = std::filesystem::path("Captures") / "gpu_profile.csv";
+		std::error_code				ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+		if (profile->WriteCSV(path) < ERROR_CODE::WARN_START)
+			PE_LOG_ERROR("Failed to write GPU profile " + path.string());
+		else
+			PE_LOG_INFO("Wrote " + std::to_string(profile->GetFrameCount()) + " GPU frames to " + path.string());
+	}
+}
+
 void GUISystem::DrawPerformanceStats(float dt) {
 	static float lastUpdateTime = 0.0f;
 	static int	 frameCount		= 0;
@@ -466,6 +537,8 @@ void GUISystem::DrawPerformanceStats(float dt) {
 		RenderStats stats = ref_renderer->GetStats();
 
 		ImGui::Text("Draw Calls:    %u", stats.drawCalls);
+		ImGui::Text("Shadow Draws:  %u", stats.shadowDrawCalls);
+		ImGui::Text("Objects:       %u visible, %u culled", stats.visibleObjects, stats.culledObjects);
 
 		float triM	= stats.triangleCount / 1000000.0f;
 		float vertM = stats.vertexCount / 1000000.0f;
@@ -479,6 +552,20 @@ void GUISystem::DrawPerformanceStats(float dt) {
 
 		ImGui::Separator();
 
+		DrawGPUProfile();
+
+		ImGui::Separator();
+
+		constexpr float toMiB = 1.0f / (1024.0f * 1024.0f);
+
+		ImGui::Text("GPU Memory:    %.1f / %.1f MiB", stats.gpuMemoryUsed * toMiB, stats.gpuMemoryReserved * toMiB);
+		ImGui::Text("Free:          %.1f MiB, %.1f MiB fragmented", stats.gpuMemoryFree * toMiB,
+					stats.gpuMemoryFragmented * toMiB);
+		ImGui::Text("Allocations:   %u in %u blocks, %u dedicated", stats.gpuAllocations, stats.gpuMemoryBlocks,
+					stats.gpuDedicated);
+
+		ImGui::Separator();
+
 		ImGui::Text("Uptime: %.1f s", currentTime);
 
 #if defined(PE_VULKAN)
@@ -5,10 +5,63 @@
 #include "Graphics/Components/ParticleEmitter.h"
 #include "Graphics/IRenderer.h"
 #include "Scene/Components/Transform.h"
+#include "Utilities/JobSystem.h"
 
 namespace PE::Graphics::Systems {
+constexpr size_t PARTICLE_GRAIN_SIZE = 1024;
+
 float RandomFloat() { return (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f; }
 
+// Per particle integration. Only touches p, so particles of one emitter can be simulated on any worker.
+void SimulateParticle(Components::Particle &p, const Components::ParticleEmitter &emitter, const float dt) {
+	float lifeRatio = 1.0f - (p.life / emitter.lifeTime);
+
+	p.life -= dt;
+	p.position += p.velocity * dt;
+
+	if (emitter.type == ParticleType::Fire) {
+		float turbulence = sinf(p.position.y * 2.0f + p.life * 5.0f) * 1.5f;
+		p.position.x += turbulence * dt;
+		p.position.z += turbulence * dt;
+
+		Math::Vector4 startColor = {1.0f, 0.9f, 0.6f, 1.0f};
+		Math::Vector4 midColor	 = {1.0f, 0.4f, 0.0f, 0.9f};
+		Math::Vector4 endColor	 = {0.1f, 0.1f, 0.1f, 0.0f};
+
+		if (lifeRatio < 0.5f) {
+			float t = lifeRatio / 0.5f;
+			p.color = Math::Lerp(startColor, midColor, t);
+			p.size	= Math::Lerp(1.0f, 0.8f, t);
+		} else {
+			float t = (lifeRatio - 0.5f) / 0.5f;
+			p.color = Math::Lerp(midColor, endColor, t);
+			p.size	= Math::Lerp(0.8f, 1.5f, t);
+		}
+	} else if (emitter.type == ParticleType::Dust) {
+		float wave = sinf(p.life * 3.0f) * 2.0f;
+
+		p.position.x += wave * dt;
+		p.position.z += wave * dt;
+
+		p.rotation += dt * 0.3f;
+
+		p.size += dt * 3.0f;
+
+		float maxAlpha = 0.3f;
+
+		if (lifeRatio < 0.1f) {
+			p.color.w = (lifeRatio / 0.1f) * maxAlpha;
+		} else if (lifeRatio > 0.8f) {
+			float remaining = (1.0f - lifeRatio) / 0.2f;
+			p.color.w		= remaining * maxAlpha;
+		} else {
+			p.color.w = maxAlpha;
+		}
+	} else {
+		p.color.w = std::clamp(p.life, 0.0f, 1.0f);
+	}
+}
+
 ERROR_CODE ParticleSystem::Initialize(ECS::ESystemStage stage, ECS::EntityManager *entityManager, IRenderer *renderer) {
 	PE_CHECK_STATE_INIT(m_state, "Particle system is already initialized!");
 	m_state = SystemState::Initializing;
@@ -17,16 +70,27 @@ ERROR_CODE ParticleSystem::Initialize(ECS::ESystemStage stage, ECS::EntityManage
 	m_stage		 = stage;
 	ref_eM		 = entityManager;
 	ref_renderer = renderer;
-	m_state		 = SystemState::Running;
-	return ERROR_CODE::OK;
+	DeclareReads<Scene::Components::Transform>();
+	DeclareWrites<Components::ParticleEmitter, IRenderer>();
+
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->RegisterSystem(this));
+
+	m_state = SystemState::Running;
+	return result;
 }
 
 ERROR_CODE ParticleSystem::Shutdown() {
 	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
 	m_state = SystemState::ShuttingDown;
 
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->UnregisterSystem(this));
+	m_stage	 = ECS::ESystemStage::Count;
+	m_typeID = UINT32_MAX;
+
 	m_state = SystemState::Uninitialized;
-	return ERROR_CODE::OK;
+	return result;
 }
 
 void ParticleSystem::OnUpdate(float dt) {
@@ -93,64 +157,17 @@ void ParticleSystem::OnUpdate(float dt) {
 			}
 			emitter.spawnAccumulator -= rate;
 		}
+	}
 
-		for (int j = 0; j < emitter.particles.size(); ++j) {
-			auto &p = emitter.particles[j];
-
-			float lifeRatio = 1.0f - (p.life / emitter.lifeTime);
-
-			p.life -= dt;
-			p.position += p.velocity * dt;
-
-			if (emitter.type == ParticleType::Fire) {
-				float turbulence = sinf(p.position.y * 2.0f + p.life * 5.0f) * 1.5f;
-				p.position.x += turbulence * dt;
-				p.position.z += turbulence * dt;
-
-				Math::Vector4 startColor = {1.0f, 0.9f, 0.6f, 1.0f};
-				Math::Vector4 midColor	 = {1.0f, 0.4f, 0.0f, 0.9f};
-				Math::Vector4 endColor	 = {0.1f, 0.1f, 0.1f, 0.0f};
-
-				if (lifeRatio < 0.5f) {
-					float t = lifeRatio / 0.5f;
-					p.color = Math::Lerp(startColor, midColor, t);
-					p.size	= Math::Lerp(1.0f, 0.8f, t);
-				} else {
-					float t = (lifeRatio - 0.5f) / 0.5f;
-					p.color = Math::Lerp(midColor, endColor, t);
-					p.size	= Math::Lerp(0.8f, 1.5f, t);
-				}
-			} else if (emitter.type == ParticleType::Dust) {
-				float wave = sinf(p.life * 3.0f) * 2.0f;
-
-				p.position.x += wave * dt;
-				p.position.z += wave * dt;
-
-				p.rotation += dt * 0.3f;
-
-				p.size += dt * 3.0f;
-
-				float maxAlpha = 0.3f;
-
-				if (lifeRatio < 0.1f) {
-					p.color.w = (lifeRatio / 0.1f) * maxAlpha;
-				} else if (lifeRatio > 0.8f) {
-					float remaining = (1.0f - lifeRatio) / 0.2f;
-					p.color.w		= remaining * maxAlpha;
-				} else {
-					p.color.w = maxAlpha;
-				}
-			} else {
-				p.color.w = std::clamp(p.life, 0.0f, 1.0f);
-			}
-
-			if (p.life <= 0.0f) {
-				emitter.particles[j] = emitter.particles.back();
-				emitter.particles.pop_back();
-				j--;
-			}
-		}
+	// Simulation is independent per particle. Spawning above stays serial because of rand() and the transform lookup.
+	Utilities::JobSystem::ParallelFor(std::span(compArr.Data()), 1, [dt](Components::ParticleEmitter &emitter, size_t) {
+		Utilities::JobSystem::ParallelFor(
+			std::span(emitter.particles), PARTICLE_GRAIN_SIZE,
+			[&emitter, dt](Components::Particle &p, size_t) { SimulateParticle(p, emitter, dt); });
+		std::erase_if(emitter.particles, [](const Components::Particle &p) { return p.life <= 0.0f; });
+	});
 
+	for (const auto &emitter : compArr.Data()) {
 		if (!emitter.particles.empty()) {
 			ref_renderer->SubmitParticles(emitter.textureID, emitter.particles);
 		}
@@ -7,28 +7,72 @@
 #include "Graphics/D3D11/D3D11Renderer.h"
 #include "Graphics/Systems/CameraSystem.h"
 #include "Graphics/Vulkan/VulkanRenderer.h"
+#include "Math/Bounds.h"
 #include "Scene/Components/DayNightCycle.h"
 #include "Scene/Components/Transform.h"
+#include "Utilities/JobSystem.h"
 #include "Utilities/Logger.h"
 #include "Utilities/MemoryUtilities.h"
 
 namespace PE::Graphics::Systems {
+constexpr size_t RENDER_COMMAND_GRAIN_SIZE = 256;
+constexpr size_t CULL_GRAIN_SIZE		   = 1024;
+constexpr float	 MAX_KEY_DEPTH			   = 65535.0f;	// the depth field of RenderKey is 16 bits
+
+// Bounds of meshes that were never registered with the AssetManager, they are never culled.
+const Math::BoundingSphere UNBOUNDED_SPHERE{Math::Vector3Zero, Math::Infinity};
+
+// Coarsest LOD of the submesh whose error, times errorScale, still fits into distance. errorScale of 0 keeps the full
+// detail mesh.
+MeshID SelectLOD(const Components::MeshRenderer::SubMeshInfo &subMesh, const float distance, const float errorScale) {
+	MeshID meshID = subMesh.meshID;
+	if (errorScale <= 0.0f) return meshID;
+	for (uint8_t l = 0; l < subMesh.lodCount; ++l) {
+		if (subMesh.lods[l].error * errorScale > distance) break;
+		meshID = subMesh.lods[l].meshID;
+	}
+	return meshID;
+}
+
+uint8_t GetRenderFlags(const Components::MeshRenderer &meshRenderer) {
+	uint8_t flags = RenderFlag_None;
+	if (meshRenderer.isVisible) flags |= RenderFlag_Visible;
+	if (meshRenderer.castShadows) flags |= RenderFlag_CastShadows;
+	if (meshRenderer.receiveShadows) flags |= RenderFlag_ReceiveShadows;
+	if (meshRenderer.forceTransparent) flags |= RenderFlag_ForceTransparent;
+	return flags;
+}
+
 ERROR_CODE RenderSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager,
-									CameraSystem *cameraSystem, GLFWwindow *window, Core::EngineConfig &config) {
+									CameraSystem *cameraSystem, Scene::Systems::TransformSystem *transformSystem,
+									GLFWwindow *window, Core::EngineConfig &config) {
 	PE_CHECK_STATE_INIT(m_state, "Render system is already initialized!");
 	m_state = SystemState::Initializing;
 
-	m_typeID		  = GetUniqueISystemTypeID<RenderSystem>();
-	ref_entityManager = entityManager;
-	ref_cameraSystem  = cameraSystem;
-	m_stage			  = stage;
-	ref_engineConfig  = &config;
-	ref_renderConfig  = &config.renderConfig;
+	m_typeID			= GetUniqueISystemTypeID<RenderSystem>();
+	ref_entityManager	= entityManager;
+	ref_cameraSystem	= cameraSystem;
+	ref_transformSystem = transformSystem;
+	m_stage				= stage;
+	ref_engineConfig	= &config;
+	ref_renderConfig	= &config.renderConfig;
+
+	// Presenting touches the window surface, so rendering stays on the main thread.
+	m_access.mainThread = true;
+	DeclareReads<Scene::Components::Transform, Components::MeshRenderer, Components::Camera,
+				 Components::DirectionalLight, Scene::Components::DayNightCycle>();
+	DeclareWrites<IRenderer>();
 
 	ERROR_CODE result;
 	PE_CHECK(result, ref_entityManager->RegisterSystem(this));
 	PE_CHECK(result, InitializeRenderer(window, config));
 
+	// Removed MeshRenderers release their GPU instances, the rest is picked up while building commands.
+	if (m_renderer->IsGPUDriven()) {
+		m_gpuEntitySlots.Reserve(config.maxEntityCount);
+		ref_entityManager->GetCompArr<Components::MeshRenderer>().SetChangeTracking(true);
+	}
+
 	m_state = SystemState::Running;
 	return result;
 }
@@ -37,6 +81,12 @@ ERROR_CODE RenderSystem::Shutdown() {
 	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
 	m_state = SystemState::ShuttingDown;
 
+	// The instances go with the renderer.
+	if (m_renderer && m_renderer->IsGPUDriven())
+		ref_entityManager->GetCompArr<Components::MeshRenderer>().SetChangeTracking(false);
+	m_gpuEntities.clear();
+	m_gpuEntitySlots.Clear();
+
 	ERROR_CODE result;
 	PE_CHECK(result, Utilities::SafeShutdownReturnsErrorCode(m_renderer));
 	PE_CHECK(result, ref_entityManager->UnregisterSystem(this));
@@ -116,38 +166,215 @@ void RenderSystem::OnUpdate(float dt) {
 		(ref_renderConfig->renderPath == RenderPathType::Deferred) ? RenderPass::GBuffer : RenderPass::Forward;
 
 	const auto &activeEntities = modelArr.Index();
-	for (uint32_t entityID : activeEntities) {
-		if (!transformArr.Has(entityID)) continue;
-
-		shouldFlush		   = true;
-		auto &meshRenderer = modelArr.Get(entityID);
-		auto &transform	   = transformArr.Get(entityID);
-
-		Math::Matrix4 world = transform.worldMatrix;
-
-		float	 dist	  = Math::Vector3Distance(transform.position, transform.position);
-		uint32_t depthInt = static_cast<uint32_t>(dist * 1000.0f);
-
-		for (const auto &[meshID, materialID] : meshRenderer.subMeshes) {
-			auto const	 &mat = m_renderer->GetMaterial(materialID);
-			RenderCommand cmd{};
-			cmd.key			= RenderKey::Create(static_cast<uint8_t>(geoPass), mat.GetShaderID(), materialID, depthInt);
-			cmd.meshID		= meshID;
-			cmd.materialID	= materialID;
-			cmd.worldMatrix = world;
-			cmd.ownerEntityID = entityID;
-
-			cmd.flags = RenderFlag_None;
-			if (meshRenderer.isVisible) cmd.flags |= RenderFlag_Visible;
-			if (meshRenderer.castShadows) cmd.flags |= RenderFlag_CastShadows;
-			if (meshRenderer.receiveShadows) cmd.flags |= RenderFlag_ReceiveShadows;
-			if (meshRenderer.forceTransparent) cmd.flags |= RenderFlag_ForceTransparent;
-
-			m_renderer->Submit(cmd);
+	const auto &meshRenderers  = modelArr.Data();
+
+	const bool gpuDriven = m_renderer->IsGPUDriven();
+	if (gpuDriven) {
+		if (modelArr.WasCleared()) {
+			for (GPUEntity &entity : m_gpuEntities) ReleaseGPUInstances(entity);
+			m_gpuEntities.clear();
+			m_gpuEntitySlots.Clear();
+		}
+		for (const ECS::EntityID entityID : modelArr.GetRemovedEntities()) RemoveGPUEntity(entityID);
+		modelArr.ClearChanges();
+	}
+
+	// Serial prefix pass gives every entity its own slice of the command list, so the fill below can run on workers.
+	// Object space bounds of newly seen meshes are cached here too, the workers only read them. Entities the GPU
+	// driven path draws get an empty slice.
+	m_commandOffsets.resize(activeEntities.size() + 1);
+	uint32_t commandCount = 0;
+	for (size_t i = 0; i < activeEntities.size(); ++i) {
+		m_commandOffsets[i] = commandCount;
+		if (!transformArr.Has(activeEntities[i])) continue;
+
+		shouldFlush = true;
+		for (const auto &subMesh : meshRenderers[i].subMeshes) CacheMeshBounds(subMesh.meshID);
+		if (gpuDriven &&
+			SyncGPUEntity(activeEntities[i], meshRenderers[i], transformArr.Get(activeEntities[i]).worldMatrix))
+			continue;
+
+		commandCount += static_cast<uint32_t>(meshRenderers[i].subMeshes.size());
+	}
+	m_commandOffsets[activeEntities.size()] = commandCount;
+	m_commandScratch.resize(commandCount);
+	m_sphereX.resize(commandCount);
+	m_sphereY.resize(commandCount);
+	m_sphereZ.resize(commandCount);
+	m_sphereRadius.resize(commandCount);
+	m_commandVisible.resize(commandCount);
+
+	// Instances only hear about the transforms that moved, the ones that didn't cost nothing.
+	if (gpuDriven) {
+		for (const ECS::EntityID entityID : ref_transformSystem->GetUpdatedEntities()) {
+			const GPUEntity *entity = FindGPUEntity(entityID);
+			if (!entity || entity->instances.empty() || !transformArr.Has(entityID)) continue;
+
+			const Math::Matrix4 &world	   = transformArr.Get(entityID).worldMatrix;
+			const auto			&subMeshes = modelArr.Get(entityID).subMeshes;
+			for (size_t s = 0; s < entity->instances.size(); ++s) {
+				m_renderer->UpdateInstance(entity->instances[s], world,
+										   Math::TransformSphere(GetMeshSphere(subMeshes[s].meshID), world));
+			}
+		}
+	}
+
+	const Math::Matrix4 &view		= cam.viewMatrix;
+	const float			 depthScale = cam.farZ > 0.0f ? MAX_KEY_DEPTH / cam.farZ : 0.0f;
+
+	// LODs are picked by how many pixels their error covers, e * pixelsPerUnit / d for an object space error e at
+	// distance d.
+	const Math::Vector3 cameraPosition = Math::Vector3(perPassData.inverseView[3]);
+	const float			pixelsPerUnit  = cam.projectionMatrix[1][1] * 0.5f * ref_renderConfig->height;
+	const float			maxErrorPixels = ref_renderConfig->lodErrorPixels;
+	const float			lodScale	   = maxErrorPixels > 0.0f ? pixelsPerUnit / maxErrorPixels : 0.0f;
+
+	Utilities::JobSystem::ParallelFor(
+		std::span(meshRenderers), RENDER_COMMAND_GRAIN_SIZE,
+		[&](const Components::MeshRenderer &meshRenderer, const size_t i) {
+			if (m_commandOffsets[i] == m_commandOffsets[i + 1]) return;
+
+			const uint32_t entityID	 = activeEntities[i];
+			auto		  &transform = transformArr.Get(entityID);
+
+			Math::Matrix4 world			= transform.worldMatrix;
+			const float	  worldLODScale = lodScale * Math::GetMaxScale(world);
+
+			uint32_t commandIndex = m_commandOffsets[i];
+			for (const auto &subMesh : meshRenderer.subMeshes) {
+				const Math::BoundingSphere sphere = Math::TransformSphere(GetMeshSphere(subMesh.meshID), world);
+				m_sphereX[commandIndex]			  = sphere.center.x;
+				m_sphereY[commandIndex]			  = sphere.center.y;
+				m_sphereZ[commandIndex]			  = sphere.center.z;
+				m_sphereRadius[commandIndex]	  = sphere.radius;
+
+				// Camera space depth of the bounds center, the view matrix is left handed so +z looks forward. It is
+				// quantized over [0, farZ] to fit the key.
+				const float	   viewDepth = (view * Math::Vector4(sphere.center, 1.0f)).z;
+				const uint16_t depthInt =
+					static_cast<uint16_t>(Math::Clamp(viewDepth * depthScale, 0.0f, MAX_KEY_DEPTH));
+
+				// Distance to the closest point of the bounds, the full detail mesh is kept while the camera is inside.
+				const float		 distance	= Math::Length(sphere.center - cameraPosition) - sphere.radius;
+				const MeshID	 meshID		= SelectLOD(subMesh, distance, worldLODScale);
+				const MaterialID materialID = subMesh.materialID;
+
+				auto const	 &mat = m_renderer->GetMaterial(materialID);
+				RenderCommand cmd{};
+				cmd.key = RenderKey::Create(static_cast<uint8_t>(geoPass), mat.GetShaderID(), materialID, meshID,
+											depthInt);
+				cmd.meshID		  = meshID;
+				cmd.materialID	  = materialID;
+				cmd.worldMatrix	  = world;
+				cmd.bounds		  = sphere;
+				cmd.ownerEntityID = entityID;
+				cmd.flags		  = GetRenderFlags(meshRenderer);
+
+				m_commandScratch[commandIndex++] = cmd;
+			}
+		});
+
+	const Math::Frustum frustum = Math::ExtractFrustum(cam.projectionMatrix * cam.viewMatrix);
+	Utilities::JobSystem::ParallelForRange(commandCount, CULL_GRAIN_SIZE, [&](const size_t begin, const size_t end) {
+		Math::CullSpheres(frustum, &m_sphereX[begin], &m_sphereY[begin], &m_sphereZ[begin], &m_sphereRadius[begin],
+						  end - begin, &m_commandVisible[begin]);
+	});
+
+	// The renderer queue is not thread safe, submit in entity order like before. Off-screen shadow casters can still
+	// throw a shadow into view, so they stay queued for the shadow pass only.
+	uint32_t culledCount = 0;
+	for (uint32_t i = 0; i < commandCount; ++i) {
+		RenderCommand &cmd = m_commandScratch[i];
+		if (!m_commandVisible[i]) {
+			culledCount++;
+			if (!(cmd.flags & RenderFlag_CastShadows)) continue;
+			cmd.flags |= RenderFlag_Culled;
 		}
+		m_renderer->Submit(cmd);
 	}
 
 	if (shouldFlush) m_renderer->Flush();
+	m_renderer->SetCullingStats(commandCount - culledCount, culledCount);
+}
+
+bool RenderSystem::SyncGPUEntity(const ECS::EntityID entityID, const Components::MeshRenderer &meshRenderer,
+								 const Math::Matrix4 &world) {
+	const uint8_t flags		   = GetRenderFlags(meshRenderer);
+	const auto	  subMeshCount = static_cast<uint32_t>(meshRenderer.subMeshes.size());
+
+	GPUEntity *entity = FindGPUEntity(entityID);
+	if (entity && entity->flags == flags && entity->subMeshCount == subMeshCount) return !entity->instances.empty();
+
+	if (!entity) {
+		// A record left behind by an earlier entity of the same index goes first.
+		const uint32_t index = ECS::GetEntityIndex(entityID);
+		if (const uint32_t slot = m_gpuEntitySlots.Get(index); slot != UINT32_MAX) {
+			RemoveGPUEntity(m_gpuEntities[slot].entityID);
+		}
+
+		m_gpuEntitySlots.Assure(index) = static_cast<uint32_t>(m_gpuEntities.size());
+		entity						   = &m_gpuEntities.emplace_back();
+		entity->entityID			   = entityID;
+	}
+
+	ReleaseGPUInstances(*entity);
+	entity->flags		 = flags;
+	entity->subMeshCount = subMeshCount;
+
+	// Transparent draws are sorted back to front every frame, they stay submitted. So does an entity that doesn't fit
+	// into the renderer's instances anymore, until its MeshRenderer changes.
+	if (flags & RenderFlag_ForceTransparent) return false;
+
+	for (const auto &subMesh : meshRenderer.subMeshes) {
+		const InstanceID instanceID =
+			m_renderer->CreateInstance(subMesh.meshID, subMesh.materialID, flags, world,
+									   Math::TransformSphere(GetMeshSphere(subMesh.meshID), world));
+		if (instanceID == INVALID_HANDLE) {
+			ReleaseGPUInstances(*entity);
+			return false;
+		}
+		entity->instances.push_back(instanceID);
+	}
+	return !entity->instances.empty();
+}
+
+void RenderSystem::RemoveGPUEntity(const ECS::EntityID entityID) {
+	GPUEntity *entity = FindGPUEntity(entityID);
+	if (!entity) return;
+
+	ReleaseGPUInstances(*entity);
+
+	// Swap and pop keeps the records packed.
+	const uint32_t slot = m_gpuEntitySlots.Get(ECS::GetEntityIndex(entityID));
+	if (slot != m_gpuEntities.size() - 1) {
+		*entity = std::move(m_gpuEntities.back());
+		m_gpuEntitySlots.Assure(ECS::GetEntityIndex(entity->entityID)) = slot;
+	}
+	m_gpuEntities.pop_back();
+	m_gpuEntitySlots.Assure(ECS::GetEntityIndex(entityID)) = UINT32_MAX;
+}
+
+void RenderSystem::ReleaseGPUInstances(GPUEntity &entity) {
+	for (const InstanceID instanceID : entity.instances) m_renderer->DestroyInstance(instanceID);
+	entity.instances.clear();
+}
+
+RenderSystem::GPUEntity *RenderSystem::FindGPUEntity(const ECS::EntityID entityID) {
+	const uint32_t slot = m_gpuEntitySlots.Get(ECS::GetEntityIndex(entityID));
+	return slot != UINT32_MAX && m_gpuEntities[slot].entityID == entityID ? &m_gpuEntities[slot] : nullptr;
+}
+
+void RenderSystem::CacheMeshBounds(const MeshID meshID) {
+	if (meshID == INVALID_HANDLE) return;
+	if (meshID < m_meshSpheres.size() && m_meshSpheres[meshID].radius >= 0.0f) return;
+	if (meshID >= m_meshSpheres.size()) m_meshSpheres.resize(meshID + 1, {Math::Vector3Zero, -1.0f});
+
+	const Assets::MeshAssetInfo *info = Assets::AssetManager::GetMeshAssetInfo(meshID);
+	m_meshSpheres[meshID]			  = info && info->bounds.IsValid() ? info->boundingSphere : UNBOUNDED_SPHERE;
+}
+
+const Math::BoundingSphere &RenderSystem::GetMeshSphere(const MeshID meshID) const {
+	return meshID < m_meshSpheres.size() ? m_meshSpheres[meshID] : UNBOUNDED_SPHERE;
 }
 
 void RenderSystem::OnResize(const RenderConfig &config) {
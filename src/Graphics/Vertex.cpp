@@ -1,6 +1,30 @@
 #include "Graphics/Vertex.h"
 
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+
 namespace PE::Graphics {
+namespace {
+// Projects a unit vector onto the octahedron |x| + |y| + |z| = 1 and folds the lower half over the upper one, so two
+// components in [-1, 1] are left. Spreads its precision far more evenly than storing x and y would.
+Math::Vector2 OctahedralEncode(const Math::Vector3 &v) {
+	const float sum = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+	if (sum == 0.0f) return {0.0f, 0.0f};
+
+	const Math::Vector2 p(v.x / sum, v.y / sum);
+	if (v.z >= 0.0f) return p;
+	return {(1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f)};
+}
+
+void PackUnitVector(const Math::Vector3 &v, int16_t out[2]) {
+	const Math::Vector2 e = OctahedralEncode(v);
+	out[0]				  = static_cast<int16_t>(glm::packSnorm1x16(e.x));
+	out[1]				  = static_cast<int16_t>(glm::packSnorm1x16(e.y));
+}
+}  // namespace
+
 Vertex::Vertex() : Position(0, 0, 0), Normal(0, 0, 0), Tangent(0, 0, 0), TexC(0, 0) {}
 
 Vertex::Vertex(Math::Vector3 position, Math::Vector3 normal, Math::Vector3 tangent, Math::Vector2 texcoord) {
@@ -13,4 +37,37 @@ Vertex::Vertex(Math::Vector3 position, Math::Vector3 normal, Math::Vector3 tange
 Vertex::Vertex(float px, float py, float pz, float nx, float ny, float nz, float tx, float ty, float tz, float u,
 			   float v)
 	: Position(px, py, pz), Normal(nx, ny, nz), Tangent(tx, ty, tz), TexC(u, v) {}
+
+VertexQuantization PackVertices(const std::span<const Vertex> vertices, std::vector<PackedVertex> &outVertices) {
+	outVertices.resize(vertices.size());
+	if (vertices.empty()) return {};
+
+	Math::Vector3 min = vertices[0].Position;
+	Math::Vector3 max = vertices[0].Position;
+	for (const Vertex &vertex : vertices) {
+		min = glm::min(min, vertex.Position);
+		max = glm::max(max, vertex.Position);
+	}
+
+	// A flat axis keeps its single coordinate in the offset.
+	const Math::Vector3 extent = max - min;
+	Math::Vector3		inverseExtent(0.0f);
+	for (int axis = 0; axis < 3; ++axis)
+		if (extent[axis] > 0.0f) inverseExtent[axis] = 1.0f / extent[axis];
+
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const Vertex	   &vertex = vertices[i];
+		PackedVertex	   &packed = outVertices[i];
+		const Math::Vector3 unit   = (vertex.Position - min) * inverseExtent;
+
+		packed.Position[0] = glm::packUnorm1x16(unit.x);
+		packed.Position[1] = glm::packUnorm1x16(unit.y);
+		packed.Position[2] = glm::packUnorm1x16(unit.z);
+		PackUnitVector(vertex.Normal, packed.Normal);
+		PackUnitVector(vertex.Tangent, packed.Tangent);
+		packed.TexC[0] = glm::packHalf1x16(vertex.TexC.x);
+		packed.TexC[1] = glm::packHalf1x16(vertex.TexC.y);
+	}
+	return {extent, min};
+}
 }  // namespace PE::Graphics
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "Graphics/Vulkan/VulkanCommand.h"
 
+#include <algorithm>
+
 #include "Graphics/Vulkan/VulkanDevice.h"
 #include "Utilities/Logger.h"
 
 namespace PE::Graphics::Vulkan {
-ERROR_CODE VulkanCommand::Initialize(VulkanDevice *device, uint32_t framesInFlight) {
+ERROR_CODE VulkanCommand::Initialize(VulkanDevice *device, uint32_t framesInFlight, uint32_t recordingSlots) {
 	PE_CHECK_STATE_INIT(m_state, "This vulkan command is already initialized.");
 	m_state = SystemState::Initializing;
 
@@ -12,6 +14,7 @@ ERROR_CODE VulkanCommand::Initialize(VulkanDevice *device, uint32_t framesInFlig
 	ERROR_CODE result;
 	PE_CHECK(result, CreateCommandPool());
 	PE_CHECK(result, CreateCommandBuffers(framesInFlight));
+	PE_CHECK(result, CreateSecondaryCommandBuffers(framesInFlight, recordingSlots));
 
 	m_state = SystemState::Running;
 	return ERROR_CODE::OK;
@@ -20,6 +23,9 @@ ERROR_CODE VulkanCommand::Initialize(VulkanDevice *device, uint32_t framesInFlig
 void VulkanCommand::Shutdown() {
 	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
 	m_state = SystemState::ShuttingDown;
+	for (const SecondaryPool &secondary : m_secondaryPools)
+		if (secondary.pool != VK_NULL_HANDLE) vkDestroyCommandPool(ref_device->GetVkDevice(), secondary.pool, nullptr);
+	m_secondaryPools.clear();
 	if (m_commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(ref_device->GetVkDevice(), m_commandPool, nullptr);
 	m_state = SystemState::Uninitialized;
 }
@@ -55,4 +61,41 @@ ERROR_CODE VulkanCommand::CreateCommandBuffers(uint32_t frames) {
 	}
 	return ERROR_CODE::OK;
 }
+
+ERROR_CODE VulkanCommand::CreateSecondaryCommandBuffers(uint32_t frames, uint32_t recordingSlots) {
+	m_recordingSlots = std::max(recordingSlots, 1u);
+	m_secondaryPools.resize(static_cast<size_t>(frames) * m_recordingSlots);
+
+	VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+	poolInfo.flags			  = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = ref_device->GetQueueFamilies().graphicsFamily.value();
+
+	for (SecondaryPool &secondary : m_secondaryPools) {
+		if (vkCreateCommandPool(ref_device->GetVkDevice(), &poolInfo, nullptr, &secondary.pool) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to create secondary command pool!");
+			return ERROR_CODE::VULKAN_COMMAND_CREATION_FAILED;
+		}
+
+		VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		allocInfo.commandPool		 = secondary.pool;
+		allocInfo.level				 = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandBufferCount = SECONDARY_BUFFERS_PER_SLOT;
+
+		if (vkAllocateCommandBuffers(ref_device->GetVkDevice(), &allocInfo, secondary.buffers.data()) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to allocate secondary command buffers!");
+			return ERROR_CODE::VULKAN_COMMAND_CREATION_FAILED;
+		}
+	}
+	return ERROR_CODE::OK;
+}
+
+VkCommandBuffer VulkanCommand::GetSecondaryCommandBuffer(const uint32_t frame, const uint32_t slot,
+														 const uint32_t buffer) const {
+	return m_secondaryPools[frame * m_recordingSlots + slot].buffers[buffer];
+}
+
+void VulkanCommand::ResetSecondaryCommandBuffers(const uint32_t frame) {
+	for (uint32_t slot = 0; slot < m_recordingSlots; ++slot)
+		vkResetCommandPool(ref_device->GetVkDevice(), m_secondaryPools[frame * m_recordingSlots + slot].pool, 0);
+}
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
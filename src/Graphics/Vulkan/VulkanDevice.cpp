@@ -9,6 +9,7 @@
 
 #include <map>
 #include <set>
+#include <span>
 
 #include "Graphics/Vulkan/VulkanDevice.h"
 #include "Utilities/Logger.h"
@@ -40,7 +41,8 @@ ERROR_CODE VulkanDevice::Initialize(GLFWwindow *windowHandle) {
 	PE_CHECK(result, CreateInstance());
 	if (m_enableValidationLayers) PE_CHECK(result, SetupDebugMessenger());
 
-	PE_CHECK(result, CreateSurface());
+	// Headless devices render offscreen, without a surface or the swapchain extension.
+	if (ref_window) PE_CHECK(result, CreateSurface());
 	PE_CHECK(result, PickPhysicalDevice());
 	PE_CHECK(result, CreateLogicalDevice());
 
@@ -57,7 +59,7 @@ void VulkanDevice::Shutdown() {
 	if (m_enableValidationLayers) {
 		DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
 	}
-	vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+	if (m_surface != VK_NULL_HANDLE) vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
 	vkDestroyInstance(m_instance, nullptr);
 
 	m_state = SystemState::Uninitialized;
@@ -198,9 +200,11 @@ ERROR_CODE VulkanDevice::PickPhysicalDevice() {
 }
 
 ERROR_CODE VulkanDevice::CreateLogicalDevice() {
-	m_indices = FindQueueFamilies(m_vkPhysicalDevice);
+	m_indices				 = FindQueueFamilies(m_vkPhysicalDevice);
+	m_indices.transferFamily = FindTransferFamily(m_vkPhysicalDevice, m_indices.graphicsFamily.value());
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies = {m_indices.graphicsFamily.value(), m_indices.presentFamily.value()};
+	std::set<uint32_t> uniqueQueueFamilies = {m_indices.graphicsFamily.value(), m_indices.presentFamily.value(),
+											  m_indices.transferFamily.value()};
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -212,20 +216,56 @@ ERROR_CODE VulkanDevice::CreateLogicalDevice() {
 		queueCreateInfos.push_back(queueCreateInfo);
 	}
 
+	VkPhysicalDeviceVulkan12Features supportedFeatures12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+	VkPhysicalDeviceFeatures2		 supportedFeatures2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+	supportedFeatures2.pNext = &supportedFeatures12;
+	vkGetPhysicalDeviceFeatures2(m_vkPhysicalDevice, &supportedFeatures2);
+	const VkPhysicalDeviceFeatures &supportedFeatures = supportedFeatures2.features;
+
+	// Indirect count draws are an optional 1.2 feature, and the 1.2 struct can't share a chain with the descriptor
+	// indexing and timeline structs it replaces, so everything from 1.2 is enabled through it.
+	VkPhysicalDeviceVulkan12Features features12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+	features12.runtimeDescriptorArray						= VK_TRUE;
+	features12.descriptorBindingPartiallyBound				= VK_TRUE;
+	features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	features12.descriptorBindingUpdateUnusedWhilePending	= VK_TRUE;
+	features12.timelineSemaphore							= VK_TRUE;
+	features12.drawIndirectCount							= supportedFeatures12.drawIndirectCount;
+
 	VkPhysicalDeviceSynchronization2Features sync2Features{};
 	sync2Features.sType			   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
 	sync2Features.synchronization2 = VK_TRUE;
+	sync2Features.pNext			   = &features12;
 
 	VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{};
 	dynamicRenderingFeatures.sType			  = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
 	dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
 	dynamicRenderingFeatures.pNext			  = &sync2Features;
 
+	// Block compressed textures are optional, the asset pipeline falls back to RGBA8 without them.
+	m_supportsBlockCompression = supportedFeatures.textureCompressionBC == VK_TRUE;
+	// So are pipeline statistics. The pass queries stay active while secondary buffers execute, which takes
+	// inheritedQueries as well.
+	m_supportsPipelineStatistics =
+		supportedFeatures.pipelineStatisticsQuery == VK_TRUE && supportedFeatures.inheritedQueries == VK_TRUE;
+	// So is GPU driven culling. Its draws come from indirect count calls that draw several commands each, and the
+	// commands find their visible lists through firstInstance.
+	m_supportsGPUCulling = supportedFeatures12.drawIndirectCount == VK_TRUE &&
+						   supportedFeatures.multiDrawIndirect == VK_TRUE &&
+						   supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+
 	VkPhysicalDeviceFeatures2 deviceFeatures2{};
-	deviceFeatures2.sType					   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-	deviceFeatures2.pNext					   = &dynamicRenderingFeatures;
-	deviceFeatures2.features.samplerAnisotropy = VK_TRUE;
-	deviceFeatures2.features.fillModeNonSolid  = VK_TRUE;
+	deviceFeatures2.sType							   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	deviceFeatures2.pNext							   = &dynamicRenderingFeatures;
+	deviceFeatures2.features.samplerAnisotropy		   = VK_TRUE;
+	deviceFeatures2.features.fillModeNonSolid		   = VK_TRUE;
+	deviceFeatures2.features.textureCompressionBC	   = supportedFeatures.textureCompressionBC;
+	deviceFeatures2.features.pipelineStatisticsQuery   = m_supportsPipelineStatistics ? VK_TRUE : VK_FALSE;
+	deviceFeatures2.features.inheritedQueries		   = m_supportsPipelineStatistics ? VK_TRUE : VK_FALSE;
+	deviceFeatures2.features.multiDrawIndirect		   = m_supportsGPUCulling ? VK_TRUE : VK_FALSE;
+	deviceFeatures2.features.drawIndirectFirstInstance = m_supportsGPUCulling ? VK_TRUE : VK_FALSE;
+
+	const std::span<const char *const> deviceExtensions = GetDeviceExtensions();
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType				   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -233,8 +273,8 @@ ERROR_CODE VulkanDevice::CreateLogicalDevice() {
 	createInfo.queueCreateInfoCount	   = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos	   = queueCreateInfos.data();
 	createInfo.pEnabledFeatures		   = nullptr;
-	createInfo.enabledExtensionCount   = static_cast<uint32_t>(m_deviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+	createInfo.enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size());
+	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
 	if (m_enableValidationLayers) {
 		createInfo.enabledLayerCount   = static_cast<uint32_t>(m_validationLayers.size());
@@ -250,6 +290,7 @@ ERROR_CODE VulkanDevice::CreateLogicalDevice() {
 
 	vkGetDeviceQueue(m_vkDevice, m_indices.graphicsFamily.value(), 0, &m_graphicsQueue);
 	vkGetDeviceQueue(m_vkDevice, m_indices.presentFamily.value(), 0, &m_presentQueue);
+	vkGetDeviceQueue(m_vkDevice, m_indices.transferFamily.value(), 0, &m_transferQueue);
 
 	return ERROR_CODE::OK;
 }
@@ -257,12 +298,24 @@ ERROR_CODE VulkanDevice::CreateLogicalDevice() {
 bool VulkanDevice::IsDeviceSuitable(VkPhysicalDevice physicalDevice) {
 	m_indices				 = FindQueueFamilies(physicalDevice);
 	bool extensionsSupported = CheckDeviceExtensionSupport(physicalDevice);
-	bool swapChainAdequate	 = false;
-	if (extensionsSupported) {
+	bool swapChainAdequate	 = ref_window == nullptr;
+	if (extensionsSupported && ref_window) {
 		SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(physicalDevice);
 		swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
 	}
-	return m_indices.IsComplete() && extensionsSupported && swapChainAdequate;
+
+	// Materials and their textures are only reachable through the bindless descriptor set.
+	VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+	VkPhysicalDeviceFeatures2 features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+	features.pNext = &indexingFeatures;
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+	const bool bindlessSupported = indexingFeatures.runtimeDescriptorArray &&
+								   indexingFeatures.descriptorBindingPartiallyBound &&
+								   indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+								   indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+
+	return m_indices.IsComplete() && extensionsSupported && swapChainAdequate && bindlessSupported;
 }
 
 uint32_t VulkanDevice::RateDeviceSuitability(VkPhysicalDevice physicalDevice) {
@@ -285,7 +338,8 @@ bool VulkanDevice::CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice)
 	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
 
-	std::set<std::string> requiredExtensions(m_deviceExtensions.begin(), m_deviceExtensions.end());
+	const std::span<const char *const> deviceExtensions = GetDeviceExtensions();
+	std::set<std::string>			   requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 	for (const auto &extension : availableExtensions) {
 		requiredExtensions.erase(extension.extensionName);
 	}
@@ -304,8 +358,9 @@ VulkanDevice::QueueFamilyIndices VulkanDevice::FindQueueFamilies(VkPhysicalDevic
 		if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
 			indices.graphicsFamily = i;
 		}
-		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, m_surface, &presentSupport);
+		// Nothing is presented without a surface, the present queue is just the graphics queue.
+		VkBool32 presentSupport = ref_window == nullptr && indices.graphicsFamily.has_value();
+		if (ref_window) vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, m_surface, &presentSupport);
 		if (presentSupport) {
 			indices.presentFamily = i;
 		}
@@ -315,6 +370,25 @@ VulkanDevice::QueueFamilyIndices VulkanDevice::FindQueueFamilies(VkPhysicalDevic
 	return indices;
 }
 
+uint32_t VulkanDevice::FindTransferFamily(VkPhysicalDevice physicalDevice, const uint32_t graphicsFamily) {
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	// A family with transfer but neither graphics nor compute is usually the copy engine, it runs next to rendering
+	// instead of taking time from it. Any family without graphics is the next best thing.
+	std::optional<uint32_t> asyncFamily;
+	for (uint32_t i = 0; i < queueFamilyCount; i++) {
+		const VkQueueFlags flags = queueFamilies[i].queueFlags;
+		if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT)) continue;
+
+		if (!(flags & VK_QUEUE_COMPUTE_BIT)) return i;
+		if (!asyncFamily) asyncFamily = i;
+	}
+	return asyncFamily.value_or(graphicsFamily);
+}
+
 bool VulkanDevice::CheckValidationLayerSupport() const {
 	uint32_t layerCount;
 	vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
@@ -335,16 +409,23 @@ bool VulkanDevice::CheckValidationLayerSupport() const {
 }
 
 std::vector<const char *> VulkanDevice::GetRequiredExtensions() const {
-	uint32_t	 glfwExtensionCount = 0;
-	const char **glfwExtensions		= glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-	std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	std::vector<const char *> extensions;
+	if (ref_window) {
+		uint32_t	 glfwExtensionCount = 0;
+		const char **glfwExtensions		= glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	}
 	if (m_enableValidationLayers) {
 		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 	}
 	return extensions;
 }
 
+std::span<const char *const> VulkanDevice::GetDeviceExtensions() const {
+	if (!ref_window) return {};
+	return m_deviceExtensions;
+}
+
 void VulkanDevice::LogEverySupportedExtensions() {
 	uint32_t extensionCount = 0;
 	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
@@ -0,0 +1,586 @@
+#include "Graphics/Vulkan/VulkanGPUCulling.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Utilities/IOUtilities.h"
+#include "Utilities/Logger.h"
+
+namespace PE::Graphics::Vulkan {
+namespace {
+constexpr uint32_t WORKGROUP_SIZE = 64;	 // local_size_x of GPUCulling.comp
+constexpr uint32_t CULL_PHASE	  = 0;
+constexpr uint32_t COMPACT_PHASE  = 1;
+// Buffers of the culling set after the CullData at binding 0, in the order GPUCulling.comp declares them.
+constexpr uint32_t STORAGE_BINDING_COUNT = 6;
+
+constexpr VkDeviceSize DRAW_COMMAND_SIZE	= sizeof(VkDrawIndexedIndirectCommand);
+constexpr VkDeviceSize INITIAL_STAGING_SIZE = 256 * 1024;
+
+// CullData of GPUCulling.comp, std140.
+struct alignas(16) CullData {
+	Math::Vector4 planes[VulkanGPUCulling::MAX_VIEWS * Math::Frustum::Count];
+	uint32_t	  viewCount		   = 0;
+	uint32_t	  instanceCount	   = 0;
+	uint32_t	  groupCount	   = 0;
+	uint32_t	  instanceCapacity = 0;
+	uint32_t	  groupCapacity	   = 0;
+};
+
+// The draw count buffer holds a count per camera bucket, at most one per group, then one per cascade, then the
+// number of instances the camera saw.
+uint32_t GetVisibleTotalIndex(const uint32_t groupCapacity) { return groupCapacity + MAX_SHADOW_CASCADES; }
+}  // namespace
+
+ERROR_CODE VulkanGPUCulling::Initialize(VulkanDevice *device, VulkanMemoryAllocator *allocator,
+										const RenderConfig &config, const VkDescriptorSetLayout instanceSetLayout,
+										const VkPipelineCache cache) {
+	PE_CHECK_STATE_INIT(m_state, "This vulkan GPU culling is already initialized.");
+	m_state = SystemState::Initializing;
+
+	ref_vkDevice	   = device->GetVkDevice();
+	ref_allocator	   = allocator;
+	m_instanceCapacity = config.maxGPUInstances;
+	m_groupCapacity	   = config.maxIndirectDrawGroups;
+
+	ERROR_CODE result;
+	PE_ENSURE_INIT(result, CreateBuffers(config.maxFramesInFlight), "Vulkan failed to create GPU culling buffers!");
+	PE_ENSURE_INIT_SILENT(result, CreateDescriptors(instanceSetLayout));
+	PE_ENSURE_INIT_SILENT(result, CreatePipelines(cache));
+
+	PE_LOG_INFO("GPU driven culling initialized for " + std::to_string(m_instanceCapacity) + " instances and " +
+				std::to_string(m_groupCapacity) + " draw groups.");
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+void VulkanGPUCulling::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
+	m_state = SystemState::ShuttingDown;
+
+	vkDestroyPipeline(ref_vkDevice, m_cullPipeline, nullptr);
+	vkDestroyPipeline(ref_vkDevice, m_compactPipeline, nullptr);
+	vkDestroyPipelineLayout(ref_vkDevice, m_pipelineLayout, nullptr);
+	vkDestroyDescriptorPool(ref_vkDevice, m_descriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(ref_vkDevice, m_cullSetLayout, nullptr);
+	m_cullPipeline	  = VK_NULL_HANDLE;
+	m_compactPipeline = VK_NULL_HANDLE;
+	m_pipelineLayout  = VK_NULL_HANDLE;
+	m_descriptorPool  = VK_NULL_HANDLE;
+	m_cullSetLayout	  = VK_NULL_HANDLE;
+	m_instanceSet	  = VK_NULL_HANDLE;
+
+	for (FrameResources &frame : m_frames) {
+		frame.cullData.Shutdown();
+		frame.staging.Shutdown();
+		frame.readback.Shutdown();
+	}
+	m_frames.clear();
+
+	m_objectBuffer.Shutdown();
+	m_instanceBuffer.Shutdown();
+	m_groupBuffer.Shutdown();
+	m_groupCountBuffer.Shutdown();
+	m_visibleBuffer.Shutdown();
+	m_commandBuffer.Shutdown();
+	m_drawCountBuffer.Shutdown();
+
+	m_objects.clear();
+	m_instances.clear();
+	m_freeInstances.clear();
+	m_dirtyInstances.clear();
+	m_instanceDirty.clear();
+	m_groups.clear();
+	m_groupRecords.clear();
+	m_pendingGroups.clear();
+	m_groupLookup.clear();
+	m_buckets.clear();
+	m_bucketLookup.clear();
+	m_instanceCount		= 0;
+	m_liveInstanceCount = 0;
+	m_visibleCount		= 0;
+
+	m_state = SystemState::Uninitialized;
+}
+
+InstanceID VulkanGPUCulling::CreateInstance(const MeshID meshID, const MaterialID materialID,
+											const uint8_t renderFlags, const CBPerObject &object,
+											const Math::BoundingSphere &bounds) {
+	if (m_state != SystemState::Running) return INVALID_HANDLE;
+	if (m_freeInstances.empty() && m_instanceCount >= m_instanceCapacity) return INVALID_HANDLE;
+
+	const uint32_t groupIndex = FindOrCreateGroup(meshID, materialID);
+	if (groupIndex == INVALID_HANDLE) return INVALID_HANDLE;
+
+	InstanceID id;
+	if (!m_freeInstances.empty()) {
+		id = m_freeInstances.back();
+		m_freeInstances.pop_back();
+	} else {
+		// Slots are dispatched up to m_instanceCount, a new one is written before the first dispatch that reads it.
+		id = m_instanceCount++;
+		m_objects.emplace_back();
+		m_instances.emplace_back();
+		m_instanceDirty.push_back(0);
+	}
+
+	GPUCullInstance &instance = m_instances[id];
+	instance.groupIndex		  = groupIndex;
+	instance.flags			  = renderFlags & (RenderFlag_Visible | RenderFlag_CastShadows);
+
+	m_groups[groupIndex].instanceCount++;
+	m_groupsDirty = true;
+	m_liveInstanceCount++;
+
+	m_objects[id] = object;
+	UpdateInstance(id, object.world, bounds);
+	return id;
+}
+
+void VulkanGPUCulling::UpdateInstance(const InstanceID id, const Math::Matrix4 &world,
+									  const Math::BoundingSphere &bounds) {
+	if (m_state != SystemState::Running || id >= m_instanceCount) return;
+
+	m_objects[id].world	   = world;
+	m_instances[id].sphere = Math::Vector4(bounds.center, bounds.radius);
+	MarkDirty(id);
+}
+
+void VulkanGPUCulling::DestroyInstance(const InstanceID id) {
+	if (m_state != SystemState::Running || id >= m_instanceCount) return;
+
+	GPUCullInstance &instance = m_instances[id];
+	if (instance.groupIndex == INVALID_HANDLE) return;
+
+	m_groups[instance.groupIndex].instanceCount--;
+	m_groupsDirty = true;
+	m_liveInstanceCount--;
+
+	// The slot stays in the dispatch, the culling pass skips it until it is reused.
+	instance.groupIndex = INVALID_HANDLE;
+	instance.flags		= 0;
+	MarkDirty(id);
+	m_freeInstances.push_back(id);
+}
+
+void VulkanGPUCulling::CollectResults(const uint32_t frame) {
+	if (m_state != SystemState::Running || !m_frames[frame].pending) return;
+
+	FrameResources &resources = m_frames[frame];
+	resources.pending		  = false;
+	std::memcpy(&m_visibleCount, resources.readback.GetMappedData(), sizeof(uint32_t));
+}
+
+void VulkanGPUCulling::RecordCulling(VkCommandBuffer cmd, const uint32_t frame,
+									 const std::span<const Math::Frustum> views) {
+	if (m_state != SystemState::Running) return;
+
+	FrameResources &resources = m_frames[frame];
+
+	// The previous frame culled into and drew from the buffers this one refills.
+	VkMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+	barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+						   VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+	barrier.dstStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+	VkDependencyInfo dependency{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+	dependency.memoryBarrierCount = 1;
+	dependency.pMemoryBarriers	  = &barrier;
+	vkCmdPipelineBarrier2(cmd, &dependency);
+
+	RecordUploads(cmd, resources);
+	vkCmdFillBuffer(cmd, m_groupCountBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+	vkCmdFillBuffer(cmd, m_drawCountBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+	CullData data{};
+	const auto viewCount = static_cast<uint32_t>(std::min<size_t>(views.size(), MAX_VIEWS));
+	for (uint32_t view = 0; view < viewCount; ++view) {
+		std::memcpy(&data.planes[view * Math::Frustum::Count], views[view].planes, sizeof(views[view].planes));
+	}
+	data.viewCount		  = viewCount;
+	data.instanceCount	  = m_instanceCount;
+	data.groupCount		  = static_cast<uint32_t>(m_groups.size());
+	data.instanceCapacity = m_instanceCapacity;
+	data.groupCapacity	  = m_groupCapacity;
+	resources.cullData.WriteToMapped(&data, sizeof(CullData));
+
+	barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+	vkCmdPipelineBarrier2(cmd, &dependency);
+
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &resources.set, 0, nullptr);
+
+	// Phase 0 appends every visible instance to the lists of its group.
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+	if (m_instanceCount > 0) vkCmdDispatch(cmd, (m_instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+	barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+	vkCmdPipelineBarrier2(cmd, &dependency);
+
+	// Phase 1 turns the groups that saw anything into draw commands.
+	const uint32_t compactCount = viewCount * data.groupCount;
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_compactPipeline);
+	if (compactCount > 0) vkCmdDispatch(cmd, (compactCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+	barrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+						   VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+							VK_ACCESS_2_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier2(cmd, &dependency);
+
+	// The camera's visible total is read back once the frame's fence has signaled, see CollectResults.
+	const VkBufferCopy totalRegion{GetVisibleTotalIndex(m_groupCapacity) * sizeof(uint32_t), 0, sizeof(uint32_t)};
+	vkCmdCopyBuffer(cmd, m_drawCountBuffer.GetBuffer(), resources.readback.GetBuffer(), 1, &totalRegion);
+
+	barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask  = VK_PIPELINE_STAGE_2_HOST_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+	vkCmdPipelineBarrier2(cmd, &dependency);
+
+	resources.pending = true;
+}
+
+void VulkanGPUCulling::DrawBucket(VkCommandBuffer cmd, const uint32_t bucket) const {
+	const Bucket &drawBucket = m_buckets[bucket];
+	if (drawBucket.groupCount == 0) return;
+
+	vkCmdDrawIndexedIndirectCount(cmd, m_commandBuffer.GetBuffer(), drawBucket.firstCommand * DRAW_COMMAND_SIZE,
+								  m_drawCountBuffer.GetBuffer(), bucket * sizeof(uint32_t), drawBucket.groupCount,
+								  static_cast<uint32_t>(DRAW_COMMAND_SIZE));
+}
+
+void VulkanGPUCulling::DrawShadowCascade(VkCommandBuffer cmd, const uint32_t cascade) const {
+	if (m_groups.empty()) return;
+
+	const VkDeviceSize commandOffset = static_cast<VkDeviceSize>(1 + cascade) * m_groupCapacity * DRAW_COMMAND_SIZE;
+	const VkDeviceSize countOffset	 = static_cast<VkDeviceSize>(m_groupCapacity + cascade) * sizeof(uint32_t);
+	vkCmdDrawIndexedIndirectCount(cmd, m_commandBuffer.GetBuffer(), commandOffset, m_drawCountBuffer.GetBuffer(),
+								  countOffset, static_cast<uint32_t>(m_groups.size()),
+								  static_cast<uint32_t>(DRAW_COMMAND_SIZE));
+}
+
+ERROR_CODE VulkanGPUCulling::CreateBuffers(const uint32_t framesInFlight) {
+	constexpr VkMemoryPropertyFlags DEVICE_LOCAL = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	constexpr VkMemoryPropertyFlags HOST_VISIBLE =
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	auto create = [this](VulkanBuffer &buffer, const VkDeviceSize size, const VkBufferUsageFlags usage,
+						 const VkMemoryPropertyFlags properties) {
+		ERROR_CODE result;
+		PE_CHECK(result,
+				 buffer.Initialize(ref_vkDevice, ref_allocator, size, usage, VK_SHARING_MODE_EXCLUSIVE, properties));
+		return (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? buffer.Map() : result;
+	};
+
+	const VkDeviceSize instanceCapacity = m_instanceCapacity;
+	const VkDeviceSize groupCapacity	= m_groupCapacity;
+	const VkDeviceSize drawCountSize	= (GetVisibleTotalIndex(m_groupCapacity) + 1) * sizeof(uint32_t);
+
+	ERROR_CODE result;
+	PE_CHECK(result, create(m_objectBuffer, instanceCapacity * sizeof(CBPerObject),
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_instanceBuffer, instanceCapacity * sizeof(GPUCullInstance),
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_groupBuffer, groupCapacity * sizeof(GPUDrawGroup),
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_groupCountBuffer, MAX_VIEWS * groupCapacity * sizeof(uint32_t),
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_visibleBuffer, MAX_VIEWS * instanceCapacity * sizeof(uint32_t),
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_commandBuffer, MAX_VIEWS * groupCapacity * DRAW_COMMAND_SIZE,
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, DEVICE_LOCAL));
+	PE_CHECK(result, create(m_drawCountBuffer, drawCountSize,
+							VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+								VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+							DEVICE_LOCAL));
+
+	m_frames.resize(framesInFlight);
+	for (FrameResources &frame : m_frames) {
+		PE_CHECK(result, create(frame.cullData, sizeof(CullData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, HOST_VISIBLE));
+		PE_CHECK(result, create(frame.staging, INITIAL_STAGING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, HOST_VISIBLE));
+		PE_CHECK(result, create(frame.readback, sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, HOST_VISIBLE));
+	}
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanGPUCulling::CreateDescriptors(const VkDescriptorSetLayout instanceSetLayout) {
+	// Binding 0 is the frame's CullData, the storage buffers follow it.
+	const std::array<VulkanBuffer *, STORAGE_BINDING_COUNT> storageBuffers = {
+		&m_instanceBuffer, &m_groupBuffer, &m_groupCountBuffer, &m_visibleBuffer, &m_commandBuffer, &m_drawCountBuffer};
+
+	std::array<VkDescriptorSetLayoutBinding, 1 + STORAGE_BINDING_COUNT> bindings{};
+	for (uint32_t binding = 0; binding < bindings.size(); ++binding) {
+		bindings[binding] = {binding,
+							 binding == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+							 VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+	}
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	layoutInfo.pBindings	= bindings.data();
+
+	if (vkCreateDescriptorSetLayout(ref_vkDevice, &layoutInfo, nullptr, &m_cullSetLayout) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create GPU culling descriptor set layout!");
+		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+	}
+
+	// A culling set per frame, they only differ in CullData, and the instance set the graphics pipelines draw with.
+	const auto frameCount = static_cast<uint32_t>(m_frames.size());
+
+	const std::array<VkDescriptorPoolSize, 2> poolSizes = {{
+		{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, frameCount},
+		{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, frameCount * STORAGE_BINDING_COUNT + 2},
+	}};
+
+	VkDescriptorPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes	   = poolSizes.data();
+	poolInfo.maxSets	   = frameCount + 1;
+
+	if (vkCreateDescriptorPool(ref_vkDevice, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create GPU culling descriptor pool!");
+		return ERROR_CODE::VULKAN_DEVICE_CREATION_FAILED;
+	}
+
+	VkDescriptorSetAllocateInfo allocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+	allocInfo.descriptorPool	 = m_descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+
+	std::array<VkDescriptorBufferInfo, 1 + STORAGE_BINDING_COUNT> bufferInfos{};
+	std::array<VkWriteDescriptorSet, 1 + STORAGE_BINDING_COUNT>	  writes{};
+	for (FrameResources &frame : m_frames) {
+		allocInfo.pSetLayouts = &m_cullSetLayout;
+		if (vkAllocateDescriptorSets(ref_vkDevice, &allocInfo, &frame.set) != VK_SUCCESS) {
+			PE_LOG_FATAL("Failed to allocate GPU culling Descriptor Set!");
+			return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+		}
+
+		for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+			const VulkanBuffer &buffer = binding == 0 ? frame.cullData : *storageBuffers[binding - 1];
+			bufferInfos[binding]	   = {buffer.GetBuffer(), 0, VK_WHOLE_SIZE};
+
+			writes[binding]					= {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+			writes[binding].dstSet			= frame.set;
+			writes[binding].dstBinding		= binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType	= bindings[binding].descriptorType;
+			writes[binding].pBufferInfo		= &bufferInfos[binding];
+		}
+		vkUpdateDescriptorSets(ref_vkDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// Set 1 of the draws: per-object records by instance slot, and the visible lists in place of the identity indices.
+	allocInfo.pSetLayouts = &instanceSetLayout;
+	if (vkAllocateDescriptorSets(ref_vkDevice, &allocInfo, &m_instanceSet) != VK_SUCCESS) {
+		PE_LOG_FATAL("Failed to allocate GPU culling instance Descriptor Set!");
+		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+	}
+
+	const VulkanBuffer *instanceBuffers[] = {&m_objectBuffer, &m_visibleBuffer};
+	for (uint32_t binding = 0; binding < 2; ++binding) {
+		bufferInfos[binding] = {instanceBuffers[binding]->GetBuffer(), 0, VK_WHOLE_SIZE};
+
+		writes[binding]					= {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+		writes[binding].dstSet			= m_instanceSet;
+		writes[binding].dstBinding		= binding;
+		writes[binding].descriptorCount = 1;
+		writes[binding].descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[binding].pBufferInfo		= &bufferInfos[binding];
+	}
+	vkUpdateDescriptorSets(ref_vkDevice, 2, writes.data(), 0, nullptr);
+
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanGPUCulling::CreatePipelines(const VkPipelineCache cache) {
+	std::vector<char> code;
+	ERROR_CODE		  result;
+	PE_CHECK(result, Utilities::IOUtilities::ReadBinaryFile(
+						 Utilities::IOUtilities::GetDefaultAssetPath("GPUCulling_comp.spv"), code));
+
+	VkPipelineLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+	layoutInfo.setLayoutCount = 1;
+	layoutInfo.pSetLayouts	  = &m_cullSetLayout;
+
+	if (vkCreatePipelineLayout(ref_vkDevice, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create GPU culling pipeline layout!");
+		return ERROR_CODE::VULKAN_SHADER_PIPELINE_FAILED;
+	}
+
+	VkShaderModuleCreateInfo moduleInfo{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+	moduleInfo.codeSize = code.size();
+	moduleInfo.pCode	= reinterpret_cast<const uint32_t *>(code.data());
+
+	VkShaderModule module = VK_NULL_HANDLE;
+	if (vkCreateShaderModule(ref_vkDevice, &moduleInfo, nullptr, &module) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan GPU culling shader module can't create!");
+		return ERROR_CODE::VULKAN_SHADER_PIPELINE_FAILED;
+	}
+
+	// Both phases come from the one module, CULL_PHASE picks the entry point's branch.
+	const VkSpecializationMapEntry phaseEntry{0, 0, sizeof(uint32_t)};
+	const uint32_t				   phases[] = {CULL_PHASE, COMPACT_PHASE};
+
+	std::array<VkSpecializationInfo, 2>		   specializations{};
+	std::array<VkComputePipelineCreateInfo, 2> pipelineInfos{};
+	for (size_t i = 0; i < pipelineInfos.size(); ++i) {
+		specializations[i] = {1, &phaseEntry, sizeof(uint32_t), &phases[i]};
+
+		pipelineInfos[i]						   = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+		pipelineInfos[i].stage					   = {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
+		pipelineInfos[i].stage.stage			   = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfos[i].stage.module			   = module;
+		pipelineInfos[i].stage.pName			   = "main";
+		pipelineInfos[i].stage.pSpecializationInfo = &specializations[i];
+		pipelineInfos[i].layout					   = m_pipelineLayout;
+	}
+
+	std::array<VkPipeline, 2> pipelines{};
+	const VkResult			  vkResult = vkCreateComputePipelines(ref_vkDevice, cache, 2, pipelineInfos.data(), nullptr,
+																 pipelines.data());
+	vkDestroyShaderModule(ref_vkDevice, module, nullptr);
+
+	m_cullPipeline	  = pipelines[0];
+	m_compactPipeline = pipelines[1];
+	if (vkResult != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create GPU culling pipelines!");
+		return ERROR_CODE::VULKAN_SHADER_PIPELINE_FAILED;
+	}
+	return ERROR_CODE::OK;
+}
+
+uint32_t VulkanGPUCulling::FindOrCreateGroup(const MeshID meshID, const MaterialID materialID) {
+	const uint64_t key = (static_cast<uint64_t>(meshID) << 32) | materialID;
+	if (auto it = m_groupLookup.find(key); it != m_groupLookup.end()) return it->second;
+	if (m_groups.size() >= m_groupCapacity) return INVALID_HANDLE;
+
+	// Every material is one bucket, its groups' camera commands are drawn by a single indirect count call.
+	auto [bucketIt, isNewBucket] = m_bucketLookup.try_emplace(materialID, static_cast<uint32_t>(m_buckets.size()));
+	if (isNewBucket) m_buckets.push_back({materialID});
+
+	const auto index = static_cast<uint32_t>(m_groups.size());
+	m_groups.push_back({meshID, materialID, bucketIt->second});
+	m_groupRecords.emplace_back();
+	m_pendingGroups.push_back(index);
+	m_groupLookup.emplace(key, index);
+	m_groupsDirty = true;
+	return index;
+}
+
+void VulkanGPUCulling::ActivateGroup(const uint32_t groupIndex, const MeshRange &range) {
+	GPUDrawGroup &record = m_groupRecords[groupIndex];
+	record.indexCount	 = range.indexCount;
+	record.firstIndex	 = range.firstIndex;
+	record.vertexOffset	 = range.vertexOffset;
+	record.active		 = 1;
+
+	m_groups[groupIndex].active = true;
+	m_groupsDirty				= true;
+}
+
+void VulkanGPUCulling::MarkDirty(const InstanceID id) {
+	if (m_instanceDirty[id]) return;
+	m_instanceDirty[id] = 1;
+	m_dirtyInstances.push_back(id);
+}
+
+void VulkanGPUCulling::UpdateGroupLayout() {
+	// Every group gets room for all of its instances in the visible lists, so the culling pass never overflows one.
+	uint32_t firstInstance = 0;
+	for (Bucket &bucket : m_buckets) bucket.groupCount = 0;
+	for (size_t i = 0; i < m_groups.size(); ++i) {
+		m_groupRecords[i].firstInstance = firstInstance;
+		m_groupRecords[i].bucket		= m_groups[i].bucket;
+		firstInstance += m_groups[i].instanceCount;
+		m_buckets[m_groups[i].bucket].groupCount++;
+	}
+
+	// And every bucket room for a camera command per group of its material.
+	uint32_t firstCommand = 0;
+	for (Bucket &bucket : m_buckets) {
+		bucket.firstCommand = firstCommand;
+		firstCommand += bucket.groupCount;
+	}
+	for (size_t i = 0; i < m_groups.size(); ++i) {
+		m_groupRecords[i].firstCommand = m_buckets[m_groups[i].bucket].firstCommand;
+	}
+}
+
+void VulkanGPUCulling::RecordUploads(VkCommandBuffer cmd, FrameResources &frame) {
+	if (m_groupsDirty) UpdateGroupLayout();
+
+	// Slots that changed together are usually neighbours, a run of them is one copy region per buffer.
+	std::ranges::sort(m_dirtyInstances);
+	m_objectCopies.clear();
+	m_instanceCopies.clear();
+	for (size_t first = 0; first < m_dirtyInstances.size();) {
+		size_t last = first + 1;
+		while (last < m_dirtyInstances.size() && m_dirtyInstances[last] == m_dirtyInstances[last - 1] + 1) last++;
+
+		const VkDeviceSize id	 = m_dirtyInstances[first];
+		const VkDeviceSize count = last - first;
+		m_objectCopies.push_back({0, id * sizeof(CBPerObject), count * sizeof(CBPerObject)});
+		m_instanceCopies.push_back({0, id * sizeof(GPUCullInstance), count * sizeof(GPUCullInstance)});
+		first = last;
+	}
+
+	const VkDeviceSize groupBytes = m_groupsDirty ? m_groupRecords.size() * sizeof(GPUDrawGroup) : 0;
+	const VkDeviceSize uploadSize =
+		groupBytes + m_dirtyInstances.size() * (sizeof(CBPerObject) + sizeof(GPUCullInstance));
+	if (uploadSize == 0) return;
+
+	if (uploadSize > frame.staging.GetSize()) {
+		// The frame's fence has signaled, nothing reads its staging buffer anymore.
+		const VkDeviceSize size = std::max<VkDeviceSize>(uploadSize, 2 * frame.staging.GetSize());
+		frame.staging.Shutdown();
+		if (frame.staging.Initialize(ref_vkDevice, ref_allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+									 VK_SHARING_MODE_EXCLUSIVE,
+									 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) <
+				ERROR_CODE::WARN_START ||
+			frame.staging.Map() < ERROR_CODE::WARN_START) {
+			// The changes stay dirty and are tried again next frame.
+			PE_LOG_ERROR("Vulkan failed to grow the GPU culling staging buffer!");
+			return;
+		}
+	}
+
+	auto		*staging = static_cast<std::byte *>(frame.staging.GetMappedData());
+	VkDeviceSize offset	 = 0;
+	if (groupBytes > 0) {
+		std::memcpy(staging, m_groupRecords.data(), groupBytes);
+		const VkBufferCopy region{0, 0, groupBytes};
+		vkCmdCopyBuffer(cmd, frame.staging.GetBuffer(), m_groupBuffer.GetBuffer(), 1, &region);
+		offset		  = groupBytes;
+		m_groupsDirty = false;
+	}
+
+	if (m_dirtyInstances.empty()) return;
+
+	for (VkBufferCopy &region : m_objectCopies) {
+		std::memcpy(staging + offset, &m_objects[region.dstOffset / sizeof(CBPerObject)], region.size);
+		region.srcOffset = offset;
+		offset += region.size;
+	}
+	for (VkBufferCopy &region : m_instanceCopies) {
+		std::memcpy(staging + offset, &m_instances[region.dstOffset / sizeof(GPUCullInstance)], region.size);
+		region.srcOffset = offset;
+		offset += region.size;
+	}
+	vkCmdCopyBuffer(cmd, frame.staging.GetBuffer(), m_objectBuffer.GetBuffer(),
+					static_cast<uint32_t>(m_objectCopies.size()), m_objectCopies.data());
+	vkCmdCopyBuffer(cmd, frame.staging.GetBuffer(), m_instanceBuffer.GetBuffer(),
+					static_cast<uint32_t>(m_instanceCopies.size()), m_instanceCopies.data());
+
+	for (const InstanceID id : m_dirtyInstances) m_instanceDirty[id] = 0;
+	m_dirtyInstances.clear();
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
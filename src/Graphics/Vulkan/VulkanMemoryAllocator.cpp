@@ -0,0 +1,349 @@
+#include "Graphics/Vulkan/VulkanMemoryAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Utilities/Logger.h"
+#include "Utilities/TLSFAllocator.h"
+
+namespace PE::Graphics::Vulkan {
+struct VulkanMemoryBlock {
+	struct Relocation {
+		VkDeviceSize							alignment;
+		VulkanMemoryAllocator::RelocateFunction relocate;
+	};
+
+	explicit VulkanMemoryBlock(const VkDeviceSize size) : ranges(size) {}
+
+	VkDeviceMemory							 memory		= VK_NULL_HANDLE;
+	void									*mappedData	= nullptr;
+	uint32_t								 poolIndex	= 0;
+	Utilities::TLSFAllocator				 ranges;
+	std::unordered_map<uint32_t, Relocation> relocations;  // by TLSF node
+};
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() = default;
+
+ERROR_CODE VulkanMemoryAllocator::Initialize(VulkanDevice *device) {
+	PE_CHECK_STATE_INIT(m_state, "Vulkan memory allocator is already initialized.");
+	m_state = SystemState::Initializing;
+
+	ref_device	 = device;
+	ref_vkDevice = device->GetVkDevice();
+	vkGetPhysicalDeviceMemoryProperties(ref_device->GetVkPhysicalDevice(), &m_memoryProperties);
+
+	m_pools.resize(m_memoryProperties.memoryTypeCount * 2);
+	for (uint32_t i = 0; i < m_pools.size(); ++i) {
+		const uint32_t	   memoryTypeIndex = i / 2;
+		const uint32_t	   heapIndex	   = m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+		const VkDeviceSize heapSize		   = m_memoryProperties.memoryHeaps[heapIndex].size;
+
+		m_pools[i].memoryTypeIndex = memoryTypeIndex;
+		// Small heaps (BAR memory, integrated GPUs) get smaller blocks so one block can't take most of the heap.
+		m_pools[i].blockSize = std::min(MAX_BLOCK_SIZE, std::bit_floor(heapSize / 8));
+	}
+
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+void VulkanMemoryAllocator::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
+	m_state = SystemState::ShuttingDown;
+
+	const VulkanMemoryStats stats = GetStats();
+	if (stats.allocationCount > 0)
+		PE_LOG_WARN("Vulkan memory allocator shut down with " + std::to_string(stats.allocationCount) +
+					" live allocations.");
+
+	for (Pool &pool : m_pools) {
+		for (const auto &block : pool.blocks) vkFreeMemory(ref_vkDevice, block->memory, nullptr);
+		pool.blocks.clear();
+	}
+	m_pools.clear();
+
+	m_state = SystemState::Uninitialized;
+}
+
+ERROR_CODE VulkanMemoryAllocator::AllocateForBuffer(const VkBuffer buffer, const VkMemoryPropertyFlags properties,
+													VulkanAllocation &outAllocation) {
+	VkBufferMemoryRequirementsInfo2 requirementsInfo{VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2};
+	requirementsInfo.buffer = buffer;
+
+	VkMemoryDedicatedRequirements dedicatedRequirements{VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS};
+	VkMemoryRequirements2		  requirements{VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+	requirements.pNext = &dedicatedRequirements;
+	vkGetBufferMemoryRequirements2(ref_vkDevice, &requirementsInfo, &requirements);
+
+	VkMemoryDedicatedAllocateInfo dedicatedInfo{VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO};
+	dedicatedInfo.buffer = buffer;
+
+	const bool dedicated =
+		dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+
+	ERROR_CODE result = Allocate(requirements.memoryRequirements, properties, false, dedicated, dedicatedInfo,
+								 outAllocation);
+	if (result < ERROR_CODE::WARN_START) return result;
+
+	if (vkBindBufferMemory(ref_vkDevice, buffer, outAllocation.memory, outAllocation.offset) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to bind buffer memory!");
+		Free(outAllocation);
+		return ERROR_CODE::VULKAN_BUFFER_CREATION_FAILED;
+	}
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanMemoryAllocator::AllocateForImage(const VkImage image, const VkImageTiling tiling,
+												   const VkMemoryPropertyFlags properties,
+												   VulkanAllocation &outAllocation) {
+	VkImageMemoryRequirementsInfo2 requirementsInfo{VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2};
+	requirementsInfo.image = image;
+
+	VkMemoryDedicatedRequirements dedicatedRequirements{VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS};
+	VkMemoryRequirements2		  requirements{VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+	requirements.pNext = &dedicatedRequirements;
+	vkGetImageMemoryRequirements2(ref_vkDevice, &requirementsInfo, &requirements);
+
+	VkMemoryDedicatedAllocateInfo dedicatedInfo{VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO};
+	dedicatedInfo.image = image;
+
+	const bool dedicated =
+		dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+
+	ERROR_CODE result = Allocate(requirements.memoryRequirements, properties, tiling == VK_IMAGE_TILING_OPTIMAL,
+								 dedicated, dedicatedInfo, outAllocation);
+	if (result < ERROR_CODE::WARN_START) return result;
+
+	if (vkBindImageMemory(ref_vkDevice, image, outAllocation.memory, outAllocation.offset) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to bind image memory!");
+		Free(outAllocation);
+		return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+	}
+	return ERROR_CODE::OK;
+}
+
+void VulkanMemoryAllocator::Free(VulkanAllocation &allocation) {
+	if (!allocation.IsValid()) return;
+
+	std::lock_guard lock(m_mutex);
+	if (!allocation.block) {
+		vkFreeMemory(ref_vkDevice, allocation.memory, nullptr);
+		m_dedicatedBytes -= allocation.size;
+		m_dedicatedCount--;
+	} else {
+		VulkanMemoryBlock *block = allocation.block;
+		block->relocations.erase(allocation.node);
+		block->ranges.Free(allocation.node);
+
+		// One empty block per pool stays around, so a resource that is recreated every frame doesn't thrash it.
+		if (block->ranges.IsEmpty()) {
+			Pool	  &pool			= m_pools[block->poolIndex];
+			const auto isOtherEmpty = [block](const auto &other) {
+				return other.get() != block && other->ranges.IsEmpty();
+			};
+			if (std::ranges::any_of(pool.blocks, isOtherEmpty)) ReleaseBlock(pool, block);
+		}
+	}
+	allocation = {};
+}
+
+void VulkanMemoryAllocator::SetRelocateFunction(const VulkanAllocation &allocation, RelocateFunction relocate) {
+	// Dedicated allocations are never moved, they don't fragment anything.
+	if (!allocation.IsValid() || !allocation.block) return;
+
+	std::lock_guard lock(m_mutex);
+	allocation.block->relocations[allocation.node] = {allocation.alignment, std::move(relocate)};
+}
+
+uint32_t VulkanMemoryAllocator::Defragment(const uint32_t maxMoves) {
+	std::lock_guard lock(m_mutex);
+
+	uint32_t moves = 0;
+	for (Pool &pool : m_pools) {
+		if (pool.blocks.size() < 2 || moves >= maxMoves) continue;
+
+		// Emptying the least used block is what gives memory back.
+		VulkanMemoryBlock *source = pool.blocks.front().get();
+		for (const auto &block : pool.blocks)
+			if (block->ranges.GetUsedSize() < source->ranges.GetUsedSize()) source = block.get();
+
+		for (auto it = source->relocations.begin(); it != source->relocations.end() && moves < maxMoves;) {
+			const Utilities::TLSFAllocator::Allocation range = source->ranges.Get(it->first);
+
+			VulkanAllocation from;
+			from.memory		= source->memory;
+			from.offset		= range.offset;
+			from.size		= range.size;
+			from.alignment	= it->second.alignment;
+			from.mappedData = source->mappedData ? static_cast<char *>(source->mappedData) + range.offset : nullptr;
+			from.block		= source;
+			from.node		= it->first;
+
+			VulkanAllocation to;
+			bool			 placed = false;
+			for (const auto &block : pool.blocks) {
+				if (block.get() == source) continue;
+				if ((placed = AllocateFromBlock(*block, from.size, from.alignment, to))) break;
+			}
+			if (!placed) break;
+
+			if (!it->second.relocate(from, to)) {
+				to.block->ranges.Free(to.node);
+				++it;
+				continue;
+			}
+
+			to.block->relocations[to.node] = std::move(it->second);
+			source->ranges.Free(from.node);
+			it = source->relocations.erase(it);
+			moves++;
+		}
+
+		if (source->ranges.IsEmpty()) ReleaseBlock(pool, source);
+	}
+
+	if (moves > 0) PE_LOG_INFO("Vulkan memory defragmentation moved " + std::to_string(moves) + " allocations.");
+	return moves;
+}
+
+VulkanMemoryStats VulkanMemoryAllocator::GetStats() const {
+	std::lock_guard lock(m_mutex);
+
+	VulkanMemoryStats stats;
+	stats.reservedBytes	  = m_dedicatedBytes;
+	stats.usedBytes		  = m_dedicatedBytes;
+	stats.dedicatedBytes  = m_dedicatedBytes;
+	stats.dedicatedCount  = m_dedicatedCount;
+	stats.allocationCount = m_dedicatedCount;
+	for (const Pool &pool : m_pools) {
+		for (const auto &block : pool.blocks) {
+			stats.reservedBytes += block->ranges.GetSize();
+			stats.usedBytes += block->ranges.GetUsedSize();
+			stats.freeBytes += block->ranges.GetFreeSize();
+			stats.fragmentedBytes += block->ranges.GetFragmentedSize();
+			stats.allocationCount += block->ranges.GetAllocationCount();
+			stats.blockCount++;
+		}
+	}
+	return stats;
+}
+
+ERROR_CODE VulkanMemoryAllocator::Allocate(const VkMemoryRequirements &requirements,
+										   const VkMemoryPropertyFlags properties, const bool optimalImage,
+										   const bool dedicated, const VkMemoryDedicatedAllocateInfo &dedicatedInfo,
+										   VulkanAllocation &outAllocation) {
+	const uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+	if (memoryTypeIndex == UINT32_MAX) {
+		PE_LOG_FATAL("Vulkan failed to find suitable memory type!");
+		return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+	}
+
+	std::lock_guard lock(m_mutex);
+
+	const uint32_t poolIndex = memoryTypeIndex * 2 + (optimalImage ? 1 : 0);
+	Pool		  &pool		 = m_pools[poolIndex];
+	if (dedicated || requirements.size > pool.blockSize / 2)
+		return AllocateDedicated(requirements.size, memoryTypeIndex, dedicatedInfo, outAllocation);
+
+	for (const auto &block : pool.blocks)
+		if (AllocateFromBlock(*block, requirements.size, requirements.alignment, outAllocation)) return ERROR_CODE::OK;
+
+	VulkanMemoryBlock *block = CreateBlock(pool);
+	if (!block || !AllocateFromBlock(*block, requirements.size, requirements.alignment, outAllocation)) {
+		PE_LOG_FATAL("Vulkan failed to allocate a memory block!");
+		return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+	}
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanMemoryAllocator::AllocateDedicated(const VkDeviceSize size, const uint32_t memoryTypeIndex,
+													const VkMemoryDedicatedAllocateInfo &dedicatedInfo,
+													VulkanAllocation &outAllocation) {
+	VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+	allocInfo.pNext			  = &dedicatedInfo;
+	allocInfo.allocationSize  = size;
+	allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	if (vkAllocateMemory(ref_vkDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to allocate dedicated memory!");
+		return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+	}
+
+	void *mappedData = nullptr;
+	if (IsHostVisible(memoryTypeIndex) &&
+		vkMapMemory(ref_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &mappedData) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to map memory!");
+		vkFreeMemory(ref_vkDevice, memory, nullptr);
+		return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+	}
+
+	outAllocation			 = {};
+	outAllocation.memory	 = memory;
+	outAllocation.size		 = size;
+	outAllocation.mappedData = mappedData;
+	m_dedicatedBytes += size;
+	m_dedicatedCount++;
+	return ERROR_CODE::OK;
+}
+
+VulkanMemoryBlock *VulkanMemoryAllocator::CreateBlock(Pool &pool) {
+	VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+	allocInfo.allocationSize  = pool.blockSize;
+	allocInfo.memoryTypeIndex = pool.memoryTypeIndex;
+
+	auto block = std::make_unique<VulkanMemoryBlock>(pool.blockSize);
+	if (vkAllocateMemory(ref_vkDevice, &allocInfo, nullptr, &block->memory) != VK_SUCCESS) return nullptr;
+
+	// Host visible blocks stay mapped for their whole life, every allocation in them gets a pointer for free.
+	if (IsHostVisible(pool.memoryTypeIndex) &&
+		vkMapMemory(ref_vkDevice, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mappedData) != VK_SUCCESS) {
+		vkFreeMemory(ref_vkDevice, block->memory, nullptr);
+		return nullptr;
+	}
+
+	block->poolIndex = static_cast<uint32_t>(&pool - m_pools.data());
+	pool.blocks.push_back(std::move(block));
+	return pool.blocks.back().get();
+}
+
+void VulkanMemoryAllocator::ReleaseBlock(Pool &pool, const VulkanMemoryBlock *block) {
+	const auto it = std::ranges::find_if(pool.blocks, [block](const auto &other) { return other.get() == block; });
+	if (it == pool.blocks.end()) return;
+
+	vkFreeMemory(ref_vkDevice, (*it)->memory, nullptr);
+	pool.blocks.erase(it);
+}
+
+bool VulkanMemoryAllocator::AllocateFromBlock(VulkanMemoryBlock &block, const VkDeviceSize size,
+											  const VkDeviceSize alignment, VulkanAllocation &outAllocation) const {
+	const Utilities::TLSFAllocator::Allocation range = block.ranges.Allocate(size, alignment);
+	if (!range.IsValid()) return false;
+
+	outAllocation			 = {};
+	outAllocation.memory	 = block.memory;
+	outAllocation.offset	 = range.offset;
+	outAllocation.size		 = range.size;
+	outAllocation.alignment	 = alignment;
+	outAllocation.mappedData = block.mappedData ? static_cast<char *>(block.mappedData) + range.offset : nullptr;
+	outAllocation.block		 = &block;
+	outAllocation.node		 = range.node;
+	return true;
+}
+
+uint32_t VulkanMemoryAllocator::FindMemoryType(const uint32_t typeFilter,
+											   const VkMemoryPropertyFlags properties) const {
+	for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+		if ((typeFilter & (1 << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+			return i;
+		}
+	}
+	return UINT32_MAX;
+}
+
+bool VulkanMemoryAllocator::IsHostVisible(const uint32_t memoryTypeIndex) const {
+	return m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -31,20 +31,22 @@ VulkanPipeline &VulkanPipeline::operator=(VulkanPipeline &&other) noexcept {
 }
 
 ERROR_CODE VulkanPipeline::Initialize(VulkanDevice *device, const VulkanShader &shader, const VkPipelineLayout layout,
-									  const VkExtent2D extent, const PipelineDescription &desc) {
-	auto bindingDesc = Vertex::GetBindingDescription();
-	auto attribDesc	 = Vertex::GetAttributeDescriptions();
+									  const VkExtent2D extent, const PipelineDescription &desc,
+									  const VkPipelineCache cache) {
+	auto bindingDesc = PackedVertex::GetBindingDescription();
+	auto attribDesc	 = PackedVertex::GetAttributeDescriptions();
 
 	const std::vector<VkVertexInputBindingDescription>	 bindings = {bindingDesc};
 	const std::vector<VkVertexInputAttributeDescription> attributes(attribDesc.begin(), attribDesc.end());
 
-	return Initialize(device, shader, layout, extent, desc, bindings, attributes);
+	return Initialize(device, shader, layout, extent, desc, bindings, attributes, cache);
 }
 
 ERROR_CODE VulkanPipeline::Initialize(VulkanDevice *device, const VulkanShader &shader, VkPipelineLayout layout,
 									  VkExtent2D extent, const PipelineDescription &desc,
 									  const std::vector<VkVertexInputBindingDescription>   &bindings,
-									  const std::vector<VkVertexInputAttributeDescription> &attributes) {
+									  const std::vector<VkVertexInputAttributeDescription> &attributes,
+									  const VkPipelineCache									cache) {
 	PE_CHECK_STATE_INIT(m_state, "This vulkan pipeline is already initialized.");
 	m_state = SystemState::Initializing;
 
@@ -181,7 +183,7 @@ ERROR_CODE VulkanPipeline::Initialize(VulkanDevice *device, const VulkanShader &
 	pipelineInfo.subpass			 = 0;
 	pipelineInfo.layout				 = m_layout;
 
-	if (vkCreateGraphicsPipelines(ref_device->GetVkDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+	if (vkCreateGraphicsPipelines(ref_device->GetVkDevice(), cache, 1, &pipelineInfo, nullptr,
 								  &m_vkPipeline) != VK_SUCCESS) {
 		PE_LOG_FATAL("Failed to create custom graphics pipeline!");
 		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
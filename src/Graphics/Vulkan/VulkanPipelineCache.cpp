@@ -0,0 +1,141 @@
+#include "Graphics/Vulkan/VulkanPipelineCache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Utilities/Logger.h"
+
+namespace PE::Graphics::Vulkan {
+ERROR_CODE VulkanPipelineCache::Initialize(VulkanDevice *device, const std::filesystem::path &filePath) {
+	PE_CHECK_STATE_INIT(m_state, "This vulkan pipeline cache is already initialized.");
+	m_state = SystemState::Initializing;
+
+	ref_device = device;
+	m_filePath = filePath;
+
+	const std::vector<char> initialData = LoadData();
+
+	VkPipelineCacheCreateInfo cacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+	cacheInfo.initialDataSize = initialData.size();
+	cacheInfo.pInitialData	  = initialData.data();
+
+	if (vkCreatePipelineCache(ref_device->GetVkDevice(), &cacheInfo, nullptr, &m_cache) != VK_SUCCESS) {
+		// The driver rejected the blob even though the header matched, start over with an empty cache.
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData	  = nullptr;
+		if (vkCreatePipelineCache(ref_device->GetVkDevice(), &cacheInfo, nullptr, &m_cache) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to create pipeline cache!");
+			return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+		}
+	}
+
+	if (!initialData.empty())
+		PE_LOG_INFO("Pipeline cache loaded " + std::to_string(initialData.size()) + " bytes from " +
+					m_filePath.string());
+
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+void VulkanPipelineCache::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
+	m_state = SystemState::ShuttingDown;
+
+	Save();
+	if (m_cache != VK_NULL_HANDLE) vkDestroyPipelineCache(ref_device->GetVkDevice(), m_cache, nullptr);
+	m_cache = VK_NULL_HANDLE;
+
+	m_state = SystemState::Uninitialized;
+}
+
+ERROR_CODE VulkanPipelineCache::Save() const {
+	if (m_cache == VK_NULL_HANDLE) return ERROR_CODE::NOT_INITIALIZED;
+
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(ref_device->GetVkDevice(), m_cache, &dataSize, nullptr) != VK_SUCCESS)
+		return ERROR_CODE::GRAPHICS_API_ERROR;
+
+	std::vector<char> data(dataSize);
+	if (vkGetPipelineCacheData(ref_device->GetVkDevice(), m_cache, &dataSize, data.data()) != VK_SUCCESS)
+		return ERROR_CODE::GRAPHICS_API_ERROR;
+
+	FileHeader header = MakeHeader();
+	header.dataSize	  = dataSize;
+
+	// Written next to the target and renamed over it, a crash mid-write can't leave a truncated cache behind.
+	std::error_code ec;
+	std::filesystem::create_directories(m_filePath.parent_path(), ec);
+	std::filesystem::path tempPath = m_filePath;
+	tempPath += ".tmp";
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			PE_LOG_WARN("Pipeline cache can't be written to " + tempPath.string());
+			return ERROR_CODE::IO_ERROR_OCCURRED;
+		}
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(data.data(), static_cast<std::streamsize>(dataSize));
+		if (!file) {
+			PE_LOG_WARN("Pipeline cache can't be written to " + tempPath.string());
+			return ERROR_CODE::IO_ERROR_OCCURRED;
+		}
+	}
+
+	std::filesystem::rename(tempPath, m_filePath, ec);
+	if (ec) {
+		PE_LOG_WARN("Pipeline cache can't be moved to " + m_filePath.string() + ": " + ec.message());
+		return ERROR_CODE::IO_ERROR_OCCURRED;
+	}
+	return ERROR_CODE::OK;
+}
+
+VulkanPipelineCache::FileHeader VulkanPipelineCache::MakeHeader() const {
+	VkPhysicalDeviceIDProperties idProperties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES};
+	VkPhysicalDeviceProperties2	 properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+	properties.pNext = &idProperties;
+	vkGetPhysicalDeviceProperties2(ref_device->GetVkPhysicalDevice(), &properties);
+
+	FileHeader header{};
+	header.magic		 = FILE_MAGIC;
+	header.version		 = FILE_VERSION;
+	header.vendorID		 = properties.properties.vendorID;
+	header.deviceID		 = properties.properties.deviceID;
+	header.driverVersion = properties.properties.driverVersion;
+	std::memcpy(header.deviceUUID, idProperties.deviceUUID, VK_UUID_SIZE);
+	std::memcpy(header.pipelineCacheUUID, properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+	return header;
+}
+
+bool VulkanPipelineCache::IsSameDevice(const FileHeader &a, const FileHeader &b) {
+	return a.magic == b.magic && a.version == b.version && a.vendorID == b.vendorID && a.deviceID == b.deviceID &&
+		   a.driverVersion == b.driverVersion && std::memcmp(a.deviceUUID, b.deviceUUID, VK_UUID_SIZE) == 0 &&
+		   std::memcmp(a.pipelineCacheUUID, b.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<char> VulkanPipelineCache::LoadData() const {
+	std::ifstream file(m_filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return {};
+
+	const auto fileSize = static_cast<size_t>(file.tellg());
+	file.seekg(0);
+
+	FileHeader stored{};
+	if (fileSize < sizeof(stored) || !file.read(reinterpret_cast<char *>(&stored), sizeof(stored))) return {};
+
+	// Everything but the size has to match this device, the driver would reject or misuse a foreign blob.
+	if (!IsSameDevice(stored, MakeHeader())) {
+		PE_LOG_INFO("Pipeline cache at " + m_filePath.string() + " is from another device or driver, ignoring it.");
+		return {};
+	}
+	if (stored.dataSize != fileSize - sizeof(stored)) {
+		PE_LOG_WARN("Pipeline cache at " + m_filePath.string() + " is truncated, ignoring it.");
+		return {};
+	}
+
+	std::vector<char> data(stored.dataSize);
+	if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) return {};
+	return data;
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "Graphics/Vulkan/VulkanProfiler.h"
+
+#include <array>
+#include <string>
+
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Utilities/Logger.h"
+
+namespace PE::Graphics::Vulkan {
+namespace {
+constexpr uint32_t TIMESTAMP_COUNT = 2 * GPU_PASS_COUNT;  // begin and end of every pass
+
+// Vulkan writes the enabled counters in bit order, which is the order of GPUPassStatistics.
+constexpr VkQueryPipelineStatisticFlags STATISTIC_FLAGS =
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t STATISTIC_COUNT = sizeof(GPUPassStatistics) / sizeof(uint64_t);
+}  // namespace
+
+ERROR_CODE VulkanProfiler::Initialize(VulkanDevice *device, const uint32_t framesInFlight) {
+	PE_CHECK_STATE_INIT(m_state, "This vulkan profiler is already initialized.");
+	m_state = SystemState::Initializing;
+
+	ref_device = device;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(ref_device->GetVkPhysicalDevice(), &properties);
+
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(ref_device->GetVkPhysicalDevice(), &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(ref_device->GetVkPhysicalDevice(), &familyCount, families.data());
+
+	const uint32_t validBits = families[ref_device->GetQueueFamilies().graphicsFamily.value()].timestampValidBits;
+	if (validBits == 0) {
+		// Not fatal, the frame just goes unprofiled.
+		PE_LOG_WARN("Graphics queue doesn't support timestamps, GPU profiling is disabled.");
+		m_state = SystemState::Uninitialized;
+		return ERROR_CODE::OK;
+	}
+
+	m_timestampMask	 = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+	m_msPerTick		 = static_cast<double>(properties.limits.timestampPeriod) / 1'000'000.0;
+	m_statisticFlags = ref_device->SupportsPipelineStatistics() ? STATISTIC_FLAGS : 0;
+	m_profile.SetHasStatistics(m_statisticFlags != 0);
+
+	VkQueryPoolCreateInfo timestampInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	timestampInfo.queryType	 = VK_QUERY_TYPE_TIMESTAMP;
+	timestampInfo.queryCount = TIMESTAMP_COUNT;
+
+	VkQueryPoolCreateInfo statisticsInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	statisticsInfo.queryType		  = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+	statisticsInfo.queryCount		  = GPU_PASS_COUNT;
+	statisticsInfo.pipelineStatistics = m_statisticFlags;
+
+	m_frames.resize(framesInFlight);
+	for (FrameQueries &frame : m_frames) {
+		if (vkCreateQueryPool(ref_device->GetVkDevice(), &timestampInfo, nullptr, &frame.timestamps) != VK_SUCCESS ||
+			(m_statisticFlags != 0 &&
+			 vkCreateQueryPool(ref_device->GetVkDevice(), &statisticsInfo, nullptr, &frame.statistics) != VK_SUCCESS)) {
+			PE_LOG_FATAL("Vulkan failed to create profiler query pools!");
+			return ERROR_CODE::VULKAN_DEVICE_CREATION_FAILED;
+		}
+	}
+
+	PE_LOG_INFO(std::string("GPU profiler initialized, pipeline statistics ") +
+				(m_statisticFlags != 0 ? "enabled." : "not supported."));
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+void VulkanProfiler::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
+	m_state = SystemState::ShuttingDown;
+
+	VkDevice device = ref_device->GetVkDevice();
+	for (const FrameQueries &frame : m_frames) {
+		if (frame.timestamps != VK_NULL_HANDLE) vkDestroyQueryPool(device, frame.timestamps, nullptr);
+		if (frame.statistics != VK_NULL_HANDLE) vkDestroyQueryPool(device, frame.statistics, nullptr);
+	}
+	m_frames.clear();
+
+	m_state = SystemState::Uninitialized;
+}
+
+void VulkanProfiler::CollectResults(const uint32_t frame) {
+	if (m_state != SystemState::Running || !m_frames[frame].pending) return;
+
+	FrameQueries &queries = m_frames[frame];
+	queries.pending		  = false;
+
+	// No wait flag, a frame whose recording failed before submission reports VK_NOT_READY and is dropped.
+	std::array<uint64_t, TIMESTAMP_COUNT> ticks{};
+	if (vkGetQueryPoolResults(ref_device->GetVkDevice(), queries.timestamps, 0, TIMESTAMP_COUNT, sizeof(ticks),
+							  ticks.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+		return;
+
+	GPUFrameTimings timings;
+	timings.frameIndex = queries.frameIndex;
+	for (size_t p = 0; p < GPU_PASS_COUNT; ++p) {
+		const uint64_t elapsed = (ticks[2 * p + 1] - ticks[2 * p]) & m_timestampMask;
+		timings.passMs[p]	   = static_cast<double>(elapsed) * m_msPerTick;
+	}
+	timings.frameMs = static_cast<double>((ticks[TIMESTAMP_COUNT - 1] - ticks[0]) & m_timestampMask) * m_msPerTick;
+
+	if (m_statisticFlags != 0) {
+		std::array<uint64_t, GPU_PASS_COUNT * STATISTIC_COUNT> counters{};
+		if (vkGetQueryPoolResults(ref_device->GetVkDevice(), queries.statistics, 0, GPU_PASS_COUNT, sizeof(counters),
+								  counters.data(), STATISTIC_COUNT * sizeof(uint64_t),
+								  VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+			for (size_t p = 0; p < GPU_PASS_COUNT; ++p) {
+				const uint64_t	  *passCounters = &counters[p * STATISTIC_COUNT];
+				GPUPassStatistics &stats		= timings.statistics[p];
+				stats.inputPrimitives			= passCounters[0];
+				stats.vertexInvocations			= passCounters[1];
+				stats.clippingPrimitives		= passCounters[2];
+				stats.fragmentInvocations		= passCounters[3];
+			}
+		}
+	}
+
+	m_profile.AddFrame(timings);
+}
+
+void VulkanProfiler::BeginFrame(VkCommandBuffer cmd, const uint32_t frame) {
+	if (m_state != SystemState::Running) return;
+
+	m_recordingFrame = frame;
+
+	FrameQueries &queries = m_frames[frame];
+	queries.frameIndex	  = m_frameCounter++;
+	queries.pending		  = true;
+
+	vkCmdResetQueryPool(cmd, queries.timestamps, 0, TIMESTAMP_COUNT);
+	if (queries.statistics != VK_NULL_HANDLE) vkCmdResetQueryPool(cmd, queries.statistics, 0, GPU_PASS_COUNT);
+}
+
+void VulkanProfiler::BeginPass(VkCommandBuffer cmd, const GPUPass pass) const {
+	if (m_state != SystemState::Running) return;
+
+	const FrameQueries &queries = m_frames[m_recordingFrame];
+	const auto			index	= static_cast<uint32_t>(pass);
+	vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, queries.timestamps, 2 * index);
+	if (queries.statistics != VK_NULL_HANDLE) vkCmdBeginQuery(cmd, queries.statistics, index, 0);
+}
+
+void VulkanProfiler::EndPass(VkCommandBuffer cmd, const GPUPass pass) const {
+	if (m_state != SystemState::Running) return;
+
+	const FrameQueries &queries = m_frames[m_recordingFrame];
+	const auto			index	= static_cast<uint32_t>(pass);
+	if (queries.statistics != VK_NULL_HANDLE) vkCmdEndQuery(cmd, queries.statistics, index);
+	vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, queries.timestamps, 2 * index + 1);
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
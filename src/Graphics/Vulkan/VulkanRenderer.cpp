@@ -1,10 +1,14 @@
 #include "Graphics/Vulkan/VulkanRenderer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <numeric>
 
 #include "Assets/AssetManager.h"
 #include "Assets/Texture.h"
 #include "Graphics/Vulkan/VulkanPipeline.h"
+#include "Graphics/Vulkan/VulkanPipelineCache.h"
+#include "Utilities/JobSystem.h"
 #include "Utilities/Logger.h"
 #include "Utilities/MemoryUtilities.h"
 #include "backends/imgui_impl_glfw.h"
@@ -12,6 +16,26 @@
 #include "imgui.h"
 
 namespace PE::Graphics::Vulkan {
+// Secondary buffer of each pass that is recorded in parallel, see VulkanCommand::SECONDARY_BUFFERS_PER_SLOT. Shadow
+// cascade c records into SHADOW_PASS + c.
+constexpr uint32_t SHADOW_PASS					  = 0;
+constexpr uint32_t MAIN_PASS					  = SHADOW_PASS + MAX_SHADOW_CASCADES;
+constexpr uint32_t MAX_RECORDING_SLOTS			  = 32;
+constexpr size_t   MIN_BATCHES_PER_RECORDING_SLOT = 64;
+
+constexpr VkDeviceSize STAGING_RING_SIZE = 64ull * 1024 * 1024;
+
+// Set index of the bindless materials and textures in every layout that samples them. Draws select their material
+// with a push constant.
+constexpr uint32_t			 BINDLESS_SET		  = 2;
+constexpr VkShaderStageFlags MATERIAL_PUSH_STAGES = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+// Particle push constants, the texture slot for the fragment stage and behind it the quantization of the quad.
+constexpr uint32_t PARTICLE_QUAD_PUSH_OFFSET = 16;
+constexpr uint32_t PARTICLE_QUAD_PUSH_SIZE	 = 2 * sizeof(Math::Vector4);
+
+const std::filesystem::path PIPELINE_CACHE_PATH = std::filesystem::current_path() / "Cache" / "pipeline_cache.bin";
+
 ERROR_CODE VulkanRenderer::Initialize(GLFWwindow *windowHandle, const Core::EngineConfig &config) {
 	PE_CHECK_STATE_INIT(m_state, "Vulkan renderer is already initialized.");
 	m_state = SystemState::Initializing;
@@ -24,12 +48,29 @@ ERROR_CODE VulkanRenderer::Initialize(GLFWwindow *windowHandle, const Core::Engi
 	ref_device = new VulkanDevice();
 	PE_ENSURE_INIT_SILENT(result, ref_device->Initialize(windowHandle));
 
+	m_memoryAllocator = new VulkanMemoryAllocator();
+	PE_ENSURE_INIT_SILENT(result, m_memoryAllocator->Initialize(ref_device));
+
+	// Headless runs have no window, the swapchain then hands out one offscreen image per frame in flight.
 	m_swapChain = new VulkanSwapchain();
-	PE_ENSURE_INIT_SILENT(
-		result, m_swapChain->Initialize(windowHandle, ref_device, ref_renderConfig->width, ref_renderConfig->height));
+	PE_ENSURE_INIT_SILENT(result, m_swapChain->Initialize(windowHandle, ref_device, m_memoryAllocator,
+														  ref_renderConfig->width, ref_renderConfig->height,
+														  ref_renderConfig->maxFramesInFlight));
+
+	m_pipelineCache = new VulkanPipelineCache();
+	PE_ENSURE_INIT_SILENT(result, m_pipelineCache->Initialize(ref_device, PIPELINE_CACHE_PATH));
+
+	m_uploadManager = new VulkanUploadManager();
+	PE_ENSURE_INIT_SILENT(result, m_uploadManager->Initialize(ref_device, m_memoryAllocator, STAGING_RING_SIZE));
+
+	m_profiler = new VulkanProfiler();
+	PE_ENSURE_INIT_SILENT(result, m_profiler->Initialize(ref_device, ref_renderConfig->maxFramesInFlight));
 
 	m_command = new VulkanCommand();
-	PE_ENSURE_INIT_SILENT(result, m_command->Initialize(ref_device, ref_renderConfig->maxFramesInFlight));
+	const uint32_t recordingSlots =
+		std::min(Utilities::JobSystem::IsRunning() ? Utilities::JobSystem::GetWorkerCount() : 1u, MAX_RECORDING_SLOTS);
+	PE_ENSURE_INIT_SILENT(result,
+						  m_command->Initialize(ref_device, ref_renderConfig->maxFramesInFlight, recordingSlots));
 
 	PE_CHECK(result, CreateDepthBuffer());
 	PE_ENSURE_INIT_SILENT(result, CreateSyncObjects(ref_renderConfig->maxFramesInFlight));
@@ -47,6 +88,18 @@ ERROR_CODE VulkanRenderer::Initialize(GLFWwindow *windowHandle, const Core::Engi
 	PE_ENSURE_INIT_SILENT(result, CreateParticleResources());
 	PE_CHECK(result, CreateStandardPipelineLayout());
 
+	// Not fatal, without it every submesh is submitted and culled on the CPU.
+	if (ref_renderConfig->gpuDrivenCulling && !ref_device->SupportsGPUCulling()) {
+		PE_LOG_WARN("Device can't draw indirect counts, GPU driven culling is disabled.");
+	} else if (ref_renderConfig->gpuDrivenCulling) {
+		m_gpuCulling = new VulkanGPUCulling();
+		if (m_gpuCulling->Initialize(ref_device, m_memoryAllocator, *ref_renderConfig, m_perObjectSetLayout,
+									 m_pipelineCache->GetHandle()) < ERROR_CODE::WARN_START) {
+			PE_LOG_WARN("GPU driven culling failed to initialize, falling back to CPU culling.");
+			Utilities::SafeShutdown(m_gpuCulling);
+		}
+	}
+
 	PE_LOG_INFO("Vulkan Renderer Initialized.");
 	m_state = SystemState::Running;
 	return result;
@@ -71,30 +124,33 @@ ERROR_CODE VulkanRenderer::Shutdown() {
 	for (auto *buf : m_particleInstanceBuffers) Utilities::SafeShutdown(buf);
 	m_particleInstanceBuffers.clear();
 
-	m_renderQueue.clear();
+	m_renderQueue.Clear();
 	m_materials.Clear();
 
 	for (auto &shader : m_shaders.Data()) shader.Shutdown();
 	m_shaders.Clear();
 	m_meshes.Clear();
 
-	for (const auto &rt : m_renderTargets.Data()) {
+	for (auto &rt : m_renderTargets.Data()) {
 		if (rt.imageView != VK_NULL_HANDLE) vkDestroyImageView(device, rt.imageView, nullptr);
 		if (rt.image != VK_NULL_HANDLE) vkDestroyImage(device, rt.image, nullptr);
-		if (rt.memory != VK_NULL_HANDLE) vkFreeMemory(device, rt.memory, nullptr);
+		m_memoryAllocator->Free(rt.allocation);
 	}
 	m_renderTargets.Clear();
 
-	for (const auto &tex : m_textures.Data()) {
+	for (auto &tex : m_textures.Data()) {
 		if (tex.imageView != VK_NULL_HANDLE) vkDestroyImageView(device, tex.imageView, nullptr);
 		if (tex.image != VK_NULL_HANDLE) vkDestroyImage(device, tex.image, nullptr);
-		if (tex.memory != VK_NULL_HANDLE) vkFreeMemory(device, tex.memory, nullptr);
+		m_memoryAllocator->Free(tex.allocation);
 	}
 	m_textures.Clear();
 
+	for (VkImageView layerView : m_shadowMap.layerViews) {
+		if (layerView) vkDestroyImageView(device, layerView, nullptr);
+	}
 	if (m_shadowMap.texture.imageView) vkDestroyImageView(device, m_shadowMap.texture.imageView, nullptr);
 	if (m_shadowMap.texture.image) vkDestroyImage(device, m_shadowMap.texture.image, nullptr);
-	if (m_shadowMap.texture.memory) vkFreeMemory(device, m_shadowMap.texture.memory, nullptr);
+	m_memoryAllocator->Free(m_shadowMap.texture.allocation);
 
 	for (auto &[desc, pipeline] : m_pipelineDescriptions) {
 		Utilities::SafeShutdown(pipeline);
@@ -109,7 +165,7 @@ ERROR_CODE VulkanRenderer::Shutdown() {
 
 	if (m_depthTexture.imageView != VK_NULL_HANDLE) vkDestroyImageView(device, m_depthTexture.imageView, nullptr);
 	if (m_depthTexture.image != VK_NULL_HANDLE) vkDestroyImage(device, m_depthTexture.image, nullptr);
-	if (m_depthTexture.memory != VK_NULL_HANDLE) vkFreeMemory(device, m_depthTexture.memory, nullptr);
+	m_memoryAllocator->Free(m_depthTexture.allocation);
 
 	for (const auto &sampler : m_globalSamplers) vkDestroySampler(device, sampler, nullptr);
 
@@ -117,11 +173,12 @@ ERROR_CODE VulkanRenderer::Shutdown() {
 	Utilities::SafeShutdown(m_indexBuffer);
 	for (auto &buffer : m_perPassBuffers) Utilities::SafeShutdown(buffer);
 	for (auto &buffer : m_perObjectBuffers) Utilities::SafeShutdown(buffer);
-	for (auto &buffer : m_perMaterialBuffers) Utilities::SafeShutdown(buffer);
+	Utilities::SafeShutdown(m_materialBuffer);
+	Utilities::SafeShutdown(m_instanceIndexBuffer);
 
 	if (m_descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+	if (m_bindlessPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(device, m_bindlessPool, nullptr);
 	for (const auto &layout : m_descriptorSetLayouts) vkDestroyDescriptorSetLayout(device, layout, nullptr);
-	if (m_particleSetLayout) vkDestroyDescriptorSetLayout(ref_device->GetVkDevice(), m_particleSetLayout, nullptr);
 
 	for (int i = 0; i < ref_renderConfig->maxFramesInFlight; ++i) {
 		vkDestroySemaphore(device, m_imageAvailableSemaphores[i], nullptr);
@@ -129,8 +186,14 @@ ERROR_CODE VulkanRenderer::Shutdown() {
 	}
 	for (const auto &sem : m_renderFinishedSemaphores) vkDestroySemaphore(device, sem, nullptr);
 
-	Utilities::SafeShutdown(m_command);
+	Utilities::SafeShutdown(m_captureBuffer);
+	Utilities::SafeShutdown(m_uploadManager);
+	Utilities::SafeShutdown(m_profiler);
+	Utilities::SafeShutdown(m_gpuCulling);
+	Utilities::SafeShutdown(m_pipelineCache);
 	Utilities::SafeShutdown(m_swapChain);
+	Utilities::SafeShutdown(m_memoryAllocator);
+	Utilities::SafeShutdown(m_command);
 	Utilities::SafeShutdown(ref_device);
 
 	m_state = SystemState::Uninitialized;
@@ -222,6 +285,8 @@ void VulkanRenderer::NewFrameGUI() {
 }
 
 void VulkanRenderer::ShutdownGUI() {
+	if (m_imguiPool == VK_NULL_HANDLE) return;
+
 	vkDeviceWaitIdle(ref_device->GetVkDevice());
 
 	ImGui_ImplVulkan_Shutdown();
@@ -234,7 +299,7 @@ void VulkanRenderer::ShutdownGUI() {
 	}
 }
 
-void VulkanRenderer::Submit(const RenderCommand &cmd) { m_renderQueue.push_back(cmd); }
+void VulkanRenderer::Submit(const RenderCommand &cmd) { m_renderQueue.Submit(cmd); }
 
 void VulkanRenderer::SubmitParticles(TextureID texture, const std::vector<Graphics::Components::Particle> &particles) {
 	if (particles.empty()) return;
@@ -251,7 +316,12 @@ void VulkanRenderer::SubmitParticles(TextureID texture, const std::vector<Graphi
 }
 
 void VulkanRenderer::Flush() {
+	// Whatever was uploaded since the last frame starts copying while this one waits for its fence.
+	m_uploadManager->Submit();
+
 	vkWaitForFences(ref_device->GetVkDevice(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
+	m_profiler->CollectResults(m_currentFrame);
+	if (m_gpuCulling) m_gpuCulling->CollectResults(m_currentFrame);
 
 	uint32_t imageIndex;
 	VkResult vkResult = m_swapChain->AcquireNextImage(m_imageAvailableSemaphores[m_currentFrame], imageIndex);
@@ -266,49 +336,88 @@ void VulkanRenderer::Flush() {
 
 	vkResetFences(ref_device->GetVkDevice(), 1, &m_inFlightFences[m_currentFrame]);
 
-	std::sort(m_renderQueue.begin(), m_renderQueue.end(), [](const auto &a, const auto &b) { return a.key < b.key; });
+	m_completedUploadValue = m_uploadManager->GetCompletedValue();
+	m_renderQueue.Sort();
+
+	// Groups join the culling pass once their mesh and material are as drawable as a submitted draw would be.
+	if (m_gpuCulling) {
+		m_gpuCulling->ActivateGroups(
+			[this](const MeshID meshID, const MaterialID materialID, VulkanGPUCulling::MeshRange &range) {
+				if (!IsMeshReady(meshID) || !IsMaterialReady(materialID)) return false;
+
+				const VulkanMeshWrapper &mesh = m_meshes.Get(meshID);
+				range.indexCount			  = mesh.indexCount;
+				range.firstIndex			  = mesh.firstIndex;
+				range.vertexOffset			  = static_cast<int32_t>(mesh.firstVertex);
+				return true;
+			});
+	}
 
+	UpdateShadowCascades();
 	UpdateUniformBuffer(m_currentFrame);
 
 	VkCommandBuffer cmd = m_command->GetCommandBuffer(m_currentFrame);
 	vkResetCommandBuffer(cmd, 0);
 
-	ERROR_CODE result = RecordCommandBuffer(imageIndex, cmd);
+	const bool captureFrame = !m_capturePath.empty();
+	ERROR_CODE result		= RecordCommandBuffer(imageIndex, cmd);
 	if (result < ERROR_CODE::WARN_START) {
 		return;
 	}
 
-	VkSemaphore			 waitSem[]	  = {m_imageAvailableSemaphores[m_currentFrame]};
-	VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-	VkSemaphore			 signalSem[]  = {m_renderFinishedSemaphores[imageIndex]};
-	VkSubmitInfo		 submitInfo{
-				.sType				  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-				.waitSemaphoreCount	  = 1,
-				.pWaitSemaphores	  = waitSem,
-				.pWaitDstStageMask	  = waitStages,
-				.commandBufferCount	  = 1,
-				.pCommandBuffers	  = &cmd,
-				.signalSemaphoreCount = 1,
-				.pSignalSemaphores	  = signalSem,
-	};
-	if (vkQueueSubmit(ref_device->GetGraphicsQueue(), 1, &submitInfo, m_inFlightFences[m_currentFrame]) != VK_SUCCESS) {
+	// Every upload drawn this frame has finished already. Waiting for it on the timeline anyway is what orders the
+	// acquire barriers in cmd after the release barriers of the transfer queue.
+	VkSemaphoreSubmitInfo waitInfos[2]{{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO},
+									   {VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO}};
+	waitInfos[0].semaphore = m_uploadManager->GetTimelineSemaphore();
+	waitInfos[0].value	   = m_completedUploadValue;
+	waitInfos[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	waitInfos[1].semaphore = m_imageAvailableSemaphores[m_currentFrame];
+	waitInfos[1].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+	VkSemaphoreSubmitInfo signalInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
+	signalInfo.semaphore = m_renderFinishedSemaphores[imageIndex];
+	signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+	// Offscreen images are neither acquired nor presented, so the binary semaphores stay out of the submit.
+	const bool offscreen = m_swapChain->IsOffscreen();
+
+	VkCommandBufferSubmitInfo cmdInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
+	cmdInfo.commandBuffer = cmd;
+
+	VkSubmitInfo2 submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
+	submitInfo.waitSemaphoreInfoCount	= offscreen ? 1 : 2;
+	submitInfo.pWaitSemaphoreInfos		= waitInfos;
+	submitInfo.commandBufferInfoCount	= 1;
+	submitInfo.pCommandBufferInfos		= &cmdInfo;
+	submitInfo.signalSemaphoreInfoCount = offscreen ? 0 : 1;
+	submitInfo.pSignalSemaphoreInfos	= &signalInfo;
+	if (vkQueueSubmit2(ref_device->GetGraphicsQueue(), 1, &submitInfo, m_inFlightFences[m_currentFrame]) !=
+		VK_SUCCESS) {
 		PE_LOG_FATAL("Vulkan failed submitting queue!");
 		return;
 	}
 
+	if (captureFrame) WriteCapture(m_inFlightFences[m_currentFrame]);
+
 	vkResult = m_swapChain->Present(m_renderFinishedSemaphores[imageIndex], imageIndex);
 	if (vkResult == VK_ERROR_OUT_OF_DATE_KHR || vkResult == VK_SUBOPTIMAL_KHR) {
 		RecreateSwapchain(ref_renderConfig->width, ref_renderConfig->height);
 	} else if (vkResult != VK_SUCCESS) {
 		PE_LOG_FATAL("Vulkan failed to present swapchain image!");
 	}
-	m_renderQueue.clear();
+	m_renderQueue.Clear();
 	m_currentFrame = (m_currentFrame + 1) % ref_renderConfig->maxFramesInFlight;
 }
 
 void VulkanRenderer::FlushParticles(VkCommandBuffer cmd) {
 	if (m_particleBatches.empty()) return;
 
+	if (!IsMeshReady(Assets::AssetManager::DefaultQuadID)) {
+		m_particleBatches.clear();
+		return;
+	}
+
 	VulkanBuffer *instanceBuf  = m_particleInstanceBuffers[m_currentFrame];
 	char		 *mappedData   = static_cast<char *>(instanceBuf->GetMappedData());
 	size_t		  globalOffset = 0;
@@ -317,6 +426,14 @@ void VulkanRenderer::FlushParticles(VkCommandBuffer cmd) {
 
 	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_particlePipelineLayout, 0, 1,
 							&m_perPassDescriptorSets[m_currentFrame], 0, nullptr);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_particlePipelineLayout, BINDLESS_SET, 1,
+							&m_bindlessSet, 0, nullptr);
+
+	const VertexQuantization &quantization = m_meshes.Get(Assets::AssetManager::DefaultQuadID).quantization;
+	const Math::Vector4		  quadPush[]   = {Math::Vector4(quantization.scale, 0.0f),
+											  Math::Vector4(quantization.offset, 0.0f)};
+	vkCmdPushConstants(cmd, m_particlePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, PARTICLE_QUAD_PUSH_OFFSET,
+					   PARTICLE_QUAD_PUSH_SIZE, quadPush);
 
 	for (const auto &batch : m_particleBatches) {
 		size_t batchSizeBytes = batch.instances.size() * sizeof(GPUInstanceData);
@@ -325,56 +442,22 @@ void VulkanRenderer::FlushParticles(VkCommandBuffer cmd) {
 			PE_LOG_WARN("Particle buffer overflow! Dropping particles.");
 			break;
 		}
+		if (m_textures.Has(batch.textureID) && !IsTextureReady(batch.textureID)) continue;
 
-		memcpy(mappedData + globalOffset, batch.instances.data(), batchSizeBytes);
-
-		VkDescriptorSet texSet = VK_NULL_HANDLE;
-
-		auto it = m_particleTextureSets.find(batch.textureID);
-		if (it != m_particleTextureSets.end()) {
-			texSet = it->second;
-		} else {
-			if (!m_textures.Has(batch.textureID)) {
-				PE_LOG_ERROR("Particle texture not found: " + std::to_string(batch.textureID));
-				continue;
-			}
-
-			VkDescriptorSetAllocateInfo allocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-			allocInfo.descriptorPool	 = m_descriptorPool;
-			allocInfo.descriptorSetCount = 1;
-			allocInfo.pSetLayouts		 = &m_particleSetLayout;
-
-			if (vkAllocateDescriptorSets(ref_device->GetVkDevice(), &allocInfo, &texSet) != VK_SUCCESS) {
-				PE_LOG_ERROR("Failed to allocate particle descriptor set! Pool might be full.");
-				continue;
-			}
-
-			VulkanTextureWrapper &tex = m_textures.Get(batch.textureID);
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			imageInfo.imageView	  = tex.imageView;
-			imageInfo.sampler	  = m_globalSamplers[static_cast<int>(SamplerType::LinearRepeat)];
-
-			VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-			write.dstSet		  = texSet;
-			write.dstBinding	  = 0;
-			write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			write.descriptorCount = 1;
-			write.pImageInfo	  = &imageInfo;
-
-			vkUpdateDescriptorSets(ref_device->GetVkDevice(), 1, &write, 0, nullptr);
-
-			m_particleTextureSets[batch.textureID] = texSet;
+		if (!m_textures.Has(batch.textureID)) {
+			PE_LOG_ERROR("Particle texture not found: " + std::to_string(batch.textureID));
+			continue;
 		}
 
-		if (texSet != VK_NULL_HANDLE) {
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_particlePipelineLayout, 1, 1, &texSet, 0,
-									nullptr);
-		}
+		memcpy(mappedData + globalOffset, batch.instances.data(), batchSizeBytes);
+
+		const uint32_t textureSlot = GetBindlessSlot(batch.textureID, SamplerType::LinearRepeat);
+		vkCmdPushConstants(cmd, m_particlePipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t),
+						   &textureSlot);
 
 		const VulkanMeshWrapper &quad		= m_meshes.Get(Assets::AssetManager::DefaultQuadID);
 		VkBuffer				 vBuffers[] = {quad.vertexBuffer, instanceBuf->GetBuffer()};
-		VkDeviceSize			 vOffsets[] = {quad.firstVertex * sizeof(Vertex), globalOffset};
+		VkDeviceSize			 vOffsets[] = {quad.firstVertex * sizeof(PackedVertex), globalOffset};
 
 		vkCmdBindVertexBuffers(cmd, 0, 2, vBuffers, vOffsets);
 		vkCmdBindIndexBuffer(cmd, quad.indexBuffer, quad.firstIndex * sizeof(uint32_t), VK_INDEX_TYPE_UINT32);
@@ -393,12 +476,28 @@ void VulkanRenderer::FlushParticles(VkCommandBuffer cmd) {
 
 ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuffer cmd) {
 	m_stats = {};
+	ERROR_CODE result = BuildDrawBatches();
+	if (result < ERROR_CODE::WARN_START) return result;
+
+	// The frame's fence has signaled, nothing recorded into its secondary buffers is in flight anymore.
+	m_command->ResetSecondaryCommandBuffers(m_currentFrame);
+
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
 	if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) return ERROR_CODE::VULKAN_BUFFER_CREATION_FAILED;
 
-	m_currentPipeline = nullptr;
+	m_uploadManager->RecordAcquireBarriers(cmd, m_completedUploadValue);
+	m_profiler->BeginFrame(cmd, m_currentFrame);
+
+	// Bracketed even when there is nothing to cull, every pass of the profile needs its timestamps written.
+	m_profiler->BeginPass(cmd, GPUPass::Culling);
+	if (m_gpuCulling) {
+		m_gpuCulling->RecordCulling(cmd, m_currentFrame, std::span(m_cullViews.data(), m_cullViewCount));
+	}
+	m_profiler->EndPass(cmd, GPUPass::Culling);
+
+	m_profiler->BeginPass(cmd, GPUPass::Shadow);
 
 	VkImageMemoryBarrier2 shadowBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
 	shadowBarrier.srcStageMask	   = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
@@ -408,7 +507,7 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	shadowBarrier.oldLayout		   = VK_IMAGE_LAYOUT_UNDEFINED;
 	shadowBarrier.newLayout		   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 	shadowBarrier.image			   = m_shadowMap.texture.image;
-	shadowBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+	shadowBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, m_shadowMap.cascadeCount};
 
 	VkDependencyInfo shadowDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
 	shadowDep.imageMemoryBarrierCount = 1;
@@ -416,7 +515,6 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	vkCmdPipelineBarrier2(cmd, &shadowDep);
 
 	VkRenderingAttachmentInfo shadowAtt{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
-	shadowAtt.imageView				  = m_shadowMap.texture.imageView;
 	shadowAtt.imageLayout			  = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 	shadowAtt.loadOp				  = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	shadowAtt.storeOp				  = VK_ATTACHMENT_STORE_OP_STORE;
@@ -427,50 +525,25 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	shadowRenderInfo.layerCount		  = 1;
 	shadowRenderInfo.pDepthAttachment = &shadowAtt;
 
-	vkCmdBeginRendering(cmd, &shadowRenderInfo);
-
-	if (!m_renderQueue.empty()) {
-		m_shadowPipeline->Bind(cmd);
-
-		VkViewport shadowVP = {0, 0, (float)m_shadowMap.dim, (float)m_shadowMap.dim, 0.0f, 1.0f};
-		vkCmdSetViewport(cmd, 0, 1, &shadowVP);
-		VkRect2D shadowScissor = {{0, 0}, {m_shadowMap.dim, m_shadowMap.dim}};
-		vkCmdSetScissor(cmd, 0, 1, &shadowScissor);
-
-		float depthBiasConstant = 1.75f;
-		float depthBiasSlope	= 1.25f;
-
-		vkCmdSetDepthBias(cmd, depthBiasConstant, 0.0f, depthBiasSlope);
-
-		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadowPipelineLayout, 0, 1,
-								&m_perPassDescriptorSets[m_currentFrame], 0, nullptr);
-
-		VkBuffer	 vBuffers[] = {m_vertexBuffer->GetBuffer()};
-		VkDeviceSize offsets[]	= {0};
-		vkCmdBindVertexBuffers(cmd, 0, 1, vBuffers, offsets);
-		vkCmdBindIndexBuffer(cmd, m_indexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-
-		for (size_t i = 0; i < m_renderQueue.size(); i++) {
-			const auto &item = m_renderQueue[i];
-
-			if (!(item.flags & RenderFlag_Visible)) continue;
-			if (!(item.flags & RenderFlag_CastShadows)) continue;
-			if (item.flags & RenderFlag_ForceTransparent) continue;
-
-			uint32_t dynamicOffset = static_cast<uint32_t>(i * m_dynamicAlignment);
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadowPipelineLayout, 1, 1,
-									&m_perObjectDescriptorSets[m_currentFrame], 1, &dynamicOffset);
-
-			VulkanMeshWrapper &mesh = m_meshes.Get(item.meshID);
-			vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.firstIndex, mesh.firstVertex, 0);
-
-			m_stats.drawCalls++;
-			m_stats.indexCount += mesh.indexCount;
-			m_stats.vertexCount += mesh.vertexCount;
-			m_stats.triangleCount += (mesh.indexCount / 3);
+	VkCommandBufferInheritanceRenderingInfo shadowInheritance{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO};
+	shadowInheritance.depthAttachmentFormat = m_shadowMap.texture.format;
+	shadowInheritance.rasterizationSamples	= VK_SAMPLE_COUNT_1_BIT;
+
+	// The GPU driven path records inline, its indirect draws are a handful per pass however many instances there are.
+	shadowRenderInfo.flags = m_gpuCulling ? 0 : VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+	for (uint32_t cascade = 0; cascade < m_shadowMap.cascadeCount; ++cascade) {
+		shadowAtt.imageView = m_shadowMap.layerViews[cascade];
+		vkCmdBeginRendering(cmd, &shadowRenderInfo);
+		if (m_gpuCulling) {
+			result = RecordGPUDrivenPass(cmd, SHADOW_PASS + cascade, m_shadowBatches[cascade]);
+		} else {
+			result = RecordPassInParallel(cmd, SHADOW_PASS + cascade, m_shadowBatches[cascade], shadowInheritance);
 		}
+		vkCmdEndRendering(cmd);
+		if (result < ERROR_CODE::WARN_START) return result;
 	}
-	vkCmdEndRendering(cmd);
+	m_profiler->EndPass(cmd, GPUPass::Shadow);
 
 	shadowBarrier.srcStageMask	= VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
 	shadowBarrier.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
@@ -525,115 +598,57 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	renderingInfo.pColorAttachments	   = &colorAttachment;
 	renderingInfo.pDepthAttachment	   = &depthAttachment;
 
-	vkCmdBeginRendering(cmd, &renderingInfo);
-
-	if (!m_renderQueue.empty()) {
-		VkDeviceSize offsets[]	= {0};
-		VkBuffer	 vBuffers[] = {m_vertexBuffer->GetBuffer()};
-		vkCmdBindVertexBuffers(cmd, 0, 1, vBuffers, offsets);
-		vkCmdBindIndexBuffer(cmd, m_indexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-
-		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1,
-								&m_perPassDescriptorSets[m_currentFrame], 0, nullptr);
-
-		VkExtent2D vkExtent2D = m_swapChain->GetExtent();
-		VkViewport viewport	  = {
-			  .x	  = 0.0f,
-			  .y	  = static_cast<float>(vkExtent2D.height),
-			  .width  = static_cast<float>(vkExtent2D.width),
-			  .height = -static_cast<float>(vkExtent2D.height),
-
-			  .minDepth = 0.0f,
-			  .maxDepth = 1.0f,
-		  };
-		vkCmdSetViewport(cmd, 0, 1, &viewport);
-		VkRect2D scissor = {.offset = {.x = 0, .y = 0}, .extent = vkExtent2D};
-		vkCmdSetScissor(cmd, 0, 1, &scissor);
-
-		MaterialID lastMaterialID = INVALID_HANDLE;
-
-		for (size_t i = 0; i < m_renderQueue.size(); i++) {
-			const auto &item = m_renderQueue[i];
-			if (!(item.flags & RenderFlag_Visible)) continue;
-
-			Material const &mat = m_materials.Get(item.materialID);
-
-			const ShaderType shaderType = m_shaders.Get(mat.GetShaderID()).GetType();
-
-			int passCount = (shaderType == ShaderType::SnowGlobe) ? 2 : 1;
-
-			for (int pass = 0; pass < passCount; ++pass) {
-				PipelineDescription desc;
-				desc.shaderID		 = mat.GetShaderID();
-				desc.colorFormat	 = m_swapChain->GetImageFormat();
-				desc.depthFormat	 = m_depthTexture.format;
-				desc.wireframe		 = false;
-				desc.enableDepthBias = false;
-				if (shaderType == ShaderType::SnowGlobe) {
-					if (pass == 0) {
-						desc.cullMode = VK_CULL_MODE_FRONT_BIT;
-
-						desc.enableDepthTest  = true;
-						desc.enableDepthWrite = false;
-						desc.enableBlend	  = false;
-						desc.compareOp		  = VK_COMPARE_OP_LESS;
-					} else {
-						desc.cullMode = VK_CULL_MODE_BACK_BIT;
-
-						desc.enableDepthTest  = true;
-						desc.enableDepthWrite = false;
-						desc.enableBlend	  = true;
-						desc.compareOp		  = VK_COMPARE_OP_LESS;
-					}
-				} else {
-					desc.cullMode		  = VK_CULL_MODE_BACK_BIT;
-					desc.enableDepthTest  = true;
-					desc.enableDepthWrite = true;
-					desc.enableBlend	  = false;
-					desc.compareOp		  = VK_COMPARE_OP_LESS;
-				}
-				VulkanPipeline *pipeline = nullptr;
-				if (auto it = m_pipelineDescriptions.find(desc); it != m_pipelineDescriptions.end()) {
-					pipeline = it->second;
-				} else {
-					pipeline = new VulkanPipeline();
-					if (pipeline->Initialize(ref_device, m_shaders.Get(desc.shaderID), m_pipelineLayout,
-											 m_swapChain->GetExtent(), desc) < ERROR_CODE::WARN_START) {
-						PE_LOG_FATAL("Vulkan failed to create pipeline.");
-						return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
-					}
-					m_pipelineDescriptions[desc] = pipeline;
-				}
-
-				if (m_currentPipeline != pipeline) {
-					m_currentPipeline = pipeline;
-					m_currentPipeline->Bind(cmd);
-				}
-
-				if (item.materialID != lastMaterialID) {
-					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 2, 1,
-											&m_materialDescriptorSets[item.materialID], 0, nullptr);
-					lastMaterialID = item.materialID;
-				}
-
-				uint32_t dynamicOffset = static_cast<uint32_t>(i * m_dynamicAlignment);
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 1, 1,
-										&m_perObjectDescriptorSets[m_currentFrame], 1, &dynamicOffset);
-
-				VulkanMeshWrapper &mesh = m_meshes.Get(item.meshID);
-				vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.firstIndex, mesh.firstVertex, 0);
+	const VkFormat							colorFormat = m_swapChain->GetImageFormat();
+	VkCommandBufferInheritanceRenderingInfo mainInheritance{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO};
+	mainInheritance.colorAttachmentCount	= 1;
+	mainInheritance.pColorAttachmentFormats = &colorFormat;
+	mainInheritance.depthAttachmentFormat	= m_depthTexture.format;
+	mainInheritance.rasterizationSamples	= VK_SAMPLE_COUNT_1_BIT;
 
-				m_stats.drawCalls++;
-				m_stats.indexCount += mesh.indexCount;
-				m_stats.vertexCount += mesh.vertexCount;
-				m_stats.triangleCount += (mesh.indexCount / 3);
-			}
-		}
+	renderingInfo.flags = m_gpuCulling ? 0 : VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+	m_profiler->BeginPass(cmd, GPUPass::Forward);
+	vkCmdBeginRendering(cmd, &renderingInfo);
+	if (m_gpuCulling) {
+		result = RecordGPUDrivenPass(cmd, MAIN_PASS, m_mainBatches);
+	} else {
+		result = RecordPassInParallel(cmd, MAIN_PASS, m_mainBatches, mainInheritance);
 	}
+	vkCmdEndRendering(cmd);
+	if (result < ERROR_CODE::WARN_START) return result;
+	m_profiler->EndPass(cmd, GPUPass::Forward);
+
+	// A rendering scope that executes secondaries can't record draws inline, so particles and ImGui get their own
+	// scope that keeps what the main pass wrote.
+	VkMemoryBarrier2 overlayBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+	overlayBarrier.srcStageMask =
+		VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+	overlayBarrier.srcAccessMask =
+		VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	overlayBarrier.dstStageMask =
+		VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+	overlayBarrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+								   VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+								   VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+	VkDependencyInfo overlayDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+	overlayDep.memoryBarrierCount = 1;
+	overlayDep.pMemoryBarriers	  = &overlayBarrier;
+	vkCmdPipelineBarrier2(cmd, &overlayDep);
+
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	renderingInfo.flags	   = 0;
+	vkCmdBeginRendering(cmd, &renderingInfo);
 
+	SetPassViewport(cmd, MAIN_PASS);
+	m_profiler->BeginPass(cmd, GPUPass::Particles);
 	FlushParticles(cmd);
+	m_profiler->EndPass(cmd, GPUPass::Particles);
 
-	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+	m_profiler->BeginPass(cmd, GPUPass::GUI);
+	if (m_imguiPool != VK_NULL_HANDLE) ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+	m_profiler->EndPass(cmd, GPUPass::GUI);
 
 	vkCmdEndRendering(cmd);
 
@@ -643,7 +658,7 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	presentBarrier.dstStageMask		= VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT;
 	presentBarrier.dstAccessMask	= 0;
 	presentBarrier.oldLayout		= VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-	presentBarrier.newLayout		= VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	presentBarrier.newLayout		= m_swapChain->GetFinalLayout();
 	presentBarrier.image			= m_swapChain->GetImages()[imageIndex];
 	presentBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
@@ -651,34 +666,457 @@ ERROR_CODE VulkanRenderer::RecordCommandBuffer(uint32_t imageIndex, VkCommandBuf
 	presentDepInfo.imageMemoryBarrierCount = 1;
 	presentDepInfo.pImageMemoryBarriers	   = &presentBarrier;
 
+	if (!m_capturePath.empty()) {
+		presentBarrier.dstStageMask	 = VK_PIPELINE_STAGE_2_COPY_BIT;
+		presentBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+	}
 	vkCmdPipelineBarrier2(cmd, &presentDepInfo);
 
+	if (!m_capturePath.empty()) RecordCapture(cmd, imageIndex);
+
 	if (vkEndCommandBuffer(cmd) != VK_SUCCESS) return ERROR_CODE::VULKAN_BUFFER_CREATION_FAILED;
 	return ERROR_CODE::OK;
 }
 
-void VulkanRenderer::UpdateGlobalBuffer(const CBPerPass &data) {
-	CBPerPass shadowData = data;
+ERROR_CODE VulkanRenderer::BuildDrawBatches() {
+	for (auto &batches : m_shadowBatches) batches.clear();
+	m_mainBatches.clear();
+
+	const std::vector<RenderCommand>			 &commands	= m_renderQueue.GetCommands();
+	const std::span<const RenderQueue::SortEntry> sorted	= m_renderQueue.GetSorted();
+	const size_t								  slotCount = GetInstanceSlotCount();
+
+	auto addStats = [this](const MeshID meshID, const uint32_t instanceCount) {
+		const VulkanMeshWrapper &mesh = m_meshes.Get(meshID);
+		m_stats.drawCalls++;
+		m_stats.indexCount += mesh.indexCount * instanceCount;
+		m_stats.vertexCount += mesh.vertexCount * instanceCount;
+		m_stats.triangleCount += (mesh.indexCount / 3) * instanceCount;
+	};
+
+	// Transparent commands don't cast shadows, so the opaque part of the draw order is all these passes need. The
+	// shadow pipeline only reads positions, so any run of one mesh that reaches the cascade is a single instanced draw.
+	auto castsShadow = [&](const size_t slot, const uint32_t cascade) {
+		const RenderCommand &item = commands[sorted[slot].index];
+		return (item.flags & RenderFlag_Visible) && (item.flags & RenderFlag_CastShadows) &&
+			   (m_casterCascades[slot] & (1u << cascade));
+	};
+
+	for (uint32_t cascade = 0; cascade < m_shadowMap.cascadeCount; ++cascade) {
+		for (size_t first = 0; first < m_casterCascades.size();) {
+			const auto &item = commands[sorted[first].index];
+			if (!castsShadow(first, cascade) || !IsMeshReady(item.meshID)) {
+				first++;
+				continue;
+			}
+
+			size_t last = first + 1;
+			while (last < m_casterCascades.size()) {
+				if (commands[sorted[last].index].meshID != item.meshID || !castsShadow(last, cascade)) break;
+				last++;
+			}
+
+			const auto instanceCount = static_cast<uint32_t>(last - first);
+			m_shadowBatches[cascade].push_back(
+				{m_shadowPipeline, INVALID_HANDLE, item.meshID, static_cast<uint32_t>(first), instanceCount});
+			addStats(item.meshID, instanceCount);
+			m_stats.shadowDrawCalls++;
+
+			first = last;
+		}
+	}
+
+	auto isDrawn = [](const RenderCommand &item) {
+		return (item.flags & RenderFlag_Visible) && !(item.flags & RenderFlag_Culled);
+	};
+
+	for (size_t first = 0; first < slotCount;) {
+		const auto &item = commands[sorted[first].index];
+		// Runs share mesh and material, so checking the first draw of one covers all of it.
+		if (!isDrawn(item) || !IsMeshReady(item.meshID) || !IsMaterialReady(item.materialID)) {
+			first++;
+			continue;
+		}
+
+		Material const &mat = m_materials.Get(item.materialID);
+
+		std::array<PipelineDescription, MAX_SHADER_PASSES> descs;
+		const uint32_t passCount = GetMainPassDescriptions(mat.GetShaderID(), descs);
+
+		// The material decides the pipeline, so a run of one material and mesh is a single instanced draw.
+		// Multi-pass shaders blend, drawing them object by object keeps every pass in back-to-front order.
+		size_t last = first + 1;
+		while (passCount == 1 && last < slotCount) {
+			const auto &next = commands[sorted[last].index];
+			if (next.meshID != item.meshID || next.materialID != item.materialID || !isDrawn(next)) break;
+			last++;
+		}
+		const auto instanceCount = static_cast<uint32_t>(last - first);
+
+		for (uint32_t pass = 0; pass < passCount; ++pass) {
+			VulkanPipeline *pipeline = GetOrCreatePipeline(descs[pass]);
+			if (!pipeline) return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+
+			m_mainBatches.push_back(
+				{pipeline, item.materialID, item.meshID, static_cast<uint32_t>(first), instanceCount});
+			addStats(item.meshID, instanceCount);
+		}
+
+		first = last;
+	}
+
+	return ERROR_CODE::OK;
+}
+
+uint32_t VulkanRenderer::GetMainPassDescriptions(const ShaderID shaderID,
+												 std::array<PipelineDescription, MAX_SHADER_PASSES> &outDescs) const {
+	const ShaderType shaderType = m_shaders.Get(shaderID).GetType();
+
+	uint32_t passCount = (shaderType == ShaderType::SnowGlobe) ? 2 : 1;
+
+	for (uint32_t pass = 0; pass < passCount; ++pass) {
+		PipelineDescription &desc = outDescs[pass];
+		desc					  = {};
+		desc.shaderID			  = shaderID;
+		desc.colorFormat		  = m_swapChain->GetImageFormat();
+		desc.depthFormat		  = m_depthTexture.format;
+		desc.wireframe			  = false;
+		desc.enableDepthBias	  = false;
+		if (shaderType == ShaderType::SnowGlobe) {
+			if (pass == 0) {
+				desc.cullMode = VK_CULL_MODE_FRONT_BIT;
+
+				desc.enableDepthTest  = true;
+				desc.enableDepthWrite = false;
+				desc.enableBlend	  = false;
+				desc.compareOp		  = VK_COMPARE_OP_LESS;
+			} else {
+				desc.cullMode = VK_CULL_MODE_BACK_BIT;
+
+				desc.enableDepthTest  = true;
+				desc.enableDepthWrite = false;
+				desc.enableBlend	  = true;
+				desc.compareOp		  = VK_COMPARE_OP_LESS;
+			}
+		} else {
+			desc.cullMode		  = VK_CULL_MODE_BACK_BIT;
+			desc.enableDepthTest  = true;
+			desc.enableDepthWrite = true;
+			desc.enableBlend	  = false;
+			desc.compareOp		  = VK_COMPARE_OP_LESS;
+		}
+	}
+	return passCount;
+}
+
+VulkanPipeline *VulkanRenderer::GetOrCreatePipeline(const PipelineDescription &desc) {
+	if (auto it = m_pipelineDescriptions.find(desc); it != m_pipelineDescriptions.end()) return it->second;
+
+	// Still works, but it is a mid-frame stall PrewarmPipelines should have taken care of.
+	PE_LOG_WARN("Pipeline for shader " + std::to_string(desc.shaderID) + " wasn't prewarmed, creating it now.");
+
+	auto *pipeline = new VulkanPipeline();
+	if (pipeline->Initialize(ref_device, m_shaders.Get(desc.shaderID), m_pipelineLayout, m_swapChain->GetExtent(),
+							 desc, m_pipelineCache->GetHandle()) < ERROR_CODE::WARN_START) {
+		PE_LOG_FATAL("Vulkan failed to create pipeline.");
+		Utilities::SafeShutdown(pipeline);
+		return nullptr;
+	}
+	m_pipelineDescriptions[desc] = pipeline;
+	return pipeline;
+}
+
+bool VulkanRenderer::IsMeshReady(const MeshID id) const {
+	return m_meshes.Get(id).uploadValue <= m_completedUploadValue;
+}
+
+CBPerObject VulkanRenderer::GetObjectData(const MeshID meshID, const Math::Matrix4 &world) const {
+	const VertexQuantization &quantization = m_meshes.Get(meshID).quantization;
+
+	CBPerObject objectData{};
+	objectData.world		  = world;
+	objectData.positionScale  = Math::Vector4(quantization.scale, 0.0f);
+	objectData.positionOffset = Math::Vector4(quantization.offset, 0.0f);
+	return objectData;
+}
+
+bool VulkanRenderer::IsTextureReady(const TextureID id) const {
+	return m_textures.Get(id).uploadValue <= m_completedUploadValue;
+}
+
+bool VulkanRenderer::IsMaterialReady(const MaterialID id) const {
+	const auto &textures = m_materials.Get(id).GetTextures();
+	for (size_t type = 0; type < textures.size(); ++type) {
+		// Same fallback as UpdateMaterialTexture, unset or unknown textures are bound as the default of their type.
+		TextureID texID = textures[type];
+		if (texID == INVALID_HANDLE || !m_textures.Has(texID)) texID = static_cast<TextureID>(type);
+		if (!IsTextureReady(texID)) return false;
+	}
+	return true;
+}
+
+ERROR_CODE VulkanRenderer::PrewarmPipelines() {
+	std::vector<PipelineDescription> pending;
+	for (const Material &material : m_materials.Data()) {
+		if (material.GetShaderID() == INVALID_HANDLE) continue;
+
+		std::array<PipelineDescription, MAX_SHADER_PASSES> descs;
+		const uint32_t passCount = GetMainPassDescriptions(material.GetShaderID(), descs);
+		for (uint32_t pass = 0; pass < passCount; ++pass) {
+			if (m_pipelineDescriptions.contains(descs[pass])) continue;
+			if (std::find(pending.begin(), pending.end(), descs[pass]) != pending.end()) continue;
+			pending.push_back(descs[pass]);
+		}
+	}
+	if (pending.empty()) return ERROR_CODE::OK;
+
+	// Pipeline creation is the slow part of loading a shader, the workers build the permutations side by side. The
+	// cache is internally synchronized and the map is only filled afterwards, on this thread.
+	std::vector<VulkanPipeline *> created(pending.size(), nullptr);
+	Utilities::JobSystem::ParallelFor(std::span(pending), 1, [&](const PipelineDescription &desc, const size_t i) {
+		auto *pipeline = new VulkanPipeline();
+
+		const ERROR_CODE result = pipeline->Initialize(ref_device, m_shaders.Get(desc.shaderID), m_pipelineLayout,
+													   m_swapChain->GetExtent(), desc, m_pipelineCache->GetHandle());
+		if (result < ERROR_CODE::WARN_START) {
+			Utilities::SafeShutdown(pipeline);
+			return;
+		}
+		created[i] = pipeline;
+	});
+
+	ERROR_CODE result = ERROR_CODE::OK;
+	for (size_t i = 0; i < pending.size(); ++i) {
+		if (!created[i]) {
+			PE_LOG_ERROR("Vulkan failed to prewarm pipeline for shader " + std::to_string(pending[i].shaderID));
+			result = ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+			continue;
+		}
+		m_pipelineDescriptions[pending[i]] = created[i];
+	}
+
+	PE_LOG_INFO("Prewarmed " + std::to_string(pending.size()) + " pipelines.");
+	m_pipelineCache->Save();
+	return result;
+}
+
+ERROR_CODE VulkanRenderer::RecordPassInParallel(VkCommandBuffer cmd, const uint32_t pass,
+												const std::span<const DrawBatch> batches,
+												const VkCommandBufferInheritanceRenderingInfo &inheritance) {
+	if (batches.empty()) return ERROR_CODE::OK;
+
+	// Small passes stay on fewer slots, a secondary buffer per handful of draws costs more than it saves.
+	const size_t wantedSlots = (batches.size() + MIN_BATCHES_PER_RECORDING_SLOT - 1) / MIN_BATCHES_PER_RECORDING_SLOT;
+	const size_t slotCount	 = std::min<size_t>(m_command->GetRecordingSlotCount(), wantedSlots);
+	const size_t grainSize	 = (batches.size() + slotCount - 1) / slotCount;
+
+	// The profiler's pipeline statistics query of the pass stays active while the secondaries execute.
+	VkCommandBufferInheritanceInfo inheritanceInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+	inheritanceInfo.pNext			   = &inheritance;
+	inheritanceInfo.pipelineStatistics = m_profiler->GetStatisticFlags();
+
+	VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	beginInfo.flags =
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+	const VkPipelineLayout layout = (pass < MAIN_PASS) ? m_shadowPipelineLayout : m_pipelineLayout;
+
+	// Every chunk is one slot, recorded by whichever worker picks it up. Chunks are executed in slot order, which is
+	// the sorted draw order.
+	std::array<VkCommandBuffer, MAX_RECORDING_SLOTS> secondaries{};
+	std::atomic<bool>								 failed{false};
+	Utilities::JobSystem::ParallelForRange(batches.size(), grainSize, [&](const size_t begin, const size_t end) {
+		const auto		slot	  = static_cast<uint32_t>(begin / grainSize);
+		VkCommandBuffer secondary = m_command->GetSecondaryCommandBuffer(m_currentFrame, slot, pass);
+
+		if (vkBeginCommandBuffer(secondary, &beginInfo) != VK_SUCCESS) {
+			failed.store(true, std::memory_order_relaxed);
+			return;
+		}
+		BindPassState(secondary, pass);
+		RecordDrawBatches(secondary, layout, batches.subspan(begin, end - begin));
+		if (vkEndCommandBuffer(secondary) != VK_SUCCESS) failed.store(true, std::memory_order_relaxed);
+
+		secondaries[slot] = secondary;
+	});
+
+	if (failed.load(std::memory_order_relaxed)) {
+		PE_LOG_ERROR("Vulkan failed to record a secondary command buffer!");
+		return ERROR_CODE::VULKAN_COMMAND_CREATION_FAILED;
+	}
+
+	const auto recordedCount = static_cast<uint32_t>((batches.size() + grainSize - 1) / grainSize);
+	vkCmdExecuteCommands(cmd, recordedCount, secondaries.data());
+	return ERROR_CODE::OK;
+}
+
+void VulkanRenderer::SetPassViewport(VkCommandBuffer cmd, const uint32_t pass) const {
+	if (pass < MAIN_PASS) {
+		VkViewport shadowVP = {0, 0, (float)m_shadowMap.dim, (float)m_shadowMap.dim, 0.0f, 1.0f};
+		vkCmdSetViewport(cmd, 0, 1, &shadowVP);
+		VkRect2D shadowScissor = {{0, 0}, {m_shadowMap.dim, m_shadowMap.dim}};
+		vkCmdSetScissor(cmd, 0, 1, &shadowScissor);
+		return;
+	}
+
+	VkExtent2D vkExtent2D = m_swapChain->GetExtent();
+	VkViewport viewport	  = {
+		  .x	  = 0.0f,
+		  .y	  = static_cast<float>(vkExtent2D.height),
+		  .width  = static_cast<float>(vkExtent2D.width),
+		  .height = -static_cast<float>(vkExtent2D.height),
+
+		  .minDepth = 0.0f,
+		  .maxDepth = 1.0f,
+	  };
+	vkCmdSetViewport(cmd, 0, 1, &viewport);
+	VkRect2D scissor = {.offset = {.x = 0, .y = 0}, .extent = vkExtent2D};
+	vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
 
-	Math::Vector3 lightDir = Math::Vector3(data.lightDirection.x, data.lightDirection.y, data.lightDirection.z);
+void VulkanRenderer::BindPassState(VkCommandBuffer cmd, const uint32_t pass) const {
+	// Secondary buffers inherit nothing but the attachments, every one of them sets the pass state up again.
+	SetPassViewport(cmd, pass);
 
-	Math::Vector3 lightPos = Math::Normalize(lightDir) * (-110.0f);
+	const VkPipelineLayout layout = (pass < MAIN_PASS) ? m_shadowPipelineLayout : m_pipelineLayout;
+	if (pass < MAIN_PASS) {
+		float depthBiasConstant = 1.75f;
+		float depthBiasSlope	= 1.25f;
 
-	Math::Vector3 target = Math::Vector3Zero;
+		vkCmdSetDepthBias(cmd, depthBiasConstant, 0.0f, depthBiasSlope);
 
-	auto up = Math::Vector3(0.0f, 1.0f, 0.0f);
-	if (Math::Abs(lightDir.y) > 0.99f) {
-		up = Math::Vector3(0.0f, 0.0f, 1.0f);
+		const uint32_t cascade = pass - SHADOW_PASS;
+		vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t), &cascade);
 	}
 
-	Math::Matrix4 lightView = Math::Mat4LookAt(lightPos, target, up);
-	float		  orthoSize = 100.0f;
-	float		  nearPlane = 0.1f;
-	float		  farPlane	= 200.0f;
+	VkBuffer	 vBuffers[] = {m_vertexBuffer->GetBuffer()};
+	VkDeviceSize offsets[]	= {0};
+	vkCmdBindVertexBuffers(cmd, 0, 1, vBuffers, offsets);
+	vkCmdBindIndexBuffer(cmd, m_indexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+	// The shadow layout stops before the bindless set, shadow draws don't sample materials.
+	const uint32_t		  setCount = (pass < MAIN_PASS) ? BINDLESS_SET : BINDLESS_SET + 1;
+	const VkDescriptorSet sets[]   = {m_perPassDescriptorSets[m_currentFrame],
+									  m_perObjectDescriptorSets[m_currentFrame], m_bindlessSet};
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, setCount, sets, 0, nullptr);
+}
+
+void VulkanRenderer::RecordDrawBatches(VkCommandBuffer cmd, VkPipelineLayout layout,
+									   const std::span<const DrawBatch> batches) const {
+	VulkanPipeline *boundPipeline = nullptr;
+	MaterialID		boundMaterial = INVALID_HANDLE;
 
-	Math::Matrix4 lightProj		= Math::Mat4Ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, nearPlane, farPlane);
-	shadowData.lightSpaceMatrix = lightProj * lightView;
-	m_perPassBuffers[m_currentFrame]->Update(&shadowData, sizeof(CBPerPass), 0);
+	for (const DrawBatch &batch : batches) {
+		if (batch.pipeline != boundPipeline) {
+			boundPipeline = batch.pipeline;
+			boundPipeline->Bind(cmd);
+		}
+
+		if (batch.materialID != INVALID_HANDLE && batch.materialID != boundMaterial) {
+			vkCmdPushConstants(cmd, layout, MATERIAL_PUSH_STAGES, 0, sizeof(MaterialID), &batch.materialID);
+			boundMaterial = batch.materialID;
+		}
+
+		const VulkanMeshWrapper &mesh = m_meshes.Get(batch.meshID);
+		vkCmdDrawIndexed(cmd, mesh.indexCount, batch.instanceCount, mesh.firstIndex, mesh.firstVertex,
+						 batch.firstInstance);
+	}
+}
+
+ERROR_CODE VulkanRenderer::RecordGPUDrivenPass(VkCommandBuffer cmd, const uint32_t pass,
+											   const std::span<const DrawBatch> batches) {
+	BindPassState(cmd, pass);
+
+	// Set 1 points at the culled instances for the indirect draws and back at the per-object buffer for the rest.
+	const VkPipelineLayout layout	   = (pass < MAIN_PASS) ? m_shadowPipelineLayout : m_pipelineLayout;
+	const VkDescriptorSet  instanceSet = m_gpuCulling->GetInstanceSet();
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &instanceSet, 0, nullptr);
+
+	if (pass < MAIN_PASS) {
+		m_shadowPipeline->Bind(cmd);
+		m_gpuCulling->DrawShadowCascade(cmd, pass - SHADOW_PASS);
+		m_stats.shadowDrawCalls++;
+	} else {
+		const std::span<const VulkanGPUCulling::Bucket> buckets = m_gpuCulling->GetBuckets();
+		for (uint32_t bucket = 0; bucket < buckets.size(); ++bucket) {
+			const MaterialID materialID = buckets[bucket].materialID;
+			if (buckets[bucket].groupCount == 0 || !IsMaterialReady(materialID)) continue;
+
+			std::array<PipelineDescription, MAX_SHADER_PASSES> descs;
+			const uint32_t passCount = GetMainPassDescriptions(m_materials.Get(materialID).GetShaderID(), descs);
+
+			vkCmdPushConstants(cmd, layout, MATERIAL_PUSH_STAGES, 0, sizeof(MaterialID), &materialID);
+			for (uint32_t shaderPass = 0; shaderPass < passCount; ++shaderPass) {
+				VulkanPipeline *pipeline = GetOrCreatePipeline(descs[shaderPass]);
+				if (!pipeline) return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
+
+				pipeline->Bind(cmd);
+				m_gpuCulling->DrawBucket(cmd, bucket);
+				m_stats.drawCalls++;
+			}
+		}
+	}
+
+	const VkDescriptorSet perObjectSet = m_perObjectDescriptorSets[m_currentFrame];
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &perObjectSet, 0, nullptr);
+	RecordDrawBatches(cmd, layout, batches);
+	return ERROR_CODE::OK;
+}
+
+void VulkanRenderer::UpdateGlobalBuffer(const CBPerPass &data) { m_perPassData = data; }
+
+void VulkanRenderer::UpdateShadowCascades() {
+	const Math::Vector3 lightDirection(m_perPassData.lightDirection);
+	const uint32_t		fittedCount	 = FitShadowCascades(m_perPassData.view, m_perPassData.projection, lightDirection,
+														 *ref_renderConfig, m_shadowCascades);
+	const uint32_t		cascadeCount = Math::Min(fittedCount, m_shadowMap.cascadeCount);
+
+	// Bounds of the opaque draws in draw order, only they can land in a shadow batch.
+	const std::vector<RenderCommand>			 &commands = m_renderQueue.GetCommands();
+	const std::span<const RenderQueue::SortEntry> sorted   = m_renderQueue.GetSorted();
+
+	const size_t slotCount = std::min(m_renderQueue.GetOpaque().size(), GetInstanceSlotCount());
+	m_casterX.resize(slotCount);
+	m_casterY.resize(slotCount);
+	m_casterZ.resize(slotCount);
+	m_casterRadius.resize(slotCount);
+	m_casterVisible.resize(slotCount);
+	m_casterCascades.assign(slotCount, 0);
+	for (size_t slot = 0; slot < slotCount; ++slot) {
+		const Math::BoundingSphere &bounds = commands[sorted[slot].index].bounds;
+		m_casterX[slot]					   = bounds.center.x;
+		m_casterY[slot]					   = bounds.center.y;
+		m_casterZ[slot]					   = bounds.center.z;
+		m_casterRadius[slot]			   = bounds.radius;
+	}
+
+	// The GPU culling pass tests its instances against the camera and the same caster volumes as the submitted draws.
+	m_cullViews[0]	= Math::ExtractFrustum(m_perPassData.projection * m_perPassData.view);
+	m_cullViewCount = 1 + cascadeCount;
+
+	for (uint32_t cascade = 0; cascade < cascadeCount; ++cascade) {
+		ShadowCascade &shadowCascade = m_shadowCascades[cascade];
+		if (m_gpuCulling) {
+			// The closest GPU caster isn't known on the CPU, so the near plane can't be pulled in to it.
+			m_cullViews[1 + cascade] = GetShadowCasterFrustum(shadowCascade, ref_renderConfig->shadowDistance);
+			Math::CullSpheres(m_cullViews[1 + cascade], m_casterX.data(), m_casterY.data(), m_casterZ.data(),
+							  m_casterRadius.data(), slotCount, m_casterVisible.data());
+		} else {
+			CullShadowCasters(shadowCascade, m_casterX.data(), m_casterY.data(), m_casterZ.data(),
+							  m_casterRadius.data(), slotCount, ref_renderConfig->shadowDistance,
+							  m_casterVisible.data());
+		}
+		for (size_t slot = 0; slot < slotCount; ++slot) {
+			m_casterCascades[slot] |= static_cast<uint8_t>(m_casterVisible[slot] << cascade);
+		}
+
+		m_perPassData.cascadeMatrices[cascade] = shadowCascade.viewProjection;
+		m_perPassData.cascadeSplits[cascade]   = shadowCascade.splitDepth;
+	}
+	m_perPassData.cascadeCount = cascadeCount;
+
+	m_perPassBuffers[m_currentFrame]->Update(&m_perPassData, sizeof(CBPerPass), 0);
 }
 
 void VulkanRenderer::UpdateUniformBuffer(uint32_t currentFrame) {
@@ -693,27 +1131,30 @@ void VulkanRenderer::UpdateUniformBuffer(uint32_t currentFrame) {
 
 	char *mappedBytePtr = static_cast<char *>(rawData);
 
-	size_t count = m_renderQueue.size();
-	if (count > ref_engineConfig->maxEntityCount) {
+	// Per-object data is laid out in draw order, so a run of equal draws is a contiguous range of instances.
+	const std::vector<RenderCommand>			 &commands = m_renderQueue.GetCommands();
+	const std::span<const RenderQueue::SortEntry> sorted   = m_renderQueue.GetSorted();
+
+	if (sorted.size() > ref_engineConfig->maxEntityCount) {
 		PE_LOG_WARN("Render Queue exceeded buffer capacity! Capping to " +
 					std::to_string(ref_engineConfig->maxEntityCount));
-		count = ref_engineConfig->maxEntityCount;
 	}
 
+	const size_t count = GetInstanceSlotCount();
 	for (size_t i = 0; i < count; i++) {
-		const auto &command = m_renderQueue[i];
-
-		CBPerObject objectData{};
-		objectData.world = command.worldMatrix;
-
-		size_t offset = i * m_dynamicAlignment;
+		const auto &command = commands[sorted[i].index];
 
-		memcpy(mappedBytePtr + offset, &objectData, sizeof(CBPerObject));
+		const CBPerObject objectData = GetObjectData(command.meshID, command.worldMatrix);
+		memcpy(mappedBytePtr + i * sizeof(CBPerObject), &objectData, sizeof(CBPerObject));
 	}
 }
 
+size_t VulkanRenderer::GetInstanceSlotCount() const {
+	return std::min<size_t>(m_renderQueue.Size(), ref_engineConfig->maxEntityCount);
+}
+
 ERROR_CODE VulkanRenderer::UpdateMaterialTexture(MaterialID matID, TextureType typeIdx, TextureID texID) {
-	if (matID >= m_materialDescriptorSets.size()) {
+	if (!m_materials.Has(matID)) {
 		PE_LOG_ERROR("Invalid Material ID for texture update.");
 		return ERROR_CODE::VULKAN_MATERIAL_UPDATE_FAILED;
 	}
@@ -725,26 +1166,46 @@ ERROR_CODE VulkanRenderer::UpdateMaterialTexture(MaterialID matID, TextureType t
 		validTexID = static_cast<TextureID>(typeIdx);
 	}
 
-	VulkanTextureWrapper &tex = m_textures.Get(validTexID);
+	// The material record only stores where the texture sits in the bindless array.
+	const uint32_t slot	  = GetBindlessSlot(validTexID, GetMaterial(matID).GetSampler(typeIdx));
+	const size_t   offset = matID * sizeof(GPUMaterial) + offsetof(GPUMaterial, textureSlots) +
+							static_cast<size_t>(typeIdx) * sizeof(uint32_t);
+	m_materialBuffer->WriteToMapped(&slot, sizeof(slot), offset);
+
+	PE_LOG_INFO("Updated Material " + std::to_string(matID) + " Texture Type " +
+				std::to_string(static_cast<uint32_t>(typeIdx)) + " to TextureID " + std::to_string(validTexID));
+	return ERROR_CODE::OK;
+}
+
+uint32_t VulkanRenderer::GetBindlessSlot(const TextureID texID, const SamplerType sampler) {
+	const uint64_t key = (static_cast<uint64_t>(texID) << 8) | static_cast<uint8_t>(sampler);
+	if (const auto it = m_bindlessSlots.find(key); it != m_bindlessSlots.end()) return it->second;
+
+	const auto slot = static_cast<uint32_t>(m_bindlessSlots.size());
+	if (slot >= m_bindlessTextureCapacity) {
+		// Slot 0 holds the first texture ever sampled, a wrong texture beats an unwritten descriptor.
+		PE_LOG_ERROR("Vulkan bindless texture array is full, raise RenderConfig::maxBindlessTextures!");
+		return 0;
+	}
 
 	VkDescriptorImageInfo imageInfo{};
 	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	imageInfo.imageView	  = tex.imageView;
-	imageInfo.sampler	  = m_globalSamplers[static_cast<uint8_t>(GetMaterial(matID).GetSampler(typeIdx))];
+	imageInfo.imageView	  = m_textures.Get(texID).imageView;
+	imageInfo.sampler	  = m_globalSamplers[static_cast<size_t>(sampler)];
 
-	VkWriteDescriptorSet texWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-	texWrite.dstSet			 = m_materialDescriptorSets[matID];
-	texWrite.dstBinding		 = static_cast<uint32_t>(typeIdx) + 1;
-	texWrite.dstArrayElement = 0;
-	texWrite.descriptorType	 = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	texWrite.descriptorCount = 1;
-	texWrite.pImageInfo		 = &imageInfo;
+	VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+	write.dstSet		  = m_bindlessSet;
+	write.dstBinding	  = 1;
+	write.dstArrayElement = slot;
+	write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	write.descriptorCount = 1;
+	write.pImageInfo	  = &imageInfo;
 
-	vkUpdateDescriptorSets(ref_device->GetVkDevice(), 1, &texWrite, 0, nullptr);
+	// Update after bind, frames in flight keep reading the slots they were recorded with.
+	vkUpdateDescriptorSets(ref_device->GetVkDevice(), 1, &write, 0, nullptr);
 
-	PE_LOG_INFO("Updated Material " + std::to_string(matID) + " Texture Type " +
-				std::to_string(static_cast<uint32_t>(typeIdx)) + " to TextureID " + std::to_string(validTexID));
-	return ERROR_CODE::OK;
+	m_bindlessSlots.emplace(key, slot);
+	return slot;
 }
 
 ERROR_CODE VulkanRenderer::UpdateMaterial(MaterialID id) {
@@ -753,18 +1214,12 @@ ERROR_CODE VulkanRenderer::UpdateMaterial(MaterialID id) {
 		return ERROR_CODE::VULKAN_MATERIAL_UPDATE_FAILED;
 	}
 
-	if (id >= m_perMaterialBuffers.size()) {
-		PE_LOG_ERROR("Material Buffer Index out of bounds");
-		return ERROR_CODE::VULKAN_MATERIAL_UPDATE_FAILED;
-	}
-
-	const Material &mat	   = m_materials.Get(id);
-	VulkanBuffer   *buffer = m_perMaterialBuffers[id];
+	const Material &mat = m_materials.Get(id);
 
 	const std::vector<uint8_t> &rawData = mat.GetPropertyData();
 
 	if (!rawData.empty()) {
-		buffer->WriteToMapped(rawData.data(), rawData.size(), 0);
+		m_materialBuffer->WriteToMapped(rawData.data(), rawData.size(), id * sizeof(GPUMaterial));
 	} else
 		PE_LOG_ERROR("Material has no property data!");
 
@@ -788,7 +1243,115 @@ TextureID VulkanRenderer::GetRenderTargetTexture(RenderTargetID id) { return 0;
 
 void VulkanRenderer::WaitIdle() { vkDeviceWaitIdle(ref_device->GetVkDevice()); }
 
-RenderStats VulkanRenderer::GetStats() const { return m_stats; }
+RenderStats VulkanRenderer::GetStats() const {
+	RenderStats stats = m_stats;
+
+	const VulkanMemoryStats memory = m_memoryAllocator->GetStats();
+	stats.gpuMemoryReserved		   = memory.reservedBytes;
+	stats.gpuMemoryUsed			   = memory.usedBytes;
+	stats.gpuMemoryFree			   = memory.freeBytes;
+	stats.gpuMemoryFragmented	   = memory.fragmentedBytes;
+	stats.gpuMemoryBlocks		   = memory.blockCount;
+	stats.gpuAllocations		   = memory.allocationCount;
+	stats.gpuDedicated			   = memory.dedicatedCount;
+
+	// The GPU's count is maxFramesInFlight frames old, reading it any sooner would stall. Instances may have been
+	// destroyed since.
+	if (m_gpuCulling) {
+		const uint32_t instanceCount = m_gpuCulling->GetInstanceCount();
+		const uint32_t visibleCount	 = std::min(m_gpuCulling->GetVisibleCount(), instanceCount);
+		stats.visibleObjects += visibleCount;
+		stats.culledObjects += instanceCount - visibleCount;
+	}
+	return stats;
+}
+
+InstanceID VulkanRenderer::CreateInstance(const MeshID meshID, const MaterialID materialID, const uint8_t renderFlags,
+										  const Math::Matrix4 &world, const Math::BoundingSphere &bounds) {
+	if (!m_gpuCulling) return INVALID_HANDLE;
+	return m_gpuCulling->CreateInstance(meshID, materialID, renderFlags, GetObjectData(meshID, world), bounds);
+}
+
+void VulkanRenderer::UpdateInstance(const InstanceID id, const Math::Matrix4 &world,
+									const Math::BoundingSphere &bounds) {
+	if (m_gpuCulling) m_gpuCulling->UpdateInstance(id, world, bounds);
+}
+
+void VulkanRenderer::DestroyInstance(const InstanceID id) {
+	if (m_gpuCulling) m_gpuCulling->DestroyInstance(id);
+}
+
+void VulkanRenderer::SetCullingStats(const uint32_t visibleCount, const uint32_t culledCount) {
+	m_stats.visibleObjects = visibleCount;
+	m_stats.culledObjects  = culledCount;
+}
+
+const GPUProfile *VulkanRenderer::GetGPUProfile() const {
+	return m_profiler && m_profiler->IsEnabled() ? &m_profiler->GetProfile() : nullptr;
+}
+
+void VulkanRenderer::RequestCapture(const std::filesystem::path &path) {
+	if (!m_swapChain->IsOffscreen()) {
+		PE_LOG_WARN("Frame capture needs the headless offscreen target, skipping " + path.string());
+		return;
+	}
+
+	const VkExtent2D   extent = m_swapChain->GetExtent();
+	const VkDeviceSize size	  = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+	if (!m_captureBuffer || m_captureBuffer->GetSize() < size) {
+		Utilities::SafeShutdown(m_captureBuffer);
+		m_captureBuffer = new VulkanBuffer();
+		if (m_captureBuffer->Initialize(ref_device->GetVkDevice(), m_memoryAllocator, size,
+										VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE,
+										VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) <
+			ERROR_CODE::WARN_START) {
+			PE_LOG_ERROR("Failed to create the frame capture buffer!");
+			Utilities::SafeShutdown(m_captureBuffer);
+			return;
+		}
+	}
+	m_capturePath = path;
+}
+
+void VulkanRenderer::RecordCapture(const VkCommandBuffer cmd, const uint32_t imageIndex) const {
+	const VkExtent2D extent = m_swapChain->GetExtent();
+
+	VkBufferImageCopy region{};
+	region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+	region.imageExtent		= {extent.width, extent.height, 1};
+	vkCmdCopyImageToBuffer(cmd, m_swapChain->GetImages()[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+						   m_captureBuffer->GetBuffer(), 1, &region);
+
+	VkBufferMemoryBarrier2 hostBarrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2};
+	hostBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	hostBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	hostBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_HOST_BIT;
+	hostBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+	hostBarrier.buffer		  = m_captureBuffer->GetBuffer();
+	hostBarrier.size		  = VK_WHOLE_SIZE;
+
+	VkDependencyInfo depInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+	depInfo.bufferMemoryBarrierCount = 1;
+	depInfo.pBufferMemoryBarriers	 = &hostBarrier;
+	vkCmdPipelineBarrier2(cmd, &depInfo);
+}
+
+void VulkanRenderer::WriteCapture(const VkFence fence) {
+	vkWaitForFences(ref_device->GetVkDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+
+	// Offscreen images are BGRA, the writer takes RGBA.
+	const VkExtent2D		   extent = m_swapChain->GetExtent();
+	const size_t			   size	  = static_cast<size_t>(extent.width) * extent.height * 4;
+	const auto				  *bgra	  = static_cast<const unsigned char *>(m_captureBuffer->GetMappedData());
+	std::vector<unsigned char> rgba(bgra, bgra + size);
+	for (size_t i = 0; i < size; i += 4) std::swap(rgba[i], rgba[i + 2]);
+
+	if (Assets::Texture::Writer::Write(m_capturePath, extent.width, extent.height, rgba.data()))
+		PE_LOG_INFO("Captured frame to " + m_capturePath.string());
+	else
+		PE_LOG_ERROR("Failed to write frame capture " + m_capturePath.string());
+	m_capturePath.clear();
+}
 
 TextureID VulkanRenderer::CreateTexture(const std::string &name, const unsigned char *data,
 										const TextureParameters &params) {
@@ -808,71 +1371,82 @@ TextureID VulkanRenderer::CreateTexture(const std::string &name, const unsigned
 		t.flags = 0;
 	}
 
-	VkDeviceSize imageSize = static_cast<VkDeviceSize>(t.width) * t.height * 4 * t.layerCount;
-
-	VulkanBuffer stagingBuffer;
-
-	ERROR_CODE result = stagingBuffer.Initialize(
-		ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(), imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	if (result != ERROR_CODE::OK) {
-		PE_LOG_FATAL("Failed to create staging buffer for texture: " + name);
-		return INVALID_HANDLE;
+	// One region per mip level, the data holds the layers of each level back to back.
+	std::vector<VkBufferImageCopy> regions(t.mipLevels);
+	VkDeviceSize				   imageSize = 0;
+	for (uint32_t level = 0; level < t.mipLevels; ++level) {
+		regions[level].bufferOffset		= imageSize;
+		regions[level].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, t.layerCount};
+		regions[level].imageExtent		= {GetMipExtent(t.width, level), GetMipExtent(t.height, level), 1};
+		imageSize += GetMipLevelSize(params, level) * t.layerCount;
 	}
 
-	stagingBuffer.Map();
-	stagingBuffer.Update(data, imageSize);
-	stagingBuffer.Unmap();
-
 	CreateImage(t, VK_IMAGE_TILING_OPTIMAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-	TransitionImageLayout(t.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, t.layerCount);
-
-	CopyBufferToImage(stagingBuffer.GetBuffer(), t.image, t.width, t.height, t.layerCount);
-
-	TransitionImageLayout(t.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-						  t.layerCount);
+	// The copy runs on the transfer queue, the texture is skipped at draw time until it is done.
+	if (m_uploadManager->UploadImage(t.image, t.mipLevels, t.layerCount, regions, data, imageSize, t.uploadValue) <
+		ERROR_CODE::WARN_START) {
+		PE_LOG_FATAL("Failed to upload texture: " + name);
+		vkDestroyImage(ref_device->GetVkDevice(), t.image, nullptr);
+		m_memoryAllocator->Free(t.allocation);
+		return INVALID_HANDLE;
+	}
 
 	t.currentLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 	const VkImageViewType viewType = params.isCubemap ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D;
 
-	t.imageView = CreateImageView(t.image, t.format, VK_IMAGE_ASPECT_COLOR_BIT, viewType, t.layerCount);
+	t.imageView =
+		CreateImageView(t.image, t.format, VK_IMAGE_ASPECT_COLOR_BIT, viewType, t.layerCount, t.mipLevels);
 
-	stagingBuffer.Shutdown();
 	return m_textures.Add(std::move(t));
 }
 
 MeshID VulkanRenderer::CreateMesh(const std::string &name, const MeshData &meshData) {
-	VkDeviceSize vertexDataSize = sizeof(Vertex) * meshData.Vertices.size();
+	// Meshes are stored packed, the quantization travels with every instance that draws them.
+	std::vector<PackedVertex> vertices;
+	const VertexQuantization  quantization	 = PackVertices(meshData.Vertices, vertices);
+	VkDeviceSize			  vertexDataSize = sizeof(PackedVertex) * vertices.size();
 
 	if (m_currentVertexOffset + vertexDataSize > MAX_VERTEX_BUFFER_SIZE) {
 		PE_LOG_FATAL("Global Vertex Buffer is full!");
 		return INVALID_HANDLE;
 	}
 
-	m_vertexBuffer->UpdateStaged(m_command->GetCommandPool(), ref_device->GetGraphicsQueue(), meshData.Vertices.data(),
-								 vertexDataSize, m_currentVertexOffset);
+	uint64_t vertexUploadValue = 0;
+	if (m_uploadManager->UploadBuffer(m_vertexBuffer->GetBuffer(), m_currentVertexOffset, vertices.data(),
+									  vertexDataSize, VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+									  VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+									  vertexUploadValue) < ERROR_CODE::WARN_START) {
+		PE_LOG_FATAL("Failed to upload vertices of mesh: " + name);
+		return INVALID_HANDLE;
+	}
 
 	VkDeviceSize indexDataSize = sizeof(uint32_t) * meshData.Indices.size();
 
-	if (m_currentIndexOffset + indexDataSize > MAX_VERTEX_BUFFER_SIZE) {
+	if (m_currentIndexOffset + indexDataSize > MAX_INDEX_BUFFER_SIZE) {
 		PE_LOG_FATAL("Global Index Buffer is full!");
 		return INVALID_HANDLE;
 	}
 
-	m_indexBuffer->UpdateStaged(m_command->GetCommandPool(), ref_device->GetGraphicsQueue(), meshData.Indices.data(),
-								indexDataSize, m_currentIndexOffset);
+	uint64_t indexUploadValue = 0;
+	if (m_uploadManager->UploadBuffer(m_indexBuffer->GetBuffer(), m_currentIndexOffset, meshData.Indices.data(),
+									  indexDataSize, VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT,
+									  indexUploadValue) < ERROR_CODE::WARN_START) {
+		PE_LOG_FATAL("Failed to upload indices of mesh: " + name);
+		return INVALID_HANDLE;
+	}
 
 	VulkanMeshWrapper m;
 	m.vertexBuffer = m_vertexBuffer->GetBuffer();
 	m.indexBuffer  = m_indexBuffer->GetBuffer();
+	m.uploadValue  = std::max(vertexUploadValue, indexUploadValue);
+	m.quantization = quantization;
 
 	m.vertexCount = static_cast<uint32_t>(meshData.Vertices.size());
 	m.indexCount  = static_cast<uint32_t>(meshData.Indices.size());
 
-	m.firstVertex = static_cast<uint32_t>(m_currentVertexOffset / sizeof(Vertex));
+	m.firstVertex = static_cast<uint32_t>(m_currentVertexOffset / sizeof(PackedVertex));
 	m.firstIndex  = static_cast<uint32_t>(m_currentIndexOffset / sizeof(uint32_t));
 
 	m_currentVertexOffset += vertexDataSize;
@@ -957,51 +1531,15 @@ MaterialID VulkanRenderer::CreateMaterial(ShaderID shaderID) {
 		default: PE_LOG_ERROR("Not implemented!"); break;
 	}
 
-	const uint32_t matID = m_materials.Add(std::move(Material()));
-	Material	  &mat	 = GetMaterial(matID);
-
-	mat.Initialize(this, matID, shaderID, bufferSize, matLayout);
-	m_perMaterialBuffers.emplace_back(new VulkanBuffer());
-	VulkanBuffer *matBuffer = m_perMaterialBuffers.back();
-	VkDeviceSize  safeSize	= bufferSize > 0 ? bufferSize : 64;
-
-	ERROR_CODE result = matBuffer->Initialize(
-		ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(), safeSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-		VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-	if (result < ERROR_CODE::WARN_START) {
-		Utilities::SafeShutdown(matBuffer);
-		PE_LOG_FATAL("Vulkan can't created material!");
-		return INVALID_HANDLE;
-	}
-
-	matBuffer->Map();
-
-	VkDescriptorSetAllocateInfo allocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-	allocInfo.descriptorPool	 = m_descriptorPool;
-	allocInfo.descriptorSetCount = 1;
-	allocInfo.pSetLayouts		 = &m_perMaterialSetLayout;
-
-	VkDescriptorSet matSet;
-	if (vkAllocateDescriptorSets(ref_device->GetVkDevice(), &allocInfo, &matSet) != VK_SUCCESS) {
-		PE_LOG_FATAL("Failed to allocate Material Descriptor Set!");
+	if (m_materials.Data().size() >= ref_renderConfig->maxMaterialCount) {
+		PE_LOG_FATAL("Vulkan material buffer is full, raise RenderConfig::maxMaterialCount!");
 		return INVALID_HANDLE;
 	}
 
-	m_materialDescriptorSets.push_back(matSet);
-
-	VkDescriptorBufferInfo bufferInfo{};
-	bufferInfo.buffer = matBuffer->GetBuffer();
-	bufferInfo.offset = 0;
-	bufferInfo.range  = VK_WHOLE_SIZE;
-
-	VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-	write.dstSet		  = matSet;
-	write.dstBinding	  = 0;
-	write.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	write.descriptorCount = 1;
-	write.pBufferInfo	  = &bufferInfo;
+	const uint32_t matID = m_materials.Add(std::move(Material()));
+	Material	  &mat	 = GetMaterial(matID);
 
-	vkUpdateDescriptorSets(ref_device->GetVkDevice(), 1, &write, 0, nullptr);
+	mat.Initialize(this, matID, shaderID, bufferSize, matLayout);
 
 	const auto &materialTextures = mat.GetTextures();
 
@@ -1047,7 +1585,7 @@ MaterialID VulkanRenderer::CreateMaterial(ShaderID shaderID) {
 
 	const auto &propData = mat.GetPropertyData();
 	if (!propData.empty()) {
-		matBuffer->WriteToMapped(propData.data(), propData.size(), 0);
+		m_materialBuffer->WriteToMapped(propData.data(), propData.size(), matID * sizeof(GPUMaterial));
 	}
 
 	return matID;
@@ -1062,6 +1600,7 @@ ERROR_CODE VulkanRenderer::CreateGlobalTextureSamplers() {
 	info.unnormalizedCoordinates = VK_FALSE;
 	info.compareEnable			 = VK_FALSE;
 	info.mipmapMode				 = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	info.maxLod					 = VK_LOD_CLAMP_NONE;
 
 	auto Create = [&](SamplerType type, VkFilter minMag, VkSamplerAddressMode addr, bool anisotropy = false) {
 		info.minFilter		  = minMag;
@@ -1160,16 +1699,16 @@ ERROR_CODE VulkanRenderer::CreateDescriptorSetLayout() {
 		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
 	}
 
-	VkDescriptorSetLayoutBinding perObjectLayoutBinding{
-		.binding			= 0,
-		.descriptorType		= VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
-		.descriptorCount	= 1,
-		.stageFlags			= VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-		.pImmutableSamplers = nullptr};
+	// Binding 0 holds the world matrices, binding 1 the index of the matrix each instance of a draw reads. The GPU
+	// driven path allocates its own set with this layout, see VulkanGPUCulling::GetInstanceSet.
+	const std::array<VkDescriptorSetLayoutBinding, 2> perObjectBindings{{
+		{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+		{1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+	}};
 
 	const VkDescriptorSetLayoutCreateInfo perObjectInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-														.bindingCount = 1,
-														.pBindings	  = &perObjectLayoutBinding};
+														.bindingCount = static_cast<uint32_t>(perObjectBindings.size()),
+														.pBindings	  = perObjectBindings.data()};
 
 	if (vkCreateDescriptorSetLayout(ref_device->GetVkDevice(), &perObjectInfo, nullptr, &m_perObjectSetLayout) !=
 		VK_SUCCESS) {
@@ -1177,48 +1716,63 @@ ERROR_CODE VulkanRenderer::CreateDescriptorSetLayout() {
 		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
 	}
 
-	std::vector<VkDescriptorSetLayoutBinding> perMatLayoutBindings;
-
-	VkDescriptorSetLayoutBinding propBinding{};
-	propBinding.binding			= 0;
-	propBinding.descriptorType	= VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	propBinding.descriptorCount = 1;
-	propBinding.stageFlags		= VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-	perMatLayoutBindings.push_back(propBinding);
-
-	constexpr size_t textureCount = static_cast<size_t>(TextureType::Count);
-
-	for (uint32_t i = 0; i < textureCount; i++) {
-		VkDescriptorSetLayoutBinding texBinding{};
-		texBinding.binding			  = i + 1;
-		texBinding.descriptorType	  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		texBinding.descriptorCount	  = 1;
-		texBinding.pImmutableSamplers = nullptr;
-		texBinding.stageFlags		  = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-		perMatLayoutBindings.push_back(texBinding);
+	// Set 2 is bindless: binding 0 holds a GPUMaterial per material, binding 1 every texture and sampler pair they or
+	// the particles sample. Slots are written as they are first used, so the array is partially bound and may be
+	// written while frames that don't read the new slots are in flight.
+	VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES};
+	VkPhysicalDeviceProperties2 properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+	properties.pNext = &indexingProperties;
+	vkGetPhysicalDeviceProperties2(ref_device->GetVkPhysicalDevice(), &properties);
+
+	m_bindlessTextureCapacity = std::min({static_cast<uint32_t>(ref_renderConfig->maxBindlessTextures),
+										  indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+										  indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers});
+	if (m_bindlessTextureCapacity < ref_renderConfig->maxBindlessTextures) {
+		PE_LOG_WARN("Device limits the bindless texture array to " + std::to_string(m_bindlessTextureCapacity) +
+					" textures.");
 	}
 
-	VkDescriptorSetLayoutCreateInfo materialInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-	materialInfo.bindingCount = static_cast<uint32_t>(perMatLayoutBindings.size());
-	materialInfo.pBindings	  = perMatLayoutBindings.data();
-
-	if (vkCreateDescriptorSetLayout(ref_device->GetVkDevice(), &materialInfo, nullptr, &m_perMaterialSetLayout) !=
+	const std::array<VkDescriptorSetLayoutBinding, 2> bindlessBindings{{
+		{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, MATERIAL_PUSH_STAGES, nullptr},
+		{1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_bindlessTextureCapacity, MATERIAL_PUSH_STAGES, nullptr},
+	}};
+	const std::array<VkDescriptorBindingFlags, 2> bindlessFlags{
+		0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+			   VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT};
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindlessFlagsInfo{
+		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+	bindlessFlagsInfo.bindingCount	= static_cast<uint32_t>(bindlessFlags.size());
+	bindlessFlagsInfo.pBindingFlags = bindlessFlags.data();
+
+	VkDescriptorSetLayoutCreateInfo bindlessInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+	bindlessInfo.pNext		  = &bindlessFlagsInfo;
+	bindlessInfo.flags		  = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	bindlessInfo.bindingCount = static_cast<uint32_t>(bindlessBindings.size());
+	bindlessInfo.pBindings	  = bindlessBindings.data();
+
+	if (vkCreateDescriptorSetLayout(ref_device->GetVkDevice(), &bindlessInfo, nullptr, &m_bindlessSetLayout) !=
 		VK_SUCCESS) {
-		PE_LOG_FATAL("Failed to create Material Layout");
+		PE_LOG_FATAL("Vulkan failed to create bindless descriptor set layout!");
 		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
 	}
 
-	m_descriptorSetLayouts = {m_perPassSetLayout, m_perObjectSetLayout, m_perMaterialSetLayout};
+	m_descriptorSetLayouts = {m_perPassSetLayout, m_perObjectSetLayout, m_bindlessSetLayout};
 
 	return ERROR_CODE::OK;
 }
 
 ERROR_CODE VulkanRenderer::CreateStandardPipelineLayout() {
+	// Index of the draw's GPUMaterial in the bindless material buffer.
+	VkPushConstantRange materialRange{MATERIAL_PUSH_STAGES, 0, sizeof(MaterialID)};
+
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 	pipelineLayoutInfo.sType				  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 	pipelineLayoutInfo.setLayoutCount		  = static_cast<uint32_t>(m_descriptorSetLayouts.size());
 	pipelineLayoutInfo.pSetLayouts			  = m_descriptorSetLayouts.data();
-	pipelineLayoutInfo.pushConstantRangeCount = 0;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges	  = &materialRange;
 
 	if (vkCreatePipelineLayout(ref_device->GetVkDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) !=
 		VK_SUCCESS) {
@@ -1233,8 +1787,7 @@ ERROR_CODE VulkanRenderer::CreateDepthBuffer() {
 		vkDestroyImage(ref_device->GetVkDevice(), m_depthTexture.image, nullptr);
 	if (m_depthTexture.imageView != VK_NULL_HANDLE)
 		vkDestroyImageView(ref_device->GetVkDevice(), m_depthTexture.imageView, nullptr);
-	if (m_depthTexture.memory != VK_NULL_HANDLE)
-		vkFreeMemory(ref_device->GetVkDevice(), m_depthTexture.memory, nullptr);
+	m_memoryAllocator->Free(m_depthTexture.allocation);
 
 	const VkFormat depthFormat = FindDepthFormat();
 	auto [width, height]	   = m_swapChain->GetExtent();
@@ -1275,17 +1828,28 @@ VkFormat VulkanRenderer::FindSupportedFormat(const std::vector<VkFormat> &candid
 }
 
 ERROR_CODE VulkanRenderer::CreateShadowResources() {
+	m_shadowMap.dim			 = ref_renderConfig->shadowMapResolution;
+	m_shadowMap.cascadeCount = Math::Clamp<uint32_t>(ref_renderConfig->shadowCascadeCount, 1, MAX_SHADOW_CASCADES);
+
 	m_shadowMap.texture.width	   = m_shadowMap.dim;
 	m_shadowMap.texture.height	   = m_shadowMap.dim;
 	m_shadowMap.texture.format	   = VK_FORMAT_D32_SFLOAT;
 	m_shadowMap.texture.usage	   = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 	m_shadowMap.texture.samples	   = VK_SAMPLE_COUNT_1_BIT;
 	m_shadowMap.texture.mipLevels  = 1;
-	m_shadowMap.texture.layerCount = 1;
+	m_shadowMap.texture.layerCount = m_shadowMap.cascadeCount;
 
 	CreateImage(m_shadowMap.texture, VK_IMAGE_TILING_OPTIMAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-	m_shadowMap.texture.imageView = CreateImageView(m_shadowMap.texture.image, m_shadowMap.texture.format,
-													VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1);
+
+	// Shaders sample every cascade through the array view, each cascade pass renders into its own layer.
+	m_shadowMap.texture.imageView =
+		CreateImageView(m_shadowMap.texture.image, m_shadowMap.texture.format, VK_IMAGE_ASPECT_DEPTH_BIT,
+						VK_IMAGE_VIEW_TYPE_2D_ARRAY, m_shadowMap.cascadeCount);
+	for (uint32_t cascade = 0; cascade < m_shadowMap.cascadeCount; ++cascade) {
+		m_shadowMap.layerViews[cascade] =
+			CreateImageView(m_shadowMap.texture.image, m_shadowMap.texture.format, VK_IMAGE_ASPECT_DEPTH_BIT,
+							VK_IMAGE_VIEW_TYPE_2D, 1, 1, cascade);
+	}
 
 	m_shadowMap.sampler = m_globalSamplers[static_cast<size_t>(SamplerType::ShadowPCF)];
 
@@ -1295,15 +1859,20 @@ ERROR_CODE VulkanRenderer::CreateShadowResources() {
 ERROR_CODE VulkanRenderer::CreateShadowPipeline() {
 	VulkanShader const &shadowShader = m_shaders.Get(Assets::AssetManager::DefaultShadowShaderID);
 
+	// Index of the cascade the pass renders, set once per secondary buffer.
+	VkPushConstantRange cascadeRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t)};
+
 	const VkDescriptorSetLayout layouts[] = {m_perPassSetLayout, m_perObjectSetLayout};
 	VkPipelineLayoutCreateInfo	pipelineLayoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-	pipelineLayoutInfo.setLayoutCount = 2;
-	pipelineLayoutInfo.pSetLayouts	  = layouts;
+	pipelineLayoutInfo.setLayoutCount		  = 2;
+	pipelineLayoutInfo.pSetLayouts			  = layouts;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges	  = &cascadeRange;
 
 	vkCreatePipelineLayout(ref_device->GetVkDevice(), &pipelineLayoutInfo, nullptr, &m_shadowPipelineLayout);
 
-	std::vector<VkVertexInputBindingDescription>   bindings	   = {Vertex::GetBindingDescription()};
-	auto										   attribArray = Vertex::GetAttributeDescriptions();
+	std::vector<VkVertexInputBindingDescription>   bindings	   = {PackedVertex::GetBindingDescription()};
+	auto										   attribArray = PackedVertex::GetAttributeDescriptions();
 	std::vector<VkVertexInputAttributeDescription> attribs(attribArray.begin(), attribArray.end());
 
 	PipelineDescription desc;
@@ -1317,7 +1886,7 @@ ERROR_CODE VulkanRenderer::CreateShadowPipeline() {
 
 	m_shadowPipeline = new VulkanPipeline();
 	m_shadowPipeline->Initialize(ref_device, shadowShader, m_shadowPipelineLayout, {m_shadowMap.dim, m_shadowMap.dim},
-								 desc, bindings, attribs);
+								 desc, bindings, attribs, m_pipelineCache->GetHandle());
 
 	return ERROR_CODE::OK;
 }
@@ -1333,32 +1902,24 @@ ERROR_CODE VulkanRenderer::CreateParticleResources() {
 		m_particleInstanceBuffers[i] = new VulkanBuffer();
 		// VERTEX_BUFFER_BIT is critical because we bind this as an Instanced Vertex Buffer
 		m_particleInstanceBuffers[i]->Initialize(
-			device, ref_device->GetVkPhysicalDevice(), bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			device, m_memoryAllocator, bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 		m_particleInstanceBuffers[i]->Map();
 	}
 
-	// 2. Create Descriptor Layout (Set 1: Single Texture Sampler)
-	// Set 0 is "PerPass" (Camera/Global), which we reuse from standard pipeline.
-	VkDescriptorSetLayoutBinding samplerBinding{};
-	samplerBinding.binding		   = 0;
-	samplerBinding.descriptorCount = 1;
-	samplerBinding.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerBinding.stageFlags	   = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-	VkDescriptorSetLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-	layoutInfo.bindingCount = 1;
-	layoutInfo.pBindings	= &samplerBinding;
-
-	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_particleSetLayout) != VK_SUCCESS)
-		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
-
-	// 3. Create Pipeline Layout (Set 0 + Set 1)
-	VkDescriptorSetLayout layouts[] = {m_perPassSetLayout, m_particleSetLayout};
+	// 2. Create Pipeline Layout (Set 0 + Bindless Set)
+	// Set 0 is "PerPass" (Camera/Global), which we reuse from standard pipeline. Each batch pushes the bindless slot of
+	// its texture, the vertex stage gets the quantization of the quad once per frame.
+	const VkPushConstantRange pushRanges[] = {
+		{VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t)},
+		{VK_SHADER_STAGE_VERTEX_BIT, PARTICLE_QUAD_PUSH_OFFSET, PARTICLE_QUAD_PUSH_SIZE},
+	};
 
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-	pipelineLayoutInfo.setLayoutCount = 2;
-	pipelineLayoutInfo.pSetLayouts	  = layouts;
+	pipelineLayoutInfo.setLayoutCount		  = static_cast<uint32_t>(m_descriptorSetLayouts.size());
+	pipelineLayoutInfo.pSetLayouts			  = m_descriptorSetLayouts.data();
+	pipelineLayoutInfo.pushConstantRangeCount = 2;
+	pipelineLayoutInfo.pPushConstantRanges	  = pushRanges;
 
 	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_particlePipelineLayout) != VK_SUCCESS)
 		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
@@ -1371,10 +1932,10 @@ ERROR_CODE VulkanRenderer::CreateParticlePipeline() {
 	VulkanShader &particleShader = m_shaders.Get(Assets::AssetManager::DefaultParticleShaderID);
 
 	// 2. Define Vertex Input (The Critical Part)
-	const std::vector bindings({Vertex::GetBindingDescription(), GPUInstanceData::GetBindingDescription()});
+	const std::vector bindings({PackedVertex::GetBindingDescription(), GPUInstanceData::GetBindingDescription()});
 
 	std::vector<VkVertexInputAttributeDescription> attribs;
-	const auto vertexParticleAttribs = Vertex::GetAttributeDescriptionForParticles();
+	const auto vertexParticleAttribs = PackedVertex::GetAttributeDescriptionForParticles();
 	const auto instanceDataAttribs	 = GPUInstanceData::GetAttributeDescription();
 
 	for (auto &vertDesc : vertexParticleAttribs) attribs.push_back(vertDesc);
@@ -1394,7 +1955,7 @@ ERROR_CODE VulkanRenderer::CreateParticlePipeline() {
 	m_particlePipeline = new VulkanPipeline();
 	// Use the Custom Overload you wrote
 	m_particlePipeline->Initialize(ref_device, particleShader, m_particlePipelineLayout, m_swapChain->GetExtent(), desc,
-								   bindings, attribs);
+								   bindings, attribs, m_pipelineCache->GetHandle());
 
 	return ERROR_CODE::OK;
 }
@@ -1403,7 +1964,7 @@ ERROR_CODE VulkanRenderer::CreateVertexBuffer() {
 	m_vertexBuffer			 = new VulkanBuffer();
 	VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-	auto result = m_vertexBuffer->Initialize(ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(),
+	auto result = m_vertexBuffer->Initialize(ref_device->GetVkDevice(), m_memoryAllocator,
 											 MAX_VERTEX_BUFFER_SIZE,  // 50MB sabit boyut
 											 usage, VK_SHARING_MODE_EXCLUSIVE,
 											 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT  // GPU tarafında allocate ediyoruz
@@ -1424,8 +1985,8 @@ ERROR_CODE VulkanRenderer::CreateIndexBuffer() {
 	m_indexBuffer			 = new VulkanBuffer();
 	VkBufferUsageFlags usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-	auto result = m_indexBuffer->Initialize(ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(),
-											MAX_VERTEX_BUFFER_SIZE,	 // 50MB sabit boyut
+	auto result = m_indexBuffer->Initialize(ref_device->GetVkDevice(), m_memoryAllocator,
+											MAX_INDEX_BUFFER_SIZE,	// 50MB sabit boyut
 											usage, VK_SHARING_MODE_EXCLUSIVE,
 											VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT	 // GPU tarafında allocate ediyoruz
 	);
@@ -1449,26 +2010,14 @@ ERROR_CODE VulkanRenderer::CreateUniformBuffers(const uint32_t maxModelCount) {
 
 	VkDeviceSize globalSize = sizeof(CBPerPass);
 
-	// Calculate dynamic alignment for Object Buffer
-	VkPhysicalDeviceProperties properties{};
-	vkGetPhysicalDeviceProperties(ref_device->GetVkPhysicalDevice(), &properties);
-	VkDeviceSize minAlignment = properties.limits.minUniformBufferOffsetAlignment;
-
-	m_dynamicAlignment = sizeof(CBPerObject);
-
-	// Round up to the next multiple of minAlignment
-	if (minAlignment > 0) {
-		m_dynamicAlignment = (m_dynamicAlignment + minAlignment - 1) & ~(minAlignment - 1);
-	}
-
-	// Allocate enough size for MAX_OBJECTS (e.g., 10,000) * Aligned Size
-	VkDeviceSize objectBufferSize = m_dynamicAlignment * maxModelCount;
+	// One tightly packed CBPerObject per draw slot, instanced draws index it with gl_InstanceIndex.
+	VkDeviceSize objectBufferSize = sizeof(CBPerObject) * maxModelCount;
 
 	for (int i = 0; i < ref_renderConfig->maxFramesInFlight; i++) {
 		// 1. Create Global Buffer (Set 0)
 		m_perPassBuffers[i] = new VulkanBuffer();
 		ERROR_CODE result	= m_perPassBuffers[i]->Initialize(
-			  ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(), globalSize,
+			  ref_device->GetVkDevice(), m_memoryAllocator, globalSize,
 			  VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 			  VK_SHARING_MODE_EXCLUSIVE,												  // Standard mode
 			  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT  // Coherent = no need to Flush()
@@ -1484,8 +2033,8 @@ ERROR_CODE VulkanRenderer::CreateUniformBuffers(const uint32_t maxModelCount) {
 		// 2. Create Object Buffer (Set 1)
 		m_perObjectBuffers[i] = new VulkanBuffer();
 		result				  = m_perObjectBuffers[i]->Initialize(
-			   ref_device->GetVkDevice(), ref_device->GetVkPhysicalDevice(), objectBufferSize,
-			   VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE,
+			   ref_device->GetVkDevice(), m_memoryAllocator, objectBufferSize,
+			   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE,
 			   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 		if (result < ERROR_CODE::WARN_START) {
 			Utilities::SafeShutdown(m_perObjectBuffers[i]);
@@ -1496,30 +2045,75 @@ ERROR_CODE VulkanRenderer::CreateUniformBuffers(const uint32_t maxModelCount) {
 		m_perObjectBuffers[i]->Map();
 	}
 
+	// 3. Create Material Buffer (Set 2), shared by every frame. Records are only written when a material changes.
+	m_materialBuffer  = new VulkanBuffer();
+	ERROR_CODE result = m_materialBuffer->Initialize(
+		ref_device->GetVkDevice(), m_memoryAllocator, sizeof(GPUMaterial) * ref_renderConfig->maxMaterialCount,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	if (result < ERROR_CODE::WARN_START) {
+		Utilities::SafeShutdown(m_materialBuffer);
+		PE_LOG_FATAL("Vulkan failed to create material buffer!");
+		return result;
+	}
+
+	m_materialBuffer->Map();
+
+	// 4. Create Instance Index Buffer (Set 1), shared by every frame. Submitted draws are laid out in slot order, so
+	// instance i reads slot i.
+	m_instanceIndexBuffer = new VulkanBuffer();
+	result				  = m_instanceIndexBuffer->Initialize(
+		   ref_device->GetVkDevice(), m_memoryAllocator, sizeof(uint32_t) * maxModelCount,
+		   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE,
+		   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	if (result < ERROR_CODE::WARN_START) {
+		Utilities::SafeShutdown(m_instanceIndexBuffer);
+		PE_LOG_FATAL("Vulkan failed to create instance index buffer!");
+		return result;
+	}
+
+	std::vector<uint32_t> identity(maxModelCount);
+	std::iota(identity.begin(), identity.end(), 0u);
+	m_instanceIndexBuffer->Map();
+	m_instanceIndexBuffer->WriteToMapped(identity.data(), identity.size() * sizeof(uint32_t));
+
 	return ERROR_CODE::OK;
 }
 
 ERROR_CODE VulkanRenderer::CreateDescriptorPool() {
 	uint32_t maxFrames = static_cast<uint32_t>(ref_renderConfig->maxFramesInFlight);
-	// Arbitrary limit for materials (e.g., 1000 materials)
-	uint32_t maxMaterials = ref_renderConfig->maxMaterialCount;
 
-	std::vector<VkDescriptorPoolSize> poolSizes = {
-		{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxFrames + maxMaterials},
-		{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, maxFrames},
-		{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (maxMaterials * 8) + maxFrames}};
+	std::vector<VkDescriptorPoolSize> poolSizes = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxFrames},
+												   {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxFrames * 2},
+												   {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxFrames}};
 
 	VkDescriptorPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes	   = poolSizes.data();
-	// Max Sets = Frames (Set 0) + Frames (Set 1) + Materials (Set 2)
-	poolInfo.maxSets = (maxFrames * 2) + maxMaterials + 50;
+	// Max Sets = Frames (Set 0) + Frames (Set 1)
+	poolInfo.maxSets = maxFrames * 2;
 
 	if (vkCreateDescriptorPool(ref_device->GetVkDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
 		PE_LOG_FATAL("Vulkan failed to create Descriptor Pool!");
 		return ERROR_CODE::VULKAN_DEVICE_CREATION_FAILED;
 	}
 
+	// The bindless set (Set 2) needs a pool of its own, update after bind sets can't share one with the others.
+	std::array<VkDescriptorPoolSize, 2> bindlessSizes = {{{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+														  {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+														   m_bindlessTextureCapacity}}};
+
+	VkDescriptorPoolCreateInfo bindlessInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	bindlessInfo.flags		   = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	bindlessInfo.poolSizeCount = static_cast<uint32_t>(bindlessSizes.size());
+	bindlessInfo.pPoolSizes	   = bindlessSizes.data();
+	bindlessInfo.maxSets	   = 1;
+
+	if (vkCreateDescriptorPool(ref_device->GetVkDevice(), &bindlessInfo, nullptr, &m_bindlessPool) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create bindless Descriptor Pool!");
+		return ERROR_CODE::VULKAN_DEVICE_CREATION_FAILED;
+	}
+
 	return ERROR_CODE::OK;
 }
 
@@ -1580,7 +2174,7 @@ ERROR_CODE VulkanRenderer::CreateDescriptorSets() {
 		vkUpdateDescriptorSets(device, 2, passWrites.data(), 0, nullptr);
 
 		// =============================================================
-		// 3. ALLOCATE SET 1 (Per Object - Dynamic)
+		// 3. ALLOCATE SET 1 (Per Object - Instances)
 		// =============================================================
 		VkDescriptorSetAllocateInfo objAllocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
 		objAllocInfo.descriptorPool		= m_descriptorPool;
@@ -1595,26 +2189,56 @@ ERROR_CODE VulkanRenderer::CreateDescriptorSets() {
 		// =============================================================
 		// 4. WRITE TO SET 1
 		// =============================================================
-		// Note: For Dynamic Buffers, we point to the BASE of the buffer (offset 0).
-		// The 'range' is the size of ONE instance of the struct (aligned is safer, but sizeof works usually).
-		// The dynamic offset applied in vkCmdBindDescriptorSets will shift this window.
-		VkDescriptorBufferInfo perObjBufferInfo{};
-		perObjBufferInfo.buffer = m_perObjectBuffers[i]->GetBuffer();
-		perObjBufferInfo.offset = 0;
-		perObjBufferInfo.range	= m_dynamicAlignment;
-
-		VkWriteDescriptorSet objWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-		objWrite.dstSet			 = m_perObjectDescriptorSets[i];
-		objWrite.dstBinding		 = 0;
-		objWrite.dstArrayElement = 0;
-		// CRITICAL: Must match layout (DYNAMIC)
-		objWrite.descriptorType	 = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-		objWrite.descriptorCount = 1;
-		objWrite.pBufferInfo	 = &perObjBufferInfo;
-
-		vkUpdateDescriptorSets(device, 1, &objWrite, 0, nullptr);
+		// Note: The whole buffer is bound once per frame, draws select their objects through firstInstance.
+		// The identity indices at binding 1 are shared by every frame.
+		const std::array<VkDescriptorBufferInfo, 2> perObjBufferInfos{{
+			{m_perObjectBuffers[i]->GetBuffer(), 0, VK_WHOLE_SIZE},
+			{m_instanceIndexBuffer->GetBuffer(), 0, VK_WHOLE_SIZE},
+		}};
+
+		std::array<VkWriteDescriptorSet, 2> objWrites{};
+		for (uint32_t binding = 0; binding < objWrites.size(); ++binding) {
+			objWrites[binding].sType		   = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			objWrites[binding].dstSet		   = m_perObjectDescriptorSets[i];
+			objWrites[binding].dstBinding	   = binding;
+			objWrites[binding].dstArrayElement = 0;
+			// CRITICAL: Must match layout (STORAGE)
+			objWrites[binding].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			objWrites[binding].descriptorCount = 1;
+			objWrites[binding].pBufferInfo	   = &perObjBufferInfos[binding];
+		}
+
+		vkUpdateDescriptorSets(device, 2, objWrites.data(), 0, nullptr);
+	}
+
+	// =============================================================
+	// 5. ALLOCATE AND WRITE SET 2 (Bindless Materials + Textures)
+	// =============================================================
+	// Note: Texture slots are written by GetBindlessSlot as materials and particles first sample them.
+	VkDescriptorSetAllocateInfo bindlessAllocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+	bindlessAllocInfo.descriptorPool	 = m_bindlessPool;
+	bindlessAllocInfo.descriptorSetCount = 1;
+	bindlessAllocInfo.pSetLayouts		 = &m_bindlessSetLayout;
+
+	if (vkAllocateDescriptorSets(device, &bindlessAllocInfo, &m_bindlessSet) != VK_SUCCESS) {
+		PE_LOG_FATAL("Failed to allocate Bindless Descriptor Set!");
+		return ERROR_CODE::VULKAN_PIPELINE_CREATION_FAILED;
 	}
 
+	VkDescriptorBufferInfo materialBufferInfo{};
+	materialBufferInfo.buffer = m_materialBuffer->GetBuffer();
+	materialBufferInfo.offset = 0;
+	materialBufferInfo.range  = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet materialWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+	materialWrite.dstSet		  = m_bindlessSet;
+	materialWrite.dstBinding	  = 0;
+	materialWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	materialWrite.descriptorCount = 1;
+	materialWrite.pBufferInfo	  = &materialBufferInfo;
+
+	vkUpdateDescriptorSets(device, 1, &materialWrite, 0, nullptr);
+
 	return ERROR_CODE::OK;
 }
 
@@ -1665,100 +2289,23 @@ void VulkanRenderer::CreateImage(VulkanTextureWrapper &tW, const VkImageTiling t
 		PE_LOG_FATAL("Failed to create image!");
 	}
 
-	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(ref_device->GetVkDevice(), tW.image, &memRequirements);
-
-	VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-	allocInfo.allocationSize  = memRequirements.size;
-	allocInfo.memoryTypeIndex = ref_device->FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-	if (vkAllocateMemory(ref_device->GetVkDevice(), &allocInfo, nullptr, &tW.memory) != VK_SUCCESS) {
+	if (m_memoryAllocator->AllocateForImage(tW.image, tiling, properties, tW.allocation) < ERROR_CODE::WARN_START) {
 		PE_LOG_FATAL("Failed to allocate image memory!");
 	}
-
-	vkBindImageMemory(ref_device->GetVkDevice(), tW.image, tW.memory, 0);
-}
-
-void VulkanRenderer::TransitionImageLayout(const VkImage image, const VkImageLayout oldLayout,
-										   const VkImageLayout newLayout, const uint32_t layerCount) {
-	const VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
-	VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-	barrier.oldLayout						= oldLayout;
-	barrier.newLayout						= newLayout;
-	barrier.srcQueueFamilyIndex				= VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex				= VK_QUEUE_FAMILY_IGNORED;
-	barrier.image							= image;
-	barrier.subresourceRange.aspectMask		= VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseMipLevel	= 0;
-	barrier.subresourceRange.levelCount		= 1;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount		= layerCount;
-
-	VkPipelineStageFlags sourceStage;
-	VkPipelineStageFlags destinationStage;
-
-	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-		barrier.srcAccessMask = 0;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		sourceStage			  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-		destinationStage	  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-	} else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-			   newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-		sourceStage			  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		destinationStage	  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-	} else {
-		PE_LOG_WARN("Unsupported layout transition!");
-		EndSingleTimeCommands(commandBuffer);
-		return;
-	}
-
-	vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-	EndSingleTimeCommands(commandBuffer);
-}
-
-void VulkanRenderer::CopyBufferToImage(const VkBuffer buffer, const VkImage image, const uint32_t width,
-									   const uint32_t height, const uint32_t layerCount) {
-	const VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
-	std::vector<VkBufferImageCopy> regions;
-	regions.reserve(layerCount);
-
-	const VkDeviceSize faceSize = static_cast<VkDeviceSize>(width) * height * 4;
-
-	for (uint32_t i = 0; i < layerCount; ++i) {
-		VkBufferImageCopy region{};
-		region.bufferOffset					   = i * faceSize;
-		region.bufferRowLength				   = 0;
-		region.bufferImageHeight			   = 0;
-		region.imageSubresource.aspectMask	   = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel	   = 0;
-		region.imageSubresource.baseArrayLayer = i;
-		region.imageSubresource.layerCount	   = 1;
-		region.imageOffset					   = {0, 0, 0};
-		region.imageExtent					   = {width, height, 1};
-		regions.push_back(region);
-	}
-	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-						   static_cast<uint32_t>(regions.size()), regions.data());
-
-	EndSingleTimeCommands(commandBuffer);
 }
 
 VkImageView VulkanRenderer::CreateImageView(const VkImage image, const VkFormat format,
 											const VkImageAspectFlags aspectFlags, const VkImageViewType viewType,
-											const uint32_t layerCount) const {
+											const uint32_t layerCount, const uint32_t mipLevels,
+											const uint32_t baseLayer) const {
 	VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
 	viewInfo.image							 = image;
 	viewInfo.viewType						 = viewType;
 	viewInfo.format							 = format;
 	viewInfo.subresourceRange.aspectMask	 = aspectFlags;
 	viewInfo.subresourceRange.baseMipLevel	 = 0;
-	viewInfo.subresourceRange.levelCount	 = 1;
-	viewInfo.subresourceRange.baseArrayLayer = 0;
+	viewInfo.subresourceRange.levelCount	 = mipLevels;
+	viewInfo.subresourceRange.baseArrayLayer = baseLayer;
 	viewInfo.subresourceRange.layerCount	 = layerCount;
 
 	VkImageView imageView;
@@ -1784,33 +2331,4 @@ void VulkanRenderer::RecreateSwapchain(int width, int height) {
 		}
 	}
 }
-
-VkCommandBuffer VulkanRenderer::BeginSingleTimeCommands() {
-	VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-	allocInfo.level				 = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocInfo.commandPool		 = m_command->GetCommandPool();
-	allocInfo.commandBufferCount = 1;
-
-	VkCommandBuffer commandBuffer;
-	vkAllocateCommandBuffers(ref_device->GetVkDevice(), &allocInfo, &commandBuffer);
-
-	VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-	vkBeginCommandBuffer(commandBuffer, &beginInfo);
-	return commandBuffer;
-}
-
-void VulkanRenderer::EndSingleTimeCommands(VkCommandBuffer commandBuffer) {
-	vkEndCommandBuffer(commandBuffer);
-
-	VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers	  = &commandBuffer;
-
-	vkQueueSubmit(ref_device->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-	vkQueueWaitIdle(ref_device->GetGraphicsQueue());
-
-	vkFreeCommandBuffers(ref_device->GetVkDevice(), m_command->GetCommandPool(), 1, &commandBuffer);
-}
 }  // namespace PE::Graphics::Vulkan
\ No newline at end of file
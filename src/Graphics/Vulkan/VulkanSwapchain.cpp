@@ -11,16 +11,22 @@
 #include "Utilities/Logger.h"
 
 namespace PE::Graphics::Vulkan {
-ERROR_CODE VulkanSwapchain::Initialize(GLFWwindow *windowHandle, VulkanDevice *vulkanDevice, float width,
-									   float height) {
+ERROR_CODE VulkanSwapchain::Initialize(GLFWwindow *windowHandle, VulkanDevice *vulkanDevice,
+									   VulkanMemoryAllocator *allocator, float width, float height,
+									   const uint32_t imageCount) {
 	PE_CHECK_STATE_INIT(m_state, "Vulkan swapchain is already initialized.");
 	m_state = SystemState::Initializing;
 
-	ref_window		 = windowHandle;
-	ref_vulkanDevice = vulkanDevice;
+	ref_window			  = windowHandle;
+	ref_vulkanDevice	  = vulkanDevice;
+	ref_allocator		  = allocator;
+	m_offscreenImageCount = imageCount;
 
 	ERROR_CODE result;
-	PE_ENSURE_INIT_SILENT(result, CreateSwapchain(width, height));
+	if (IsOffscreen())
+		PE_ENSURE_INIT_SILENT(result, CreateOffscreenImages(width, height));
+	else
+		PE_ENSURE_INIT_SILENT(result, CreateSwapchain(width, height));
 	PE_ENSURE_INIT_SILENT(result, CreateImageViews());
 
 	m_state = SystemState::Running;
@@ -33,6 +39,7 @@ void VulkanSwapchain::Shutdown() {
 
 	for (const auto iv : m_swapChainImageViews) vkDestroyImageView(ref_vulkanDevice->GetVkDevice(), iv, nullptr);
 	if (m_vkSwapchain) vkDestroySwapchainKHR(ref_vulkanDevice->GetVkDevice(), m_vkSwapchain, nullptr);
+	DestroyOffscreenImages();
 
 	m_swapChainImageViews.clear();
 	m_swapChainImages.clear();
@@ -41,11 +48,20 @@ void VulkanSwapchain::Shutdown() {
 }
 
 VkResult VulkanSwapchain::AcquireNextImage(VkSemaphore imageAvailableSemaphore, uint32_t &outImageIndex) {
+	// Nothing signals the semaphore here, the renderer doesn't wait on it for offscreen images.
+	if (IsOffscreen()) {
+		outImageIndex		 = m_nextOffscreenImage;
+		m_nextOffscreenImage = (m_nextOffscreenImage + 1) % m_offscreenImageCount;
+		return VK_SUCCESS;
+	}
+
 	return vkAcquireNextImageKHR(ref_vulkanDevice->GetVkDevice(), m_vkSwapchain, UINT64_MAX, imageAvailableSemaphore,
 								 VK_NULL_HANDLE, &outImageIndex);
 }
 
 VkResult VulkanSwapchain::Present(VkSemaphore renderFinishedSemaphore, uint32_t imageIndex) {
+	if (IsOffscreen()) return VK_SUCCESS;
+
 	VkSwapchainKHR	 swapChains[] = {m_vkSwapchain};
 	VkPresentInfoKHR presentInfo  = {
 		 .sType				 = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -64,8 +80,16 @@ void VulkanSwapchain::Recreate(int width, int height) {
 	for (const auto iv : m_swapChainImageViews) vkDestroyImageView(ref_vulkanDevice->GetVkDevice(), iv, nullptr);
 
 	m_swapChainImageViews.clear();
+	DestroyOffscreenImages();
 	m_swapChainImages.clear();
 
+	if (IsOffscreen()) {
+		if (CreateOffscreenImages(width, height) < ERROR_CODE::WARN_START)
+			PE_LOG_FATAL("Vulkan can't recreate offscreen images!");
+		CreateImageViews();
+		return;
+	}
+
 	VkSwapchainKHR oldSwapchain = m_vkSwapchain;
 	ERROR_CODE	   result		= CreateSwapchain(width, height, oldSwapchain);
 	if (result < ERROR_CODE::WARN_START) PE_LOG_FATAL("Vulkan can't recreate swapchain!");
@@ -132,6 +156,57 @@ ERROR_CODE VulkanSwapchain::CreateSwapchain(const float width, const float heigh
 	return ERROR_CODE::OK;
 }
 
+ERROR_CODE VulkanSwapchain::CreateOffscreenImages(const float width, const float height) {
+	// The format a window surface is asked for first, so pipelines and output match windowed runs.
+	m_swapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+	m_swapChainExtent	   = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+	m_nextOffscreenImage   = 0;
+
+	m_swapChainImages.resize(m_offscreenImageCount, VK_NULL_HANDLE);
+	m_offscreenAllocations.resize(m_offscreenImageCount);
+	for (uint32_t i = 0; i < m_offscreenImageCount; i++) {
+		VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		imageInfo.imageType		= VK_IMAGE_TYPE_2D;
+		imageInfo.extent		= {m_swapChainExtent.width, m_swapChainExtent.height, 1};
+		imageInfo.mipLevels		= 1;
+		imageInfo.arrayLayers	= 1;
+		imageInfo.format		= m_swapChainImageFormat;
+		imageInfo.tiling		= VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage			= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageInfo.samples		= VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateImage(ref_vulkanDevice->GetVkDevice(), &imageInfo, nullptr, &m_swapChainImages[i]) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to create offscreen image!");
+			return ERROR_CODE::VULKAN_SWAPCHAIN_CREATION_FAILED;
+		}
+		if (ref_allocator->AllocateForImage(m_swapChainImages[i], VK_IMAGE_TILING_OPTIMAL,
+											VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+											m_offscreenAllocations[i]) < ERROR_CODE::WARN_START) {
+			PE_LOG_FATAL("Vulkan failed to allocate offscreen image memory!");
+			return ERROR_CODE::VULKAN_MEMORY_ALLOCATION_FAILED;
+		}
+	}
+
+	return ERROR_CODE::OK;
+}
+
+void VulkanSwapchain::DestroyOffscreenImages() {
+	if (!IsOffscreen()) return;
+
+	for (const auto image : m_swapChainImages)
+		if (image != VK_NULL_HANDLE) vkDestroyImage(ref_vulkanDevice->GetVkDevice(), image, nullptr);
+	for (auto &allocation : m_offscreenAllocations) ref_allocator->Free(allocation);
+
+	m_swapChainImages.clear();
+	m_offscreenAllocations.clear();
+}
+
+VkImageLayout VulkanSwapchain::GetFinalLayout() const {
+	return IsOffscreen() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 ERROR_CODE VulkanSwapchain::CreateImageViews() {
 	m_swapChainImageViews.resize(m_swapChainImages.size());
 	for (size_t i = 0; i < m_swapChainImages.size(); i++) {
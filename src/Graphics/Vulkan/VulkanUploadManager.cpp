@@ -0,0 +1,399 @@
+#include "Graphics/Vulkan/VulkanUploadManager.h"
+
+#include <cstring>
+
+#include "Graphics/Vulkan/VulkanDevice.h"
+#include "Utilities/Logger.h"
+
+namespace PE::Graphics::Vulkan {
+ERROR_CODE VulkanUploadManager::Initialize(VulkanDevice *device, VulkanMemoryAllocator *allocator,
+										   const VkDeviceSize ringSize) {
+	PE_CHECK_STATE_INIT(m_state, "Vulkan upload manager is already initialized.");
+	m_state = SystemState::Initializing;
+
+	ref_vkDevice	 = device->GetVkDevice();
+	ref_allocator	 = allocator;
+	m_queue			 = device->GetTransferQueue();
+	m_transferFamily = device->GetQueueFamilies().transferFamily.value();
+	m_graphicsFamily = device->GetQueueFamilies().graphicsFamily.value();
+	m_ringSize		 = ringSize & ~(STAGING_ALIGNMENT - 1);
+
+	ERROR_CODE result;
+	PE_ENSURE_INIT_SILENT(
+		result, m_ring.Initialize(ref_vkDevice, allocator, m_ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+								  VK_SHARING_MODE_EXCLUSIVE,
+								  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+	PE_ENSURE_INIT_SILENT(result, m_ring.Map());
+	m_ringData = static_cast<uint8_t *>(m_ring.GetMappedData());
+
+	VkSemaphoreTypeCreateInfo timelineInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+	timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timelineInfo.initialValue  = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	semaphoreInfo.pNext = &timelineInfo;
+
+	if (vkCreateSemaphore(ref_vkDevice, &semaphoreInfo, nullptr, &m_timeline) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to create the upload timeline semaphore!");
+		Shutdown();
+		return ERROR_CODE::VULKAN_SYNCOBJECTS_CREATION_FAILED;
+	}
+
+	// Command buffers are recorded once per batch, the whole pool is reset when the batch is reused.
+	VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+	poolInfo.flags			  = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = m_transferFamily;
+
+	for (Batch &batch : m_batches) {
+		if (vkCreateCommandPool(ref_vkDevice, &poolInfo, nullptr, &batch.pool) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to create upload command pool!");
+			Shutdown();
+			return ERROR_CODE::VULKAN_COMMAND_CREATION_FAILED;
+		}
+
+		VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		allocInfo.commandPool		 = batch.pool;
+		allocInfo.level				 = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(ref_vkDevice, &allocInfo, &batch.cmd) != VK_SUCCESS) {
+			PE_LOG_FATAL("Vulkan failed to allocate upload command buffer!");
+			Shutdown();
+			return ERROR_CODE::VULKAN_COMMAND_CREATION_FAILED;
+		}
+	}
+
+	PE_LOG_INFO("Vulkan uploads use queue family " + std::to_string(m_transferFamily) +
+				(IsSameFamily() ? " (graphics)." : " (transfer)."));
+	m_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+void VulkanUploadManager::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return;
+	m_state = SystemState::ShuttingDown;
+
+	for (Batch &batch : m_batches) {
+		if (batch.inFlight) WaitForBatch(batch);
+		for (VulkanBuffer &staging : batch.oversized) staging.Shutdown();
+		// Destroying the pool frees its command buffer as well.
+		if (batch.pool != VK_NULL_HANDLE) vkDestroyCommandPool(ref_vkDevice, batch.pool, nullptr);
+		batch = {};
+	}
+	m_bufferAcquires.clear();
+	m_imageAcquires.clear();
+
+	if (m_timeline != VK_NULL_HANDLE) vkDestroySemaphore(ref_vkDevice, m_timeline, nullptr);
+	m_timeline = VK_NULL_HANDLE;
+
+	m_ring.Shutdown();
+	m_ringData	= nullptr;
+	m_ringHead	= 0;
+	m_ringTail	= 0;
+	m_nextValue = 1;
+	m_current	= 0;
+
+	m_state = SystemState::Uninitialized;
+}
+
+ERROR_CODE VulkanUploadManager::UploadBuffer(const VkBuffer buffer, const VkDeviceSize dstOffset, const void *data,
+											 const VkDeviceSize size, const VkPipelineStageFlags2 dstStage,
+											 const VkAccessFlags2 dstAccess, uint64_t &outUploadValue) {
+	std::lock_guard lock(m_mutex);
+
+	VkBuffer	 srcBuffer = VK_NULL_HANDLE;
+	VkDeviceSize srcOffset = 0;
+	ERROR_CODE	 result;
+	PE_CHECK(result, Stage(data, size, srcBuffer, srcOffset));
+
+	Batch *batch = GetOpenBatch();
+	if (!batch) return ERROR_CODE::VULKAN_UPLOAD_FAILED;
+
+	const VkBufferCopy region{srcOffset, dstOffset, size};
+	vkCmdCopyBuffer(batch->cmd, srcBuffer, buffer, 1, &region);
+
+	// With a single family the graphics queue's wait on the timeline makes the copy visible, nothing to transfer.
+	if (!IsSameFamily()) {
+		VkBufferMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2};
+		barrier.srcStageMask		= VK_PIPELINE_STAGE_2_COPY_BIT;
+		barrier.srcAccessMask		= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		barrier.dstStageMask		= VK_PIPELINE_STAGE_2_NONE;
+		barrier.dstAccessMask		= VK_ACCESS_2_NONE;
+		barrier.srcQueueFamilyIndex = m_transferFamily;
+		barrier.dstQueueFamilyIndex = m_graphicsFamily;
+		barrier.buffer				= buffer;
+		barrier.offset				= dstOffset;
+		barrier.size				= size;
+		batch->bufferReleases.push_back(barrier);
+
+		barrier.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+		barrier.srcAccessMask = VK_ACCESS_2_NONE;
+		barrier.dstStageMask  = dstStage;
+		barrier.dstAccessMask = dstAccess;
+		m_bufferAcquires.emplace_back(m_nextValue, barrier);
+	}
+
+	outUploadValue = m_nextValue;
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanUploadManager::UploadImage(const VkImage image, const uint32_t mipLevels, const uint32_t layerCount,
+											const std::span<const VkBufferImageCopy> regions, const void *data,
+											const VkDeviceSize size, uint64_t &outUploadValue) {
+	std::lock_guard lock(m_mutex);
+
+	VkBuffer	 srcBuffer = VK_NULL_HANDLE;
+	VkDeviceSize srcOffset = 0;
+	ERROR_CODE	 result;
+	PE_CHECK(result, Stage(data, size, srcBuffer, srcOffset));
+
+	Batch *batch = GetOpenBatch();
+	if (!batch) return ERROR_CODE::VULKAN_UPLOAD_FAILED;
+
+	VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+	barrier.srcStageMask		= VK_PIPELINE_STAGE_2_NONE;
+	barrier.srcAccessMask		= VK_ACCESS_2_NONE;
+	barrier.dstStageMask		= VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.dstAccessMask		= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.oldLayout			= VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout			= VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image				= image;
+	barrier.subresourceRange	= {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, layerCount};
+
+	VkDependencyInfo dependency{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+	dependency.imageMemoryBarrierCount = 1;
+	dependency.pImageMemoryBarriers	   = &barrier;
+	vkCmdPipelineBarrier2(batch->cmd, &dependency);
+
+	std::vector<VkBufferImageCopy> stagedRegions(regions.begin(), regions.end());
+	for (VkBufferImageCopy &region : stagedRegions) region.bufferOffset += srcOffset;
+	vkCmdCopyBufferToImage(batch->cmd, srcBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+						   static_cast<uint32_t>(stagedRegions.size()), stagedRegions.data());
+
+	// The layout change to SHADER_READ_ONLY_OPTIMAL rides on the release, and on the acquire with the same layouts.
+	barrier.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask  = VK_PIPELINE_STAGE_2_NONE;
+	barrier.dstAccessMask = VK_ACCESS_2_NONE;
+	barrier.oldLayout	  = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout	  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	if (!IsSameFamily()) {
+		barrier.srcQueueFamilyIndex = m_transferFamily;
+		barrier.dstQueueFamilyIndex = m_graphicsFamily;
+	}
+	batch->imageReleases.push_back(barrier);
+
+	if (!IsSameFamily()) {
+		barrier.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+		barrier.srcAccessMask = VK_ACCESS_2_NONE;
+		barrier.dstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+		barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+		m_imageAcquires.emplace_back(m_nextValue, barrier);
+	}
+
+	outUploadValue = m_nextValue;
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE VulkanUploadManager::Submit() {
+	std::lock_guard lock(m_mutex);
+	RetireCompletedBatches();
+	return SubmitBatch();
+}
+
+uint64_t VulkanUploadManager::GetCompletedValue() const {
+	uint64_t value = 0;
+	vkGetSemaphoreCounterValue(ref_vkDevice, m_timeline, &value);
+	return value;
+}
+
+void VulkanUploadManager::RecordAcquireBarriers(VkCommandBuffer cmd, const uint64_t uploadValue) {
+	std::lock_guard lock(m_mutex);
+	if (IsSameFamily()) return;
+
+	std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+	std::vector<VkImageMemoryBarrier2>	imageBarriers;
+
+	// Pending acquires are in upload order, the ones up to uploadValue move out and the rest stays.
+	auto take = [uploadValue](auto &pending, auto &outBarriers) {
+		size_t kept = 0;
+		for (size_t i = 0; i < pending.size(); ++i) {
+			if (pending[i].first <= uploadValue)
+				outBarriers.push_back(pending[i].second);
+			else
+				pending[kept++] = pending[i];
+		}
+		pending.resize(kept);
+	};
+	take(m_bufferAcquires, bufferBarriers);
+	take(m_imageAcquires, imageBarriers);
+	if (bufferBarriers.empty() && imageBarriers.empty()) return;
+
+	VkDependencyInfo dependency{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+	dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+	dependency.pBufferMemoryBarriers	= bufferBarriers.data();
+	dependency.imageMemoryBarrierCount	= static_cast<uint32_t>(imageBarriers.size());
+	dependency.pImageMemoryBarriers		= imageBarriers.data();
+	vkCmdPipelineBarrier2(cmd, &dependency);
+}
+
+ERROR_CODE VulkanUploadManager::SubmitBatch() {
+	Batch &batch = m_batches[m_current];
+	if (!batch.recording) return ERROR_CODE::OK;
+
+	if (!batch.bufferReleases.empty() || !batch.imageReleases.empty()) {
+		VkDependencyInfo dependency{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+		dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(batch.bufferReleases.size());
+		dependency.pBufferMemoryBarriers	= batch.bufferReleases.data();
+		dependency.imageMemoryBarrierCount	= static_cast<uint32_t>(batch.imageReleases.size());
+		dependency.pImageMemoryBarriers		= batch.imageReleases.data();
+		vkCmdPipelineBarrier2(batch.cmd, &dependency);
+		batch.bufferReleases.clear();
+		batch.imageReleases.clear();
+	}
+
+	batch.recording = false;
+	batch.inFlight	= true;
+	batch.value		= m_nextValue++;
+	batch.ringEnd	= m_ringHead;
+	m_current		= (m_current + 1) % MAX_BATCHES;
+
+	VkCommandBufferSubmitInfo cmdInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
+	cmdInfo.commandBuffer = batch.cmd;
+
+	VkSemaphoreSubmitInfo signalInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
+	signalInfo.semaphore = m_timeline;
+	signalInfo.value	 = batch.value;
+	signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+	VkSubmitInfo2 submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
+	submitInfo.commandBufferInfoCount	= 1;
+	submitInfo.pCommandBufferInfos		= &cmdInfo;
+	submitInfo.signalSemaphoreInfoCount = 1;
+	submitInfo.pSignalSemaphoreInfos	= &signalInfo;
+
+	if (vkEndCommandBuffer(batch.cmd) != VK_SUCCESS ||
+		vkQueueSubmit2(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		PE_LOG_FATAL("Vulkan failed to submit an upload batch!");
+		// Signal from the host so nothing waits for the lost batch forever, its resources stay undefined.
+		VkSemaphoreSignalInfo hostSignal{VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO};
+		hostSignal.semaphore = m_timeline;
+		hostSignal.value	 = batch.value;
+		vkSignalSemaphore(ref_vkDevice, &hostSignal);
+		return ERROR_CODE::VULKAN_UPLOAD_FAILED;
+	}
+	return ERROR_CODE::OK;
+}
+
+VulkanUploadManager::Batch *VulkanUploadManager::GetOpenBatch() {
+	Batch &batch = m_batches[m_current];
+	if (batch.recording) return &batch;
+
+	// The slot after the last submitted batch holds the oldest one, it has to be done before it is recorded again.
+	if (batch.inFlight) {
+		WaitForBatch(batch);
+		RetireBatch(batch);
+	}
+
+	vkResetCommandPool(ref_vkDevice, batch.pool, 0);
+
+	VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (vkBeginCommandBuffer(batch.cmd, &beginInfo) != VK_SUCCESS) {
+		PE_LOG_ERROR("Vulkan failed to begin an upload batch!");
+		return nullptr;
+	}
+
+	batch.recording = true;
+	return &batch;
+}
+
+ERROR_CODE VulkanUploadManager::Stage(const void *data, const VkDeviceSize size, VkBuffer &outBuffer,
+									  VkDeviceSize &outOffset) {
+	if (size > m_ringSize / 2) {
+		Batch *batch = GetOpenBatch();
+		if (!batch) return ERROR_CODE::VULKAN_UPLOAD_FAILED;
+
+		VulkanBuffer staging;
+		if (staging.Initialize(ref_vkDevice, ref_allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+							   VK_SHARING_MODE_EXCLUSIVE,
+							   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) <
+				ERROR_CODE::WARN_START ||
+			staging.Map() < ERROR_CODE::WARN_START) {
+			PE_LOG_ERROR("Vulkan failed to create staging buffer for a " + std::to_string(size) + " byte upload!");
+			staging.Shutdown();
+			return ERROR_CODE::VULKAN_UPLOAD_FAILED;
+		}
+
+		memcpy(staging.GetMappedData(), data, size);
+		outBuffer = staging.GetBuffer();
+		outOffset = 0;
+		batch->oversized.push_back(std::move(staging));
+		return ERROR_CODE::OK;
+	}
+
+	RetireCompletedBatches();
+
+	// m_ringHead and m_ringTail only grow, the ring offset of a position is position % m_ringSize.
+	for (;;) {
+		VkDeviceSize offset = (m_ringHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+		// Ranges never wrap, what is left at the end of the ring is skipped instead.
+		if (offset % m_ringSize + size > m_ringSize) offset += m_ringSize - offset % m_ringSize;
+
+		if (offset + size - m_ringTail <= m_ringSize) {
+			m_ringHead = offset + size;
+			outBuffer  = m_ring.GetBuffer();
+			outOffset  = offset % m_ringSize;
+			memcpy(m_ringData + outOffset, data, size);
+			return ERROR_CODE::OK;
+		}
+
+		// Out of space. The oldest batch in flight frees some once it is done, if the open batch holds the whole
+		// ring it has to be submitted first.
+		Batch *oldest = nullptr;
+		for (uint32_t i = 0; i < MAX_BATCHES && !oldest; ++i) {
+			Batch &batch = m_batches[(m_current + i) % MAX_BATCHES];
+			if (batch.inFlight) oldest = &batch;
+		}
+
+		if (oldest) {
+			WaitForBatch(*oldest);
+			RetireBatch(*oldest);
+		} else if (m_batches[m_current].recording) {
+			ERROR_CODE result;
+			PE_CHECK(result, SubmitBatch());
+		} else {
+			m_ringTail = m_ringHead;
+		}
+	}
+}
+
+void VulkanUploadManager::WaitForBatch(const Batch &batch) const {
+	VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores	= &m_timeline;
+	waitInfo.pValues		= &batch.value;
+	vkWaitSemaphores(ref_vkDevice, &waitInfo, UINT64_MAX);
+}
+
+void VulkanUploadManager::RetireBatch(Batch &batch) {
+	for (VulkanBuffer &staging : batch.oversized) staging.Shutdown();
+	batch.oversized.clear();
+	batch.inFlight = false;
+	m_ringTail	   = batch.ringEnd;
+}
+
+void VulkanUploadManager::RetireCompletedBatches() {
+	const uint64_t completed = GetCompletedValue();
+
+	// Oldest first, the timeline signals batches in submission order.
+	for (uint32_t i = 0; i < MAX_BATCHES; ++i) {
+		Batch &batch = m_batches[(m_current + i) % MAX_BATCHES];
+		if (!batch.inFlight) continue;
+		if (batch.value > completed) break;
+		RetireBatch(batch);
+	}
+}
+}  // namespace PE::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "Math/Bounds.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PE_BOUNDS_SSE2
+#endif
+
+namespace PE::Math {
+Frustum ExtractFrustum(const Matrix4 &viewProjection) {
+	// Gribb-Hartmann on the rows of the column-major matrix. Clip z runs from 0 to w, so near is the third row alone.
+	const Matrix4 m = Transpose(viewProjection);
+
+	Frustum frustum;
+	frustum.planes[Frustum::Left]	= m[3] + m[0];
+	frustum.planes[Frustum::Right]	= m[3] - m[0];
+	frustum.planes[Frustum::Bottom] = m[3] + m[1];
+	frustum.planes[Frustum::Top]	= m[3] - m[1];
+	frustum.planes[Frustum::Near]	= m[2];
+	frustum.planes[Frustum::Far]	= m[3] - m[2];
+
+	for (Vector4 &plane : frustum.planes) plane /= Length(Vector3(plane));
+	return frustum;
+}
+
+size_t CullSpheres(const Frustum &frustum, const float *centerX, const float *centerY, const float *centerZ,
+				   const float *radius, const size_t count, uint8_t *visible) {
+	size_t visibleCount = 0;
+	size_t i			= 0;
+
+#ifdef PE_BOUNDS_SSE2
+	for (; i + 4 <= count; i += 4) {
+		const __m128 x		   = _mm_loadu_ps(centerX + i);
+		const __m128 y		   = _mm_loadu_ps(centerY + i);
+		const __m128 z		   = _mm_loadu_ps(centerZ + i);
+		const __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(radius + i), _mm_set1_ps(-0.0f));
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Vector4 &plane : frustum.planes) {
+			__m128 distance = _mm_mul_ps(x, _mm_set1_ps(plane.x));
+			distance		= _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+			distance		= _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+			distance		= _mm_add_ps(distance, _mm_set1_ps(plane.w));
+			inside			= _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; ++lane) {
+			visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			visibleCount += visible[i + lane];
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		bool inside = true;
+		for (const Vector4 &plane : frustum.planes)
+			inside &= plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w >= -radius[i];
+
+		visible[i] = static_cast<uint8_t>(inside);
+		visibleCount += visible[i];
+	}
+
+	return visibleCount;
+}
+}  // namespace PE::Math
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "Math/TransformBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PE_TRANSFORM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PE_TRANSFORM_SSE2
+#endif
+
+namespace PE::Math {
+namespace {
+#if defined(PE_TRANSFORM_SSE2) || defined(PE_TRANSFORM_AVX2)
+// Turns four column loads of lanes 0-3 into four row registers, and back.
+inline void Transpose4(__m128 &a, __m128 &b, __m128 &c, __m128 &d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+#endif
+
+// Each backend exposes the same handful of lane-wise operations, the kernel below is written once against them.
+#if defined(PE_TRANSFORM_AVX2)
+struct Simd {
+	using Float					  = __m256;
+	using Int					  = __m256i;
+	static constexpr size_t WIDTH = 8;
+
+	static Float Set(const float v) { return _mm256_set1_ps(v); }
+	static Float Load(const float *p) { return _mm256_loadu_ps(p); }
+	static Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+	static Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+	static Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+	static Float Negate(const Float a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	static Int	 RoundToInt(const Float a) { return _mm256_cvtps_epi32(a); }
+	static Int	 AddInt(const Int a, const int b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+	static Float ToFloat(const Int a) { return _mm256_cvtepi32_ps(a); }
+	// All bits set in lanes where (a & bit) != 0.
+	static Float HasBit(const Int a, const int bit) {
+		const Int mask = _mm256_set1_epi32(bit);
+		return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, mask), mask));
+	}
+	static Float Select(const Float mask, const Float ifSet, const Float ifClear) {
+		return _mm256_blendv_ps(ifClear, ifSet, mask);
+	}
+
+	// Reads element [column][row] of 8 matrices into rows[column * 4 + row].
+	static void Gather(const Matrix4 *const *matrices, Float *rows) {
+		for (int column = 0; column < 4; ++column) {
+			__m128 lo[4], hi[4];
+			for (int lane = 0; lane < 4; ++lane) {
+				lo[lane] = _mm_loadu_ps(&(*matrices[lane])[column][0]);
+				hi[lane] = _mm_loadu_ps(&(*matrices[lane + 4])[column][0]);
+			}
+			Transpose4(lo[0], lo[1], lo[2], lo[3]);
+			Transpose4(hi[0], hi[1], hi[2], hi[3]);
+			for (int row = 0; row < 4; ++row) rows[column * 4 + row] = _mm256_set_m128(hi[row], lo[row]);
+		}
+	}
+
+	static void Scatter(const Float *rows, Matrix4 *const *matrices) {
+		for (int column = 0; column < 4; ++column) {
+			__m128 lo[4], hi[4];
+			for (int row = 0; row < 4; ++row) {
+				lo[row] = _mm256_castps256_ps128(rows[column * 4 + row]);
+				hi[row] = _mm256_extractf128_ps(rows[column * 4 + row], 1);
+			}
+			Transpose4(lo[0], lo[1], lo[2], lo[3]);
+			Transpose4(hi[0], hi[1], hi[2], hi[3]);
+			for (int lane = 0; lane < 4; ++lane) {
+				_mm_storeu_ps(&(*matrices[lane])[column][0], lo[lane]);
+				_mm_storeu_ps(&(*matrices[lane + 4])[column][0], hi[lane]);
+			}
+		}
+	}
+};
+#elif defined(PE_TRANSFORM_SSE2)
+struct Simd {
+	using Float					  = __m128;
+	using Int					  = __m128i;
+	static constexpr size_t WIDTH = 4;
+
+	static Float Set(const float v) { return _mm_set1_ps(v); }
+	static Float Load(const float *p) { return _mm_loadu_ps(p); }
+	static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+	static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+	static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+	static Float Negate(const Float a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+	static Int	 RoundToInt(const Float a) { return _mm_cvtps_epi32(a); }
+	static Int	 AddInt(const Int a, const int b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+	static Float ToFloat(const Int a) { return _mm_cvtepi32_ps(a); }
+	static Float HasBit(const Int a, const int bit) {
+		const Int mask = _mm_set1_epi32(bit);
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, mask), mask));
+	}
+	static Float Select(const Float mask, const Float ifSet, const Float ifClear) {
+		return _mm_or_ps(_mm_and_ps(mask, ifSet), _mm_andnot_ps(mask, ifClear));
+	}
+
+	static void Gather(const Matrix4 *const *matrices, Float *rows) {
+		for (int column = 0; column < 4; ++column) {
+			Float lanes[4];
+			for (int lane = 0; lane < 4; ++lane) lanes[lane] = _mm_loadu_ps(&(*matrices[lane])[column][0]);
+			Transpose4(lanes[0], lanes[1], lanes[2], lanes[3]);
+			for (int row = 0; row < 4; ++row) rows[column * 4 + row] = lanes[row];
+		}
+	}
+
+	static void Scatter(const Float *rows, Matrix4 *const *matrices) {
+		for (int column = 0; column < 4; ++column) {
+			Float lanes[4] = {rows[column * 4], rows[column * 4 + 1], rows[column * 4 + 2], rows[column * 4 + 3]};
+			Transpose4(lanes[0], lanes[1], lanes[2], lanes[3]);
+			for (int lane = 0; lane < 4; ++lane) _mm_storeu_ps(&(*matrices[lane])[column][0], lanes[lane]);
+		}
+	}
+};
+#else
+// One lane, for targets without SSE2. Same arithmetic as the vector backends.
+struct Simd {
+	using Float					  = float;
+	using Int					  = int32_t;
+	static constexpr size_t WIDTH = 1;
+
+	static Float Set(const float v) { return v; }
+	static Float Load(const float *p) { return *p; }
+	static Float Add(const Float a, const Float b) { return a + b; }
+	static Float Sub(const Float a, const Float b) { return a - b; }
+	static Float Mul(const Float a, const Float b) { return a * b; }
+	static Float Negate(const Float a) { return -a; }
+	static Int	 RoundToInt(const Float a) { return static_cast<Int>(std::nearbyint(a)); }
+	static Int	 AddInt(const Int a, const int b) { return a + b; }
+	static Float ToFloat(const Int a) { return static_cast<Float>(a); }
+	static Float HasBit(const Int a, const int bit) { return (a & bit) ? 1.0f : 0.0f; }
+	static Float Select(const Float mask, const Float ifSet, const Float ifClear) {
+		return mask != 0.0f ? ifSet : ifClear;
+	}
+
+	static void Gather(const Matrix4 *const *matrices, Float *rows) {
+		for (int column = 0; column < 4; ++column)
+			for (int row = 0; row < 4; ++row) rows[column * 4 + row] = (*matrices[0])[column][row];
+	}
+
+	static void Scatter(const Float *rows, Matrix4 *const *matrices) {
+		for (int column = 0; column < 4; ++column)
+			for (int row = 0; row < 4; ++row) (*matrices[0])[column][row] = rows[column * 4 + row];
+	}
+};
+#endif
+
+using Float = Simd::Float;
+
+// sin and cos together. The angle is reduced by multiples of pi/2 (split in three parts to keep the remainder
+// exact) and both minimax polynomials are evaluated on [-pi/4, pi/4], the quadrant then picks and signs them.
+void SinCos(const Float angle, Float &sinOut, Float &cosOut) {
+	const Simd::Int quadrant = Simd::RoundToInt(Simd::Mul(angle, Simd::Set(0.63661977236f)));  // 2 / pi
+	const Float		q		 = Simd::ToFloat(quadrant);
+
+	Float r = Simd::Sub(angle, Simd::Mul(q, Simd::Set(1.5703125f)));
+	r		= Simd::Sub(r, Simd::Mul(q, Simd::Set(4.837512969970703125e-4f)));
+	r		= Simd::Sub(r, Simd::Mul(q, Simd::Set(7.54978995489188216e-8f)));
+
+	const Float r2 = Simd::Mul(r, r);
+
+	Float sinPoly = Simd::Set(-1.9515295891e-4f);
+	sinPoly		  = Simd::Add(Simd::Mul(sinPoly, r2), Simd::Set(8.3321608736e-3f));
+	sinPoly		  = Simd::Add(Simd::Mul(sinPoly, r2), Simd::Set(-1.6666654611e-1f));
+	sinPoly		  = Simd::Add(Simd::Mul(Simd::Mul(sinPoly, r2), r), r);
+
+	Float cosPoly = Simd::Set(2.443315711809948e-5f);
+	cosPoly		  = Simd::Add(Simd::Mul(cosPoly, r2), Simd::Set(-1.388731625493765e-3f));
+	cosPoly		  = Simd::Add(Simd::Mul(cosPoly, r2), Simd::Set(4.166664568298827e-2f));
+	cosPoly		  = Simd::Mul(Simd::Mul(cosPoly, r2), r2);
+	cosPoly		  = Simd::Add(Simd::Sub(cosPoly, Simd::Mul(r2, Simd::Set(0.5f))), Simd::Set(1.0f));
+
+	// quadrant 0: (s, c)  1: (c, -s)  2: (-s, -c)  3: (-c, s)
+	const Float swap	= Simd::HasBit(quadrant, 1);
+	const Float sinBase = Simd::Select(swap, cosPoly, sinPoly);
+	const Float cosBase = Simd::Select(swap, sinPoly, cosPoly);
+	const Float negSin	= Simd::HasBit(quadrant, 2);
+	const Float negCos	= Simd::HasBit(Simd::AddInt(quadrant, 1), 2);
+	sinOut				= Simd::Select(negSin, Simd::Negate(sinBase), sinBase);
+	cosOut				= Simd::Select(negCos, Simd::Negate(cosBase), cosBase);
+}
+
+// Computes the Simd::WIDTH transforms whose TRS start at 'first', the matrix pointers are passed separately so the
+// padded tail can swap in its own.
+void ComputeGroup(const TransformBatch &batch, const size_t first, const Matrix4 *const *parents, Matrix4 *const *locals,
+				  Matrix4 *const *worlds) {
+	Float sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos(Simd::Load(&batch.rotationX[first]), sinX, cosX);
+	SinCos(Simd::Load(&batch.rotationY[first]), sinY, cosY);
+	SinCos(Simd::Load(&batch.rotationZ[first]), sinZ, cosZ);
+
+	// rotateY * rotateX * rotateZ, written out as rows
+	const Float sinYsinX = Simd::Mul(sinY, sinX);
+	const Float cosYsinX = Simd::Mul(cosY, sinX);
+	const Float r00		 = Simd::Add(Simd::Mul(cosY, cosZ), Simd::Mul(sinYsinX, sinZ));
+	const Float r01		 = Simd::Sub(Simd::Mul(sinYsinX, cosZ), Simd::Mul(cosY, sinZ));
+	const Float r02		 = Simd::Mul(sinY, cosX);
+	const Float r10		 = Simd::Mul(cosX, sinZ);
+	const Float r11		 = Simd::Mul(cosX, cosZ);
+	const Float r12		 = Simd::Negate(sinX);
+	const Float r20		 = Simd::Sub(Simd::Mul(cosYsinX, sinZ), Simd::Mul(sinY, cosZ));
+	const Float r21		 = Simd::Add(Simd::Mul(sinY, sinZ), Simd::Mul(cosYsinX, cosZ));
+	const Float r22		 = Simd::Mul(cosY, cosX);
+
+	const Float scaleX = Simd::Load(&batch.scaleX[first]);
+	const Float scaleY = Simd::Load(&batch.scaleY[first]);
+	const Float scaleZ = Simd::Load(&batch.scaleZ[first]);
+	const Float zero   = Simd::Set(0.0f);
+	const Float one	   = Simd::Set(1.0f);
+
+	// [column * 4 + row], like Matrix4
+	const Float local[16] = {
+		Simd::Mul(r00, scaleX), Simd::Mul(r10, scaleX), Simd::Mul(r20, scaleX), zero,
+		Simd::Mul(r01, scaleY), Simd::Mul(r11, scaleY), Simd::Mul(r21, scaleY), zero,
+		Simd::Mul(r02, scaleZ), Simd::Mul(r12, scaleZ), Simd::Mul(r22, scaleZ), zero,
+		Simd::Load(&batch.positionX[first]), Simd::Load(&batch.positionY[first]), Simd::Load(&batch.positionZ[first]),
+		one};
+
+	Float parent[16];
+	Simd::Gather(parents, parent);
+
+	// The local matrix is affine, so its last row only contributes the parent's translation column.
+	Float world[16];
+	for (int column = 0; column < 4; ++column) {
+		for (int row = 0; row < 4; ++row) {
+			Float sum = Simd::Mul(parent[row], local[column * 4]);
+			sum		  = Simd::Add(sum, Simd::Mul(parent[4 + row], local[column * 4 + 1]));
+			sum		  = Simd::Add(sum, Simd::Mul(parent[8 + row], local[column * 4 + 2]));
+			if (column == 3) sum = Simd::Add(sum, parent[12 + row]);
+			world[column * 4 + row] = sum;
+		}
+	}
+
+	Simd::Scatter(local, locals);
+	Simd::Scatter(world, worlds);
+}
+}  // namespace
+
+void TransformBatch::Clear() {
+	for (std::vector<float> *values :
+		 {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ})
+		values->clear();
+	parentWorld.clear();
+	local.clear();
+	world.clear();
+}
+
+void TransformBatch::Reserve(const size_t count) {
+	for (std::vector<float> *values :
+		 {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ})
+		values->reserve(count);
+	parentWorld.reserve(count);
+	local.reserve(count);
+	world.reserve(count);
+}
+
+void TransformBatch::Push(const Vector3 &position, const Vector3 &rotation, const Vector3 &scale,
+						  const Matrix4 *parentWorldMatrix, Matrix4 *localMatrix, Matrix4 *worldMatrix) {
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	positionZ.push_back(position.z);
+	rotationX.push_back(rotation.x);
+	rotationY.push_back(rotation.y);
+	rotationZ.push_back(rotation.z);
+	scaleX.push_back(scale.x);
+	scaleY.push_back(scale.y);
+	scaleZ.push_back(scale.z);
+	parentWorld.push_back(parentWorldMatrix);
+	local.push_back(localMatrix);
+	world.push_back(worldMatrix);
+}
+
+void TransformBatch::Resize(const size_t count) {
+	for (std::vector<float> *values :
+		 {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ})
+		values->resize(count);
+	parentWorld.resize(count);
+	local.resize(count);
+	world.resize(count);
+}
+
+void TransformBatch::Set(const size_t index, const Vector3 &position, const Vector3 &rotation, const Vector3 &scale,
+						 const Matrix4 *parentWorldMatrix, Matrix4 *localMatrix, Matrix4 *worldMatrix) {
+	positionX[index]   = position.x;
+	positionY[index]   = position.y;
+	positionZ[index]   = position.z;
+	rotationX[index]   = rotation.x;
+	rotationY[index]   = rotation.y;
+	rotationZ[index]   = rotation.z;
+	scaleX[index]	   = scale.x;
+	scaleY[index]	   = scale.y;
+	scaleZ[index]	   = scale.z;
+	parentWorld[index] = parentWorldMatrix;
+	local[index]	   = localMatrix;
+	world[index]	   = worldMatrix;
+}
+
+size_t GetTransformBatchWidth() { return Simd::WIDTH; }
+
+const Matrix4 *IdentityMatrix() {
+	static const Matrix4 identity = Matrix4Identity();
+	return &identity;
+}
+
+void ComputeTransformMatrices(const TransformBatch &batch, const size_t begin, const size_t end) {
+	constexpr size_t WIDTH = Simd::WIDTH;
+
+	size_t i = begin;
+	for (; i + WIDTH <= end; i += WIDTH)
+		ComputeGroup(batch, i, &batch.parentWorld[i], &batch.local[i], &batch.world[i]);
+	if (i == end) return;
+
+	// The tail is copied into a full group, padded with the last transform and written to throwaway matrices.
+	// thread_local so jobs finishing a range don't allocate.
+	thread_local TransformBatch tail;
+	Matrix4						discard[WIDTH];
+	tail.Clear();
+	for (size_t lane = 0; lane < WIDTH; ++lane) {
+		const size_t source = std::min(i + lane, end - 1);
+		const bool	 isReal = i + lane < end;
+		tail.Push({batch.positionX[source], batch.positionY[source], batch.positionZ[source]},
+				  {batch.rotationX[source], batch.rotationY[source], batch.rotationZ[source]},
+				  {batch.scaleX[source], batch.scaleY[source], batch.scaleZ[source]}, batch.parentWorld[source],
+				  isReal ? batch.local[source] : &discard[lane], isReal ? batch.world[source] : &discard[lane]);
+	}
+	ComputeGroup(tail, 0, tail.parentWorld.data(), tail.local.data(), tail.world.data());
+}
+}  // namespace PE::Math
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "Platform/PlatformSystem.h"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+
 #include "Core/Engine.h"
 #include "Input/InputSystem.h"
 #include "Platform/GLFWCallbacks.h"
@@ -8,19 +13,22 @@
 
 namespace PE::Platform {
 ERROR_CODE PlatformSystem::Initialize(Core::EngineConfig &config) {
-	if (!glfwInit()) {
-		PE_LOG_FATAL("Failed to initialize GLFW.");
-		return ERROR_CODE::WINDOW_CREATION_FAILED;
-	}
+	// Headless runs never touch GLFW, there may be no display to open a window on.
+	if (!config.headless) {
+		if (!glfwInit()) {
+			PE_LOG_FATAL("Failed to initialize GLFW.");
+			return ERROR_CODE::WINDOW_CREATION_FAILED;
+		}
 
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-	glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
-	m_mainWindow = glfwCreateWindow(config.renderConfig.width, config.renderConfig.height, m_mainWindowCaption.c_str(),
-									nullptr, nullptr);
-	if (!m_mainWindow) {
-		glfwTerminate();
-		PE_LOG_FATAL("Failed to create GLFW window.");
-		return ERROR_CODE::WINDOW_CREATION_FAILED;
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+		glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+		m_mainWindow = glfwCreateWindow(config.renderConfig.width, config.renderConfig.height,
+										m_mainWindowCaption.c_str(), nullptr, nullptr);
+		if (!m_mainWindow) {
+			glfwTerminate();
+			PE_LOG_FATAL("Failed to create GLFW window.");
+			return ERROR_CODE::WINDOW_CREATION_FAILED;
+		}
 	}
 
 	ref_config	  = &config;
@@ -31,13 +39,15 @@ ERROR_CODE PlatformSystem::Initialize(Core::EngineConfig &config) {
 	m_callbackManager = new CallbackManager();
 	PE_ENSURE_INIT_SILENT(result, m_callbackManager->Initialize(this, m_inputSystem));
 
-	glfwSetWindowUserPointer(m_mainWindow, m_callbackManager);
-	glfwSetKeyCallback(m_mainWindow, GLFWCallbacks::StaticKeyCallback);
-	glfwSetCursorPosCallback(m_mainWindow, GLFWCallbacks::StaticCursorPosCallback);
-	glfwSetMouseButtonCallback(m_mainWindow, GLFWCallbacks::StaticMouseButtonCallback);
-	glfwSetFramebufferSizeCallback(m_mainWindow, GLFWCallbacks::StaticFramebufferSizeCallback);
-	glfwSetWindowFocusCallback(m_mainWindow, GLFWCallbacks::StaticWindowFocusCallback);
-	glfwSetWindowCloseCallback(m_mainWindow, GLFWCallbacks::StaticWindowCloseCallback);
+	if (m_mainWindow) {
+		glfwSetWindowUserPointer(m_mainWindow, m_callbackManager);
+		glfwSetKeyCallback(m_mainWindow, GLFWCallbacks::StaticKeyCallback);
+		glfwSetCursorPosCallback(m_mainWindow, GLFWCallbacks::StaticCursorPosCallback);
+		glfwSetMouseButtonCallback(m_mainWindow, GLFWCallbacks::StaticMouseButtonCallback);
+		glfwSetFramebufferSizeCallback(m_mainWindow, GLFWCallbacks::StaticFramebufferSizeCallback);
+		glfwSetWindowFocusCallback(m_mainWindow, GLFWCallbacks::StaticWindowFocusCallback);
+		glfwSetWindowCloseCallback(m_mainWindow, GLFWCallbacks::StaticWindowCloseCallback);
+	}
 
 	m_application = new Core::Engine;
 	PE_ENSURE_INIT(result, m_application->Initialize(this, config, m_mainWindow, m_inputSystem),
@@ -50,14 +60,20 @@ void PlatformSystem::Shutdown() {
 	Utilities::SafeShutdown(m_inputSystem);
 	Utilities::SafeDelete(m_callbackManager);
 
-	if (m_mainWindow) glfwDestroyWindow(m_mainWindow);
-
-	glfwTerminate();
+	if (m_mainWindow) {
+		glfwDestroyWindow(m_mainWindow);
+		glfwTerminate();
+	}
 
 	return;
 }
 
 void PlatformSystem::Run() {
+	if (ref_config->headless) {
+		RunHeadless();
+		return;
+	}
+
 	m_timer.Reset();
 
 	while (!m_appShouldClose) {
@@ -74,6 +90,61 @@ void PlatformSystem::Run() {
 	}
 }
 
+void PlatformSystem::RunHeadless() {
+	// A fixed time step keeps the simulation, and so every captured frame, the same from run to run.
+	constexpr float FIXED_DELTA_TIME = 1.0f / 60.0f;
+
+	Graphics::IRenderer			*renderer = m_application->GetRenderSystem()->GetRenderer();
+	const std::vector<uint32_t> &captures = ref_config->captureFrames;
+	if (!captures.empty()) {
+		std::error_code ec;
+		std::filesystem::create_directories(ref_config->captureDirectory, ec);
+		if (ec) PE_LOG_ERROR("Can't create capture directory: " + ref_config->captureDirectory.string());
+	}
+
+	std::vector<double> frameTimes;
+	frameTimes.reserve(ref_config->headlessFrameCount);
+	for (uint32_t frame = 0; frame < ref_config->headlessFrameCount && !m_appShouldClose; ++frame) {
+		const bool capture = std::ranges::find(captures, frame) != captures.end();
+		if (capture)
+			renderer->RequestCapture(ref_config->captureDirectory /
+									 std::format("frame_{:05}.{}", frame, ref_config->captureFormat));
+
+		const auto start = std::chrono::steady_clock::now();
+		m_inputSystem->OnUpdate(FIXED_DELTA_TIME);
+		m_application->UpdateApplication(FIXED_DELTA_TIME);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// A captured frame waits for its readback, it would skew the timings.
+		if (!capture) frameTimes.push_back(ms);
+	}
+
+	if (frameTimes.empty()) return;
+
+	std::ranges::sort(frameTimes);
+	double totalMs = 0.0;
+	for (const double ms : frameTimes) totalMs += ms;
+	const double averageMs = totalMs / static_cast<double>(frameTimes.size());
+	const double p99Ms	   = frameTimes[std::min(frameTimes.size() - 1, frameTimes.size() * 99 / 100)];
+	PE_LOG_INFO(std::format("Headless run: {} frames, average {:.3f} ms ({:.1f} FPS), min {:.3f} ms, p99 {:.3f} ms, "
+							"max {:.3f} ms.",
+							frameTimes.size(), averageMs, 1000.0 / averageMs, frameTimes.front(), p99Ms,
+							frameTimes.back()));
+
+	// The GPU side of the same run, one row per frame the renderer read back.
+	if (const Graphics::GPUProfile *profile = renderer->GetGPUProfile(); profile && !profile->IsEmpty()) {
+		const std::filesystem::path path = ref_config->captureDirectory / "gpu_profile.csv";
+		std::error_code				ec;
+		std::filesystem::create_directories(ref_config->captureDirectory, ec);
+		if (profile->WriteCSV(path) < ERROR_CODE::WARN_START)
+			PE_LOG_ERROR("Failed to write GPU profile " + path.string());
+		else
+			PE_LOG_INFO(std::format("Headless GPU: p50 {:.3f} ms, p99 {:.3f} ms, written to {}.",
+									profile->GetPercentileMs(Graphics::GPUPass::Count, 50.0),
+									profile->GetPercentileMs(Graphics::GPUPass::Count, 99.0), path.string()));
+	}
+}
+
 void PlatformSystem::RequestToCloseTheApplication() { m_appShouldClose = true; }
 
 void PlatformSystem::CalculateFrameStats() const {
@@ -160,6 +160,8 @@ void SceneLoader::LoadScene(const std::string &filePath) {
 
 	FinalizeDayNightCycle();
 	FinalizeHierarchy();
+
+	if (ref_renderer->PrewarmPipelines() < ERROR_CODE::WARN_START) PE_LOG_ERROR("Failed to prewarm scene pipelines.");
 }
 
 void SceneLoader::ReloadScene() {
@@ -439,10 +441,17 @@ void SceneLoader::HandleMeshRendererKey(const std::string &key, const std::strin
 	if (key == "Mesh") {
 		if (auto const *modelAssetInfo = Assets::AssetManager::GetModelAssetInfo(value)) {
 			mr->subMeshes.clear();
-			for (auto &[meshAssetName, materialAssetName] : modelAssetInfo->subMeshes) {
-				MaterialID materialHandle = Assets::AssetManager::GetMaterialHandle(materialAssetName);
+			for (const auto &entry : modelAssetInfo->subMeshes) {
+				MaterialID materialHandle = Assets::AssetManager::GetMaterialHandle(entry.materialAssetName);
 				if (materialHandle == INVALID_HANDLE) materialHandle = Assets::AssetManager::RequestDefaultMaterial();
-				mr->subMeshes.emplace_back(Assets::AssetManager::GetMeshHandle(meshAssetName), materialHandle);
+				const MeshID meshHandle = Assets::AssetManager::GetMeshHandle(entry.meshAssetName);
+				auto		&subMesh	= mr->subMeshes.emplace_back(meshHandle, materialHandle);
+
+				for (const std::string &lodName : entry.lodMeshAssetNames) {
+					const MeshID lodID = Assets::AssetManager::GetMeshHandle(lodName);
+					if (lodID == INVALID_HANDLE || subMesh.lodCount == MAX_MESH_LODS) break;
+					subMesh.lods[subMesh.lodCount++] = {lodID, Assets::AssetManager::GetMeshAssetInfo(lodID)->lodError};
+				}
 			}
 		} else {
 			MeshID meshID = Assets::AssetManager::GetMeshHandle(value);
@@ -10,13 +10,38 @@
 #include "Scene/Components/Transform.h"
 
 namespace PE::Scene::Systems {
-ERROR_CODE DayNightSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager) {
-	m_stage = stage;
-	ref_eM	= entityManager;
-	return ERROR_CODE::OK;
+ERROR_CODE DayNightSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager,
+									  TransformSystem *transformSystem) {
+	PE_CHECK_STATE_INIT(m_state, "DayNight system is already initialized!");
+	m_state = SystemState::Initializing;
+
+	m_typeID			= GetUniqueISystemTypeID<DayNightSystem>();
+	m_stage				= stage;
+	ref_eM				= entityManager;
+	ref_transformSystem = transformSystem;
+	DeclareReads<Components::Tag>();
+	DeclareWrites<Components::DayNightCycle, Components::Transform, Graphics::Components::DirectionalLight,
+				  Graphics::Components::ParticleEmitter>();
+
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->RegisterSystem(this));
+
+	m_state = SystemState::Running;
+	return result;
 }
 
-ERROR_CODE DayNightSystem::Shutdown() { return ERROR_CODE::OK; }
+ERROR_CODE DayNightSystem::Shutdown() {
+	if (m_state == SystemState::Uninitialized || m_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
+	m_state = SystemState::ShuttingDown;
+
+	ERROR_CODE result;
+	PE_CHECK(result, ref_eM->UnregisterSystem(this));
+	m_stage	 = ECS::ESystemStage::Count;
+	m_typeID = UINT32_MAX;
+
+	m_state = SystemState::Uninitialized;
+	return result;
+}
 
 void DayNightSystem::OnUpdate(float dt) {
 	auto &cycleArr = ref_eM->GetCompArr<Components::DayNightCycle>();
@@ -79,7 +104,7 @@ void DayNightSystem::UpdateSunMoon(Components::DayNightCycle &cycle, float dt) {
 
 		if (sunTrans) {
 			sunTrans->position = sunDir * 105.0f;
-			sunTrans->state	   = Components::Transform::TransformState::Dirty;
+			ref_transformSystem->MarkDirty(cycle.sunEntity);
 		}
 		if (sunLight) {
 			Math::Vector4 baseColor = CalculateLightColor(sunDir.y, cycle);
@@ -98,7 +123,7 @@ void DayNightSystem::UpdateSunMoon(Components::DayNightCycle &cycle, float dt) {
 
 		if (moonTrans) {
 			moonTrans->position = moonDir * 105.0f;
-			moonTrans->state	= Components::Transform::TransformState::Dirty;
+			ref_transformSystem->MarkDirty(cycle.moonEntity);
 		}
 		if (moonLight) {
 			float fade = std::clamp((SWITCH_THRESHOLD - sunDir.y) / FADE_RANGE, 0.0f, 1.0f);
@@ -182,7 +207,7 @@ void DayNightSystem::UpdateEnvironmentalEffects(Components::DayNightCycle &cycle
 				}
 
 				transform->scale = Math::Vector3(currentScale);
-				transform->state = Components::Transform::TransformState::Dirty;
+				ref_transformSystem->MarkDirty(treeID);
 			}
 		}
 	}
@@ -75,6 +75,7 @@ ERROR_CODE SceneControlSystem::Initialize(ECS::ESystemStage stage, Core::Engine
 	ref_dayNightSystem	= dayNightSystem;
 	ref_config			= &config;
 	m_stage				= stage;
+	DeclareWrites<Components::Transform, Graphics::Components::ParticleEmitter>();
 
 	ERROR_CODE result;
 	PE_CHECK(result, ref_eM->RegisterSystem(this));
@@ -230,7 +231,9 @@ void SceneControlSystem::SetupInputBindings() {
 				break;
 			}
 			case Input::KeyCode::U: {
-				action.callback = [this](const Input::InputContext &) { ref_guiSystem->ToggleGUI(); };
+				action.callback = [this](const Input::InputContext &) {
+					if (ref_guiSystem) ref_guiSystem->ToggleGUI();
+				};
 				break;
 			}
 			case Input::KeyCode::T: {
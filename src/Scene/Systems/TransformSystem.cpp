@@ -4,9 +4,13 @@
 #include "Input/InputCode.h"
 #include "Input/InputSystem.h"
 #include "Input/InputTypes.h"
+#include "Math/TransformBatch.h"
 #include "Scene/Components/Transform.h"
+#include "Utilities/JobSystem.h"
 
 namespace PE::Scene::Systems {
+constexpr size_t TRANSFORM_GRAIN_SIZE = 256;
+
 ERROR_CODE TransformSystem::Initialize(const ECS::ESystemStage stage, ECS::EntityManager *entityManager,
 									   Input::InputSystem *inputSystem, Graphics::Systems::CameraSystem *cameraSystem,
 									   const Core::EngineConfig &config) {
@@ -17,6 +21,12 @@ ERROR_CODE TransformSystem::Initialize(const ECS::ESystemStage stage, ECS::Entit
 	ref_eM	   = entityManager;
 	ref_config = &config;
 	m_stage	   = stage;
+	DeclareWrites<Components::Transform>();
+
+	// The hierarchy follows the Transform array through its added/removed lists instead of rescanning it.
+	m_nodes.Clear();
+	m_nodes.Reserve(config.maxEntityCount);
+	ref_eM->GetCompArr<Components::Transform>().SetChangeTracking(true);
 
 	ERROR_CODE result;
 	PE_CHECK(result, ref_eM->RegisterSystem(this));
@@ -31,6 +41,11 @@ ERROR_CODE TransformSystem::Shutdown() {
 
 	ERROR_CODE result;
 	PE_CHECK(result, ref_eM->UnregisterSystem(this));
+	ref_eM->GetCompArr<Components::Transform>().SetChangeTracking(false);
+	m_nodes.Clear();
+	m_dirtyEntities.clear();
+	m_updatedEntities.clear();
+	m_dirtyLevels.clear();
 	m_stage	 = ECS::ESystemStage::Count;
 	m_typeID = UINT32_MAX;
 	m_state	 = SystemState::Uninitialized;
@@ -40,211 +55,273 @@ ERROR_CODE TransformSystem::Shutdown() {
 
 void TransformSystem::OnUpdate(float dt) {
 	using Components::Transform;
-	auto &compArr = ref_eM->GetCompArr<Transform>();
-	if (compArr.GetCount() != m_lastComponentCount) m_isHierarchyDirty = true;
-
-	if (m_isHierarchyDirty) {
-		RebuildTransformArray();
-		m_isHierarchyDirty = false;
-
-		m_lastComponentCount = compArr.GetCount();
-	}
-
-	const uint32_t transformCount = compArr.GetCount();
+	auto &array = ref_eM->GetCompArr<Transform>();
+	SyncHierarchy(array);
 
-	std::vector<Transform> &transforms = compArr.Data();
-
-	for (uint32_t i = 0; i < transformCount; ++i) {
-		if (transforms[i].state == Transform::TransformState::Updated) {
-			transforms[i].state = Transform::TransformState::Clean;
-		}
+	for (const ECS::EntityID entityID : m_updatedEntities) {
+		if (!array.Has(entityID)) continue;
+		if (Transform &transform = array.Get(entityID); transform.state == Transform::TransformState::Updated)
+			transform.state = Transform::TransformState::Clean;
 	}
-
-	for (uint32_t i = 0; i < transformCount; ++i) {
-		Transform &transform = transforms[i];
-
-		if (transform.parentPackedIndex != UINT32_MAX) {
-			Transform const &parent = transforms[transform.parentPackedIndex];
-
-			if (parent.state == Transform::TransformState::Updated) {
-				transform.state = Transform::TransformState::Dirty;
-			}
-
-			if (transform.state == Transform::TransformState::Dirty) {
-				UpdateWorldMatrix(transform, parent);
-				transform.state = Transform::TransformState::Updated;
-			}
-		} else {
-			if (transform.state == Transform::TransformState::Dirty) {
-				UpdateWorldMatrix(transform);
-				transform.state = Transform::TransformState::Updated;
-			}
-		}
+	m_updatedEntities.clear();
+
+	if (m_dirtyEntities.empty()) return;
+
+	// Parents are settled first so every dirty subtree lands in the bucket of its final depth.
+	for (const ECS::EntityID entityID : m_dirtyEntities)
+		if (array.Has(entityID)) ApplyParent(entityID, array.Get(entityID), array);
+
+	m_visitStamp++;
+	for (const ECS::EntityID entityID : m_dirtyEntities)
+		if (array.Has(entityID)) CollectSubtree(entityID);
+	m_dirtyEntities.clear();
+
+	// Shallower levels first, so a parent's world matrix is always final before its children read it. Entities of
+	// one level only read their parents and write themselves, so each level is gathered into SoA form and computed
+	// across the job system. The kernel's result doesn't depend on where the level is split.
+	for (std::vector<ECS::EntityID> &level : m_dirtyLevels) {
+		if (level.empty()) continue;
+
+		m_batch.Resize(level.size());
+		Utilities::JobSystem::ParallelForRange(
+			level.size(), TRANSFORM_GRAIN_SIZE, [this, &array, &level](const size_t begin, const size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					Transform			&transform	 = array.Get(level[i]);
+					const ECS::EntityID	 parentID	 = FindNode(level[i])->parent;
+					const Math::Matrix4 *parentWorld = parentID == ECS::INVALID_ENTITY_ID
+														   ? Math::IdentityMatrix()
+														   : &array.Get(parentID).worldMatrix;
+
+					m_batch.Set(i, transform.position, transform.rotation, transform.scale, parentWorld,
+								&transform.localMatrix, &transform.worldMatrix);
+					transform.state = Transform::TransformState::Updated;
+				}
+				Math::ComputeTransformMatrices(m_batch, begin, end);
+			});
+
+		m_updatedEntities.insert(m_updatedEntities.end(), level.begin(), level.end());
+		level.clear();
 	}
 }
 
-void TransformSystem::SetPosition(const uint32_t entityID, const float x, const float y, const float z) const {
-	auto &transform	   = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.position = Math::Vector3(x, y, z);
-	transform.state	   = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetPosition(const uint32_t entityID, const float x, const float y, const float z) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).position = Math::Vector3(x, y, z);
+	MarkDirty(entityID);
 }
 
-void TransformSystem::SetPosition(const uint32_t entityID, const Math::Vector3 pos) const {
-	auto &transform	   = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.position = pos;
-	transform.state	   = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetPosition(const uint32_t entityID, const Math::Vector3 pos) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).position = pos;
+	MarkDirty(entityID);
 }
 
 Math::Vector3 TransformSystem::GetPosition(const uint32_t entityID) const {
 	return ref_eM->GetCompArr<Components::Transform>().Get(entityID).position;
 }
 
-void TransformSystem::SetRotation(const uint32_t entityID, const float pitch, const float yaw, const float roll) const {
-	auto &transform	   = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.rotation = Math::Vector3(pitch, yaw, roll);
-	transform.state	   = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetRotation(const uint32_t entityID, const float pitch, const float yaw, const float roll) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).rotation = Math::Vector3(pitch, yaw, roll);
+	MarkDirty(entityID);
 }
 
-void TransformSystem::SetRotation(const uint32_t entityID, const Math::Vector3 rot) const {
-	auto &transform	   = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.rotation = rot;
-	transform.state	   = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetRotation(const uint32_t entityID, const Math::Vector3 rot) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).rotation = rot;
+	MarkDirty(entityID);
 }
 
 Math::Vector3 TransformSystem::GetRotation(const uint32_t entityID) const {
 	return ref_eM->GetCompArr<Components::Transform>().Get(entityID).rotation;
 }
 
-void TransformSystem::SetScale(const uint32_t entityID, const float x, const float y, const float z) const {
-	auto &transform = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.scale = Math::Vector3(x, y, z);
-	transform.state = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetScale(const uint32_t entityID, const float x, const float y, const float z) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).scale = Math::Vector3(x, y, z);
+	MarkDirty(entityID);
 }
 
-void TransformSystem::SetScale(const uint32_t entityID, const Math::Vector3 scale) const {
-	auto &transform = ref_eM->GetCompArr<Components::Transform>().Get(entityID);
-	transform.scale = scale;
-	transform.state = Components::Transform::TransformState::Dirty;
+void TransformSystem::SetScale(const uint32_t entityID, const Math::Vector3 scale) {
+	ref_eM->GetCompArr<Components::Transform>().Get(entityID).scale = scale;
+	MarkDirty(entityID);
 }
 
 Math::Vector3 TransformSystem::GetScale(const uint32_t entityID) const {
 	return ref_eM->GetCompArr<Components::Transform>().Get(entityID).scale;
 }
 
-void TransformSystem::UpdateWorldMatrix(Components::Transform &transform) {
-	const Math::Matrix4 identity	= Math::Matrix4Identity();
-	const Math::Matrix4 scale		= Math::Scale(identity, transform.scale);
-	Math::Matrix4		rotation	= Math::Rotate(identity, transform.rotation.y, Math::Vector3(0.0f, 1.0f, 0.0f));
-	rotation						= Math::Rotate(rotation, transform.rotation.x, Math::Vector3(1.0f, 0.0f, 0.0f));
-	rotation						= Math::Rotate(rotation, transform.rotation.z, Math::Vector3(0.0f, 0.0f, 1.0f));
-	const Math::Matrix4 translation = Math::Translate(identity, transform.position);
+void TransformSystem::AttachEntity(const uint32_t childEntityID, const uint32_t parentEntityID) {
+	auto &array = ref_eM->GetCompArr<Components::Transform>();
+	if (!array.Has(childEntityID) || !array.Has(parentEntityID)) return;
 
-	transform.localMatrix = translation * rotation * scale;
-	transform.worldMatrix = transform.localMatrix;
+	array.Get(childEntityID).parentEntityID = parentEntityID;
+	MarkDirty(childEntityID);
 }
 
-void TransformSystem::UpdateWorldMatrix(Components::Transform		&transform,
-										const Components::Transform &parentTransform) {
-	const Math::Matrix4 identity	= Math::Matrix4Identity();
-	const Math::Matrix4 scale		= Math::Scale(identity, transform.scale);
-	Math::Matrix4		rotation	= Math::Rotate(identity, transform.rotation.y, Math::Vector3(0.0f, 1.0f, 0.0f));
-	rotation						= Math::Rotate(rotation, transform.rotation.x, Math::Vector3(1.0f, 0.0f, 0.0f));
-	rotation						= Math::Rotate(rotation, transform.rotation.z, Math::Vector3(0.0f, 0.0f, 1.0f));
-	const Math::Matrix4 translation = Math::Translate(identity, transform.position);
+void TransformSystem::DetachEntity(const uint32_t entityID) {
+	auto &array = ref_eM->GetCompArr<Components::Transform>();
+	if (!array.Has(entityID)) return;
 
-	transform.localMatrix = translation * rotation * scale;
-	transform.worldMatrix = parentTransform.worldMatrix * transform.localMatrix;
+	array.Get(entityID).parentEntityID = ECS::INVALID_ENTITY_ID;
+	MarkDirty(entityID);
 }
 
-void TransformSystem::AttachEntity(const uint32_t childEntityID, const uint32_t parentEntityID) {
+void TransformSystem::MarkDirty(const ECS::EntityID entityID) {
 	auto &array = ref_eM->GetCompArr<Components::Transform>();
-	if (!array.Has(childEntityID) || !array.Has(parentEntityID)) return;
+	if (!array.Has(entityID)) return;
 
-	array.Get(childEntityID).parentEntityID = parentEntityID;
+	array.Get(entityID).state = Components::Transform::TransformState::Dirty;
+	m_dirtyEntities.push_back(entityID);
+}
+
+void TransformSystem::SyncHierarchy(ECS::ComponentArray<Components::Transform> &array) {
+	if (array.WasCleared()) {
+		m_nodes.Clear();
+		m_dirtyEntities.clear();
+		m_updatedEntities.clear();
+	}
+
+	for (const ECS::EntityID entityID : array.GetRemovedEntities()) RemoveNode(entityID);
+
+	// Every new node exists before any is linked, so a child added ahead of its parent still finds it.
+	const std::vector<uint32_t> &added = array.GetAddedEntities();
+	for (const ECS::EntityID entityID : added)
+		if (array.Has(entityID)) InsertNode(entityID);
+	for (const ECS::EntityID entityID : added)
+		if (array.Has(entityID)) MarkDirty(entityID);
 
-	m_isHierarchyDirty = true;
+	array.ClearChanges();
 }
 
-void TransformSystem::DetachEntity(const uint32_t entityID) {
-	auto &array = ref_eM->GetCompArr<Components::Transform>();
-	if (!array.Has(entityID)) return;
+void TransformSystem::InsertNode(const ECS::EntityID entityID) {
+	HierarchyNode &node = m_nodes.Assure(ECS::GetEntityIndex(entityID));
+	if (node.entityID == entityID) return;
 
-	array.Get(entityID).parentEntityID = UINT32_MAX;
-	m_isHierarchyDirty				   = true;
+	node		  = HierarchyNode{};
+	node.entityID = entityID;
 }
 
-void TransformSystem::RebuildTransformArray() {
-	auto		  &array = ref_eM->GetCompArr<Components::Transform>();
-	const uint32_t count = array.GetCount();
-	if (count == 0) return;
+void TransformSystem::RemoveNode(const ECS::EntityID entityID) {
+	HierarchyNode *node = FindNode(entityID);
+	if (!node) return;
 
-	static std::vector<std::vector<uint32_t>> adj;
+	Unlink(entityID);
 
-	if (adj.size() < ref_config->maxEntityCount) adj.resize(ref_config->maxEntityCount);
+	// Orphans become roots, the same as a child whose parent handle went stale.
+	ECS::EntityID childID = node->firstChild;
+	while (childID != ECS::INVALID_ENTITY_ID) {
+		HierarchyNode	   &child  = *FindNode(childID);
+		const ECS::EntityID	nextID = child.nextSibling;
 
-	const auto &indices = array.Index();
-	for (const uint32_t entityID : indices) {
-		if (entityID >= adj.size()) PE_LOG_FATAL("This vector can't be bigger than max entity count!");
+		child.parent	  = ECS::INVALID_ENTITY_ID;
+		child.prevSibling = ECS::INVALID_ENTITY_ID;
+		child.nextSibling = ECS::INVALID_ENTITY_ID;
+		SetSubtreeDepth(childID, 0);
+		m_dirtyEntities.push_back(childID);
 
-		adj[entityID].clear();
+		childID = nextID;
 	}
 
-	std::vector<uint32_t> roots;
-	roots.reserve(count / 2);
-
-	for (uint32_t i = 0; i < count; ++i) {
-		uint32_t entityID = indices[i];
-		if (const auto &transform = array.Data()[i]; transform.parentEntityID == UINT32_MAX) {
-			roots.push_back(entityID);
-		} else {
-			if (transform.parentEntityID < adj.size())
-				adj[transform.parentEntityID].push_back(entityID);
-			else
-				PE_LOG_FATAL("This entity ID can't be bigger than max entity count!");
-		}
-	}
+	*node = HierarchyNode{};
+}
 
-	static std::vector<Components::Transform> sortedData;
-	static std::vector<uint32_t>			  sortedEntities;
+void TransformSystem::ApplyParent(const ECS::EntityID entityID, Components::Transform &transform,
+								  const ECS::ComponentArray<Components::Transform> &array) {
+	// A parent handle that went stale (destroyed, index reused) fails Has and the entity becomes a root.
+	ECS::EntityID parentID = transform.parentEntityID;
+	if (parentID == entityID || (parentID != ECS::INVALID_ENTITY_ID && !array.Has(parentID)))
+		parentID = ECS::INVALID_ENTITY_ID;
 
-	sortedData.clear();
-	sortedData.reserve(count);
-	sortedEntities.clear();
-	sortedEntities.reserve(count);
+	const HierarchyNode *node = FindNode(entityID);
+	if (node->parent == parentID) return;
 
-	for (uint32_t rootID : roots) {
-		DFSRebuild(rootID, UINT32_MAX, adj, sortedData, sortedEntities);
+	if (parentID != ECS::INVALID_ENTITY_ID && IsDescendant(parentID, entityID)) {
+		PE_LOG_WARN("Can't attach entity " + std::to_string(entityID) + " below its own descendant.");
+		transform.parentEntityID = node->parent;
+		return;
 	}
 
-	array.Shutdown();
+	Unlink(entityID);
+	if (parentID != ECS::INVALID_ENTITY_ID) Link(entityID, parentID);
+}
 
-	array.Initialize(ref_config->maxEntityCount);
+void TransformSystem::Link(const ECS::EntityID entityID, const ECS::EntityID parentID) {
+	HierarchyNode &node	  = *FindNode(entityID);
+	HierarchyNode &parent = *FindNode(parentID);
 
-	for (size_t i = 0; i < sortedData.size(); ++i) {
-		array.Add(sortedEntities[i], &sortedData[i]);
-	}
+	node.parent		 = parentID;
+	node.prevSibling = ECS::INVALID_ENTITY_ID;
+	node.nextSibling = parent.firstChild;
+	if (parent.firstChild != ECS::INVALID_ENTITY_ID) FindNode(parent.firstChild)->prevSibling = entityID;
+	parent.firstChild = entityID;
 
-	m_lastComponentCount = array.GetCount();
+	SetSubtreeDepth(entityID, parent.depth + 1);
 }
 
-void TransformSystem::DFSRebuild(uint32_t entityID, uint32_t currentParentPackedIndex,
-								 const std::vector<std::vector<uint32_t>> &adj,
-								 std::vector<Components::Transform>		  &sortedData,
-								 std::vector<uint32_t>					  &sortedEntities) {
-	auto				 &array		= ref_eM->GetCompArr<Components::Transform>();
-	Components::Transform transform = array.Get(entityID);
+void TransformSystem::Unlink(const ECS::EntityID entityID) {
+	HierarchyNode &node = *FindNode(entityID);
+	if (node.parent == ECS::INVALID_ENTITY_ID) return;
 
-	uint32_t myNewPackedIndex = (uint32_t)sortedData.size();
+	if (node.prevSibling != ECS::INVALID_ENTITY_ID)
+		FindNode(node.prevSibling)->nextSibling = node.nextSibling;
+	else
+		FindNode(node.parent)->firstChild = node.nextSibling;
+	if (node.nextSibling != ECS::INVALID_ENTITY_ID) FindNode(node.nextSibling)->prevSibling = node.prevSibling;
 
-	transform.parentPackedIndex = currentParentPackedIndex;
+	node.parent		 = ECS::INVALID_ENTITY_ID;
+	node.prevSibling = ECS::INVALID_ENTITY_ID;
+	node.nextSibling = ECS::INVALID_ENTITY_ID;
+	SetSubtreeDepth(entityID, 0);
+}
 
-	sortedData.push_back(transform);
-	sortedEntities.push_back(entityID);
+void TransformSystem::SetSubtreeDepth(const ECS::EntityID entityID, const uint32_t depth) {
+	HierarchyNode &root = *FindNode(entityID);
+	if (root.depth == depth) return;
+	root.depth = depth;
+
+	m_stack.clear();
+	m_stack.push_back(entityID);
+	while (!m_stack.empty()) {
+		const HierarchyNode &node = *FindNode(m_stack.back());
+		m_stack.pop_back();
+
+		for (ECS::EntityID childID = node.firstChild; childID != ECS::INVALID_ENTITY_ID;) {
+			HierarchyNode &child = *FindNode(childID);
+			child.depth			 = node.depth + 1;
+			m_stack.push_back(childID);
+			childID = child.nextSibling;
+		}
+	}
+}
+
+void TransformSystem::CollectSubtree(const ECS::EntityID entityID) {
+	m_stack.clear();
+	m_stack.push_back(entityID);
+	while (!m_stack.empty()) {
+		const ECS::EntityID currentID = m_stack.back();
+		m_stack.pop_back();
+
+		// Already collected through an ancestor or a repeated mark this update.
+		HierarchyNode &node = *FindNode(currentID);
+		if (node.visitStamp == m_visitStamp) continue;
+		node.visitStamp = m_visitStamp;
+
+		if (node.depth >= m_dirtyLevels.size()) m_dirtyLevels.resize(node.depth + 1);
+		m_dirtyLevels[node.depth].push_back(currentID);
 
-	if (entityID < adj.size()) {
-		for (uint32_t childID : adj[entityID]) {
-			DFSRebuild(childID, myNewPackedIndex, adj, sortedData, sortedEntities);
+		for (ECS::EntityID childID = node.firstChild; childID != ECS::INVALID_ENTITY_ID;) {
+			m_stack.push_back(childID);
+			childID = FindNode(childID)->nextSibling;
 		}
 	}
 }
+
+TransformSystem::HierarchyNode *TransformSystem::FindNode(const ECS::EntityID entityID) {
+	HierarchyNode *node = m_nodes.Find(ECS::GetEntityIndex(entityID));
+	return node && node->entityID == entityID ? node : nullptr;
+}
+
+bool TransformSystem::IsDescendant(ECS::EntityID entityID, const ECS::EntityID ancestorID) {
+	while (entityID != ECS::INVALID_ENTITY_ID) {
+		if (entityID == ancestorID) return true;
+		entityID = FindNode(entityID)->parent;
+	}
+	return false;
+}
 }  // namespace PE::Scene::Systems
\ No newline at end of file
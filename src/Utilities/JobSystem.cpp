@@ -0,0 +1,145 @@
+#include "Utilities/JobSystem.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Utilities/Logger.h"
+
+namespace PE::Utilities {
+namespace {
+thread_local uint32_t t_workerIndex = UINT32_MAX;
+}
+
+ERROR_CODE JobSystem::Initialize(uint32_t workerCount) {
+	PE_CHECK_STATE_INIT(s_state, "JobSystem is already initialized.");
+	s_state = SystemState::Initializing;
+
+	if (workerCount == 0) workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+	s_shutdownRequested.store(false, std::memory_order_relaxed);
+	s_queuedJobs.store(0, std::memory_order_relaxed);
+	s_queues.clear();
+	for (uint32_t i = 0; i < workerCount; ++i) s_queues.push_back(std::make_unique<WorkerQueue>());
+
+	t_workerIndex = 0;
+	s_threads.reserve(workerCount - 1);
+	for (uint32_t i = 1; i < workerCount; ++i) s_threads.emplace_back(WorkerLoop, i);
+
+	PE_LOG_INFO("JobSystem initialized with " + std::to_string(workerCount) + " worker(s).");
+	s_state = SystemState::Running;
+	return ERROR_CODE::OK;
+}
+
+ERROR_CODE JobSystem::Shutdown() {
+	if (s_state == SystemState::Uninitialized || s_state == SystemState::ShuttingDown) return ERROR_CODE::OK;
+	s_state = SystemState::ShuttingDown;
+
+	// Drain whatever is left so nobody waits on a counter forever.
+	while (TryExecuteJob()) {
+	}
+
+	{
+		std::lock_guard lock(s_wakeMutex);
+		s_shutdownRequested.store(true, std::memory_order_release);
+	}
+	s_wakeCondition.notify_all();
+
+	for (auto &thread : s_threads)
+		if (thread.joinable()) thread.join();
+
+	s_threads.clear();
+	s_queues.clear();
+	t_workerIndex = UINT32_MAX;
+
+	s_state = SystemState::Uninitialized;
+	return ERROR_CODE::OK;
+}
+
+void JobSystem::Run(JobFunction job, JobCounter *counter) {
+	if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+	// Without workers the job runs inline, which also keeps callers working before Initialize.
+	if (s_state != SystemState::Running) {
+		job();
+		if (counter) counter->pending.fetch_sub(1, std::memory_order_release);
+		return;
+	}
+
+	const uint32_t queueIndex = t_workerIndex < s_queues.size() ? t_workerIndex : 0;
+	{
+		std::lock_guard lock(s_queues[queueIndex]->mutex);
+		s_queues[queueIndex]->jobs.push_back({std::move(job), counter});
+	}
+	s_queuedJobs.fetch_add(1, std::memory_order_release);
+
+	{
+		std::lock_guard lock(s_wakeMutex);
+	}
+	s_wakeCondition.notify_one();
+}
+
+void JobSystem::Wait(const JobCounter &counter) {
+	while (!counter.IsDone()) {
+		if (!TryExecuteJob()) std::this_thread::yield();
+	}
+}
+
+bool JobSystem::TryExecuteJob() {
+	Job job;
+	if (!PopJob(job)) return false;
+	Execute(job);
+	return true;
+}
+
+uint32_t JobSystem::GetCurrentWorkerIndex() { return t_workerIndex; }
+
+void JobSystem::WorkerLoop(const uint32_t workerIndex) {
+	t_workerIndex = workerIndex;
+
+	while (!s_shutdownRequested.load(std::memory_order_acquire)) {
+		if (TryExecuteJob()) continue;
+
+		std::unique_lock lock(s_wakeMutex);
+		s_wakeCondition.wait(lock, [] {
+			return s_shutdownRequested.load(std::memory_order_acquire) ||
+				   s_queuedJobs.load(std::memory_order_acquire) > 0;
+		});
+	}
+}
+
+bool JobSystem::PopJob(Job &outJob) {
+	if (s_queues.empty() || s_queuedJobs.load(std::memory_order_acquire) == 0) return false;
+
+	const auto	   queueCount = static_cast<uint32_t>(s_queues.size());
+	const uint32_t self		  = t_workerIndex < queueCount ? t_workerIndex : 0;
+
+	{
+		WorkerQueue &own = *s_queues[self];
+		std::lock_guard lock(own.mutex);
+		if (!own.jobs.empty()) {
+			outJob = std::move(own.jobs.back());
+			own.jobs.pop_back();
+			s_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	for (uint32_t offset = 1; offset < queueCount; ++offset) {
+		WorkerQueue	   &victim = *s_queues[(self + offset) % queueCount];
+		std::lock_guard lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			outJob = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			s_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Job &job) {
+	job.function();
+	if (job.counter) job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+}  // namespace PE::Utilities
\ No newline at end of file
@@ -20,8 +20,10 @@ bool		  Logger::s_initialized		 = false;
 std::string	  Logger::s_logFilePath		 = (std::filesystem::current_path() / "engine.log").string();
 size_t		  Logger::s_maxFiles		 = 1;
 uint64_t	  Logger::s_maxFileSizeBytes = 5ull * 1024 * 1024;
+std::recursive_mutex Logger::s_mutex;
 
 ERROR_CODE Logger::Initialize(const std::string &logFilePath, size_t maxFiles, uint64_t maxFileSizeBytes) {
+	std::lock_guard lock(s_mutex);
 	if (s_initialized) return ERROR_CODE::ALREADY_INITIALIZED;
 
 	s_logFilePath	   = logFilePath;
@@ -43,6 +45,7 @@ ERROR_CODE Logger::Initialize(const std::string &logFilePath, size_t maxFiles, u
 }
 
 ERROR_CODE Logger::Shutdown() {
+	std::lock_guard lock(s_mutex);
 	if (s_file.is_open()) {
 		s_file.flush();
 		s_file.close();
@@ -114,6 +117,7 @@ void Logger::Log(LogLevel level, const std::string &message, const char *file, i
 
 	std::string formatted = FormatMessage(level, message, file, line);
 
+	std::lock_guard lock(s_mutex);
 	if (!s_initialized) {
 		s_file.open(s_logFilePath.empty() ? "engine.log" : s_logFilePath, std::ios::out | std::ios::app);
 		s_initialized = s_file.is_open();
@@ -0,0 +1,177 @@
+#include "Utilities/TLSFAllocator.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace PE::Utilities {
+TLSFAllocator::TLSFAllocator(const uint64_t size) : m_size(size) {
+	m_freeHeads.fill(INVALID_NODE);
+	if (size > 0) InsertFree(CreateNode(0, size));
+}
+
+TLSFAllocator::Allocation TLSFAllocator::Allocate(uint64_t size, const uint64_t alignment) {
+	size = std::max<uint64_t>(size, 1);
+
+	// Any range of at least size + alignment - 1 bytes has an aligned offset with size bytes after it.
+	const uint32_t nodeIndex = FindFree(size + alignment - 1);
+	if (nodeIndex == INVALID_NODE) return {};
+
+	RemoveFree(nodeIndex);
+
+	const uint64_t alignedOffset = (m_nodes[nodeIndex].offset + alignment - 1) & ~(alignment - 1);
+	if (const uint64_t padding = alignedOffset - m_nodes[nodeIndex].offset; padding > 0) {
+		// The node before a free one is always in use, so the padding becomes a free node of its own.
+		const uint32_t paddingIndex = CreateNode(m_nodes[nodeIndex].offset, padding);
+		Node		  &padNode		= m_nodes[paddingIndex];
+		Node		  &node			= m_nodes[nodeIndex];
+		padNode.prevPhysical		= node.prevPhysical;
+		padNode.nextPhysical		= nodeIndex;
+		if (node.prevPhysical != INVALID_NODE) m_nodes[node.prevPhysical].nextPhysical = paddingIndex;
+		node.prevPhysical = paddingIndex;
+		node.offset		  = alignedOffset;
+		node.size -= padding;
+		InsertFree(paddingIndex);
+	}
+
+	if (m_nodes[nodeIndex].size > size) SplitTail(nodeIndex, size);
+
+	m_nodes[nodeIndex].free = false;
+	m_usedSize += m_nodes[nodeIndex].size;
+	m_allocationCount++;
+	return {m_nodes[nodeIndex].offset, m_nodes[nodeIndex].size, nodeIndex};
+}
+
+void TLSFAllocator::Free(uint32_t node) {
+	if (node == INVALID_NODE || m_nodes[node].free) return;
+
+	m_usedSize -= m_nodes[node].size;
+	m_allocationCount--;
+	m_nodes[node].free = true;
+
+	if (const uint32_t prev = m_nodes[node].prevPhysical; prev != INVALID_NODE && m_nodes[prev].free) {
+		RemoveFree(prev);
+		m_nodes[prev].size += m_nodes[node].size;
+		m_nodes[prev].nextPhysical = m_nodes[node].nextPhysical;
+		if (m_nodes[node].nextPhysical != INVALID_NODE) m_nodes[m_nodes[node].nextPhysical].prevPhysical = prev;
+		ReleaseNode(node);
+		node = prev;
+	}
+
+	if (const uint32_t next = m_nodes[node].nextPhysical; next != INVALID_NODE && m_nodes[next].free) {
+		RemoveFree(next);
+		m_nodes[node].size += m_nodes[next].size;
+		m_nodes[node].nextPhysical = m_nodes[next].nextPhysical;
+		if (m_nodes[next].nextPhysical != INVALID_NODE) m_nodes[m_nodes[next].nextPhysical].prevPhysical = node;
+		ReleaseNode(next);
+	}
+
+	InsertFree(node);
+}
+
+uint64_t TLSFAllocator::GetLargestFreeRange() const {
+	if (m_flBitmap == 0) return 0;
+
+	// Everything in the highest non-empty list is bigger than any other free range, but not sorted inside it.
+	const uint32_t fl	   = 63 - std::countl_zero(m_flBitmap);
+	const uint32_t sl	   = 31 - std::countl_zero(m_slBitmaps[fl]);
+	uint64_t	   largest = 0;
+	for (uint32_t node = m_freeHeads[fl * SL_COUNT + sl]; node != INVALID_NODE; node = m_nodes[node].nextFree)
+		largest = std::max(largest, m_nodes[node].size);
+	return largest;
+}
+
+void TLSFAllocator::Mapping(const uint64_t size, uint32_t &fl, uint32_t &sl) {
+	if (size < SL_COUNT) {
+		fl = 0;
+		sl = static_cast<uint32_t>(size);
+		return;
+	}
+
+	const auto topBit = static_cast<uint32_t>(std::bit_width(size) - 1);
+	fl				  = topBit - SL_COUNT_LOG2 + 1;
+	sl				  = static_cast<uint32_t>(size >> (topBit - SL_COUNT_LOG2)) - SL_COUNT;
+}
+
+uint32_t TLSFAllocator::CreateNode(const uint64_t offset, const uint64_t size) {
+	uint32_t index;
+	if (!m_unusedNodes.empty()) {
+		index = m_unusedNodes.back();
+		m_unusedNodes.pop_back();
+	} else {
+		index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+	}
+
+	m_nodes[index]		  = {};
+	m_nodes[index].offset = offset;
+	m_nodes[index].size	  = size;
+	return index;
+}
+
+void TLSFAllocator::ReleaseNode(const uint32_t node) { m_unusedNodes.push_back(node); }
+
+void TLSFAllocator::InsertFree(const uint32_t node) {
+	uint32_t fl, sl;
+	Mapping(m_nodes[node].size, fl, sl);
+
+	uint32_t &head		   = m_freeHeads[fl * SL_COUNT + sl];
+	m_nodes[node].free	   = true;
+	m_nodes[node].prevFree = INVALID_NODE;
+	m_nodes[node].nextFree = head;
+	if (head != INVALID_NODE) m_nodes[head].prevFree = node;
+	head = node;
+
+	m_flBitmap |= 1ull << fl;
+	m_slBitmaps[fl] |= 1u << sl;
+}
+
+void TLSFAllocator::RemoveFree(const uint32_t node) {
+	uint32_t fl, sl;
+	Mapping(m_nodes[node].size, fl, sl);
+
+	const Node &entry = m_nodes[node];
+	if (entry.prevFree != INVALID_NODE) m_nodes[entry.prevFree].nextFree = entry.nextFree;
+	if (entry.nextFree != INVALID_NODE) m_nodes[entry.nextFree].prevFree = entry.prevFree;
+
+	uint32_t &head = m_freeHeads[fl * SL_COUNT + sl];
+	if (head == node) {
+		head = entry.nextFree;
+		if (head == INVALID_NODE) {
+			m_slBitmaps[fl] &= ~(1u << sl);
+			if (m_slBitmaps[fl] == 0) m_flBitmap &= ~(1ull << fl);
+		}
+	}
+	m_nodes[node].free = false;
+}
+
+void TLSFAllocator::SplitTail(const uint32_t node, const uint64_t size) {
+	const uint32_t tailIndex = CreateNode(m_nodes[node].offset + size, m_nodes[node].size - size);
+	Node		  &tail		 = m_nodes[tailIndex];
+	tail.prevPhysical		 = node;
+	tail.nextPhysical		 = m_nodes[node].nextPhysical;
+	if (tail.nextPhysical != INVALID_NODE) m_nodes[tail.nextPhysical].prevPhysical = tailIndex;
+	m_nodes[node].nextPhysical = tailIndex;
+	m_nodes[node].size		   = size;
+	InsertFree(tailIndex);
+}
+
+uint32_t TLSFAllocator::FindFree(uint64_t size) const {
+	// Rounding the request up to the next size class makes every range in the found list big enough.
+	if (size >= SL_COUNT) size += (1ull << (std::bit_width(size) - 1 - SL_COUNT_LOG2)) - 1;
+
+	uint32_t fl, sl;
+	Mapping(size, fl, sl);
+	if (fl >= FL_COUNT) return INVALID_NODE;
+
+	uint32_t slMap = m_slBitmaps[fl] & (~0u << sl);
+	if (slMap == 0) {
+		const uint64_t flMap = (fl + 1 < 64) ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+		if (flMap == 0) return INVALID_NODE;
+
+		fl	  = static_cast<uint32_t>(std::countr_zero(flMap));
+		slMap = m_slBitmaps[fl];
+	}
+	sl = static_cast<uint32_t>(std::countr_zero(slMap));
+	return m_freeHeads[fl * SL_COUNT + sl];
+}
+}  // namespace PE::Utilities
\ No newline at end of file
@@ -66,12 +66,26 @@ PE::Core::EngineConfig CreateEngineConfig(PE::Core::EngineConfig					&config,
 													   ? PE::Graphics::SupportedGraphicAPI::Vulkan
 													   : PE::Graphics::SupportedGraphicAPI::D3D11;
 	config.renderConfig.enableVSync				 = args.enableVSync;
+	config.renderConfig.compressTextures		 = args.compressTextures;
+	config.renderConfig.gpuDrivenCulling		 = args.gpuDrivenCulling;
 	config.renderConfig.width					 = args.clientWidth;
 	config.renderConfig.height					 = args.clientHeight;
 	config.renderConfig.maxCameraCount			 = 1;
 	config.renderConfig.maxDirectionalLightCount = 1;
 	config.maxEntityCount						 = 1024;
 	config.maxComponentTypeCount				 = 1024;
+	config.workerThreadCount					 = args.workerThreadCount;
+	config.parallelSystemUpdate					 = !args.singleThreaded;
+
+	// The offscreen path only exists in the Vulkan renderer.
+	if (args.headless) {
+		config.renderConfig.graphicAPI = PE::Graphics::SupportedGraphicAPI::Vulkan;
+		config.headless				   = true;
+		config.headlessFrameCount	   = args.headlessFrameCount;
+		config.captureFrames		   = args.captureFrames;
+		config.captureDirectory		   = args.captureDirectory;
+		config.captureFormat		   = args.captureFormat;
+	}
 
 	return config;
 }
\ No newline at end of file